@@ -61,6 +61,7 @@ public class Designer : ModuleRules
 				"Slate",
 				"SlateCore",
 				"InputCore",
+				"Landscape",
 				"UnrealEd",
 				"LevelEditor",
                 "EditorStyle",
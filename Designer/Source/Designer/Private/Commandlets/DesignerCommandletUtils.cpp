@@ -0,0 +1,87 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Commandlets/DesignerCommandletUtils.h"
+
+// Engine Includes
+#include "Editor.h"
+#include "Engine/World.h"
+#include "Misc/Parse.h"
+#include "UObject/Package.h"
+
+UWorld* FDesignerCommandletUtils::LoadWorld(const FString& MapName)
+{
+	UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = Package != nullptr ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (World == nullptr)
+	{
+		return nullptr;
+	}
+
+	World->AddToRoot();
+	World->WorldType = EWorldType::Editor;
+
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.AllowAudioPlayback(false)
+			.CreatePhysicsScene(true));
+	}
+
+	GEditor->GetEditorWorldContext().SetCurrentWorld(World);
+	GWorld = World;
+
+	World->UpdateWorldComponents(/*bRerunConstructionScripts*/true, /*bCurrentLevelOnly*/false);
+
+	return World;
+}
+
+bool FDesignerCommandletUtils::ParseExactValue(const TCHAR* Params, const TCHAR* Key, FString& OutValue)
+{
+	const int32 KeyLength = FCString::Strlen(Key);
+
+	// Tokens keep quoted parts intact, so -Key="A B" is a single token
+	FString Token;
+	while (FParse::Token(Params, Token, /*UseEscape*/false))
+	{
+		const TCHAR* Name = *Token;
+		while (*Name == TEXT('-') || *Name == TEXT('/'))
+		{
+			++Name;
+		}
+
+		if (FCString::Strnicmp(Name, Key, KeyLength) == 0)
+		{
+			OutValue = FString(Name + KeyLength).TrimQuotes();
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,47 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Forward Declares
+class UWorld;
+
+/**
+ * Helpers shared by the Designer commandlets
+ */
+class FDesignerCommandletUtils
+{
+public:
+	/** Loads the map package, initializes its world for tracing and makes it the editor world */
+	static UWorld* LoadWorld(const FString& MapName);
+
+	/**
+	 * Finds the value of a -Key=Value parameter, where Key has to match a whole parameter name, so Bounds= does not match -DensityBounds=.
+	 * Key includes the trailing '=' like FParse::Value. Quotes around the value are removed. Returns false if the parameter is not given.
+	 */
+	static bool ParseExactValue(const TCHAR* Params, const TCHAR* Key, FString& OutValue);
+};
@@ -0,0 +1,119 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Commandlets/DesignerReplayCommandlet.h"
+
+// Engine Includes
+#include "Misc/FileHelper.h"
+
+// Local Includes
+#include "Commandlets/DesignerCommandletUtils.h"
+#include "DesignerModule.h"
+#include "Recording/DesignerInputRecorder.h"
+#include "Recording/DesignerInputReplayer.h"
+
+UDesignerReplayCommandlet::UDesignerReplayCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UDesignerReplayCommandlet::Main(const FString& Params)
+{
+	FString RecordingFilename;
+	if (!FParse::Value(*Params, TEXT("Recording="), RecordingFilename))
+	{
+		UE_LOG(LogDesigner, Error, TEXT("No recording given, use -Recording=<File.drec>."));
+		return 1;
+	}
+
+	FDesignerInputRecording Recording;
+	if (!Recording.LoadFromFile(RecordingFilename))
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Could not read recording %s."), *RecordingFilename);
+		return 1;
+	}
+
+	FString MapName = Recording.MapName;
+	FParse::Value(*Params, TEXT("Map="), MapName);
+
+	if (FDesignerCommandletUtils::LoadWorld(MapName) == nullptr)
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Could not load map %s."), *MapName);
+		return 1;
+	}
+
+	TArray<FDesignerReplayFrame> Frames;
+	if (!FDesignerInputReplayer::Replay(Recording, Frames) || Frames.Num() == 0)
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Could not replay %s."), *RecordingFilename);
+		return 1;
+	}
+
+	TArray<float> SortedFrameTimes;
+	SortedFrameTimes.Reserve(Frames.Num());
+	float TotalFrameTime = 0.F;
+	for (const FDesignerReplayFrame& Frame : Frames)
+	{
+		SortedFrameTimes.Add(Frame.ReplayTimeMs);
+		TotalFrameTime += Frame.ReplayTimeMs;
+	}
+	SortedFrameTimes.Sort();
+
+	const float AverageFrameTime = TotalFrameTime / Frames.Num();
+	const float P95FrameTime = SortedFrameTimes[FMath::Min(FMath::FloorToInt(Frames.Num() * 0.95F), Frames.Num() - 1)];
+	const float MaxFrameTime = SortedFrameTimes.Last();
+
+	UE_LOG(LogDesigner, Display, TEXT("Replayed %d frames of %s: average %.3f ms, 95th percentile %.3f ms, max %.3f ms."),
+		Frames.Num(), *RecordingFilename, AverageFrameTime, P95FrameTime, MaxFrameTime);
+
+	FString TimingsFilename;
+	if (FParse::Value(*Params, TEXT("Timings="), TimingsFilename))
+	{
+		FString Timings = TEXT("Frame,RecordedMs,ReplayMs\n");
+		for (int32 FrameIndex = 0; FrameIndex < Frames.Num(); ++FrameIndex)
+		{
+			Timings += FString::Printf(TEXT("%d,%.3f,%.3f\n"), FrameIndex, Frames[FrameIndex].RecordedDeltaTime * 1000.F, Frames[FrameIndex].ReplayTimeMs);
+		}
+
+		if (!FFileHelper::SaveStringToFile(Timings, *TimingsFilename))
+		{
+			UE_LOG(LogDesigner, Error, TEXT("Could not write %s."), *TimingsFilename);
+			return 1;
+		}
+	}
+
+	float MaxFrameMs = 0.F;
+	if (FParse::Value(*Params, TEXT("MaxFrameMs="), MaxFrameMs) && MaxFrameMs > 0.F && MaxFrameTime > MaxFrameMs)
+	{
+		UE_LOG(LogDesigner, Error, TEXT("The slowest frame took %.3f ms, the budget is %.3f ms."), MaxFrameTime, MaxFrameMs);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,53 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+// Generated Include
+#include "DesignerReplayCommandlet.generated.h"
+
+/**
+ * Replays recorded designer input headlessly against its map and reports the frame timings.
+ * Recordings are made in the editor with designer.record.start and designer.record.stop.
+ * With -MaxFrameMs the commandlet fails when any replayed frame is slower, so a recording can serve as a regression test.
+ *
+ * Usage:
+ *   -run=DesignerReplay -Recording=<File.drec> [-Map=<MapOverride>] [-Timings=<File.csv>] [-MaxFrameMs=<Milliseconds>]
+ */
+UCLASS()
+class UDesignerReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UDesignerReplayCommandlet(const FObjectInitializer& ObjectInitializer);
+
+	//~ Begin UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet interface
+};
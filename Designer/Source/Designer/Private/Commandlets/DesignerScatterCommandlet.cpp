@@ -0,0 +1,484 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Commandlets/DesignerScatterCommandlet.h"
+
+// Engine Includes
+#include "Editor.h"
+#include "Engine/Texture2D.h"
+#include "EngineUtils.h"
+#include "Engine/LevelBounds.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "LandscapeLayerInfoObject.h"
+#include "Misc/PackageName.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+
+// Local Includes
+#include "Commandlets/DesignerCommandletUtils.h"
+#include "DesignerInstanceContainer.h"
+#include "DesignerModule.h"
+#include "DesignerPalette.h"
+#include "DesignerSettings.h"
+#include "Placement/DesignerPlacement.h"
+#include "Placement/DesignerScatter.h"
+
+UDesignerScatterCommandlet::UDesignerScatterCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, Bounds(ForceInit)
+	, Density(0.F)
+	, TileSize(25600.F)
+	, Seed(0)
+	, NumTilesX(0)
+	, NumTilesY(0)
+	, Settings(nullptr)
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UDesignerScatterCommandlet::Main(const FString& Params)
+{
+	FString MapName;
+	if (!FParse::Value(*Params, TEXT("Map="), MapName))
+	{
+		UE_LOG(LogDesigner, Error, TEXT("No map given, use -Map=/Game/Path/To/Map."));
+		return 1;
+	}
+
+	UWorld* World = FDesignerCommandletUtils::LoadWorld(MapName);
+	if (World == nullptr)
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Could not load map %s."), *MapName);
+		return 1;
+	}
+
+	if (!ParseSharedParams(World, Params))
+	{
+		return 1;
+	}
+
+	int32 Result = 0;
+	if (FParse::Param(*Params, TEXT("Worker")))
+	{
+		int32 WorkerIndex = 0;
+		int32 WorkerCount = 1;
+		FParse::Value(*Params, TEXT("WorkerIndex="), WorkerIndex);
+		FParse::Value(*Params, TEXT("WorkerCount="), WorkerCount);
+		Result = RunWorker(World, WorkerIndex, FMath::Max(WorkerCount, 1));
+	}
+	else
+	{
+		Result = RunCoordinator(World, Params);
+	}
+
+	World->RemoveFromRoot();
+	return Result;
+}
+
+int32 UDesignerScatterCommandlet::RunCoordinator(UWorld* World, const FString& Params)
+{
+	const int32 NumTiles = NumTilesX * NumTilesY;
+
+	int32 WorkerCount = FPlatformMisc::NumberOfCores();
+	FParse::Value(*Params, TEXT("Workers="), WorkerCount);
+	WorkerCount = FMath::Clamp(WorkerCount, 1, NumTiles);
+
+	UE_LOG(LogDesigner, Display, TEXT("Scattering %d tiles (%d x %d) with %d worker(s)."), NumTiles, NumTilesX, NumTilesY, WorkerCount);
+
+	double StartTime = FPlatformTime::Seconds();
+
+	// A single worker runs in this process, the result is the same as with separate processes since every tile has its own seed
+	bool bSuccess = WorkerCount > 1 ? RunWorkerProcesses(Params, WorkerCount) : RunWorker(World, 0, 1) == 0;
+	if (!bSuccess)
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Not all tiles could be scattered."));
+		return 1;
+	}
+
+	UE_LOG(LogDesigner, Display, TEXT("Scattered all tiles in %.2f seconds, merging."), FPlatformTime::Seconds() - StartTime);
+
+	// Remove the results of previous runs so the commandlet can be run repeatedly
+	TMap<FString, ADesignerInstanceContainer*> ExistingContainers;
+	for (TActorIterator<ADesignerInstanceContainer> It(World); It; ++It)
+	{
+		ExistingContainers.Add(It->GetActorLabel(), *It);
+	}
+
+	int32 NumPlacements = 0;
+	FDesignerPlacementBatch TileBatch;
+	TArray<AActor*> SpawnedActors;
+	for (int32 TileIndex = 0; TileIndex < NumTiles; ++TileIndex)
+	{
+		TileBatch.Reset();
+		if (!TileBatch.LoadFromFile(GetTileFilename(TileIndex)))
+		{
+			UE_LOG(LogDesigner, Error, TEXT("Could not read the result of tile %d."), TileIndex);
+			return 1;
+		}
+
+		const FString TileLabel = GetTileLabel(TileIndex);
+		const FName TileTag(*TileLabel);
+
+		for (TActorIterator<AActor> It(World); It; ++It)
+		{
+			if (It->ActorHasTag(TileTag) && !It->IsA<ADesignerInstanceContainer>())
+			{
+				World->EditorDestroyActor(*It, false);
+			}
+		}
+
+		ADesignerInstanceContainer* Container = ExistingContainers.FindRef(TileLabel);
+		if (Container == nullptr)
+		{
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.OverrideLevel = World->PersistentLevel;
+			Container = World->SpawnActor<ADesignerInstanceContainer>(GetTileBounds(TileIndex).GetCenter(), FRotator::ZeroRotator, SpawnParameters);
+			Container->SetActorLabel(TileLabel);
+		}
+		Container->ClearInstances();
+
+		SpawnedActors.Reset();
+		NumPlacements += FDesignerPlacement::CommitBatch(TileBatch, World->PersistentLevel, Container, &SpawnedActors);
+		for (AActor* SpawnedActor : SpawnedActors)
+		{
+			SpawnedActor->Tags.Add(TileTag);
+		}
+	}
+
+	UE_LOG(LogDesigner, Display, TEXT("Committed %d placements in %.2f seconds."), NumPlacements, FPlatformTime::Seconds() - StartTime);
+
+	if (!FParse::Param(*Params, TEXT("NoSave")))
+	{
+		UPackage* Package = World->GetOutermost();
+		FString PackageFilename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetMapPackageExtension());
+		if (!UPackage::SavePackage(Package, World, RF_NoFlags, *PackageFilename, GError, nullptr, false, true, SAVE_NoError))
+		{
+			UE_LOG(LogDesigner, Error, TEXT("Could not save %s."), *PackageFilename);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+int32 UDesignerScatterCommandlet::RunWorker(UWorld* World, int32 WorkerIndex, int32 WorkerCount)
+{
+	const int32 NumTiles = NumTilesX * NumTilesY;
+
+	for (int32 TileIndex = WorkerIndex; TileIndex < NumTiles; TileIndex += WorkerCount)
+	{
+		if (!ScatterTile(World, TileIndex))
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+bool UDesignerScatterCommandlet::ScatterTile(UWorld* World, int32 TileIndex)
+{
+	FDesignerScatterParams ScatterParams;
+	ScatterParams.Bounds = GetTileBounds(TileIndex);
+	ScatterParams.Density = Density;
+	ScatterParams.Seed = FDesignerScatter::MakeRegionSeed(Seed, TileIndex);
+
+	FDesignerPlacementBatch TileBatch;
+	TileBatch.Assets = Assets;
+
+	int32 NumPlacements = FDesignerScatter::Scatter(World, Settings, ScatterParams, TileBatch);
+	UE_LOG(LogDesigner, Display, TEXT("Tile %d: %d placements."), TileIndex, NumPlacements);
+
+	return TileBatch.SaveToFile(GetTileFilename(TileIndex));
+}
+
+bool UDesignerScatterCommandlet::RunWorkerProcesses(const FString& Params, int32 WorkerCount)
+{
+	// Forward the shared parameters verbatim so every worker parses exactly the same values as the coordinator
+	FString SharedParams;
+	for (const TCHAR* SharedParam : { TEXT("Map="), TEXT("Assets="), TEXT("Palette="), TEXT("OverlapPadding="), TEXT("DensityTexture="), TEXT("DensityChannel="), TEXT("DensityBounds="), TEXT("DensityLayer="), TEXT("Slope="), TEXT("Height="), TEXT("Facing="), TEXT("ExcludeMaterials="), TEXT("Density="), TEXT("TileSize="), TEXT("Seed="), TEXT("Output="), TEXT("Bounds=") })
+	{
+		FString Value;
+		if (FDesignerCommandletUtils::ParseExactValue(*Params, SharedParam, Value))
+		{
+			SharedParams += FString::Printf(TEXT(" -%s\"%s\""), SharedParam, *Value);
+		}
+	}
+
+	// Workers must use the same bounds even if the coordinator computed them from the level
+	FString BoundsValue;
+	if (!FDesignerCommandletUtils::ParseExactValue(*Params, TEXT("Bounds="), BoundsValue))
+	{
+		SharedParams += FString::Printf(TEXT(" -Bounds=\"%.9g,%.9g,%.9g,%.9g,%.9g,%.9g\""), Bounds.Min.X, Bounds.Min.Y, Bounds.Min.Z, Bounds.Max.X, Bounds.Max.Y, Bounds.Max.Z);
+	}
+
+	const FString ExecutablePath = FPlatformProcess::ExecutablePath();
+	const FString ProjectFilePath = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+
+	TArray<FProcHandle> WorkerHandles;
+	for (int32 WorkerIndex = 0; WorkerIndex < WorkerCount; ++WorkerIndex)
+	{
+		FString WorkerParams = FString::Printf(TEXT("\"%s\" -run=DesignerScatter -Worker -WorkerIndex=%d -WorkerCount=%d%s -unattended -nopause -nosplash -nullrhi -stdout"),
+			*ProjectFilePath, WorkerIndex, WorkerCount, *SharedParams);
+
+		FProcHandle WorkerHandle = FPlatformProcess::CreateProc(*ExecutablePath, *WorkerParams, false, true, true, nullptr, 0, nullptr, nullptr);
+		if (!WorkerHandle.IsValid())
+		{
+			UE_LOG(LogDesigner, Error, TEXT("Could not launch worker %d."), WorkerIndex);
+			for (FProcHandle& Handle : WorkerHandles)
+			{
+				FPlatformProcess::TerminateProc(Handle);
+				FPlatformProcess::CloseProc(Handle);
+			}
+			return false;
+		}
+
+		WorkerHandles.Add(WorkerHandle);
+	}
+
+	bool bSuccess = true;
+	for (int32 WorkerIndex = 0; WorkerIndex < WorkerHandles.Num(); ++WorkerIndex)
+	{
+		FProcHandle& WorkerHandle = WorkerHandles[WorkerIndex];
+		FPlatformProcess::WaitForProc(WorkerHandle);
+
+		int32 ReturnCode = 0;
+		if (!FPlatformProcess::GetProcReturnCode(WorkerHandle, &ReturnCode) || ReturnCode != 0)
+		{
+			UE_LOG(LogDesigner, Error, TEXT("Worker %d failed with code %d."), WorkerIndex, ReturnCode);
+			bSuccess = false;
+		}
+
+		FPlatformProcess::CloseProc(WorkerHandle);
+	}
+
+	return bSuccess;
+}
+
+bool UDesignerScatterCommandlet::ParseSharedParams(UWorld* World, const FString& Params)
+{
+	FString AssetsString;
+	FParse::Value(*Params, TEXT("Assets="), AssetsString, /*bShouldStopOnSeparator*/false);
+
+	TArray<FString> AssetPaths;
+	AssetsString.ParseIntoArray(AssetPaths, TEXT(","));
+	Assets.Reset();
+	for (const FString& AssetPath : AssetPaths)
+	{
+		Assets.Add(FSoftObjectPath(AssetPath.TrimStartAndEnd()));
+	}
+
+	Settings = NewObject<UDesignerSettings>(this);
+
+	FString PalettePath;
+	if (FParse::Value(*Params, TEXT("Palette="), PalettePath))
+	{
+		Settings->Palette = LoadObject<UDesignerPalette>(nullptr, *PalettePath);
+		if (Settings->Palette == nullptr)
+		{
+			UE_LOG(LogDesigner, Error, TEXT("Could not load palette %s."), *PalettePath);
+			return false;
+		}
+	}
+
+	// Giving a padding enables the overlap rejection, it only sees content committed before the run and the placements of the same tile
+	if (FParse::Value(*Params, TEXT("OverlapPadding="), Settings->OverlapPadding))
+	{
+		Settings->bRejectOverlaps = true;
+	}
+
+	// A landscape layer takes precedence over a texture, like it does in the settings
+	FString DensityLayerPath;
+	if (FParse::Value(*Params, TEXT("DensityLayer="), DensityLayerPath))
+	{
+		Settings->DensityLayer = LoadObject<ULandscapeLayerInfoObject>(nullptr, *DensityLayerPath);
+		if (Settings->DensityLayer == nullptr)
+		{
+			UE_LOG(LogDesigner, Error, TEXT("Could not load landscape layer %s."), *DensityLayerPath);
+			return false;
+		}
+	}
+
+	FString DensityTexturePath;
+	if (FParse::Value(*Params, TEXT("DensityTexture="), DensityTexturePath))
+	{
+		Settings->DensityTexture = LoadObject<UTexture2D>(nullptr, *DensityTexturePath);
+		if (Settings->DensityTexture == nullptr)
+		{
+			UE_LOG(LogDesigner, Error, TEXT("Could not load density texture %s."), *DensityTexturePath);
+			return false;
+		}
+
+		FString DensityChannelName;
+		if (FParse::Value(*Params, TEXT("DensityChannel="), DensityChannelName))
+		{
+			const int64 DensityChannel = StaticEnum<EDensityMapChannel>()->GetValueByNameString(DensityChannelName);
+			if (DensityChannel == INDEX_NONE)
+			{
+				UE_LOG(LogDesigner, Error, TEXT("DensityChannel must be Red, Green, Blue or Alpha."));
+				return false;
+			}
+			Settings->DensityTextureChannel = static_cast<EDensityMapChannel>(DensityChannel);
+		}
+
+		FString DensityBoundsString;
+		TArray<FString> DensityBoundsValues;
+		FDesignerCommandletUtils::ParseExactValue(*Params, TEXT("DensityBounds="), DensityBoundsString);
+		DensityBoundsString.ParseIntoArray(DensityBoundsValues, TEXT(","));
+		if (DensityBoundsValues.Num() != 4)
+		{
+			UE_LOG(LogDesigner, Error, TEXT("A density texture needs its world region, use -DensityBounds=MinX,MinY,MaxX,MaxY."));
+			return false;
+		}
+
+		Settings->DensityTextureBounds = FBox2D(
+			FVector2D(FCString::Atof(*DensityBoundsValues[0]), FCString::Atof(*DensityBoundsValues[1])),
+			FVector2D(FCString::Atof(*DensityBoundsValues[2]), FCString::Atof(*DensityBoundsValues[3])));
+	}
+
+	// Every limit is given as a pair of values and enables its rule
+	struct FRuleLimitParam
+	{
+		const TCHAR* Name;
+		bool& bEnabled;
+		float& First;
+		float& Second;
+	};
+	for (const FRuleLimitParam& RuleLimit : {
+		FRuleLimitParam{ TEXT("Slope="), Settings->bLimitSlope, Settings->MinSlopeAngle, Settings->MaxSlopeAngle },
+		FRuleLimitParam{ TEXT("Height="), Settings->bLimitHeight, Settings->MinHeight, Settings->MaxHeight },
+		FRuleLimitParam{ TEXT("Facing="), Settings->bLimitFacing, Settings->FacingYaw, Settings->MaxFacingAngle } })
+	{
+		FString LimitString;
+		if (FParse::Value(*Params, RuleLimit.Name, LimitString, /*bShouldStopOnSeparator*/false))
+		{
+			TArray<FString> LimitValues;
+			LimitString.ParseIntoArray(LimitValues, TEXT(","));
+			if (LimitValues.Num() != 2)
+			{
+				UE_LOG(LogDesigner, Error, TEXT("-%s takes two values separated by a comma."), RuleLimit.Name);
+				return false;
+			}
+
+			RuleLimit.bEnabled = true;
+			RuleLimit.First = FCString::Atof(*LimitValues[0]);
+			RuleLimit.Second = FCString::Atof(*LimitValues[1]);
+		}
+	}
+
+	FString ExcludedMaterialsString;
+	FParse::Value(*Params, TEXT("ExcludeMaterials="), ExcludedMaterialsString, /*bShouldStopOnSeparator*/false);
+	TArray<FString> ExcludedMaterialPaths;
+	ExcludedMaterialsString.ParseIntoArray(ExcludedMaterialPaths, TEXT(","));
+	for (const FString& ExcludedMaterialPath : ExcludedMaterialPaths)
+	{
+		UPhysicalMaterial* ExcludedMaterial = LoadObject<UPhysicalMaterial>(nullptr, *ExcludedMaterialPath.TrimStartAndEnd());
+		if (ExcludedMaterial == nullptr)
+		{
+			UE_LOG(LogDesigner, Error, TEXT("Could not load physical material %s."), *ExcludedMaterialPath);
+			return false;
+		}
+		Settings->ExcludedPhysicalMaterials.Add(ExcludedMaterial);
+	}
+
+	if (Assets.Num() == 0 && Settings->Palette == nullptr)
+	{
+		UE_LOG(LogDesigner, Error, TEXT("No assets given, use -Assets=/Game/Path/To/Asset.Asset,... or -Palette=/Game/Path/To/Palette.Palette"));
+		return false;
+	}
+
+	FParse::Value(*Params, TEXT("Density="), Density);
+	FParse::Value(*Params, TEXT("TileSize="), TileSize);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+
+	if (Density <= 0.F || TileSize <= 0.F)
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Density and TileSize must be larger than zero."));
+		return false;
+	}
+
+	FString BoundsString;
+	// FParse::Value would also match -DensityBounds=
+	if (FDesignerCommandletUtils::ParseExactValue(*Params, TEXT("Bounds="), BoundsString))
+	{
+		TArray<FString> BoundsValues;
+		BoundsString.ParseIntoArray(BoundsValues, TEXT(","));
+		if (BoundsValues.Num() != 6)
+		{
+			UE_LOG(LogDesigner, Error, TEXT("Bounds must be given as MinX,MinY,MinZ,MaxX,MaxY,MaxZ."));
+			return false;
+		}
+
+		Bounds = FBox(
+			FVector(FCString::Atof(*BoundsValues[0]), FCString::Atof(*BoundsValues[1]), FCString::Atof(*BoundsValues[2])),
+			FVector(FCString::Atof(*BoundsValues[3]), FCString::Atof(*BoundsValues[4]), FCString::Atof(*BoundsValues[5])));
+	}
+	else
+	{
+		Bounds = ALevelBounds::CalculateLevelBounds(World->PersistentLevel);
+	}
+
+	if (!Bounds.IsValid)
+	{
+		UE_LOG(LogDesigner, Error, TEXT("The map has no bounds, use -Bounds=MinX,MinY,MinZ,MaxX,MaxY,MaxZ."));
+		return false;
+	}
+
+	NumTilesX = FMath::Max(FMath::CeilToInt((Bounds.Max.X - Bounds.Min.X) / TileSize), 1);
+	NumTilesY = FMath::Max(FMath::CeilToInt((Bounds.Max.Y - Bounds.Min.Y) / TileSize), 1);
+
+	OutputDirectory = FPaths::ProjectSavedDir() / TEXT("Designer") / TEXT("Scatter");
+	FParse::Value(*Params, TEXT("Output="), OutputDirectory, /*bShouldStopOnSeparator*/false);
+	IFileManager::Get().MakeDirectory(*OutputDirectory, /*Tree*/true);
+
+	return true;
+}
+
+FBox UDesignerScatterCommandlet::GetTileBounds(int32 TileIndex) const
+{
+	const int32 TileX = TileIndex % NumTilesX;
+	const int32 TileY = TileIndex / NumTilesX;
+
+	FVector TileMin(Bounds.Min.X + TileX * TileSize, Bounds.Min.Y + TileY * TileSize, Bounds.Min.Z);
+	FVector TileMax(FMath::Min(TileMin.X + TileSize, Bounds.Max.X), FMath::Min(TileMin.Y + TileSize, Bounds.Max.Y), Bounds.Max.Z);
+
+	return FBox(TileMin, TileMax);
+}
+
+FString UDesignerScatterCommandlet::GetTileFilename(int32 TileIndex) const
+{
+	return OutputDirectory / FString::Printf(TEXT("Tile_%d.dplb"), TileIndex);
+}
+
+FString UDesignerScatterCommandlet::GetTileLabel(int32 TileIndex) const
+{
+	return FString::Printf(TEXT("DesignerScatter_%d_%d"), TileIndex % NumTilesX, TileIndex / NumTilesX);
+}
@@ -0,0 +1,119 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+// Generated Include
+#include "DesignerScatterCommandlet.generated.h"
+
+// Forward Declares
+class UDesignerSettings;
+class UWorld;
+struct FDesignerPlacementBatch;
+
+/**
+ * Offline scatter placement over a whole map.
+ *
+ * The map is split into tiles which are distributed over a number of worker processes on this machine.
+ * Every tile is scattered with its own seed derived from the base seed and the tile index, so the result is
+ * identical no matter how many workers are used. The coordinator merges the tile results in tile order and
+ * commits every tile to its own instance container.
+ *
+ * Usage:
+ *   -run=DesignerScatter -Map=/Game/Maps/World (-Assets=/Game/Rock.Rock,/Game/Tree.Tree | -Palette=/Game/Rocks.Rocks) -Density=0.01
+ *   [-TileSize=25600] [-Seed=0] [-Workers=<NumberOfCores>] [-Bounds=MinX,MinY,MinZ,MaxX,MaxY,MaxZ] [-Output=<Dir>] [-NoSave]
+ *   [-OverlapPadding=<cm>] (rejects placements overlapping placed content or each other)
+ *   [-DensityTexture=/Game/Mask.Mask -DensityBounds=MinX,MinY,MaxX,MaxY [-DensityChannel=Red]] [-DensityLayer=/Game/Grass_LayerInfo.Grass_LayerInfo]
+ *   (scales the density by a texture channel stretched over the given region, or by the weights of a painted landscape layer)
+ *   [-Slope=MinDegrees,MaxDegrees] [-Height=Min,Max] [-Facing=Yaw,MaxDegrees] [-ExcludeMaterials=/Game/Water.Water,...]
+ *   (only places on surfaces within the slope, height and facing limits and without the excluded physical materials)
+ */
+UCLASS()
+class UDesignerScatterCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UDesignerScatterCommandlet(const FObjectInitializer& ObjectInitializer);
+
+	//~ Begin UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet interface
+
+private:
+	/** Splits the map in tiles, runs the workers and merges the results */
+	int32 RunCoordinator(UWorld* World, const FString& Params);
+
+	/** Scatters the tiles assigned to a worker and writes them to the output directory */
+	int32 RunWorker(UWorld* World, int32 WorkerIndex, int32 WorkerCount);
+
+	/** Scatters a single tile and writes it to the output directory. Returns true if it was successful */
+	bool ScatterTile(UWorld* World, int32 TileIndex);
+
+	/** Launches the worker processes and waits for all of them to finish. Returns true if all workers succeeded */
+	bool RunWorkerProcesses(const FString& Params, int32 WorkerCount);
+
+	/** Parses the parameters shared by the coordinator and the workers. Returns true if they are valid */
+	bool ParseSharedParams(UWorld* World, const FString& Params);
+
+	/** The world bounds of a tile */
+	FBox GetTileBounds(int32 TileIndex) const;
+
+	/** The file a tile result is written to */
+	FString GetTileFilename(int32 TileIndex) const;
+
+	/** The label of the instance container holding a tile */
+	FString GetTileLabel(int32 TileIndex) const;
+
+private:
+	/** The assets to scatter */
+	TArray<FSoftObjectPath> Assets;
+
+	/** The region that is split into tiles */
+	FBox Bounds;
+
+	/** The placements per square meter */
+	float Density;
+
+	/** The size of a tile in cm */
+	float TileSize;
+
+	/** The base seed of the run */
+	int32 Seed;
+
+	/** The number of tiles along x and y */
+	int32 NumTilesX;
+	int32 NumTilesY;
+
+	/** The directory the tile results are written to */
+	FString OutputDirectory;
+
+	/** The default settings, with the palette set when one was given */
+	UPROPERTY()
+	UDesignerSettings* Settings;
+};
@@ -26,25 +26,46 @@
 #include "DesignerEdMode.h"
 
 // Engine Includes
+#include "Editor.h"
 #include "Toolkits/ToolkitManager.h"
 #include "EditorModeManager.h"
+#include "LevelEditorViewport.h"
 
 // Local Includes
 #include "DesignerEdModeToolkit.h"
 #include "DesignerModule.h"
 #include "DesignerSettings.h"
+#include "Diagnostics/DesignerMemory.h"
+#include "Diagnostics/DesignerPerfHUD.h"
+#include "Placement/DesignerSpawnQueue.h"
+#include "Recording/DesignerInputRecorder.h"
 
 #include "Tools/DesignerTool.h"
+#include "Tools/EraseTool.h"
 #include "Tools/SpawnAssetTool.h"
+#include "Tools/SplinePlacementTool.h"
 
 const FEditorModeID FDesignerEdMode::EM_DesignerEdModeId = TEXT("EM_DesignerEdMode");
 
 FDesignerEdMode::FDesignerEdMode()
+	: bUsesToolkits(true)
 {
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Tools);
+
 	DesignerSettings = NewObject<UDesignerSettings>(GetTransientPackage(), TEXT("DesignerEdModeSettings"), RF_Transactional);
 	DesignerSettings->SetParent(this);
 
-	SpawnAssetTool = new FSpawnAssetTool(DesignerSettings);
+	SpawnAssetTool = new FSpawnAssetTool(DesignerSettings, &SnapIndex);
+	SplinePlacementTool = new FSplinePlacementTool(DesignerSettings);
+	EraseTool = new FEraseTool(DesignerSettings, &ContentIndex);
+}
+
+FDesignerEdMode::~FDesignerEdMode()
+{
+	// The editor creates a new mode every time it is activated
+	delete SpawnAssetTool;
+	delete SplinePlacementTool;
+	delete EraseTool;
 }
 
 void FDesignerEdMode::AddReferencedObjects(FReferenceCollector& Collector)
@@ -71,11 +92,24 @@ void FDesignerEdMode::Enter()
 	}
 
 	SwitchTool(nullptr);
+
+	OnLevelActorAddedHandle = GEngine->OnLevelActorAdded().AddRaw(this, &FDesignerEdMode::OnLevelActorAdded);
+	OnLevelActorDeletedHandle = GEngine->OnLevelActorDeleted().AddRaw(this, &FDesignerEdMode::OnLevelActorDeleted);
+	OnActorMovedHandle = GEngine->OnActorMoved().AddRaw(this, &FDesignerEdMode::OnActorMoved);
+	OnPostUndoRedoHandle = FEditorDelegates::PostUndoRedo.AddRaw(this, &FDesignerEdMode::OnPostUndoRedo);
 }
 
 void FDesignerEdMode::Exit()
 {
 	SwitchTool(nullptr);
+	FDesignerPerfHUD::SetVisible(false);
+
+	GEngine->OnLevelActorAdded().Remove(OnLevelActorAddedHandle);
+	GEngine->OnLevelActorDeleted().Remove(OnLevelActorDeletedHandle);
+	GEngine->OnActorMoved().Remove(OnActorMovedHandle);
+	FEditorDelegates::PostUndoRedo.Remove(OnPostUndoRedoHandle);
+	SnapIndex.Reset();
+	ContentIndex.Reset();
 
 	if (Toolkit.IsValid())
 	{
@@ -97,9 +131,26 @@ bool FDesignerEdMode::LostFocus(FEditorViewportClient * ViewportClient, FViewpor
 
 bool FDesignerEdMode::InputKey(FEditorViewportClient* ViewportClient, FViewport* Viewport, FKey Key, EInputEvent Event)
 {
+	FDesignerInputRecorder::Get().RecordKey(Viewport, Key, Event);
+
 	bool bHandled = false;
 
-	if (Key == EKeys::LeftControl || Key == EKeys::RightControl)
+	const bool bControlKey = Key == EKeys::LeftControl || Key == EKeys::RightControl;
+	const bool bShiftKey = Key == EKeys::LeftShift || Key == EKeys::RightShift;
+
+	// Holding Control and Shift together erases, releasing one of them goes back to the tool of the other
+	if ((bControlKey || bShiftKey) && Event == IE_Pressed && CurrentTool != EraseTool && !SpawnAssetTool->IsDragging()
+		&& (bControlKey ? ViewportClient->IsShiftPressed() : ViewportClient->IsCtrlPressed()))
+	{
+		SwitchTool(EraseTool);
+		bHandled = true;
+	}
+	else if ((bControlKey || bShiftKey) && Event == IE_Released && CurrentTool == EraseTool)
+	{
+		SwitchTool(bShiftKey ? SpawnAssetTool : nullptr);
+		bHandled = true;
+	}
+	else if (bControlKey)
 	{
 		if (Event == IE_Pressed)
 		{
@@ -112,12 +163,56 @@ bool FDesignerEdMode::InputKey(FEditorViewportClient* ViewportClient, FViewport*
 			bHandled = true;
 		}
 	}
+	else if (bShiftKey && (CurrentTool == nullptr || CurrentTool == SplinePlacementTool))
+	{
+		if (Event == IE_Pressed)
+		{
+			SwitchTool(SplinePlacementTool);
+			bHandled = true;
+		}
+		else if (Event == IE_Released)
+		{
+			SwitchTool(nullptr);
+			bHandled = true;
+		}
+	}
 
 	bool bHandledInSuper = FEdMode::InputKey(ViewportClient, Viewport, Key, Event);
 
 	return bHandled || bHandledInSuper;
 }
 
+void FDesignerEdMode::Tick(FEditorViewportClient* ViewportClient, float DeltaTime)
+{
+	// Every level viewport ticks the mode, only the one receiving input is recorded
+	if (FDesignerInputRecorder::Get().IsRecording() && ViewportClient == GCurrentLevelEditingViewportClient)
+	{
+		FDesignerInputRecorder::Get().RecordFrame(ViewportClient, ViewportClient->Viewport, DeltaTime);
+	}
+
+	FDesignerPerfHUD::SetVisible(DesignerSettings->bShowPerformanceHUD);
+	if (FDesignerPerfHUD::IsVisible())
+	{
+		FDesignerPerfGauges Gauges;
+		Gauges.NumPendingLoads = GetNumAsyncPackages();
+		Gauges.NumQueuedSpawns = SpawnAssetTool->GetNumQueuedSpawns() + FDesignerSpawnQueue::Get().GetNumQueued();
+		FDesignerPerfHUD::Tick(DeltaTime, Gauges);
+	}
+
+	FEdMode::Tick(ViewportClient, DeltaTime);
+}
+
+void FDesignerEdMode::DrawHUD(FEditorViewportClient* ViewportClient, FViewport* Viewport, const FSceneView* View, FCanvas* Canvas)
+{
+	FEdMode::DrawHUD(ViewportClient, Viewport, View, Canvas);
+
+	// Only the viewport being worked in shows the HUD
+	if (FDesignerPerfHUD::IsVisible() && ViewportClient == GCurrentLevelEditingViewportClient)
+	{
+		FDesignerPerfHUD::Draw(Canvas);
+	}
+}
+
 bool FDesignerEdMode::DisallowMouseDeltaTracking() const
 {
 	return CurrentTool != nullptr;
@@ -140,7 +235,7 @@ bool FDesignerEdMode::IsSelectionAllowed(AActor* InActor, bool bInSelection) con
 
 bool FDesignerEdMode::UsesToolkits() const
 {
-	return true;
+	return bUsesToolkits;
 }
 
 void FDesignerEdMode::SwitchTool(FDesignerTool* NewDesignerTool)
@@ -161,3 +256,40 @@ void FDesignerEdMode::SwitchTool(FDesignerTool* NewDesignerTool)
 		CurrentTool = nullptr;
 	}	
 }
+
+void FDesignerEdMode::OnLevelActorAdded(AActor* Actor)
+{
+	if (Actor->GetWorld() == SnapIndex.GetWorld())
+	{
+		SnapIndex.AddActor(Actor);
+	}
+	if (Actor->GetWorld() == ContentIndex.GetWorld())
+	{
+		ContentIndex.AddActor(Actor);
+	}
+}
+
+void FDesignerEdMode::OnLevelActorDeleted(AActor* Actor)
+{
+	SnapIndex.RemoveActor(Actor);
+	ContentIndex.RemoveActor(Actor);
+}
+
+void FDesignerEdMode::OnActorMoved(AActor* Actor)
+{
+	if (Actor->GetWorld() == SnapIndex.GetWorld())
+	{
+		SnapIndex.AddActor(Actor);
+	}
+	if (Actor->GetWorld() == ContentIndex.GetWorld())
+	{
+		ContentIndex.AddActor(Actor);
+	}
+}
+
+void FDesignerEdMode::OnPostUndoRedo()
+{
+	// Undo can bring back or move any number of actors without notifications, the indices are rebuilt when they are used next
+	SnapIndex.Reset();
+	ContentIndex.Reset();
+}
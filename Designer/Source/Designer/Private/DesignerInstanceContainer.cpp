@@ -0,0 +1,406 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "DesignerInstanceContainer.h"
+
+// Engine Includes
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+
+// Local Includes
+#include "Diagnostics/DesignerMemory.h"
+#include "Placement/DesignerPlacement.h"
+
+ADesignerInstanceContainer::ADesignerInstanceContainer(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	USceneComponent* SceneComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	SceneComponent->SetMobility(EComponentMobility::Static);
+	RootComponent = SceneComponent;
+
+	Tags.Add(FDesignerPlacement::PlacedActorTag);
+}
+
+#if WITH_EDITOR
+void ADesignerInstanceContainer::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	MarkInstancesChanged();
+}
+#endif
+
+UHierarchicalInstancedStaticMeshComponent* ADesignerInstanceContainer::FindOrAddComponent(UStaticMesh* StaticMesh)
+{
+	check(StaticMesh != nullptr);
+
+	for (UHierarchicalInstancedStaticMeshComponent* Component : InstanceComponents)
+	{
+		if (Component != nullptr && Component->GetStaticMesh() == StaticMesh)
+		{
+			return Component;
+		}
+	}
+
+	return AddComponent(StaticMesh);
+}
+
+UHierarchicalInstancedStaticMeshComponent* ADesignerInstanceContainer::AddComponent(UStaticMesh* StaticMesh)
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Containers);
+
+	check(StaticMesh != nullptr);
+
+	{
+		DESIGNER_LLM_SCOPE(EDesignerLLMTag::Transactions);
+		Modify();
+	}
+
+	UHierarchicalInstancedStaticMeshComponent* Component = NewObject<UHierarchicalInstancedStaticMeshComponent>(this, NAME_None, RF_Transactional);
+	Component->SetMobility(EComponentMobility::Static);
+	Component->SetStaticMesh(StaticMesh);
+	Component->SetupAttachment(RootComponent);
+	Component->bAutoRebuildTreeOnInstanceChanges = false;
+	AddInstanceComponent(Component);
+
+	if (GetWorld() != nullptr)
+	{
+		Component->RegisterComponent();
+	}
+
+	InstanceComponents.Add(Component);
+	InstanceSeeds.AddDefaulted();
+
+	return Component;
+}
+
+void ADesignerInstanceContainer::AddInstances(UStaticMesh* StaticMesh, TArrayView<const FTransform> WorldTransforms, TArrayView<const int32> Seeds)
+{
+	check(Seeds.Num() == 0 || Seeds.Num() == WorldTransforms.Num());
+
+	if (WorldTransforms.Num() == 0)
+	{
+		return;
+	}
+
+	AddInstancesToComponent(FindOrAddComponent(StaticMesh), WorldTransforms, Seeds);
+}
+
+void ADesignerInstanceContainer::AddInstancesToComponent(UHierarchicalInstancedStaticMeshComponent* Component, TArrayView<const FTransform> WorldTransforms, TArrayView<const int32> Seeds)
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Containers);
+
+	check(Seeds.Num() == 0 || Seeds.Num() == WorldTransforms.Num());
+
+	int32 ComponentIndex = InstanceComponents.IndexOfByKey(Component);
+	check(ComponentIndex != INDEX_NONE);
+
+	// The seeds live on the container, so it is recorded together with the instances of the component
+	{
+		DESIGNER_LLM_SCOPE(EDesignerLLMTag::Transactions);
+		Modify();
+		Component->Modify();
+	}
+
+	// The tree is rebuilt once after all instances are added instead of after every instance
+	const bool bAutoRebuildTree = Component->bAutoRebuildTreeOnInstanceChanges;
+	Component->bAutoRebuildTreeOnInstanceChanges = false;
+	for (const FTransform& WorldTransform : WorldTransforms)
+	{
+		Component->AddInstanceWorldSpace(WorldTransform);
+	}
+	Component->BuildTreeIfOutdated(/*Async*/true, /*ForceUpdate*/false);
+	Component->bAutoRebuildTreeOnInstanceChanges = bAutoRebuildTree;
+	MarkInstancesChanged();
+
+	TArray<int32>& ComponentSeeds = InstanceSeeds[ComponentIndex].Seeds;
+	if (Seeds.Num() > 0)
+	{
+		ComponentSeeds.Append(Seeds.GetData(), Seeds.Num());
+	}
+	else
+	{
+		ComponentSeeds.AddZeroed(WorldTransforms.Num());
+	}
+}
+
+void ADesignerInstanceContainer::AddUninitializedInstances(UStaticMesh* StaticMesh, int32 NumInstances, TArrayView<FInstancedStaticMeshInstanceData>& OutInstanceData, TArrayView<int32>& OutSeeds)
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Containers);
+
+	check(NumInstances >= 0);
+
+	UHierarchicalInstancedStaticMeshComponent* Component = FindOrAddComponent(StaticMesh);
+	int32 ComponentIndex = InstanceComponents.IndexOfByKey(Component);
+
+	{
+		DESIGNER_LLM_SCOPE(EDesignerLLMTag::Transactions);
+		Modify();
+		Component->Modify();
+	}
+
+	int32 FirstInstance = Component->PerInstanceSMData.AddUninitialized(NumInstances);
+	OutInstanceData = TArrayView<FInstancedStaticMeshInstanceData>(Component->PerInstanceSMData.GetData() + FirstInstance, NumInstances);
+
+	TArray<int32>& ComponentSeeds = InstanceSeeds[ComponentIndex].Seeds;
+	int32 FirstSeed = ComponentSeeds.AddUninitialized(NumInstances);
+	OutSeeds = TArrayView<int32>(ComponentSeeds.GetData() + FirstSeed, NumInstances);
+
+	MarkInstancesChanged();
+}
+
+void ADesignerInstanceContainer::ReplaceUninitializedInstances(UHierarchicalInstancedStaticMeshComponent* Component, int32 FirstInstance, int32 NumReplaced, int32 NumInstances, TArrayView<FInstancedStaticMeshInstanceData>& OutInstanceData, TArrayView<int32>& OutSeeds)
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Containers);
+
+	int32 ComponentIndex = InstanceComponents.IndexOfByKey(Component);
+	check(ComponentIndex != INDEX_NONE);
+
+	TArray<FInstancedStaticMeshInstanceData>& InstanceData = Component->PerInstanceSMData;
+	TArray<int32>& ComponentSeeds = InstanceSeeds[ComponentIndex].Seeds;
+	check(NumReplaced >= 0 && NumInstances >= 0 && FirstInstance >= 0 && FirstInstance + NumReplaced <= InstanceData.Num());
+	check(ComponentSeeds.Num() == InstanceData.Num());
+
+	{
+		DESIGNER_LLM_SCOPE(EDesignerLLMTag::Transactions);
+		Modify();
+		Component->Modify();
+	}
+
+	// Only the instances after the range move, and only when the range changes size
+	if (NumInstances > NumReplaced)
+	{
+		InstanceData.InsertUninitialized(FirstInstance + NumReplaced, NumInstances - NumReplaced);
+		ComponentSeeds.InsertUninitialized(FirstInstance + NumReplaced, NumInstances - NumReplaced);
+	}
+	else if (NumInstances < NumReplaced)
+	{
+		InstanceData.RemoveAt(FirstInstance + NumInstances, NumReplaced - NumInstances, /*bAllowShrinking*/false);
+		ComponentSeeds.RemoveAt(FirstInstance + NumInstances, NumReplaced - NumInstances, /*bAllowShrinking*/false);
+	}
+
+	OutInstanceData = TArrayView<FInstancedStaticMeshInstanceData>(InstanceData.GetData() + FirstInstance, NumInstances);
+	OutSeeds = TArrayView<int32>(ComponentSeeds.GetData() + FirstInstance, NumInstances);
+
+	MarkInstancesChanged();
+}
+
+void ADesignerInstanceContainer::RemoveInstances(UHierarchicalInstancedStaticMeshComponent* Component, TArrayView<const int32> SortedInstanceIndices)
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Containers);
+
+	int32 ComponentIndex = InstanceComponents.IndexOfByKey(Component);
+	check(ComponentIndex != INDEX_NONE);
+
+	if (SortedInstanceIndices.Num() == 0)
+	{
+		return;
+	}
+
+	{
+		DESIGNER_LLM_SCOPE(EDesignerLLMTag::Transactions);
+		Modify();
+		Component->Modify();
+	}
+
+	// A single compacting pass instead of removing the instances one by one, which shifts the arrays every time
+	TArray<int32>& ComponentSeeds = InstanceSeeds[ComponentIndex].Seeds;
+	TArray<FInstancedStaticMeshInstanceData>& InstanceData = Component->PerInstanceSMData;
+	TArray<FBodyInstance*>& InstanceBodies = Component->InstanceBodies;
+	const bool bHasSeeds = ComponentSeeds.Num() == InstanceData.Num();
+	const bool bHasBodies = InstanceBodies.Num() == InstanceData.Num();
+#if WITH_EDITOR
+	const bool bHasSelection = Component->SelectedInstances.Num() == InstanceData.Num();
+#endif
+
+	int32 NextRemoved = 0;
+	int32 NumKept = 0;
+	for (int32 InstanceIndex = 0; InstanceIndex < InstanceData.Num(); ++InstanceIndex)
+	{
+		if (NextRemoved < SortedInstanceIndices.Num() && SortedInstanceIndices[NextRemoved] == InstanceIndex)
+		{
+			// Traces must not hit the removed instance before the next physics rebuild
+			if (bHasBodies && InstanceBodies[InstanceIndex] != nullptr)
+			{
+				InstanceBodies[InstanceIndex]->TermBody();
+				delete InstanceBodies[InstanceIndex];
+				InstanceBodies[InstanceIndex] = nullptr;
+			}
+			++NextRemoved;
+			continue;
+		}
+
+		if (NumKept != InstanceIndex)
+		{
+			InstanceData[NumKept] = InstanceData[InstanceIndex];
+			if (bHasSeeds)
+			{
+				ComponentSeeds[NumKept] = ComponentSeeds[InstanceIndex];
+			}
+			if (bHasBodies)
+			{
+				// Hits report the instance through the index of its body
+				InstanceBodies[NumKept] = InstanceBodies[InstanceIndex];
+				if (InstanceBodies[NumKept] != nullptr)
+				{
+					InstanceBodies[NumKept]->InstanceBodyIndex = NumKept;
+				}
+			}
+#if WITH_EDITOR
+			if (bHasSelection)
+			{
+				Component->SelectedInstances[NumKept] = Component->SelectedInstances[InstanceIndex];
+			}
+#endif
+		}
+		++NumKept;
+	}
+
+	InstanceData.SetNum(NumKept, /*bAllowShrinking*/false);
+	ComponentSeeds.SetNum(FMath::Min(ComponentSeeds.Num(), NumKept), /*bAllowShrinking*/false);
+	if (bHasBodies)
+	{
+		InstanceBodies.SetNum(NumKept, /*bAllowShrinking*/false);
+	}
+
+	MarkInstancesChanged();
+}
+
+void ADesignerInstanceContainer::FinishInstanceChanges(bool bUpdatePhysics)
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Containers);
+
+	for (UHierarchicalInstancedStaticMeshComponent* Component : InstanceComponents)
+	{
+		if (Component != nullptr)
+		{
+			FinishComponentChanges(Component, bUpdatePhysics);
+		}
+	}
+
+	MarkInstancesChanged();
+}
+
+void ADesignerInstanceContainer::FinishComponentChanges(UHierarchicalInstancedStaticMeshComponent* Component, bool bUpdatePhysics)
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Containers);
+
+	check(Component != nullptr);
+
+#if WITH_EDITOR
+	// The selection state is tracked per instance and has to match the instance count
+	int32 NumInstances = Component->PerInstanceSMData.Num();
+	if (Component->SelectedInstances.Num() < NumInstances)
+	{
+		Component->SelectedInstances.Add(false, NumInstances - Component->SelectedInstances.Num());
+	}
+	else if (Component->SelectedInstances.Num() > NumInstances)
+	{
+		Component->SelectedInstances.RemoveAt(NumInstances, Component->SelectedInstances.Num() - NumInstances);
+	}
+#endif
+
+	// The instance count alone does not tell whether the tree is outdated when instances were rewritten
+	Component->BuildTreeIfOutdated(/*Async*/true, /*ForceUpdate*/true);
+	Component->MarkRenderStateDirty();
+
+	if (bUpdatePhysics && Component->IsRegistered())
+	{
+		Component->RecreatePhysicsState();
+	}
+
+	MarkInstancesChanged();
+}
+
+void ADesignerInstanceContainer::EmptyInstances()
+{
+	// Emptying only frees instances, what it allocates are the undo records
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Transactions);
+
+	Modify();
+
+	for (int32 ComponentIndex = 0; ComponentIndex < InstanceComponents.Num(); ++ComponentIndex)
+	{
+		UHierarchicalInstancedStaticMeshComponent* Component = InstanceComponents[ComponentIndex];
+		if (Component != nullptr)
+		{
+			Component->Modify();
+			Component->PerInstanceSMData.Reset();
+		}
+		InstanceSeeds[ComponentIndex].Seeds.Reset();
+	}
+
+	MarkInstancesChanged();
+}
+
+void ADesignerInstanceContainer::ClearInstances()
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Transactions);
+
+	Modify();
+
+	for (UHierarchicalInstancedStaticMeshComponent* Component : InstanceComponents)
+	{
+		if (Component != nullptr)
+		{
+			Component->Modify();
+			RemoveInstanceComponent(Component);
+			Component->DestroyComponent();
+		}
+	}
+
+	InstanceComponents.Reset();
+	InstanceSeeds.Reset();
+
+	MarkInstancesChanged();
+}
+
+int32 ADesignerInstanceContainer::GetInstanceCount() const
+{
+	int32 InstanceCount = 0;
+	for (const UHierarchicalInstancedStaticMeshComponent* Component : InstanceComponents)
+	{
+		if (Component != nullptr)
+		{
+			InstanceCount += Component->GetInstanceCount();
+		}
+	}
+	return InstanceCount;
+}
+
+const TArray<int32>& ADesignerInstanceContainer::GetInstanceSeeds(const UHierarchicalInstancedStaticMeshComponent* Component) const
+{
+	int32 ComponentIndex = InstanceComponents.IndexOfByKey(Component);
+	check(ComponentIndex != INDEX_NONE);
+	return InstanceSeeds[ComponentIndex].Seeds;
+}
+
+void ADesignerInstanceContainer::MarkInstancesChanged()
+{
+	check(IsInGameThread());
+
+	static uint64 NextInstanceChangeStamp = 0;
+	InstanceChangeStamp = ++NextInstanceChangeStamp;
+}
@@ -25,14 +25,15 @@
 // This Include
 #include "DesignerModule.h"
 
-// Engine Includes
-#include "PropertyEditorModule.h"
-
 // Local Includes
 #include "DesignerEdMode.h"
 
 #include "DesignerSlateStyle.h"
-#include "DesignerSettingsCustomization.h"
+#include "Diagnostics/DesignerAllocationCounter.h"
+#include "Diagnostics/DesignerMemory.h"
+#include "Placement/DesignerDensityMap.h"
+#include "Placement/DesignerLandscapeHeightfield.h"
+#include "Placement/DesignerSpawnQueue.h"
 
 
 
@@ -42,29 +43,28 @@ DEFINE_LOG_CATEGORY(LogDesigner);
 
 void FDesignerModule::StartupModule()
 {
+	FDesignerMemory::RegisterLLMTags();
+	FDesignerAllocationCounter::InstallIfRequested();
 	FDesignerSlateStyle::Initialize();
 
 	FSlateIcon DesignerIcon = FSlateIcon(FDesignerSlateStyle::Get()->GetStyleSetName(), "Designer.Icon");
 
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	// Only the mode is registered here, everything else is created when the mode is first used
 	FEditorModeRegistry::Get().RegisterMode<FDesignerEdMode>(FDesignerEdMode::EM_DesignerEdModeId, LOCTEXT("DesignerEdModeName", "Designer"), DesignerIcon, true, 100);
-
-	/** Register detail/property customization */
-	FPropertyEditorModule& PropertyModule = FModuleManager::LoadModuleChecked<FPropertyEditorModule>("PropertyEditor");
-	PropertyModule.RegisterCustomClassLayout("DesignerSettings", FOnGetDetailCustomizationInstance::CreateStatic(&FDesignerSettingsCustomization::MakeInstance));
 }
 
 void FDesignerModule::ShutdownModule()
 {
 	FDesignerSlateStyle::Shutdown();
+	FDesignerAllocationCounter::Stop();
+	FDesignerSpawnQueue::Shutdown();
+	FDesignerDensityMap::FlushCache();
+	FDesignerLandscapeHeightfield::FlushCache();
 
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
 	FEditorModeRegistry::Get().UnregisterMode(FDesignerEdMode::EM_DesignerEdModeId);
-
-	/** De-register detail/property customization */
-	FPropertyEditorModule& PropertyModule = FModuleManager::LoadModuleChecked<FPropertyEditorModule>("PropertyEditor");
-	PropertyModule.UnregisterCustomClassLayout("DesignerSettings");
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,157 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "DesignerPalette.h"
+
+// Local Includes
+#include "Diagnostics/DesignerMemory.h"
+
+void FDesignerAliasTable::Build(TArrayView<const float> Weights)
+{
+	Probabilities.Reset();
+	Aliases.Reset();
+
+	double TotalWeight = 0.0;
+	for (float Weight : Weights)
+	{
+		TotalWeight += FMath::Max(Weight, 0.F);
+	}
+
+	if (TotalWeight <= 0.0)
+	{
+		return;
+	}
+
+	const int32 NumWeights = Weights.Num();
+	Probabilities.SetNumUninitialized(NumWeights);
+	Aliases.SetNumUninitialized(NumWeights);
+
+	// Scale the weights so the average is one, then pair every column below one with a column above one to fill it up
+	TArray<double> ScaledWeights;
+	TArray<int32> Small;
+	TArray<int32> Large;
+	ScaledWeights.SetNumUninitialized(NumWeights);
+	Small.Reserve(NumWeights);
+	Large.Reserve(NumWeights);
+
+	for (int32 Index = 0; Index < NumWeights; ++Index)
+	{
+		ScaledWeights[Index] = FMath::Max(Weights[Index], 0.F) * NumWeights / TotalWeight;
+		(ScaledWeights[Index] < 1.0 ? Small : Large).Add(Index);
+	}
+
+	while (Small.Num() > 0 && Large.Num() > 0)
+	{
+		const int32 SmallIndex = Small.Pop(/*bAllowShrinking*/false);
+		const int32 LargeIndex = Large.Pop(/*bAllowShrinking*/false);
+
+		Probabilities[SmallIndex] = ScaledWeights[SmallIndex];
+		Aliases[SmallIndex] = LargeIndex;
+
+		ScaledWeights[LargeIndex] = (ScaledWeights[LargeIndex] + ScaledWeights[SmallIndex]) - 1.0;
+		(ScaledWeights[LargeIndex] < 1.0 ? Small : Large).Add(LargeIndex);
+	}
+
+	// Whatever is left is one up to rounding errors
+	for (int32 Index : Large)
+	{
+		Probabilities[Index] = 1.F;
+		Aliases[Index] = Index;
+	}
+	for (int32 Index : Small)
+	{
+		Probabilities[Index] = 1.F;
+		Aliases[Index] = Index;
+	}
+}
+
+int32 FDesignerAliasTable::Sample(FRandomStream& RandomStream) const
+{
+	if (Probabilities.Num() == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 Column = RandomStream.RandHelper(Probabilities.Num());
+	return RandomStream.FRand() < Probabilities[Column] ? Column : Aliases[Column];
+}
+
+FDesignerPaletteEntry::FDesignerPaletteEntry()
+	: Asset(nullptr)
+	, Weight(1.F)
+	, bOverrideRandomRotation(false)
+	, RandomRotationX(0.F, 0.F, false)
+	, RandomRotationY(0.F, 0.F, false)
+	, RandomRotationZ(0.F, 360.F, false)
+	, bOverrideRandomScale(false)
+	, RandomScaleX(1.F, 1.F, false)
+	, RandomScaleY(1.F, 1.F, false)
+	, RandomScaleZ(1.F, 1.F, false)
+	, bOverrideOverlapPadding(false)
+	, OverlapPadding(0.F)
+{
+}
+
+int32 UDesignerPalette::PickEntry(FRandomStream& RandomStream) const
+{
+	return AliasTable.Sample(RandomStream);
+}
+
+void UDesignerPalette::RebuildAliasTable()
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Palette);
+
+	TArray<float> Weights;
+	Weights.SetNumUninitialized(Entries.Num());
+	for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+	{
+		Weights[EntryIndex] = Entries[EntryIndex].Asset != nullptr ? Entries[EntryIndex].Weight : 0.F;
+	}
+
+	AliasTable.Build(Weights);
+}
+
+void UDesignerPalette::PostLoad()
+{
+	Super::PostLoad();
+
+	RebuildAliasTable();
+}
+
+#if WITH_EDITOR
+void UDesignerPalette::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	RebuildAliasTable();
+}
+
+void UDesignerPalette::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	RebuildAliasTable();
+}
+#endif
@@ -25,6 +25,9 @@
 // This Include
 #include "DesignerSettings.h"
 
+// Engine Includes
+#include "EditorModeManager.h"
+
 // Local Includes
 #include "DesignerEdMode.h"
 
@@ -38,9 +41,9 @@ FRandomMinMaxFloat::FRandomMinMaxFloat()
 
 FRandomMinMaxFloat::FRandomMinMaxFloat(float Min, float Max, bool bRandomlyNegateValue = false)
 {
-	Min = Min;
-	Max = Max;
-	bRandomlyNegateValue = bRandomlyNegateValue;
+	this->Min = Min;
+	this->Max = Max;
+	this->bRandomlyNegateValue = bRandomlyNegateValue;
 	RandomValue = (Min + Max) / 2.0;
 
 }
@@ -62,6 +65,19 @@ float FRandomMinMaxFloat::RegenerateRandomValue()
 	return RandomValue;
 }
 
+float FRandomMinMaxFloat::GetRandomValue(FRandomStream& RandomStream) const
+{
+	float Value = RandomStream.FRandRange(Min, Max);
+
+	// Always consume the sign draw so the stream advances the same amount regardless of bRandomlyNegateValue
+	bool bNegate = RandomStream.FRand() < 0.5F;
+	if (bNegate && bRandomlyNegateValue)
+	{
+		Value *= -1.F;
+	}
+	return Value;
+}
+
 UDesignerSettings::UDesignerSettings(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, RelativeLocationOffset(FVector::ZeroVector)
@@ -80,6 +96,37 @@ UDesignerSettings::UDesignerSettings(const FObjectInitializer& ObjectInitializer
 	, RandomScaleX(FRandomMinMaxFloat(0.8F, 1.2F, true))
 	, RandomScaleY(FRandomMinMaxFloat(0.8F, 1.2F, true))
 	, RandomScaleZ(FRandomMinMaxFloat(0.8F, 1.2F, true))
+	, bAlignToFootprint(false)
+	, FootprintRaysPerAxis(3)
+	, bSettlePlacements(false)
+	, Palette(nullptr)
+	, SpawnBudgetMilliseconds(8.F)
+	, DensityTexture(nullptr)
+	, DensityTextureChannel(EDensityMapChannel::Red)
+	, DensityTextureBounds(ForceInit)
+	, DensityLayer(nullptr)
+	, bRejectOverlaps(false)
+	, OverlapPadding(0.F)
+	, bLimitSlope(false)
+	, MinSlopeAngle(0.F)
+	, MaxSlopeAngle(30.F)
+	, bLimitHeight(false)
+	, MinHeight(0.F)
+	, MaxHeight(10000.F)
+	, bLimitFacing(false)
+	, FacingYaw(0.F)
+	, MaxFacingAngle(45.F)
+	, bSnapToPlacedContent(false)
+	, SnapDistance(50.F)
+	, PlacementMode(EPlacementMode::Single)
+	, ArraySpacing(FVector::ZeroVector)
+	, ArrayLayers(1)
+	, bCommitArrayAsInstances(true)
+	, EraseRadius(500.F)
+	, EraseFraction(1.F)
+	, EraseFilter(EEraseFilter::All)
+	, bShowPerformanceHUD(false)
+	, ParentEdMode(nullptr)
 {
 }
 
@@ -91,4 +138,26 @@ EAxisType UDesignerSettings::GetPositiveAxisToAlignWithCursor() const
 void UDesignerSettings::SetParent(FDesignerEdMode* DesignerEdMode)
 {
 	ParentEdMode = DesignerEdMode;
-}
\ No newline at end of file
+}
+
+void UDesignerSettings::CopySettingsFrom(const UDesignerSettings* Other)
+{
+	check(Other != nullptr);
+
+	for (TFieldIterator<UProperty> PropertyIt(UDesignerSettings::StaticClass()); PropertyIt; ++PropertyIt)
+	{
+		if (PropertyIt->HasAnyPropertyFlags(CPF_Edit))
+		{
+			PropertyIt->CopyCompleteValue_InContainer(this, Other);
+		}
+	}
+}
+
+const UDesignerSettings* UDesignerSettings::GetActiveSettings()
+{
+	if (FDesignerEdMode* DesignerEdMode = static_cast<FDesignerEdMode*>(GLevelEditorModeTools().GetActiveMode(FDesignerEdMode::EM_DesignerEdModeId)))
+	{
+		return DesignerEdMode->GetDesignerSettings();
+	}
+	return GetDefault<UDesignerSettings>();
+}
@@ -0,0 +1,490 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "DesignerSplinePlacer.h"
+
+// Engine Includes
+#include "Algo/BinarySearch.h"
+#include "Algo/Count.h"
+#include "Async/ParallelFor.h"
+#include "CollisionQueryParams.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/SplineComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "HAL/ThreadSafeCounter.h"
+
+// Local Includes
+#include "DesignerPalette.h"
+#include "DesignerSettings.h"
+#include "Placement/DesignerPlacementTransform.h"
+#include "Placement/DesignerScatter.h"
+
+namespace DesignerSplinePlacer
+{
+	/** The number of steps per segment in the arc length table */
+	static const int32 ArcLengthSteps = 32;
+
+	/** The values of a spline point that affect the shape of the segments next to it */
+	struct FSplinePointState
+	{
+		FVector Location;
+		FVector ArriveTangent;
+		FVector LeaveTangent;
+		FQuat Rotation;
+		FVector Scale;
+		int32 InterpMode;
+	};
+
+	static uint32 GetSplinePointHash(const USplineComponent* Spline, int32 PointIndex)
+	{
+		FSplinePointState State;
+		FMemory::Memzero(State);
+
+		const FInterpCurvePoint<FVector>& PositionPoint = Spline->SplineCurves.Position.Points[PointIndex];
+		State.Location = PositionPoint.OutVal;
+		State.ArriveTangent = PositionPoint.ArriveTangent;
+		State.LeaveTangent = PositionPoint.LeaveTangent;
+		State.InterpMode = (int32)PositionPoint.InterpMode;
+		State.Rotation = Spline->SplineCurves.Rotation.Points[PointIndex].OutVal;
+		State.Scale = Spline->SplineCurves.Scale.Points[PointIndex].OutVal;
+
+		return FCrc::MemCrc32(&State, sizeof(State));
+	}
+
+	/** The input key fraction within a segment at a distance along it, found with a binary search in the arc length table */
+	static float GetSegmentInputKeyFraction(const TArray<float>& ArcLengths, float Distance)
+	{
+		const int32 NumEntries = ArcLengths.Num();
+
+		int32 UpperIndex = FMath::Clamp(Algo::UpperBound(ArcLengths, Distance), 1, NumEntries - 1);
+		int32 LowerIndex = UpperIndex - 1;
+
+		float StepLength = ArcLengths[UpperIndex] - ArcLengths[LowerIndex];
+		float Alpha = StepLength > KINDA_SMALL_NUMBER ? FMath::Clamp((Distance - ArcLengths[LowerIndex]) / StepLength, 0.F, 1.F) : 0.F;
+
+		return (LowerIndex + Alpha) / (NumEntries - 1);
+	}
+}
+
+ADesignerSplinePlacer::ADesignerSplinePlacer(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, Spacing(200.F)
+	, Seed(0)
+	, bProjectToSurface(false)
+	, ProjectionDistance(1000.F)
+{
+	Spline = CreateDefaultSubobject<USplineComponent>(TEXT("Spline"));
+	Spline->SetupAttachment(RootComponent);
+	Spline->SetMobility(EComponentMobility::Static);
+
+	Settings = CreateDefaultSubobject<UDesignerSettings>(TEXT("Settings"));
+}
+
+void ADesignerSplinePlacer::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+	UpdatePlacements();
+}
+
+#if WITH_EDITOR
+void ADesignerSplinePlacer::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	const FName MemberPropertyName = PropertyChangedEvent.MemberProperty != nullptr ? PropertyChangedEvent.MemberProperty->GetFName() : NAME_None;
+
+	// Spline edits are picked up per segment, every other change affects all placements
+	if (MemberPropertyName != GET_MEMBER_NAME_CHECKED(ADesignerSplinePlacer, Spline))
+	{
+		if (MemberPropertyName == GET_MEMBER_NAME_CHECKED(ADesignerSplinePlacer, Meshes) || MemberPropertyName == GET_MEMBER_NAME_CHECKED(ADesignerSplinePlacer, Settings))
+		{
+			ClearInstances();
+		}
+		InvalidatePlacements();
+	}
+
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+}
+
+void ADesignerSplinePlacer::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	// The instances are restored by the transaction, but the cache no longer matches them
+	InvalidatePlacements();
+}
+#endif
+
+void ADesignerSplinePlacer::InvalidatePlacements()
+{
+	for (FDesignerSplineSegment& Segment : Segments)
+	{
+		Segment.Signature = 0;
+	}
+}
+
+void ADesignerSplinePlacer::UpdatePlacements()
+{
+	if (Spline == nullptr || Settings == nullptr)
+	{
+		return;
+	}
+
+	if (!GetActorTransform().Equals(GeneratedActorTransform))
+	{
+		// Surface projection depends on the world location of the spline
+		GeneratedActorTransform = GetActorTransform();
+		InvalidatePlacements();
+	}
+
+	// Edits to the palette asset are not reported to this actor, so the meshes are compared on every update
+	TArray<UStaticMesh*> CurrentPlacementMeshes;
+	GetPlacementMeshes(CurrentPlacementMeshes);
+	if (CurrentPlacementMeshes != PlacementMeshes)
+	{
+		PlacementMeshes = MoveTemp(CurrentPlacementMeshes);
+		InvalidatePlacements();
+	}
+
+	const int32 NumPoints = Spline->GetNumberOfSplinePoints();
+	const int32 NumSegments = NumPoints < 2 ? 0 : (Spline->IsClosedLoop() ? NumPoints : NumPoints - 1);
+
+	bool bSegmentCountChanged = Segments.Num() != NumSegments;
+	Segments.SetNum(NumSegments);
+
+	TArray<int32> DirtySegments;
+	for (int32 SegmentIndex = 0; SegmentIndex < NumSegments; ++SegmentIndex)
+	{
+		uint32 Signature = GetSegmentSignature(SegmentIndex);
+		if (Segments[SegmentIndex].Signature != Signature)
+		{
+			Segments[SegmentIndex].Signature = Signature;
+			DirtySegments.Add(SegmentIndex);
+		}
+	}
+
+	if (DirtySegments.Num() == 0 && !bSegmentCountChanged)
+	{
+		return;
+	}
+
+	const FDesignerRotationGrid RotationGrid = FDesignerRotationGrid::GetEditorGrid();
+	FThreadSafeCounter NumFallbackRotations;
+
+	ParallelFor(DirtySegments.Num(), [&](int32 DirtyIndex)
+	{
+		NumFallbackRotations.Add(GenerateSegment(DirtySegments[DirtyIndex], RotationGrid));
+	});
+	FDesignerPlacementTransform::WarnFallbackRotations(NumFallbackRotations.GetValue());
+
+	// Every segment keeps its own range of instances, so editing a spline point only rewrites the ranges of the segments next to it.
+	// Adding or removing a spline point shifts the segments after it, everything is refilled then
+	if (bSegmentCountChanged || DirtySegments.Num() == NumSegments || !ReplaceSegmentInstances(DirtySegments))
+	{
+		RefillInstances();
+	}
+}
+
+void ADesignerSplinePlacer::RefillInstances()
+{
+	EmptyInstances();
+
+	TArray<int32> MeshInstanceCounts;
+	MeshInstanceCounts.SetNumZeroed(PlacementMeshes.Num());
+	for (FDesignerSplineSegment& Segment : Segments)
+	{
+		Segment.InstanceCounts.Reset();
+		Segment.InstanceCounts.SetNumZeroed(PlacementMeshes.Num());
+		for (int32 MeshIndex : Segment.MeshIndices)
+		{
+			++Segment.InstanceCounts[MeshIndex];
+			++MeshInstanceCounts[MeshIndex];
+		}
+	}
+
+	const FTransform ActorTransform = GetActorTransform();
+
+	for (int32 MeshIndex = 0; MeshIndex < PlacementMeshes.Num(); ++MeshIndex)
+	{
+		if (PlacementMeshes[MeshIndex] == nullptr || MeshInstanceCounts[MeshIndex] == 0)
+		{
+			continue;
+		}
+
+		TArrayView<FInstancedStaticMeshInstanceData> InstanceData;
+		TArrayView<int32> InstanceSeeds;
+		AddUninitializedInstances(PlacementMeshes[MeshIndex], MeshInstanceCounts[MeshIndex], InstanceData, InstanceSeeds);
+
+		int32 InstanceIndex = 0;
+		for (const FDesignerSplineSegment& Segment : Segments)
+		{
+			for (int32 PlacementIndex = 0; PlacementIndex < Segment.MeshIndices.Num(); ++PlacementIndex)
+			{
+				if (Segment.MeshIndices[PlacementIndex] == MeshIndex)
+				{
+					InstanceData[InstanceIndex].Transform = Segment.Transforms[PlacementIndex].GetRelativeTransform(ActorTransform).ToMatrixWithScale();
+					InstanceSeeds[InstanceIndex] = Segment.Seeds[PlacementIndex];
+					++InstanceIndex;
+				}
+			}
+		}
+	}
+
+	FinishInstanceChanges();
+}
+
+bool ADesignerSplinePlacer::ReplaceSegmentInstances(const TArray<int32>& DirtySegments)
+{
+	const int32 NumMeshes = PlacementMeshes.Num();
+
+	TArray<int32> MeshInstanceCounts;
+	MeshInstanceCounts.SetNumZeroed(NumMeshes);
+	for (const FDesignerSplineSegment& Segment : Segments)
+	{
+		if (Segment.InstanceCounts.Num() != NumMeshes)
+		{
+			return false;
+		}
+		for (int32 MeshIndex = 0; MeshIndex < NumMeshes; ++MeshIndex)
+		{
+			MeshInstanceCounts[MeshIndex] += Segment.InstanceCounts[MeshIndex];
+		}
+	}
+
+	// The instances of a component are grouped by mesh index first and by segment second, the way RefillInstances writes them.
+	// Palette entries with the same mesh share a component
+	TArray<int32> MeshFirstInstances;
+	MeshFirstInstances.SetNumZeroed(NumMeshes);
+	TMap<UStaticMesh*, int32> ComponentInstanceCounts;
+	for (int32 MeshIndex = 0; MeshIndex < NumMeshes; ++MeshIndex)
+	{
+		if (PlacementMeshes[MeshIndex] != nullptr)
+		{
+			int32& ComponentInstanceCount = ComponentInstanceCounts.FindOrAdd(PlacementMeshes[MeshIndex]);
+			MeshFirstInstances[MeshIndex] = ComponentInstanceCount;
+			ComponentInstanceCount += MeshInstanceCounts[MeshIndex];
+		}
+	}
+
+	for (const TPair<UStaticMesh*, int32>& ComponentInstanceCount : ComponentInstanceCounts)
+	{
+		const UHierarchicalInstancedStaticMeshComponent* const* Component = GetInstanceComponents().FindByPredicate([&](const UHierarchicalInstancedStaticMeshComponent* InstanceComponent)
+		{
+			return InstanceComponent != nullptr && InstanceComponent->GetStaticMesh() == ComponentInstanceCount.Key;
+		});
+
+		const int32 NumInstances = Component != nullptr ? (*Component)->PerInstanceSMData.Num() : 0;
+		if (NumInstances != ComponentInstanceCount.Value)
+		{
+			return false;
+		}
+	}
+
+	const FTransform ActorTransform = GetActorTransform();
+	TArray<int32> SegmentFirstInstances;
+	SegmentFirstInstances.SetNumUninitialized(Segments.Num());
+	TArray<UHierarchicalInstancedStaticMeshComponent*, TInlineAllocator<8>> ChangedComponents;
+
+	// Ranges are replaced from the back, so the ranges in front of them keep their position
+	for (int32 MeshIndex = NumMeshes - 1; MeshIndex >= 0; --MeshIndex)
+	{
+		if (PlacementMeshes[MeshIndex] == nullptr)
+		{
+			continue;
+		}
+
+		int32 FirstInstance = MeshFirstInstances[MeshIndex];
+		for (int32 SegmentIndex = 0; SegmentIndex < Segments.Num(); ++SegmentIndex)
+		{
+			SegmentFirstInstances[SegmentIndex] = FirstInstance;
+			FirstInstance += Segments[SegmentIndex].InstanceCounts[MeshIndex];
+		}
+
+		for (int32 DirtyIndex = DirtySegments.Num() - 1; DirtyIndex >= 0; --DirtyIndex)
+		{
+			const int32 SegmentIndex = DirtySegments[DirtyIndex];
+			FDesignerSplineSegment& Segment = Segments[SegmentIndex];
+
+			const int32 NumReplaced = Segment.InstanceCounts[MeshIndex];
+			const int32 NumInstances = Algo::Count(Segment.MeshIndices, MeshIndex);
+			if (NumReplaced == 0 && NumInstances == 0)
+			{
+				continue;
+			}
+
+			UHierarchicalInstancedStaticMeshComponent* Component = FindOrAddComponent(PlacementMeshes[MeshIndex]);
+			ChangedComponents.AddUnique(Component);
+
+			TArrayView<FInstancedStaticMeshInstanceData> InstanceData;
+			TArrayView<int32> InstanceSeeds;
+			ReplaceUninitializedInstances(Component, SegmentFirstInstances[SegmentIndex], NumReplaced, NumInstances, InstanceData, InstanceSeeds);
+
+			int32 InstanceIndex = 0;
+			for (int32 PlacementIndex = 0; PlacementIndex < Segment.MeshIndices.Num(); ++PlacementIndex)
+			{
+				if (Segment.MeshIndices[PlacementIndex] == MeshIndex)
+				{
+					InstanceData[InstanceIndex].Transform = Segment.Transforms[PlacementIndex].GetRelativeTransform(ActorTransform).ToMatrixWithScale();
+					InstanceSeeds[InstanceIndex] = Segment.Seeds[PlacementIndex];
+					++InstanceIndex;
+				}
+			}
+
+			Segment.InstanceCounts[MeshIndex] = NumInstances;
+		}
+	}
+
+	// The trees of the components without changes stay as they are
+	for (UHierarchicalInstancedStaticMeshComponent* Component : ChangedComponents)
+	{
+		FinishComponentChanges(Component);
+	}
+
+	return true;
+}
+
+void ADesignerSplinePlacer::GetPlacementMeshes(TArray<UStaticMesh*>& OutPlacementMeshes) const
+{
+	const UDesignerPalette* Palette = Settings->Palette;
+	if (Palette == nullptr)
+	{
+		OutPlacementMeshes = Meshes;
+		return;
+	}
+
+	// Only static meshes can be instanced, other entries are skipped when they are picked
+	OutPlacementMeshes.Reset(Palette->Entries.Num());
+	for (const FDesignerPaletteEntry& Entry : Palette->Entries)
+	{
+		OutPlacementMeshes.Add(Cast<UStaticMesh>(Entry.Asset));
+	}
+}
+
+int32 ADesignerSplinePlacer::GenerateSegment(int32 SegmentIndex, const FDesignerRotationGrid& RotationGrid)
+{
+	FDesignerSplineSegment& Segment = Segments[SegmentIndex];
+	Segment.Transforms.Reset();
+	Segment.MeshIndices.Reset();
+	Segment.Seeds.Reset();
+
+	const int32 NumSteps = DesignerSplinePlacer::ArcLengthSteps;
+
+	Segment.ArcLengths.SetNumUninitialized(NumSteps + 1);
+	Segment.ArcLengths[0] = 0.F;
+
+	FVector PreviousLocation = Spline->GetLocationAtSplineInputKey(SegmentIndex, ESplineCoordinateSpace::World);
+	for (int32 Step = 1; Step <= NumSteps; ++Step)
+	{
+		FVector Location = Spline->GetLocationAtSplineInputKey(SegmentIndex + (float)Step / NumSteps, ESplineCoordinateSpace::World);
+		Segment.ArcLengths[Step] = Segment.ArcLengths[Step - 1] + FVector::Dist(Location, PreviousLocation);
+		PreviousLocation = Location;
+	}
+
+	const UDesignerPalette* Palette = Settings->Palette;
+	if (PlacementMeshes.Num() == 0)
+	{
+		return 0;
+	}
+
+	const float SegmentLength = Segment.ArcLengths.Last();
+	const int32 NumPlacements = FMath::Max(1, FMath::FloorToInt(SegmentLength / FMath::Max(Spacing, 1.F)));
+	const float PlacementSpacing = SegmentLength / NumPlacements;
+
+	// The end point of an open spline is not the start of another segment
+	const bool bIsLastOpenSegment = !Spline->IsClosedLoop() && SegmentIndex == Spline->GetNumberOfSplinePoints() - 2;
+	const int32 NumSegmentPlacements = bIsLastOpenSegment ? NumPlacements + 1 : NumPlacements;
+
+	Segment.Transforms.Reserve(NumSegmentPlacements);
+	Segment.MeshIndices.Reserve(NumSegmentPlacements);
+	Segment.Seeds.Reserve(NumSegmentPlacements);
+
+	FRandomStream RandomStream(FDesignerScatter::MakeRegionSeed(Seed, SegmentIndex));
+	int32 NumFallbackRotations = 0;
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(DesignerSplinePlacer), /*bTraceComplex*/true);
+	QueryParams.AddIgnoredActor(this);
+	FCollisionObjectQueryParams ObjectQueryParams(FCollisionObjectQueryParams::InitType::AllStaticObjects);
+
+	for (int32 PlacementIndex = 0; PlacementIndex < NumSegmentPlacements; ++PlacementIndex)
+	{
+		// Draw the random values first so skipped placements do not shift the ones after them
+		const int32 MeshIndex = Palette != nullptr ? Palette->PickEntry(RandomStream) : RandomStream.RandRange(0, PlacementMeshes.Num() - 1);
+		const int32 PlacementSeed = static_cast<int32>(RandomStream.GetUnsignedInt());
+
+		if (MeshIndex == INDEX_NONE || PlacementMeshes[MeshIndex] == nullptr)
+		{
+			continue;
+		}
+
+		const float InputKey = SegmentIndex + DesignerSplinePlacer::GetSegmentInputKeyFraction(Segment.ArcLengths, PlacementIndex * PlacementSpacing);
+
+		FVector Location = Spline->GetLocationAtSplineInputKey(InputKey, ESplineCoordinateSpace::World);
+		FVector ForwardVector = Spline->GetDirectionAtSplineInputKey(InputKey, ESplineCoordinateSpace::World);
+		FVector UpVector = Spline->GetUpVectorAtSplineInputKey(InputKey, ESplineCoordinateSpace::World);
+
+		if (bProjectToSurface)
+		{
+			const FVector TraceOffset(0.F, 0.F, ProjectionDistance);
+
+			FHitResult Hit;
+			if (GetWorld()->LineTraceSingleByObjectType(Hit, Location + TraceOffset, Location - TraceOffset, ObjectQueryParams, QueryParams))
+			{
+				Location = Hit.Location;
+				UpVector = Hit.ImpactNormal;
+
+				FVector ProjectedForwardVector = FVector::VectorPlaneProject(ForwardVector, UpVector).GetSafeNormal();
+				if (!ProjectedForwardVector.IsNearlyZero())
+				{
+					ForwardVector = ProjectedForwardVector;
+				}
+			}
+		}
+
+		const FDesignerPaletteEntry* PaletteEntry = Palette != nullptr ? &Palette->Entries[MeshIndex] : nullptr;
+		bool bUsedFallbackRotation = false;
+		Segment.Transforms.Add(FDesignerPlacementTransform::MakeDirectedTransform(Settings, RotationGrid, Location, ForwardVector, UpVector, PlacementSeed, 1.F, PaletteEntry, &bUsedFallbackRotation));
+		Segment.MeshIndices.Add(MeshIndex);
+		Segment.Seeds.Add(PlacementSeed);
+		NumFallbackRotations += bUsedFallbackRotation ? 1 : 0;
+	}
+
+	return NumFallbackRotations;
+}
+
+uint32 ADesignerSplinePlacer::GetSegmentSignature(int32 SegmentIndex) const
+{
+	const int32 NumPoints = Spline->GetNumberOfSplinePoints();
+
+	uint32 Signature = HashCombine(
+		DesignerSplinePlacer::GetSplinePointHash(Spline, SegmentIndex),
+		DesignerSplinePlacer::GetSplinePointHash(Spline, (SegmentIndex + 1) % NumPoints));
+
+	// The last segment of an open spline also places its end point
+	const bool bIsLastOpenSegment = !Spline->IsClosedLoop() && SegmentIndex == NumPoints - 2;
+	Signature = HashCombine(Signature, GetTypeHash(bIsLastOpenSegment));
+
+	// Zero marks an invalidated segment
+	return Signature != 0 ? Signature : 1;
+}
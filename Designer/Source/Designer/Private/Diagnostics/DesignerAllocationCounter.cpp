@@ -0,0 +1,282 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Diagnostics/DesignerAllocationCounter.h"
+
+// Engine Includes
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/MemoryBase.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+// Local Includes
+#include "DesignerModule.h"
+
+bool FDesignerAllocationCounter::bIsCounting = false;
+int32 FDesignerAllocationCounter::ScopeDepth = 0;
+FDesignerAllocationCount FDesignerAllocationCounter::Count;
+uint64 FDesignerAllocationCounter::StartFrame = 0;
+
+/**
+ * Forwards to the wrapped allocator and counts the allocations of the game thread inside allocation scopes
+ */
+class FDesignerCountingMalloc : public FMalloc
+{
+public:
+	explicit FDesignerCountingMalloc(FMalloc* InInnerMalloc)
+		: InnerMalloc(InInnerMalloc)
+	{
+	}
+
+	//~ Begin FMalloc interface
+	virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+	{
+		CountAllocation(Size);
+		return InnerMalloc->Malloc(Size, Alignment);
+	}
+
+	virtual void* Realloc(void* Original, SIZE_T Size, uint32 Alignment) override
+	{
+		// Shrinking to zero frees, that is not an allocation
+		if (Size > 0)
+		{
+			CountAllocation(Size);
+		}
+		return InnerMalloc->Realloc(Original, Size, Alignment);
+	}
+
+	virtual void Free(void* Original) override
+	{
+		InnerMalloc->Free(Original);
+	}
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+	{
+		return InnerMalloc->QuantizeSize(Count, Alignment);
+	}
+
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+	{
+		return InnerMalloc->GetAllocationSize(Original, SizeOut);
+	}
+
+	virtual void Trim(bool bTrimThreadCaches) override
+	{
+		InnerMalloc->Trim(bTrimThreadCaches);
+	}
+
+	virtual void SetupTLSCachesOnCurrentThread() override
+	{
+		InnerMalloc->SetupTLSCachesOnCurrentThread();
+	}
+
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+	{
+		InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+	}
+
+	virtual void InitializeStatsMetadata() override
+	{
+		InnerMalloc->InitializeStatsMetadata();
+	}
+
+	virtual void UpdateStats() override
+	{
+		InnerMalloc->UpdateStats();
+	}
+
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override
+	{
+		InnerMalloc->GetAllocatorStats(OutStats);
+	}
+
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override
+	{
+		InnerMalloc->DumpAllocatorStats(Ar);
+	}
+
+	virtual bool IsInternallyThreadSafe() const override
+	{
+		return InnerMalloc->IsInternallyThreadSafe();
+	}
+
+	virtual bool ValidateHeap() override
+	{
+		return InnerMalloc->ValidateHeap();
+	}
+
+	virtual const TCHAR* GetDescriptiveName() override
+	{
+		return InnerMalloc->GetDescriptiveName();
+	}
+	//~ End FMalloc interface
+
+private:
+	void CountAllocation(SIZE_T Size)
+	{
+		if (FDesignerAllocationCounter::ScopeDepth > 0 && IsInGameThread())
+		{
+			++FDesignerAllocationCounter::Count.NumAllocations;
+			FDesignerAllocationCounter::Count.NumBytes += Size;
+		}
+	}
+
+private:
+	FMalloc* InnerMalloc;
+};
+
+namespace DesignerAllocationCounter
+{
+	/** The installed proxy, it stays in place until the process exits */
+	static FDesignerCountingMalloc* CountingMalloc = nullptr;
+
+	/** Stops the counter after a number of frames, invalid while no timed count runs */
+	static FDelegateHandle StopTickerHandle;
+
+	static void LogCount(const FDesignerAllocationCount& Count)
+	{
+		UE_LOG(LogDesigner, Display, TEXT("%llu allocations (%llu bytes) in %llu hot path calls over %llu frames, %.2f allocations per frame."),
+			Count.NumAllocations, Count.NumBytes, Count.NumScopes, Count.NumFrames, Count.NumFrames > 0 ? double(Count.NumAllocations) / Count.NumFrames : 0.0);
+	}
+}
+
+void FDesignerAllocationCounter::InstallIfRequested()
+{
+	using namespace DesignerAllocationCounter;
+
+	check(IsInGameThread());
+
+	if (CountingMalloc != nullptr || !FParse::Param(FCommandLine::Get(), TEXT("DesignerAllocs")))
+	{
+		return;
+	}
+
+	// The proxy only forwards, so a block allocated before it is installed is freed by the same allocator
+	CountingMalloc = new FDesignerCountingMalloc(GMalloc);
+	GMalloc = CountingMalloc;
+
+	UE_LOG(LogDesigner, Display, TEXT("Installed the designer allocation counter, use designer.allocs to count hot path allocations."));
+}
+
+bool FDesignerAllocationCounter::IsAvailable()
+{
+	return DesignerAllocationCounter::CountingMalloc != nullptr;
+}
+
+bool FDesignerAllocationCounter::Start()
+{
+	check(IsInGameThread());
+
+	if (!IsAvailable())
+	{
+		return false;
+	}
+
+	if (!bIsCounting)
+	{
+		Count = FDesignerAllocationCount();
+		StartFrame = GFrameCounter;
+		bIsCounting = true;
+	}
+
+	return true;
+}
+
+FDesignerAllocationCount FDesignerAllocationCounter::Stop()
+{
+	using namespace DesignerAllocationCounter;
+
+	check(IsInGameThread());
+
+	if (bIsCounting)
+	{
+		bIsCounting = false;
+		Count.NumFrames = GFrameCounter - StartFrame;
+	}
+
+	if (StopTickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(StopTickerHandle);
+		StopTickerHandle.Reset();
+	}
+
+	return Count;
+}
+
+/**
+ * designer.allocs [start|stop|frames=<Frames>]
+ * Counts the heap allocations of the interactive tool hot paths, e.g. while dragging out an asset.
+ */
+static void AllocsCommand(const TArray<FString>& Args)
+{
+	using namespace DesignerAllocationCounter;
+
+	if (Args.Num() > 0 && Args[0].Equals(TEXT("stop"), ESearchCase::IgnoreCase))
+	{
+		LogCount(FDesignerAllocationCounter::Stop());
+		return;
+	}
+
+	int32 NumFrames = 0;
+	for (const FString& Arg : Args)
+	{
+		FParse::Value(*Arg, TEXT("frames="), NumFrames);
+	}
+
+	FDesignerAllocationCounter::Stop();
+	if (!FDesignerAllocationCounter::Start())
+	{
+		UE_LOG(LogDesigner, Error, TEXT("The allocation counter is not installed, restart the editor with -DesignerAllocs to count allocations."));
+		return;
+	}
+
+	if (NumFrames > 0)
+	{
+		const uint64 StopFrame = GFrameCounter + NumFrames;
+		StopTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([StopFrame](float DeltaTime)
+		{
+			if (GFrameCounter < StopFrame)
+			{
+				return true;
+			}
+
+			// Clear the handle first, the ticker removes this delegate itself when it returns false
+			StopTickerHandle.Reset();
+			LogCount(FDesignerAllocationCounter::Stop());
+			return false;
+		}));
+		UE_LOG(LogDesigner, Display, TEXT("Counting hot path allocations for %d frames."), NumFrames);
+	}
+	else
+	{
+		UE_LOG(LogDesigner, Display, TEXT("Counting hot path allocations until designer.allocs stop."));
+	}
+}
+
+static FAutoConsoleCommand AllocsConsoleCommand(
+	TEXT("designer.allocs"),
+	TEXT("Counts the heap allocations of the interactive tool hot paths. Usage: designer.allocs [start|stop|frames=<Frames>]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&AllocsCommand));
@@ -0,0 +1,114 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+/**
+ * The allocations counted between starting and stopping the counter
+ */
+struct FDesignerAllocationCount
+{
+	/** The number of heap allocations and reallocations made inside allocation scopes */
+	uint64 NumAllocations = 0;
+
+	/** The number of bytes requested by them */
+	uint64 NumBytes = 0;
+
+	/** The number of allocation scopes that were entered */
+	uint64 NumScopes = 0;
+
+	/** The number of frames that were counted */
+	uint64 NumFrames = 0;
+};
+
+/**
+ * Counts the heap allocations the game thread makes inside allocation scopes, to keep interactive hot paths allocation free.
+ *
+ * Counting needs GMalloc to be wrapped in a proxy that forwards everything to the allocator it replaced.
+ * The proxy is installed once when the module starts with -DesignerAllocs on the command line and is never removed,
+ * so the allocator is not swapped while other threads use it. Without the switch a scope costs a single branch.
+ */
+class FDesignerAllocationCounter
+{
+public:
+	/** Wraps GMalloc in the counting proxy if -DesignerAllocs is on the command line. Called once at module startup */
+	static void InstallIfRequested();
+
+	/** Is the counting proxy installed? Counting is not possible without it */
+	static bool IsAvailable();
+
+	/** Starts counting. Returns false if the counting proxy is not installed, does nothing if already counting */
+	static bool Start();
+
+	/** Stops counting and returns what was counted since the start */
+	static FDesignerAllocationCount Stop();
+
+	static bool IsCounting()
+	{
+		return bIsCounting;
+	}
+
+private:
+	friend class FDesignerAllocationScope;
+	friend class FDesignerCountingMalloc;
+
+	static bool bIsCounting;
+
+	/** The number of allocation scopes open on the game thread */
+	static int32 ScopeDepth;
+
+	static FDesignerAllocationCount Count;
+	static uint64 StartFrame;
+};
+
+/**
+ * Marks a hot path whose allocations are counted while the allocation counter runs. Game thread only.
+ */
+class FDesignerAllocationScope
+{
+public:
+	FDesignerAllocationScope()
+	{
+		if (FDesignerAllocationCounter::bIsCounting)
+		{
+			++FDesignerAllocationCounter::ScopeDepth;
+			++FDesignerAllocationCounter::Count.NumScopes;
+			bCounted = true;
+		}
+	}
+
+	~FDesignerAllocationScope()
+	{
+		if (bCounted)
+		{
+			--FDesignerAllocationCounter::ScopeDepth;
+		}
+	}
+
+private:
+	bool bCounted = false;
+};
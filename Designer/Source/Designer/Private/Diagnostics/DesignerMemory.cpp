@@ -0,0 +1,211 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Diagnostics/DesignerMemory.h"
+
+// Engine Includes
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Editor.h"
+#include "Editor/TransBuffer.h"
+#include "Editor/Transactor.h"
+#include "EditorModeManager.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Parse.h"
+
+// Local Includes
+#include "DesignerEdMode.h"
+#include "DesignerInstanceContainer.h"
+#include "DesignerModule.h"
+#include "DesignerPalette.h"
+#include "DesignerSettings.h"
+#include "Placement/DesignerDensityMap.h"
+#include "Placement/DesignerLandscapeHeightfield.h"
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER && STATS
+DECLARE_LLM_MEMORY_STAT(TEXT("Designer"), STAT_DesignerSummaryLLM, STATGROUP_LLM);
+DECLARE_LLM_MEMORY_STAT(TEXT("Designer Tools"), STAT_DesignerToolsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Designer Palette"), STAT_DesignerPaletteLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Designer Caches"), STAT_DesignerCachesLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Designer Containers"), STAT_DesignerContainersLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Designer Transactions"), STAT_DesignerTransactionsLLM, STATGROUP_LLMFULL);
+#endif
+
+namespace DesignerMemory
+{
+	/** The prefix of the titles of all Designer transactions */
+	static const TCHAR* TransactionTitlePrefix = TEXT("Designer:");
+
+	static double ToMegabytes(SIZE_T Bytes)
+	{
+		return Bytes / (1024.0 * 1024.0);
+	}
+
+	static void LogLine(const TCHAR* Name, const FString& Count, SIZE_T Bytes)
+	{
+		UE_LOG(LogDesigner, Display, TEXT("  %-28s %-28s %10.2f MB"), Name, *Count, ToMegabytes(Bytes));
+	}
+}
+
+void FDesignerMemory::RegisterLLMTags()
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER && STATS
+	FLowLevelMemTracker& Tracker = FLowLevelMemTracker::Get();
+	const FName SummaryStatName = GET_STATFNAME(STAT_DesignerSummaryLLM);
+	Tracker.RegisterProjectTag(static_cast<int32>(EDesignerLLMTag::Tools), TEXT("DesignerTools"), GET_STATFNAME(STAT_DesignerToolsLLM), SummaryStatName);
+	Tracker.RegisterProjectTag(static_cast<int32>(EDesignerLLMTag::Palette), TEXT("DesignerPalette"), GET_STATFNAME(STAT_DesignerPaletteLLM), SummaryStatName);
+	Tracker.RegisterProjectTag(static_cast<int32>(EDesignerLLMTag::Caches), TEXT("DesignerCaches"), GET_STATFNAME(STAT_DesignerCachesLLM), SummaryStatName);
+	Tracker.RegisterProjectTag(static_cast<int32>(EDesignerLLMTag::Containers), TEXT("DesignerContainers"), GET_STATFNAME(STAT_DesignerContainersLLM), SummaryStatName);
+	Tracker.RegisterProjectTag(static_cast<int32>(EDesignerLLMTag::Transactions), TEXT("DesignerTransactions"), GET_STATFNAME(STAT_DesignerTransactionsLLM), SummaryStatName);
+#endif
+}
+
+/**
+ * designer.memreport [budget=<MB>]
+ * Breaks down the editor memory held by the Designer plugin, warning when it exceeds the budget.
+ */
+static void MemReportCommand(const TArray<FString>& Args)
+{
+	using namespace DesignerMemory;
+
+	float BudgetMegabytes = 0.F;
+	for (const FString& Arg : Args)
+	{
+		FParse::Value(*Arg, TEXT("budget="), BudgetMegabytes);
+	}
+
+	SIZE_T TotalBytes = 0;
+	UE_LOG(LogDesigner, Display, TEXT("Designer memory:"));
+
+	// Caches shared by all bulk placement
+	int32 NumDensityMaps = 0;
+	SIZE_T DensityMapBytes = 0;
+	FDesignerDensityMap::GetCacheSize(NumDensityMaps, DensityMapBytes);
+	LogLine(TEXT("Density map cache"), FString::Printf(TEXT("%d maps"), NumDensityMaps), DensityMapBytes);
+	TotalBytes += DensityMapBytes;
+
+	int32 NumHeightfields = 0;
+	SIZE_T HeightfieldBytes = 0;
+	FDesignerLandscapeHeightfield::GetCacheSize(NumHeightfields, HeightfieldBytes);
+	LogLine(TEXT("Heightfield cache"), FString::Printf(TEXT("%d landscapes"), NumHeightfields), HeightfieldBytes);
+	TotalBytes += HeightfieldBytes;
+
+	// The state of the mode only exists while it is active
+	const UDesignerSettings* Settings = UDesignerSettings::GetActiveSettings();
+	if (FDesignerEdMode* DesignerEdMode = static_cast<FDesignerEdMode*>(GLevelEditorModeTools().GetActiveMode(FDesignerEdMode::EM_DesignerEdModeId)))
+	{
+		const FDesignerSnapIndex& SnapIndex = DesignerEdMode->GetSnapIndex();
+		LogLine(TEXT("Snap index"), FString::Printf(TEXT("%d points"), SnapIndex.Num()), SnapIndex.GetAllocatedSize());
+		TotalBytes += SnapIndex.GetAllocatedSize();
+
+		const FDesignerPlacedContentIndex& ContentIndex = DesignerEdMode->GetContentIndex();
+		LogLine(TEXT("Placed content index"), FString::Printf(TEXT("%d items"), ContentIndex.Num()), ContentIndex.GetAllocatedSize());
+		TotalBytes += ContentIndex.GetAllocatedSize();
+
+		const SIZE_T PreviewBytes = DesignerEdMode->GetSpawnAssetTool()->GetPreviewResourceSize();
+		LogLine(TEXT("Spawn visualizer and preview"), FString(), PreviewBytes);
+		TotalBytes += PreviewBytes;
+	}
+
+	// Palette assets are loaded with the palette, but the levels that place them share them, so they are not part of the total
+	if (UDesignerPalette* Palette = Settings->Palette)
+	{
+		SIZE_T PaletteAssetBytes = 0;
+		for (const FDesignerPaletteEntry& Entry : Palette->Entries)
+		{
+			if (Entry.Asset != nullptr)
+			{
+				PaletteAssetBytes += Entry.Asset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+			}
+		}
+
+		const SIZE_T PaletteBytes = Palette->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		LogLine(TEXT("Palette"), FString::Printf(TEXT("%d entries"), Palette->Entries.Num()), PaletteBytes);
+		LogLine(TEXT("Palette assets (shared)"), FString(), PaletteAssetBytes);
+		TotalBytes += PaletteBytes;
+	}
+
+	// Instance containers of the edited world
+	UWorld* World = GEditor->GetEditorWorldContext().World();
+	int32 NumContainers = 0;
+	int32 NumInstances = 0;
+	SIZE_T ContainerBytes = 0;
+	for (TActorIterator<ADesignerInstanceContainer> ContainerIt(World); ContainerIt; ++ContainerIt)
+	{
+		++NumContainers;
+		NumInstances += ContainerIt->GetInstanceCount();
+		for (UHierarchicalInstancedStaticMeshComponent* Component : ContainerIt->GetInstanceComponents())
+		{
+			if (Component != nullptr)
+			{
+				ContainerBytes += Component->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal) + ContainerIt->GetInstanceSeeds(Component).GetAllocatedSize();
+			}
+		}
+	}
+	LogLine(TEXT("Instance containers"), FString::Printf(TEXT("%d containers, %d instances"), NumContainers, NumInstances), ContainerBytes);
+	TotalBytes += ContainerBytes;
+
+	// The undo records of Designer transactions, all of them are titled "Designer: ..."
+	if (const UTransBuffer* TransBuffer = Cast<UTransBuffer>(GEditor->Trans))
+	{
+		int32 NumDesignerTransactions = 0;
+		SIZE_T DesignerTransactionBytes = 0;
+		SIZE_T TransactionBytes = 0;
+		for (int32 QueueIndex = 0; QueueIndex < TransBuffer->GetQueueLength(); ++QueueIndex)
+		{
+			const FTransaction* Transaction = TransBuffer->GetTransaction(QueueIndex);
+			if (Transaction == nullptr)
+			{
+				continue;
+			}
+
+			const SIZE_T TransactionSize = Transaction->DataSize();
+			TransactionBytes += TransactionSize;
+			if (Transaction->GetContext().Title.ToString().StartsWith(TransactionTitlePrefix))
+			{
+				++NumDesignerTransactions;
+				DesignerTransactionBytes += TransactionSize;
+			}
+		}
+
+		LogLine(TEXT("Designer transactions"), FString::Printf(TEXT("%d of %d transactions"), NumDesignerTransactions, TransBuffer->GetQueueLength()), DesignerTransactionBytes);
+		LogLine(TEXT("Transaction buffer (all)"), FString(), TransactionBytes);
+		TotalBytes += DesignerTransactionBytes;
+	}
+
+	LogLine(TEXT("Total"), FString(), TotalBytes);
+	UE_LOG(LogDesigner, Display, TEXT("Allocations are tagged per area, run stat LLMFULL for the tracked totals."));
+
+	if (BudgetMegabytes > 0.F && ToMegabytes(TotalBytes) > BudgetMegabytes)
+	{
+		UE_LOG(LogDesigner, Warning, TEXT("Designer memory of %.2f MB exceeds the budget of %.2f MB."), ToMegabytes(TotalBytes), BudgetMegabytes);
+	}
+}
+
+static FAutoConsoleCommand MemReportConsoleCommand(
+	TEXT("designer.memreport"),
+	TEXT("Breaks down the editor memory held by the Designer caches, tools, instance containers and transactions. Usage: designer.memreport [budget=<MB>]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&MemReportCommand));
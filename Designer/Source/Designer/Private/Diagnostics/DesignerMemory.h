@@ -0,0 +1,68 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+/**
+ * The low level memory tracker tags of the Designer plugin.
+ * They are the last tags of the project range (150 to 255), so they stay clear of the tags a project registers from the start.
+ */
+enum class EDesignerLLMTag : uint8
+{
+	/** The tools, their spawn visualizer and previews */
+	Tools = 251,
+
+	/** Palettes and their alias tables */
+	Palette,
+
+	/** The density map and heightfield caches and the snap and placed content indices */
+	Caches,
+
+	/** The instances and seeds of instance containers */
+	Containers,
+
+	/** The undo records the Designer edits write to the transaction buffer */
+	Transactions,
+};
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+#define DESIGNER_LLM_SCOPE(Tag) LLM_SCOPE(static_cast<ELLMTag>(Tag))
+#else
+#define DESIGNER_LLM_SCOPE(Tag)
+#endif
+
+/**
+ * Accounts for the editor memory held by the Designer plugin.
+ * The designer.memreport command breaks it down per cache, tool, container and transaction.
+ */
+class FDesignerMemory
+{
+public:
+	/** Registers the Designer tags with the low level memory tracker, so they show up in stat LLMFULL */
+	static void RegisterLLMTags();
+};
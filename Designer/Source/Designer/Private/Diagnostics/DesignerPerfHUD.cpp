@@ -0,0 +1,183 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Diagnostics/DesignerPerfHUD.h"
+
+// Engine Includes
+#include "CanvasTypes.h"
+#include "Engine/Engine.h"
+#include "Engine/Font.h"
+
+bool FDesignerPerfHUD::bIsVisible = false;
+FDesignerPerfHUD::FFrame FDesignerPerfHUD::CurrentFrame;
+FDesignerPerfHUD::FFrame FDesignerPerfHUD::History[FDesignerPerfHUD::NumHistoryFrames];
+int32 FDesignerPerfHUD::NumHistory = 0;
+int32 FDesignerPerfHUD::LastHistoryIndex = INDEX_NONE;
+uint64 FDesignerPerfHUD::LastFrameCounter = 0;
+FDesignerPerfGauges FDesignerPerfHUD::Gauges;
+
+namespace DesignerPerfHUD
+{
+	static const TCHAR* CategoryNames[] = { TEXT("Trace"), TEXT("Transform"), TEXT("Spawn"), TEXT("Visualizer") };
+	static_assert(ARRAY_COUNT(CategoryNames) == (int32)EDesignerPerfCategory::Num, "Every perf category needs a name");
+
+	/** The last frame is a spike when it costs this many times the average */
+	static const double SpikeRatio = 2.0;
+
+	/** Costs below this many milliseconds are too small to notice and never spikes */
+	static const double MinSpikeMilliseconds = 0.5;
+
+	/** The layout of the HUD in pixels */
+	static const float Margin = 10.F;
+	static const float LabelWidth = 110.F;
+	static const float ColumnWidth = 70.F;
+
+	static const FLinearColor TextColor(0.9F, 0.9F, 0.9F);
+	static const FLinearColor SpikeColor(1.F, 0.2F, 0.2F);
+
+	static bool IsSpike(double LastMilliseconds, double AverageMilliseconds)
+	{
+		return LastMilliseconds >= MinSpikeMilliseconds && LastMilliseconds > AverageMilliseconds * SpikeRatio;
+	}
+
+	/** Draws a label with its average and last frame value and moves down a line */
+	static void DrawRow(FCanvas* Canvas, float& InOutY, const TCHAR* Label, const FString& Average, const FString& Last, const FLinearColor& Color)
+	{
+		const UFont* Font = GEngine->GetSmallFont();
+		Canvas->DrawShadowedString(Margin, InOutY, Label, Font, Color);
+		Canvas->DrawShadowedString(Margin + LabelWidth, InOutY, *Average, Font, Color);
+		Canvas->DrawShadowedString(Margin + LabelWidth + ColumnWidth, InOutY, *Last, Font, Color);
+		InOutY += Font->GetMaxCharHeight() + 2.F;
+	}
+}
+
+void FDesignerPerfHUD::SetVisible(bool bVisible)
+{
+	if (bVisible == bIsVisible)
+	{
+		return;
+	}
+
+	bIsVisible = bVisible;
+	CurrentFrame = FFrame();
+	NumHistory = 0;
+	LastHistoryIndex = INDEX_NONE;
+	LastFrameCounter = GFrameCounter;
+	Gauges = FDesignerPerfGauges();
+}
+
+void FDesignerPerfHUD::Tick(float DeltaTime, const FDesignerPerfGauges& InGauges)
+{
+	// Every level viewport ticks the ed mode, only the first tick of a frame closes it
+	if (!bIsVisible || GFrameCounter == LastFrameCounter)
+	{
+		return;
+	}
+	LastFrameCounter = GFrameCounter;
+
+	CurrentFrame.DeltaTime = DeltaTime;
+	LastHistoryIndex = (LastHistoryIndex + 1) % NumHistoryFrames;
+	History[LastHistoryIndex] = CurrentFrame;
+	NumHistory = FMath::Min(NumHistory + 1, NumHistoryFrames);
+
+	CurrentFrame = FFrame();
+	Gauges = InGauges;
+}
+
+void FDesignerPerfHUD::Draw(FCanvas* Canvas)
+{
+	using namespace DesignerPerfHUD;
+
+	if (!bIsVisible || NumHistory == 0 || Canvas == nullptr)
+	{
+		return;
+	}
+
+	const double MillisecondsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1000.0;
+	const int32 NumCategories = (int32)EDesignerPerfCategory::Num;
+
+	double AverageMilliseconds[NumCategories] = {};
+	double TotalSeconds = 0.0;
+	int64 TotalTraces = 0;
+	int64 TotalCoherenceTests = 0;
+	int64 TotalCoherenceHits = 0;
+	int64 TotalPlacements = 0;
+	for (int32 HistoryIndex = 0; HistoryIndex < NumHistory; ++HistoryIndex)
+	{
+		const FFrame& Frame = History[HistoryIndex];
+		for (int32 CategoryIndex = 0; CategoryIndex < NumCategories; ++CategoryIndex)
+		{
+			AverageMilliseconds[CategoryIndex] += Frame.Cycles[CategoryIndex] * MillisecondsPerCycle;
+		}
+		TotalSeconds += Frame.DeltaTime;
+		TotalTraces += Frame.NumTraces;
+		TotalCoherenceTests += Frame.NumCoherenceTests;
+		TotalCoherenceHits += Frame.NumCoherenceHits;
+		TotalPlacements += Frame.NumPlacements;
+	}
+
+	const FFrame& LastFrame = History[LastHistoryIndex];
+
+	float Y = Margin;
+	DrawRow(Canvas, Y, TEXT("Designer"), TEXT("avg"), TEXT("last"), TextColor);
+
+	double AverageTotalMilliseconds = 0.0;
+	double LastTotalMilliseconds = 0.0;
+	for (int32 CategoryIndex = 0; CategoryIndex < NumCategories; ++CategoryIndex)
+	{
+		AverageMilliseconds[CategoryIndex] /= NumHistory;
+		const double LastMilliseconds = LastFrame.Cycles[CategoryIndex] * MillisecondsPerCycle;
+		AverageTotalMilliseconds += AverageMilliseconds[CategoryIndex];
+		LastTotalMilliseconds += LastMilliseconds;
+
+		DrawRow(Canvas, Y, CategoryNames[CategoryIndex],
+			FString::Printf(TEXT("%.2f ms"), AverageMilliseconds[CategoryIndex]),
+			FString::Printf(TEXT("%.2f ms"), LastMilliseconds),
+			IsSpike(LastMilliseconds, AverageMilliseconds[CategoryIndex]) ? SpikeColor : TextColor);
+	}
+
+	DrawRow(Canvas, Y, TEXT("Total"),
+		FString::Printf(TEXT("%.2f ms"), AverageTotalMilliseconds),
+		FString::Printf(TEXT("%.2f ms"), LastTotalMilliseconds),
+		IsSpike(LastTotalMilliseconds, AverageTotalMilliseconds) ? SpikeColor : TextColor);
+
+	DrawRow(Canvas, Y, TEXT("Traces / frame"),
+		FString::Printf(TEXT("%.1f"), (double)TotalTraces / NumHistory),
+		FString::FromInt(LastFrame.NumTraces),
+		TextColor);
+
+	DrawRow(Canvas, Y, TEXT("Coherent traces"),
+		FString::Printf(TEXT("%.0f%%"), TotalCoherenceTests > 0 ? 100.0 * TotalCoherenceHits / TotalCoherenceTests : 0.0),
+		FString::Printf(TEXT("%d / %d"), LastFrame.NumCoherenceHits, LastFrame.NumCoherenceTests),
+		TextColor);
+
+	DrawRow(Canvas, Y, TEXT("Placements / s"),
+		FString::Printf(TEXT("%.1f"), TotalSeconds > 0.0 ? TotalPlacements / TotalSeconds : 0.0),
+		FString::FromInt(LastFrame.NumPlacements),
+		TextColor);
+
+	DrawRow(Canvas, Y, TEXT("Pending loads"), FString::FromInt(Gauges.NumPendingLoads), FString(), TextColor);
+	DrawRow(Canvas, Y, TEXT("Queued spawns"), FString::FromInt(Gauges.NumQueuedSpawns), FString(), TextColor);
+}
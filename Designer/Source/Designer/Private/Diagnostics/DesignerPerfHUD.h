@@ -0,0 +1,171 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Forward Declares
+class FCanvas;
+
+/**
+ * The parts of the per frame cost of the tools that the performance HUD breaks down
+ */
+enum class EDesignerPerfCategory : uint8
+{
+	/** Tracing the world under the cursor and under the footprint */
+	Trace,
+
+	/** Moving, scaling and snapping the spawned actor and the array preview */
+	Transform,
+
+	/** Spawning and committing placements */
+	Spawn,
+
+	/** Updating the spawn visualizer */
+	Visualizer,
+
+	Num
+};
+
+/**
+ * The work waiting on the Designer tools, sampled once per frame
+ */
+struct FDesignerPerfGauges
+{
+	/** The number of packages being loaded asynchronously */
+	int32 NumPendingLoads = 0;
+
+	/** The number of placements waiting to be spawned */
+	int32 NumQueuedSpawns = 0;
+};
+
+/**
+ * Gathers the per frame cost of the Designer tools and draws it over the viewport, with rolling averages and spikes highlighted.
+ *
+ * Nothing is gathered while the HUD is hidden, a scope or a counter then costs a single branch. Game thread only.
+ */
+class FDesignerPerfHUD
+{
+public:
+	static bool IsVisible()
+	{
+		return bIsVisible;
+	}
+
+	/** Shows or hides the HUD. Showing it starts the averages over */
+	static void SetVisible(bool bVisible);
+
+	/** Counts the traces made this frame */
+	static void AddTraces(int32 NumTraces)
+	{
+		if (bIsVisible)
+		{
+			CurrentFrame.NumTraces += NumTraces;
+		}
+	}
+
+	/** Counts the actors and instances placed this frame */
+	static void AddPlacements(int32 NumPlacements)
+	{
+		if (bIsVisible)
+		{
+			CurrentFrame.NumPlacements += NumPlacements;
+		}
+	}
+
+	/** Counts a cursor trace that tried the component hit last time, bHit if it did not need the world query */
+	static void AddTraceCoherence(bool bHit)
+	{
+		if (bIsVisible)
+		{
+			++CurrentFrame.NumCoherenceTests;
+			CurrentFrame.NumCoherenceHits += bHit ? 1 : 0;
+		}
+	}
+
+	/** Closes the gathered frame once per engine frame, it is fine to call this from every viewport tick */
+	static void Tick(float DeltaTime, const FDesignerPerfGauges& InGauges);
+
+	/** Draws the HUD in the top left corner of the canvas */
+	static void Draw(FCanvas* Canvas);
+
+private:
+	friend class FDesignerPerfScope;
+
+	/** What was gathered over a single frame */
+	struct FFrame
+	{
+		uint64 Cycles[(int32)EDesignerPerfCategory::Num] = {};
+		int32 NumTraces = 0;
+		int32 NumCoherenceTests = 0;
+		int32 NumCoherenceHits = 0;
+		int32 NumPlacements = 0;
+		float DeltaTime = 0.F;
+	};
+
+	/** The number of frames the averages are taken over */
+	static const int32 NumHistoryFrames = 60;
+
+	static bool bIsVisible;
+
+	/** The frame being gathered */
+	static FFrame CurrentFrame;
+
+	/** The last closed frames, as a ring */
+	static FFrame History[NumHistoryFrames];
+	static int32 NumHistory;
+	static int32 LastHistoryIndex;
+
+	/** The engine frame the last frame was closed on */
+	static uint64 LastFrameCounter;
+
+	static FDesignerPerfGauges Gauges;
+};
+
+/**
+ * Adds the time spent inside of it to a category of the performance HUD, while the HUD is visible. Scopes of the same category should not nest.
+ */
+class FDesignerPerfScope
+{
+public:
+	explicit FDesignerPerfScope(EDesignerPerfCategory InCategory)
+		: Category(InCategory)
+		, StartCycles(FDesignerPerfHUD::bIsVisible ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	~FDesignerPerfScope()
+	{
+		if (StartCycles != 0)
+		{
+			FDesignerPerfHUD::CurrentFrame.Cycles[(int32)Category] += FPlatformTime::Cycles64() - StartCycles;
+		}
+	}
+
+private:
+	EDesignerPerfCategory Category;
+	uint64 StartCycles;
+};
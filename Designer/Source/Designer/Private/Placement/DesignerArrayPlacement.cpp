@@ -0,0 +1,66 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerArrayPlacement.h"
+
+void FDesignerArrayPlacement::GenerateLattice(const FVector& Origin, const FQuat& LatticeRotation, const FIntVector& Counts, const FVector& Step, const FQuat& ItemRotation, TArray<FTransform>& OutTransforms)
+{
+	const int32 NumItems = FMath::Max(Counts.X, 0) * FMath::Max(Counts.Y, 0) * FMath::Max(Counts.Z, 0);
+	OutTransforms.SetNumUninitialized(NumItems, /*bAllowShrinking*/false);
+
+	if (NumItems == 0)
+	{
+		return;
+	}
+
+	const FVector StepX = LatticeRotation.GetAxisX() * Step.X;
+	const FVector StepY = LatticeRotation.GetAxisY() * Step.Y;
+	const FVector StepZ = LatticeRotation.GetAxisZ() * Step.Z;
+
+	const VectorRegister OriginRegister = VectorLoadFloat3_W0(&Origin);
+	const VectorRegister StepXRegister = VectorLoadFloat3_W0(&StepX);
+	const VectorRegister StepYRegister = VectorLoadFloat3_W0(&StepY);
+	const VectorRegister StepZRegister = VectorLoadFloat3_W0(&StepZ);
+
+	// Every item is computed from the origin instead of accumulated, so large arrays do not drift
+	int32 ItemIndex = 0;
+	for (int32 Z = 0; Z < Counts.Z; ++Z)
+	{
+		const VectorRegister LayerOrigin = VectorMultiplyAdd(VectorSetFloat1((float)Z), StepZRegister, OriginRegister);
+		for (int32 Y = 0; Y < Counts.Y; ++Y)
+		{
+			const VectorRegister RowOrigin = VectorMultiplyAdd(VectorSetFloat1((float)Y), StepYRegister, LayerOrigin);
+			for (int32 X = 0; X < Counts.X; ++X)
+			{
+				const VectorRegister ItemLocation = VectorMultiplyAdd(VectorSetFloat1((float)X), StepXRegister, RowOrigin);
+
+				FVector Location;
+				VectorStoreFloat3(ItemLocation, &Location);
+
+				OutTransforms[ItemIndex++] = FTransform(ItemRotation, Location);
+			}
+		}
+	}
+}
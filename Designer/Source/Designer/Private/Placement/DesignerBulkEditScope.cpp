@@ -0,0 +1,313 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerBulkEditScope.h"
+
+// Engine Includes
+#include "Editor.h"
+#include "Engine/Level.h"
+#include "Engine/Selection.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Optional.h"
+#include "ScopedTransaction.h"
+#include "UObject/Package.h"
+
+// Local Includes
+#include "DesignerModule.h"
+
+#define LOCTEXT_NAMESPACE "DesignerBulkEditScope"
+
+namespace DesignerBulkEditScope
+{
+	/** The number of scopes that are alive */
+	static int32 Depth = 0;
+
+	/** Clear the selection before selecting the pending actors */
+	static bool bPendingSelectNone = false;
+
+	/** The actors to select when the outermost scope ends */
+	static TArray<TWeakObjectPtr<AActor>> PendingSelection;
+
+	/** The levels to mark dirty when the outermost scope ends */
+	static TArray<TWeakObjectPtr<ULevel>> DirtyLevels;
+
+	/** The actors added while a scope was alive, reported to the held back listeners when the outermost scope ends */
+	static TArray<TWeakObjectPtr<AActor>> AddedActors;
+
+	/** The number of actors removed while a scope was alive */
+	static int32 NumDeletedActors = 0;
+
+	/** The listeners of the level actor added event, held back while a scope is alive */
+	static TOptional<UEngine::FLevelActorAddedEvent> HeldBackActorAddedListeners;
+
+	/** Record actor list changes while a scope is alive */
+	static FDelegateHandle ActorAddedHandle;
+	static FDelegateHandle ActorDeletedHandle;
+
+	static void OnActorAdded(AActor* Actor)
+	{
+		AddedActors.Add(Actor);
+	}
+
+	static void OnActorDeleted(AActor* Actor)
+	{
+		++NumDeletedActors;
+	}
+}
+
+FDesignerBulkEditScope::FDesignerBulkEditScope()
+{
+	using namespace DesignerBulkEditScope;
+
+	if (Depth++ > 0)
+	{
+		return;
+	}
+
+	GEditor->GetSelectedActors()->BeginBatchSelectOperation();
+
+	// Spawning reports every actor right away, before an actor factory finished it, so the listeners are only told at the end
+	HeldBackActorAddedListeners.Emplace(GEngine->OnLevelActorAdded());
+	GEngine->OnLevelActorAdded().Clear();
+
+	ActorAddedHandle = GEngine->OnLevelActorAdded().AddStatic(&OnActorAdded);
+	ActorDeletedHandle = GEngine->OnLevelActorDeleted().AddStatic(&OnActorDeleted);
+}
+
+FDesignerBulkEditScope::~FDesignerBulkEditScope()
+{
+	using namespace DesignerBulkEditScope;
+
+	check(Depth > 0);
+	if (--Depth > 0)
+	{
+		return;
+	}
+
+	GEngine->OnLevelActorAdded() = HeldBackActorAddedListeners.GetValue();
+	HeldBackActorAddedListeners.Reset();
+	GEngine->OnLevelActorDeleted().Remove(ActorDeletedHandle);
+
+	Flush();
+}
+
+bool FDesignerBulkEditScope::IsActive()
+{
+	return DesignerBulkEditScope::Depth > 0;
+}
+
+void FDesignerBulkEditScope::SelectNone()
+{
+	using namespace DesignerBulkEditScope;
+
+	if (!IsActive())
+	{
+		GEditor->SelectNone(/*bNoteSelectionChange*/true, /*bDeselectBSPSurfs*/true, /*WarnAboutManyActors*/false);
+		return;
+	}
+
+	bPendingSelectNone = true;
+	PendingSelection.Reset();
+}
+
+void FDesignerBulkEditScope::SelectActor(AActor* Actor)
+{
+	using namespace DesignerBulkEditScope;
+
+	if (!IsActive())
+	{
+		GEditor->SelectActor(Actor, /*bInSelected*/true, /*bNotify*/true, /*bSelectEvenIfHidden*/true);
+		return;
+	}
+
+	PendingSelection.Add(Actor);
+}
+
+void FDesignerBulkEditScope::MarkLevelDirty(ULevel* Level)
+{
+	using namespace DesignerBulkEditScope;
+
+	if (!IsActive())
+	{
+		Level->MarkPackageDirty();
+		return;
+	}
+
+	DirtyLevels.AddUnique(Level);
+}
+
+void FDesignerBulkEditScope::Flush()
+{
+	using namespace DesignerBulkEditScope;
+
+	// The listeners learn about the actors before they are selected. Actors that were removed again in the meantime are left out
+	int32 NumAddedActors = 0;
+	for (const TWeakObjectPtr<AActor>& Actor : AddedActors)
+	{
+		if (Actor.IsValid())
+		{
+			GEngine->BroadcastLevelActorAdded(Actor.Get());
+			++NumAddedActors;
+		}
+	}
+
+	USelection* SelectedActors = GEditor->GetSelectedActors();
+	const bool bSelectionChanged = bPendingSelectNone || PendingSelection.Num() > 0;
+
+	if (bPendingSelectNone)
+	{
+		GEditor->SelectNone(/*bNoteSelectionChange*/false, /*bDeselectBSPSurfs*/true, /*WarnAboutManyActors*/false);
+	}
+	for (const TWeakObjectPtr<AActor>& Actor : PendingSelection)
+	{
+		if (Actor.IsValid())
+		{
+			GEditor->SelectActor(Actor.Get(), /*bInSelected*/true, /*bNotify*/false, /*bSelectEvenIfHidden*/true);
+		}
+	}
+	SelectedActors->EndBatchSelectOperation();
+
+	if (bSelectionChanged)
+	{
+		GEditor->NoteSelectionChange();
+	}
+
+	for (const TWeakObjectPtr<ULevel>& Level : DirtyLevels)
+	{
+		if (Level.IsValid())
+		{
+			Level->MarkPackageDirty();
+		}
+	}
+
+	if (NumAddedActors > 0 || NumDeletedActors > 0)
+	{
+		GEditor->RedrawLevelEditingViewports();
+	}
+
+	bPendingSelectNone = false;
+	PendingSelection.Reset();
+	DirtyLevels.Reset();
+	AddedActors.Reset();
+	NumDeletedActors = 0;
+}
+
+/**
+ * designer.bench.bulkscope [Count]
+ * Places Count actors one at a time the way a stroke commits them, once with per actor notifications and once inside a
+ * bulk edit scope, and reports the time per actor of both. All placed actors are removed again and the level is left as
+ * clean or dirty as it was.
+ */
+static void BenchmarkBulkEditScopeCommand(const TArray<FString>& Args)
+{
+	const int32 NumActors = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 2000;
+
+	UStaticMesh* StaticMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	UWorld* World = GEditor->GetEditorWorldContext().World();
+	ULevel* Level = World->GetCurrentLevel();
+	UPackage* LevelPackage = Level->GetOutermost();
+	const bool bWasLevelDirty = LevelPackage->IsDirty();
+
+	auto RunPass = [&](bool bUseScope)
+	{
+		FScopedTransaction Transaction(LOCTEXT("BenchmarkTransaction", "Designer: Benchmark Bulk Edit Scope"));
+
+		TArray<AActor*> PlacedActors;
+		PlacedActors.Reserve(NumActors);
+
+		double StartTime = FPlatformTime::Seconds();
+		{
+			TOptional<FDesignerBulkEditScope> BulkEditScope;
+			if (bUseScope)
+			{
+				BulkEditScope.Emplace();
+			}
+
+			for (int32 ActorIndex = 0; ActorIndex < NumActors; ++ActorIndex)
+			{
+				FActorSpawnParameters SpawnParameters;
+				SpawnParameters.OverrideLevel = Level;
+				FVector Location((ActorIndex % 100) * 200.F, (ActorIndex / 100) * 200.F, 0.F);
+				AStaticMeshActor* Actor = World->SpawnActor<AStaticMeshActor>(Location, FRotator::ZeroRotator, SpawnParameters);
+				Actor->GetStaticMeshComponent()->SetStaticMesh(StaticMesh);
+				PlacedActors.Add(Actor);
+
+				if (bUseScope)
+				{
+					FDesignerBulkEditScope::SelectNone();
+					FDesignerBulkEditScope::SelectActor(Actor);
+					FDesignerBulkEditScope::MarkLevelDirty(Level);
+				}
+				else
+				{
+					GEditor->SelectNone(/*bNoteSelectionChange*/true, /*bDeselectBSPSurfs*/true, /*WarnAboutManyActors*/false);
+					GEditor->SelectActor(Actor, /*bInSelected*/true, /*bNotify*/true, /*bSelectEvenIfHidden*/true);
+					Level->MarkPackageDirty();
+					GEditor->RedrawLevelEditingViewports();
+				}
+			}
+		}
+		double Elapsed = FPlatformTime::Seconds() - StartTime;
+
+		// Leave the level as it was
+		{
+			FDesignerBulkEditScope CleanupScope;
+			FDesignerBulkEditScope::SelectNone();
+			for (AActor* PlacedActor : PlacedActors)
+			{
+				World->EditorDestroyActor(PlacedActor, /*bShouldModifyLevel*/false);
+			}
+		}
+		Transaction.Cancel();
+
+		return Elapsed;
+	};
+
+	const double UnscopedTime = RunPass(false);
+	const double ScopedTime = RunPass(true);
+
+	if (!bWasLevelDirty)
+	{
+		LevelPackage->SetDirtyFlag(false);
+	}
+
+	const double UnscopedMicroseconds = UnscopedTime * 1000000.0 / NumActors;
+	const double ScopedMicroseconds = ScopedTime * 1000000.0 / NumActors;
+
+	UE_LOG(LogDesigner, Display, TEXT("Placed %d actors per pass."), NumActors);
+	UE_LOG(LogDesigner, Display, TEXT("  Per actor notifications: %.3f seconds, %.1f us per actor"), UnscopedTime, UnscopedMicroseconds);
+	UE_LOG(LogDesigner, Display, TEXT("  Bulk edit scope:         %.3f seconds, %.1f us per actor"), ScopedTime, ScopedMicroseconds);
+	UE_LOG(LogDesigner, Display, TEXT("  Overhead removed:        %.1f us per actor"), UnscopedMicroseconds - ScopedMicroseconds);
+}
+
+static FAutoConsoleCommand BenchmarkBulkEditScopeConsoleCommand(
+	TEXT("designer.bench.bulkscope"),
+	TEXT("Measures the per actor notification overhead removed by the bulk edit scope. Usage: designer.bench.bulkscope [Count]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkBulkEditScopeCommand));
+
+#undef LOCTEXT_NAMESPACE
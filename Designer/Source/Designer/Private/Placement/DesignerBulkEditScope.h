@@ -0,0 +1,66 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Forward Declares
+class AActor;
+class ULevel;
+
+/**
+ * Defers the editor notifications of a bulk placement to the end of the operation.
+ *
+ * While a scope is alive, selection changes made through it are queued and applied in a single batch, touched levels
+ * are marked dirty once and the viewports are redrawn once at the end, instead of once per actor. The listeners of the
+ * level actor added event of the engine, such as the scene outliner, are held back and told about the added actors in
+ * one pass at the end, once the actors are fully placed. Scopes can be nested, only the outermost one flushes.
+ */
+class FDesignerBulkEditScope
+{
+public:
+	FDesignerBulkEditScope();
+	~FDesignerBulkEditScope();
+
+	FDesignerBulkEditScope(const FDesignerBulkEditScope&) = delete;
+	FDesignerBulkEditScope& operator=(const FDesignerBulkEditScope&) = delete;
+
+	/** Is a bulk edit in progress? */
+	static bool IsActive();
+
+	/** Clears the selection, at the end of the bulk edit if one is in progress */
+	static void SelectNone();
+
+	/** Adds the actor to the selection, at the end of the bulk edit if one is in progress */
+	static void SelectActor(AActor* Actor);
+
+	/** Marks the level package dirty, at the end of the bulk edit if one is in progress */
+	static void MarkLevelDirty(ULevel* Level);
+
+private:
+	/** Applies everything that was deferred */
+	static void Flush();
+};
@@ -0,0 +1,485 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerConsolidation.h"
+
+// Engine Includes
+#include "Async/ParallelFor.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Editor.h"
+#include "Engine/Level.h"
+#include "Engine/Selection.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Volume.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Parse.h"
+#include "ScopedTransaction.h"
+#include "Serialization/ArchiveCountMem.h"
+
+// Local Includes
+#include "DesignerInstanceContainer.h"
+#include "DesignerModule.h"
+#include "Diagnostics/DesignerMemory.h"
+#include "Placement/DesignerBulkEditScope.h"
+#include "Placement/DesignerPlacement.h"
+
+#define LOCTEXT_NAMESPACE "DesignerConsolidation"
+
+namespace DesignerConsolidation
+{
+	/** The boolean component settings that must match within a group */
+	enum EGroupFlags : uint32
+	{
+		GroupFlag_CastShadow = 1 << 0,
+		GroupFlag_CastDynamicShadow = 1 << 1,
+		GroupFlag_CastStaticShadow = 1 << 2,
+		GroupFlag_ReceivesDecals = 1 << 3,
+		GroupFlag_GenerateOverlapEvents = 1 << 4,
+		GroupFlag_Visible = 1 << 5,
+		GroupFlag_HiddenInGame = 1 << 6,
+		GroupFlag_RenderInMainPass = 1 << 7,
+		GroupFlag_RenderCustomDepth = 1 << 8,
+		GroupFlag_OverrideLightMapRes = 1 << 9,
+	};
+
+	/** Everything that has to match for actors to share one instanced component */
+	struct FGroupKey
+	{
+		ULevel* Level;
+		UStaticMesh* StaticMesh;
+		TArray<UMaterialInterface*> Materials;
+		FName CollisionProfileName;
+		FCollisionResponseContainer CollisionResponses;
+		uint8 CollisionEnabled;
+		uint8 ObjectType;
+		uint8 Mobility;
+		uint32 Flags;
+		float MaxDrawDistance;
+		int32 ForcedLodModel;
+		int32 OverriddenLightMapRes;
+		int32 CustomDepthStencilValue;
+		int32 TranslucencySortPriority;
+
+		/** Computed once when the key is built, the keys are hashed many times while grouping */
+		uint32 Hash;
+
+		bool operator==(const FGroupKey& Other) const
+		{
+			return Hash == Other.Hash
+				&& Level == Other.Level
+				&& StaticMesh == Other.StaticMesh
+				&& Materials == Other.Materials
+				&& CollisionProfileName == Other.CollisionProfileName
+				&& FMemory::Memcmp(CollisionResponses.EnumArray, Other.CollisionResponses.EnumArray, sizeof(CollisionResponses.EnumArray)) == 0
+				&& CollisionEnabled == Other.CollisionEnabled
+				&& ObjectType == Other.ObjectType
+				&& Mobility == Other.Mobility
+				&& Flags == Other.Flags
+				&& MaxDrawDistance == Other.MaxDrawDistance
+				&& ForcedLodModel == Other.ForcedLodModel
+				&& OverriddenLightMapRes == Other.OverriddenLightMapRes
+				&& CustomDepthStencilValue == Other.CustomDepthStencilValue
+				&& TranslucencySortPriority == Other.TranslucencySortPriority;
+		}
+
+		friend uint32 GetTypeHash(const FGroupKey& Key)
+		{
+			return Key.Hash;
+		}
+	};
+
+	/**
+	 * Builds the group key of an actor. Returns false if the actor can not be replaced by an instance without changing the level.
+	 * Only reads from the actor, so it is safe to call from worker threads.
+	 */
+	static bool MakeGroupKey(const AStaticMeshActor* Actor, FGroupKey& OutKey)
+	{
+		// Subclasses may add behavior an instance does not have
+		if (Actor == nullptr || Actor->GetClass() != AStaticMeshActor::StaticClass() || Actor->IsPendingKillPending())
+		{
+			return false;
+		}
+
+		const UStaticMeshComponent* Component = Actor->GetStaticMeshComponent();
+		if (Component == nullptr || Component->GetStaticMesh() == nullptr || Component->Mobility == EComponentMobility::Movable)
+		{
+			return false;
+		}
+
+		// Attachments and extra components would be lost
+		if (Component->GetAttachParent() != nullptr || Component->GetAttachChildren().Num() > 0 || Actor->GetInstanceComponents().Num() > 0)
+		{
+			return false;
+		}
+
+		// Painted vertex colors are per actor
+		for (const FStaticMeshComponentLODInfo& LODInfo : Component->LODData)
+		{
+			if (LODInfo.OverrideVertexColors != nullptr)
+			{
+				return false;
+			}
+		}
+
+		// Mirrored instances would render with flipped faces
+		if (Component->GetComponentTransform().GetDeterminant() < 0.F)
+		{
+			return false;
+		}
+
+		const FBodyInstance& BodyInstance = Component->BodyInstance;
+
+		OutKey.Level = Actor->GetLevel();
+		OutKey.StaticMesh = Component->GetStaticMesh();
+		OutKey.Materials = Component->OverrideMaterials;
+		OutKey.CollisionProfileName = BodyInstance.GetCollisionProfileName();
+		OutKey.CollisionResponses = BodyInstance.GetResponseToChannels();
+		OutKey.CollisionEnabled = BodyInstance.GetCollisionEnabled();
+		OutKey.ObjectType = BodyInstance.GetObjectType();
+		OutKey.Mobility = Component->Mobility;
+		OutKey.MaxDrawDistance = Component->LDMaxDrawDistance;
+		OutKey.ForcedLodModel = Component->ForcedLodModel;
+		OutKey.OverriddenLightMapRes = Component->bOverrideLightMapRes ? Component->OverriddenLightMapRes : 0;
+		OutKey.CustomDepthStencilValue = Component->bRenderCustomDepth ? Component->CustomDepthStencilValue : 0;
+		OutKey.TranslucencySortPriority = Component->TranslucencySortPriority;
+
+		OutKey.Flags = 0;
+		OutKey.Flags |= Component->CastShadow ? GroupFlag_CastShadow : 0;
+		OutKey.Flags |= Component->bCastDynamicShadow ? GroupFlag_CastDynamicShadow : 0;
+		OutKey.Flags |= Component->bCastStaticShadow ? GroupFlag_CastStaticShadow : 0;
+		OutKey.Flags |= Component->bReceivesDecals ? GroupFlag_ReceivesDecals : 0;
+		OutKey.Flags |= Component->GetGenerateOverlapEvents() ? GroupFlag_GenerateOverlapEvents : 0;
+		OutKey.Flags |= Component->IsVisible() ? GroupFlag_Visible : 0;
+		OutKey.Flags |= (Component->bHiddenInGame || Actor->bHidden) ? GroupFlag_HiddenInGame : 0;
+		OutKey.Flags |= Component->bRenderInMainPass ? GroupFlag_RenderInMainPass : 0;
+		OutKey.Flags |= Component->bRenderCustomDepth ? GroupFlag_RenderCustomDepth : 0;
+		OutKey.Flags |= Component->bOverrideLightMapRes ? GroupFlag_OverrideLightMapRes : 0;
+
+		uint32 Hash = HashCombine(GetTypeHash(OutKey.Level), GetTypeHash(OutKey.StaticMesh));
+		for (const UMaterialInterface* Material : OutKey.Materials)
+		{
+			Hash = HashCombine(Hash, GetTypeHash(Material));
+		}
+		Hash = HashCombine(Hash, GetTypeHash(OutKey.CollisionProfileName));
+		Hash = HashCombine(Hash, FCrc::MemCrc32(OutKey.CollisionResponses.EnumArray, sizeof(OutKey.CollisionResponses.EnumArray)));
+		Hash = HashCombine(Hash, OutKey.Flags | (OutKey.CollisionEnabled << 16) | (OutKey.ObjectType << 24));
+		Hash = HashCombine(Hash, GetTypeHash(OutKey.MaxDrawDistance));
+		Hash = HashCombine(Hash, GetTypeHash(OutKey.ForcedLodModel));
+		Hash = HashCombine(Hash, GetTypeHash(OutKey.OverriddenLightMapRes));
+		OutKey.Hash = Hash;
+
+		return true;
+	}
+
+	/** Gives a new instanced component the settings of the actors it replaces */
+	static void CopyComponentSettings(const AStaticMeshActor* SourceActor, UHierarchicalInstancedStaticMeshComponent* Target)
+	{
+		const UStaticMeshComponent* Source = SourceActor->GetStaticMeshComponent();
+
+		Target->SetMobility(Source->Mobility);
+		Target->OverrideMaterials = Source->OverrideMaterials;
+		Target->BodyInstance.CopyBodyInstancePropertiesFrom(&Source->BodyInstance);
+		Target->SetGenerateOverlapEvents(Source->GetGenerateOverlapEvents());
+		Target->CastShadow = Source->CastShadow;
+		Target->bCastDynamicShadow = Source->bCastDynamicShadow;
+		Target->bCastStaticShadow = Source->bCastStaticShadow;
+		Target->bReceivesDecals = Source->bReceivesDecals;
+		Target->bRenderInMainPass = Source->bRenderInMainPass;
+		Target->bRenderCustomDepth = Source->bRenderCustomDepth;
+		Target->CustomDepthStencilValue = Source->CustomDepthStencilValue;
+		Target->TranslucencySortPriority = Source->TranslucencySortPriority;
+		Target->ForcedLodModel = Source->ForcedLodModel;
+		Target->bOverrideLightMapRes = Source->bOverrideLightMapRes;
+		Target->OverriddenLightMapRes = Source->OverriddenLightMapRes;
+		Target->bHiddenInGame = Source->bHiddenInGame || SourceActor->bHidden;
+		Target->SetVisibility(Source->IsVisible());
+
+		// The component bounds cover all instances, so the draw distance has to be applied per instance
+		Target->LDMaxDrawDistance = Source->LDMaxDrawDistance;
+		Target->InstanceEndCullDistance = FMath::CeilToInt(Source->LDMaxDrawDistance);
+
+		Target->ReregisterComponent();
+	}
+}
+
+void FDesignerConsolidationStats::AddActor(const AActor* Actor)
+{
+	++NumActors;
+	MemoryBytes += FArchiveCountMem(const_cast<AActor*>(Actor)).GetMax();
+
+	TInlineComponentArray<UActorComponent*> Components;
+	Actor->GetComponents(Components);
+
+	for (UActorComponent* Component : Components)
+	{
+		MemoryBytes += FArchiveCountMem(Component).GetMax() + Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+
+		const UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(Component);
+		if (StaticMeshComponent == nullptr || StaticMeshComponent->GetStaticMesh() == nullptr || !StaticMeshComponent->IsVisible())
+		{
+			continue;
+		}
+
+		const UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(StaticMeshComponent);
+		if (InstancedComponent == nullptr || InstancedComponent->GetInstanceCount() > 0)
+		{
+			NumDrawCalls += StaticMeshComponent->GetStaticMesh()->GetNumSections(0);
+		}
+	}
+}
+
+FDesignerConsolidationStats& FDesignerConsolidationStats::operator+=(const FDesignerConsolidationStats& Other)
+{
+	NumActors += Other.NumActors;
+	NumDrawCalls += Other.NumDrawCalls;
+	MemoryBytes += Other.MemoryBytes;
+	return *this;
+}
+
+FDesignerConsolidationStats& FDesignerConsolidationStats::operator-=(const FDesignerConsolidationStats& Other)
+{
+	NumActors -= Other.NumActors;
+	NumDrawCalls -= Other.NumDrawCalls;
+	MemoryBytes -= Other.MemoryBytes;
+	return *this;
+}
+
+int32 FDesignerConsolidation::Consolidate(const TArray<AStaticMeshActor*>& Actors, int32 MinGroupSize, TArray<ADesignerInstanceContainer*>& OutContainers, FDesignerConsolidationStats& OutStatsBefore, FDesignerConsolidationStats& OutStatsAfter)
+{
+	using namespace DesignerConsolidation;
+
+	const int32 NumActors = Actors.Num();
+
+	// Building the keys reads a lot of scattered component data, so it is spread over all cores. Only the grouping has to be serial.
+	TArray<FGroupKey> Keys;
+	TArray<bool> bEligible;
+	Keys.SetNum(NumActors);
+	bEligible.SetNumZeroed(NumActors);
+
+	ParallelFor(NumActors, [&](int32 ActorIndex)
+	{
+		bEligible[ActorIndex] = MakeGroupKey(Actors[ActorIndex], Keys[ActorIndex]);
+	});
+
+	// Memory counting serializes the objects, which is only safe on the game thread
+	TArray<FDesignerConsolidationStats> ActorStats;
+	ActorStats.SetNum(NumActors);
+	for (int32 ActorIndex = 0; ActorIndex < NumActors; ++ActorIndex)
+	{
+		ActorStats[ActorIndex].AddActor(Actors[ActorIndex]);
+		OutStatsBefore += ActorStats[ActorIndex];
+	}
+
+	TMap<FGroupKey, int32> GroupIndices;
+	TArray<TArray<int32>> Groups;
+	for (int32 ActorIndex = 0; ActorIndex < NumActors; ++ActorIndex)
+	{
+		if (!bEligible[ActorIndex])
+		{
+			continue;
+		}
+
+		const int32* GroupIndex = GroupIndices.Find(Keys[ActorIndex]);
+		if (GroupIndex != nullptr)
+		{
+			Groups[*GroupIndex].Add(ActorIndex);
+		}
+		else
+		{
+			GroupIndices.Add(Keys[ActorIndex], Groups.Num());
+			Groups.AddDefaulted();
+			Groups.Last().Add(ActorIndex);
+		}
+	}
+
+	OutStatsAfter = OutStatsBefore;
+
+	TMap<ULevel*, ADesignerInstanceContainer*> LevelContainers;
+	TArray<FTransform> Transforms;
+	int32 NumConsolidated = 0;
+
+	// The consolidated actors are deleted and the containers selected instead
+	FDesignerBulkEditScope BulkEditScope;
+
+	for (const TArray<int32>& Group : Groups)
+	{
+		if (Group.Num() < FMath::Max(MinGroupSize, 1))
+		{
+			continue;
+		}
+
+		const FGroupKey& Key = Keys[Group[0]];
+
+		ADesignerInstanceContainer*& Container = LevelContainers.FindOrAdd(Key.Level);
+		if (Container == nullptr)
+		{
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.OverrideLevel = Key.Level;
+			Container = Key.Level->OwningWorld->SpawnActor<ADesignerInstanceContainer>(SpawnParameters);
+			Container->SetActorLabel(TEXT("DesignerConsolidated"));
+
+			if (OutContainers.Num() == 0)
+			{
+				FDesignerBulkEditScope::SelectNone();
+			}
+			FDesignerBulkEditScope::SelectActor(Container);
+			OutContainers.Add(Container);
+		}
+
+		UHierarchicalInstancedStaticMeshComponent* Component = Container->AddComponent(Key.StaticMesh);
+		CopyComponentSettings(Actors[Group[0]], Component);
+
+		Transforms.Reset(Group.Num());
+		for (int32 ActorIndex : Group)
+		{
+			Transforms.Add(Actors[ActorIndex]->GetStaticMeshComponent()->GetComponentTransform());
+		}
+		Container->AddInstancesToComponent(Component, Transforms, TArrayView<const int32>());
+
+		for (int32 ActorIndex : Group)
+		{
+			{
+				DESIGNER_LLM_SCOPE(EDesignerLLMTag::Transactions);
+				Key.Level->OwningWorld->EditorDestroyActor(Actors[ActorIndex], /*bShouldModifyLevel*/true);
+			}
+			OutStatsAfter -= ActorStats[ActorIndex];
+		}
+
+		NumConsolidated += Group.Num();
+	}
+
+	for (ADesignerInstanceContainer* Container : OutContainers)
+	{
+		OutStatsAfter.AddActor(Container);
+	}
+
+	return NumConsolidated;
+}
+
+/**
+ * designer.consolidate [selection|level|volume] [min=<Count>] [placed]
+ * Scope selection uses the selected actors, level all actors of the current level and volume
+ * all actors whose location is inside one of the selected volumes.
+ */
+static void ConsolidateCommand(const TArray<FString>& Args)
+{
+	const FString Scope = Args.Num() > 0 ? Args[0] : TEXT("selection");
+
+	int32 MinGroupSize = 2;
+	bool bPlacedOnly = false;
+	for (int32 ArgIndex = 1; ArgIndex < Args.Num(); ++ArgIndex)
+	{
+		if (!FParse::Value(*Args[ArgIndex], TEXT("min="), MinGroupSize))
+		{
+			bPlacedOnly |= Args[ArgIndex].Equals(TEXT("placed"), ESearchCase::IgnoreCase);
+		}
+	}
+
+	UWorld* World = GEditor->GetEditorWorldContext().World();
+
+	TArray<AStaticMeshActor*> Actors;
+	if (Scope.Equals(TEXT("selection"), ESearchCase::IgnoreCase))
+	{
+		for (FSelectionIterator It(GEditor->GetSelectedActorIterator()); It; ++It)
+		{
+			if (AStaticMeshActor* Actor = Cast<AStaticMeshActor>(*It))
+			{
+				Actors.Add(Actor);
+			}
+		}
+	}
+	else if (Scope.Equals(TEXT("level"), ESearchCase::IgnoreCase))
+	{
+		for (AActor* Actor : World->GetCurrentLevel()->Actors)
+		{
+			if (AStaticMeshActor* StaticMeshActor = Cast<AStaticMeshActor>(Actor))
+			{
+				Actors.Add(StaticMeshActor);
+			}
+		}
+	}
+	else if (Scope.Equals(TEXT("volume"), ESearchCase::IgnoreCase))
+	{
+		TArray<AVolume*> Volumes;
+		GEditor->GetSelectedActors()->GetSelectedObjects<AVolume>(Volumes);
+
+		for (TActorIterator<AStaticMeshActor> It(World); It; ++It)
+		{
+			const FVector Location = It->GetActorLocation();
+			if (Volumes.ContainsByPredicate([&Location](const AVolume* Volume) { return Volume->EncompassesPoint(Location); }))
+			{
+				Actors.Add(*It);
+			}
+		}
+	}
+	else
+	{
+		UE_LOG(LogDesigner, Display, TEXT("Usage: designer.consolidate [selection|level|volume] [min=<Count>] [placed]"));
+		return;
+	}
+
+	if (bPlacedOnly)
+	{
+		Actors.RemoveAll([](const AStaticMeshActor* Actor) { return !FDesignerPlacement::IsPlaced(Actor); });
+	}
+
+	if (Actors.Num() == 0)
+	{
+		UE_LOG(LogDesigner, Display, TEXT("No static mesh actors to consolidate."));
+		return;
+	}
+
+	FScopedTransaction Transaction(LOCTEXT("ConsolidateTransaction", "Designer: Consolidate Actors"));
+
+	double StartTime = FPlatformTime::Seconds();
+
+	TArray<ADesignerInstanceContainer*> Containers;
+	FDesignerConsolidationStats StatsBefore;
+	FDesignerConsolidationStats StatsAfter;
+	int32 NumConsolidated = FDesignerConsolidation::Consolidate(Actors, MinGroupSize, Containers, StatsBefore, StatsAfter);
+
+	if (NumConsolidated == 0)
+	{
+		Transaction.Cancel();
+		UE_LOG(LogDesigner, Display, TEXT("None of the %d static mesh actors could be consolidated."), Actors.Num());
+		return;
+	}
+
+	UE_LOG(LogDesigner, Display, TEXT("Consolidated %d of %d static mesh actors into %d containers in %.2f seconds."),
+		NumConsolidated, Actors.Num(), Containers.Num(), FPlatformTime::Seconds() - StartTime);
+	UE_LOG(LogDesigner, Display, TEXT("  Actors: %d -> %d"), StatsBefore.NumActors, StatsAfter.NumActors);
+	UE_LOG(LogDesigner, Display, TEXT("  Draw calls: %d -> %d"), StatsBefore.NumDrawCalls, StatsAfter.NumDrawCalls);
+	UE_LOG(LogDesigner, Display, TEXT("  Memory: %.1f KB -> %.1f KB"), StatsBefore.MemoryBytes / 1024.0, StatsAfter.MemoryBytes / 1024.0);
+}
+
+static FAutoConsoleCommand ConsolidateConsoleCommand(
+	TEXT("designer.consolidate"),
+	TEXT("Replaces groups of compatible static mesh actors with instances. Usage: designer.consolidate [selection|level|volume] [min=<Count>] [placed]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&ConsolidateCommand));
+
+#undef LOCTEXT_NAMESPACE
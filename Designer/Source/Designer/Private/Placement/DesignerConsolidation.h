@@ -0,0 +1,77 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Forward Declares
+class AActor;
+class ADesignerInstanceContainer;
+class AStaticMeshActor;
+
+/**
+ * Actor count, draw calls and memory of a set of actors
+ */
+struct FDesignerConsolidationStats
+{
+	FDesignerConsolidationStats()
+		: NumActors(0)
+		, NumDrawCalls(0)
+		, MemoryBytes(0)
+	{
+	}
+
+	/** Adds the stats of an actor and its primitive components */
+	void AddActor(const AActor* Actor);
+
+	FDesignerConsolidationStats& operator+=(const FDesignerConsolidationStats& Other);
+	FDesignerConsolidationStats& operator-=(const FDesignerConsolidationStats& Other);
+
+	/** The number of actors */
+	int32 NumActors;
+
+	/** The number of mesh sections drawn at LOD 0, an instanced component draws each section once for all of its instances */
+	int32 NumDrawCalls;
+
+	/** The object memory of the actors and components plus the resource size of the components */
+	int64 MemoryBytes;
+};
+
+/**
+ * Replaces static mesh actors with instances on instance containers.
+ * Actors are only grouped together if the instances render and collide exactly like the actors did,
+ * so they must share the mesh, the material overrides and the component settings.
+ */
+class FDesignerConsolidation
+{
+public:
+	/**
+	 * Consolidates every group of at least MinGroupSize compatible actors into an instanced component, one container per level.
+	 * Consolidated actors are destroyed. All changes are recorded in the current transaction.
+	 * Returns the number of consolidated actors.
+	 */
+	static int32 Consolidate(const TArray<AStaticMeshActor*>& Actors, int32 MinGroupSize, TArray<ADesignerInstanceContainer*>& OutContainers, FDesignerConsolidationStats& OutStatsBefore, FDesignerConsolidationStats& OutStatsAfter);
+};
@@ -0,0 +1,448 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerDensityMap.h"
+
+// Engine Includes
+#include "Engine/Texture2D.h"
+#include "Engine/World.h"
+#include "LandscapeComponent.h"
+#include "LandscapeEdit.h"
+#include "LandscapeInfo.h"
+#include "LandscapeInfoMap.h"
+#include "LandscapeLayerInfoObject.h"
+#include "LandscapeProxy.h"
+#include "UObject/ObjectKey.h"
+
+// Local Includes
+#include "DesignerModule.h"
+#include "DesignerPalette.h"
+#include "DesignerSettings.h"
+#include "Diagnostics/DesignerMemory.h"
+
+namespace DesignerDensityMap
+{
+	/** A region is sampled on the finest level where it spans at most this many cells along each axis */
+	static const int32 MaxRegionCellsPerAxis = 64;
+
+	/** Locations drawn from cells on the border of a region can fall outside of it and are drawn again, up to this many times */
+	static const int32 MaxAttemptsPerLocation = 8;
+
+	/** A cached density map together with the hash of the source it was built from */
+	struct FCachedDensityMap
+	{
+		uint32 SourceHash;
+		TSharedPtr<const FDesignerDensityMap> DensityMap;
+	};
+
+	static TMap<FObjectKey, FCachedDensityMap>& GetCache()
+	{
+		static TMap<FObjectKey, FCachedDensityMap> Cache;
+		return Cache;
+	}
+
+	/** Reads a channel of the first mip of the texture source as weights in [0, 1] */
+	static bool ReadTextureWeights(UTexture2D* Texture, EDensityMapChannel Channel, TArray<float>& OutWeights, int32& OutWidth, int32& OutHeight)
+	{
+		FTextureSource& Source = Texture->Source;
+		TArray<uint8> MipData;
+		if (!Source.IsValid() || !Source.GetMipData(MipData, 0))
+		{
+			UE_LOG(LogDesigner, Warning, TEXT("%s has no source data, it cannot be used as a density map."), *Texture->GetName());
+			return false;
+		}
+
+		OutWidth = Source.GetSizeX();
+		OutHeight = Source.GetSizeY();
+		const int32 NumTexels = OutWidth * OutHeight;
+		const int32 ChannelIndex = static_cast<int32>(Channel);
+		OutWeights.SetNumUninitialized(NumTexels);
+
+		switch (Source.GetFormat())
+		{
+		case TSF_G8:
+			for (int32 TexelIndex = 0; TexelIndex < NumTexels; ++TexelIndex)
+			{
+				OutWeights[TexelIndex] = MipData[TexelIndex] / 255.F;
+			}
+			break;
+		case TSF_BGRA8:
+		{
+			static const int32 ByteOffsets[] = { 2, 1, 0, 3 };
+			const int32 ByteOffset = ByteOffsets[ChannelIndex];
+			for (int32 TexelIndex = 0; TexelIndex < NumTexels; ++TexelIndex)
+			{
+				OutWeights[TexelIndex] = MipData[TexelIndex * 4 + ByteOffset] / 255.F;
+			}
+			break;
+		}
+		case TSF_G16:
+		{
+			const uint16* Values = reinterpret_cast<const uint16*>(MipData.GetData());
+			for (int32 TexelIndex = 0; TexelIndex < NumTexels; ++TexelIndex)
+			{
+				OutWeights[TexelIndex] = Values[TexelIndex] / 65535.F;
+			}
+			break;
+		}
+		case TSF_RGBA16:
+		{
+			const uint16* Values = reinterpret_cast<const uint16*>(MipData.GetData());
+			for (int32 TexelIndex = 0; TexelIndex < NumTexels; ++TexelIndex)
+			{
+				OutWeights[TexelIndex] = Values[TexelIndex * 4 + ChannelIndex] / 65535.F;
+			}
+			break;
+		}
+		case TSF_RGBA16F:
+		{
+			const FFloat16* Values = reinterpret_cast<const FFloat16*>(MipData.GetData());
+			for (int32 TexelIndex = 0; TexelIndex < NumTexels; ++TexelIndex)
+			{
+				OutWeights[TexelIndex] = FMath::Clamp(Values[TexelIndex * 4 + ChannelIndex].GetFloat(), 0.F, 1.F);
+			}
+			break;
+		}
+		default:
+			UE_LOG(LogDesigner, Warning, TEXT("The format of %s is not supported for density maps, use a grayscale or RGBA texture."), *Texture->GetName());
+			return false;
+		}
+
+		return true;
+	}
+
+	/** The landscape the layer is painted on, nullptr if it is not used in the world */
+	static ULandscapeInfo* FindLandscapeInfo(UWorld* World, ULandscapeLayerInfoObject* Layer)
+	{
+		for (const TPair<FGuid, ULandscapeInfo*>& Pair : ULandscapeInfoMap::GetLandscapeInfoMap(World).Map)
+		{
+			if (Pair.Value != nullptr && Pair.Value->GetLayerInfoIndex(Layer) != INDEX_NONE)
+			{
+				return Pair.Value;
+			}
+		}
+		return nullptr;
+	}
+
+	/** Changes whenever the landscape is painted, every stroke gives the weightmap sources a new id */
+	static uint32 GetLandscapeWeightsHash(ULandscapeInfo* LandscapeInfo)
+	{
+		uint32 Hash = 0;
+		for (const TPair<FIntPoint, ULandscapeComponent*>& Pair : LandscapeInfo->XYtoComponentMap)
+		{
+			Hash = HashCombine(Hash, GetTypeHash(Pair.Key));
+			for (UTexture2D* WeightmapTexture : Pair.Value->GetWeightmapTextures())
+			{
+				if (WeightmapTexture != nullptr)
+				{
+					Hash = HashCombine(Hash, GetTypeHash(WeightmapTexture->Source.GetId()));
+				}
+			}
+		}
+		return Hash;
+	}
+
+	/** Reads the weights of the layer at every landscape vertex and the world region they cover */
+	static bool ReadLandscapeWeights(ULandscapeInfo* LandscapeInfo, ULandscapeLayerInfoObject* Layer, TArray<float>& OutWeights, int32& OutWidth, int32& OutHeight, FBox2D& OutWorldBounds)
+	{
+		int32 MinX, MinY, MaxX, MaxY;
+		ALandscapeProxy* LandscapeProxy = LandscapeInfo->GetLandscapeProxy();
+		if (LandscapeProxy == nullptr || !LandscapeInfo->GetLandscapeExtent(MinX, MinY, MaxX, MaxY))
+		{
+			return false;
+		}
+
+		OutWidth = MaxX - MinX + 1;
+		OutHeight = MaxY - MinY + 1;
+
+		TArray<uint8> LayerWeights;
+		LayerWeights.SetNumZeroed(OutWidth * OutHeight);
+		FLandscapeEditDataInterface LandscapeEdit(LandscapeInfo);
+		LandscapeEdit.GetWeightDataFast(Layer, MinX, MinY, MaxX, MaxY, LayerWeights.GetData(), 0);
+
+		OutWeights.SetNumUninitialized(LayerWeights.Num());
+		for (int32 WeightIndex = 0; WeightIndex < LayerWeights.Num(); ++WeightIndex)
+		{
+			OutWeights[WeightIndex] = LayerWeights[WeightIndex] / 255.F;
+		}
+
+		// Every vertex is the center of a texel, the landscape is assumed not to be rotated
+		const FTransform LandscapeToWorld = LandscapeProxy->LandscapeActorToWorld();
+		const FVector WorldMin = LandscapeToWorld.TransformPosition(FVector(MinX - 0.5F, MinY - 0.5F, 0.F));
+		const FVector WorldMax = LandscapeToWorld.TransformPosition(FVector(MaxX + 0.5F, MaxY + 0.5F, 0.F));
+		OutWorldBounds = FBox2D(FVector2D(WorldMin), FVector2D(WorldMax));
+		return true;
+	}
+}
+
+FDesignerDensityMap::FDesignerDensityMap(TArray<float>&& Weights, int32 Width, int32 Height, const FBox2D& InWorldBounds)
+	: WorldBounds(InWorldBounds)
+{
+	check(Width > 0 && Height > 0 && Weights.Num() == Width * Height);
+
+	TexelSize = WorldBounds.GetSize() / FVector2D(Width, Height);
+
+	Levels.Add(MoveTemp(Weights));
+	LevelSizes.Add(FIntPoint(Width, Height));
+
+	while (LevelSizes.Last().X > 1 || LevelSizes.Last().Y > 1)
+	{
+		const int32 ChildLevel = Levels.Num() - 1;
+		const FIntPoint LevelSize((LevelSizes.Last().X + 1) / 2, (LevelSizes.Last().Y + 1) / 2);
+
+		TArray<float> LevelWeights;
+		LevelWeights.SetNumUninitialized(LevelSize.X * LevelSize.Y);
+		for (int32 CellY = 0; CellY < LevelSize.Y; ++CellY)
+		{
+			for (int32 CellX = 0; CellX < LevelSize.X; ++CellX)
+			{
+				LevelWeights[CellY * LevelSize.X + CellX] =
+					GetCellWeight(ChildLevel, CellX * 2, CellY * 2) + GetCellWeight(ChildLevel, CellX * 2 + 1, CellY * 2) +
+					GetCellWeight(ChildLevel, CellX * 2, CellY * 2 + 1) + GetCellWeight(ChildLevel, CellX * 2 + 1, CellY * 2 + 1);
+			}
+		}
+
+		Levels.Add(MoveTemp(LevelWeights));
+		LevelSizes.Add(LevelSize);
+	}
+}
+
+TSharedPtr<const FDesignerDensityMap> FDesignerDensityMap::FindOrBuild(UWorld* World, const UDesignerSettings* Settings)
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Caches);
+
+	using namespace DesignerDensityMap;
+
+	check(Settings != nullptr);
+
+	UObject* Source = nullptr;
+	uint32 SourceHash = 0;
+	ULandscapeInfo* LandscapeInfo = nullptr;
+	if (Settings->DensityLayer != nullptr)
+	{
+		LandscapeInfo = World != nullptr ? FindLandscapeInfo(World, Settings->DensityLayer) : nullptr;
+		if (LandscapeInfo == nullptr)
+		{
+			UE_LOG(LogDesigner, Warning, TEXT("%s is not painted on any landscape, density is uniform."), *Settings->DensityLayer->GetName());
+			return nullptr;
+		}
+
+		Source = Settings->DensityLayer;
+		SourceHash = HashCombine(GetTypeHash(LandscapeInfo), GetLandscapeWeightsHash(LandscapeInfo));
+	}
+	else if (Settings->DensityTexture != nullptr)
+	{
+		if (!Settings->DensityTextureBounds.bIsValid)
+		{
+			UE_LOG(LogDesigner, Warning, TEXT("The density texture has no bounds, density is uniform."));
+			return nullptr;
+		}
+
+		Source = Settings->DensityTexture;
+		SourceHash = GetTypeHash(Settings->DensityTexture->Source.GetId());
+		SourceHash = HashCombine(SourceHash, GetTypeHash(static_cast<uint8>(Settings->DensityTextureChannel)));
+		SourceHash = HashCombine(SourceHash, HashCombine(GetTypeHash(Settings->DensityTextureBounds.Min), GetTypeHash(Settings->DensityTextureBounds.Max)));
+	}
+	else
+	{
+		return nullptr;
+	}
+
+	FCachedDensityMap* CachedDensityMap = GetCache().Find(FObjectKey(Source));
+	if (CachedDensityMap != nullptr && CachedDensityMap->SourceHash == SourceHash)
+	{
+		return CachedDensityMap->DensityMap;
+	}
+
+	TArray<float> Weights;
+	int32 Width = 0;
+	int32 Height = 0;
+	FBox2D Bounds = Settings->DensityTextureBounds;
+	const bool bRead = LandscapeInfo != nullptr
+		? ReadLandscapeWeights(LandscapeInfo, Settings->DensityLayer, Weights, Width, Height, Bounds)
+		: ReadTextureWeights(Settings->DensityTexture, Settings->DensityTextureChannel, Weights, Width, Height);
+	if (!bRead || Width <= 0 || Height <= 0)
+	{
+		return nullptr;
+	}
+
+	TSharedPtr<const FDesignerDensityMap> DensityMap = MakeShared<FDesignerDensityMap>(MoveTemp(Weights), Width, Height, Bounds);
+	GetCache().Add(FObjectKey(Source), { SourceHash, DensityMap });
+	return DensityMap;
+}
+
+void FDesignerDensityMap::FlushCache()
+{
+	DesignerDensityMap::GetCache().Empty();
+}
+
+void FDesignerDensityMap::GetCacheSize(int32& OutNumCached, SIZE_T& OutAllocatedSize)
+{
+	const TMap<FObjectKey, DesignerDensityMap::FCachedDensityMap>& Cache = DesignerDensityMap::GetCache();
+
+	OutNumCached = Cache.Num();
+	OutAllocatedSize = Cache.GetAllocatedSize();
+	for (const TPair<FObjectKey, DesignerDensityMap::FCachedDensityMap>& Pair : Cache)
+	{
+		OutAllocatedSize += sizeof(FDesignerDensityMap) + Pair.Value.DensityMap->GetAllocatedSize();
+	}
+}
+
+SIZE_T FDesignerDensityMap::GetAllocatedSize() const
+{
+	SIZE_T AllocatedSize = Levels.GetAllocatedSize() + LevelSizes.GetAllocatedSize();
+	for (const TArray<float>& Level : Levels)
+	{
+		AllocatedSize += Level.GetAllocatedSize();
+	}
+	return AllocatedSize;
+}
+
+void FDesignerDensityMap::DrawLocations(const FBox2D& InRegion, float Density, FRandomStream& RandomStream, TArray<FVector2D>& OutLocations) const
+{
+	using namespace DesignerDensityMap;
+
+	const FBox2D Region(FVector2D::Max(InRegion.Min, WorldBounds.Min), FVector2D::Min(InRegion.Max, WorldBounds.Max));
+	if (Region.Min.X >= Region.Max.X || Region.Min.Y >= Region.Max.Y)
+	{
+		return;
+	}
+
+	// The finest level where the region spans a bounded number of cells, so the setup cost does not grow with the resolution
+	int32 Level = 0;
+	FVector2D CellSize = TexelSize;
+	while (Level < Levels.Num() - 1 && FMath::Max((Region.Max.X - Region.Min.X) / CellSize.X, (Region.Max.Y - Region.Min.Y) / CellSize.Y) > MaxRegionCellsPerAxis)
+	{
+		++Level;
+		CellSize *= 2.F;
+	}
+
+	const FIntPoint LevelSize = GetLevelSize(Level);
+	const FIntPoint MinCell(
+		FMath::Clamp(FMath::FloorToInt((Region.Min.X - WorldBounds.Min.X) / CellSize.X), 0, LevelSize.X - 1),
+		FMath::Clamp(FMath::FloorToInt((Region.Min.Y - WorldBounds.Min.Y) / CellSize.Y), 0, LevelSize.Y - 1));
+	const FIntPoint MaxCell(
+		FMath::Clamp(FMath::FloorToInt((Region.Max.X - WorldBounds.Min.X) / CellSize.X), 0, LevelSize.X - 1),
+		FMath::Clamp(FMath::FloorToInt((Region.Max.Y - WorldBounds.Min.Y) / CellSize.Y), 0, LevelSize.Y - 1));
+
+	// Cells on the border of the region only count with the part of them inside of it
+	TArray<FIntPoint> Cells;
+	TArray<float> CellWeights;
+	float TotalWeight = 0.F;
+	for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+	{
+		for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+		{
+			const FVector2D CellMin = WorldBounds.Min + FVector2D(CellX, CellY) * CellSize;
+			const FVector2D OverlapSize = FVector2D::Min(CellMin + CellSize, Region.Max) - FVector2D::Max(CellMin, Region.Min);
+			const float OverlapFraction = FMath::Max(OverlapSize.X, 0.F) * FMath::Max(OverlapSize.Y, 0.F) / (CellSize.X * CellSize.Y);
+
+			const float CellWeight = GetCellWeight(Level, CellX, CellY) * OverlapFraction;
+			if (CellWeight > 0.F)
+			{
+				Cells.Add(FIntPoint(CellX, CellY));
+				CellWeights.Add(CellWeight);
+				TotalWeight += CellWeight;
+			}
+		}
+	}
+
+	// A weight of one over a texel is the full density over the area of that texel
+	const float ExpectedCount = TotalWeight * (TexelSize.X * TexelSize.Y / 10000.F) * Density;
+	int32 NumLocations = FMath::FloorToInt(ExpectedCount);
+	if (RandomStream.FRand() < ExpectedCount - NumLocations)
+	{
+		++NumLocations;
+	}
+
+	if (NumLocations <= 0)
+	{
+		return;
+	}
+
+	FDesignerAliasTable CellTable;
+	CellTable.Build(CellWeights);
+
+	OutLocations.Reserve(OutLocations.Num() + NumLocations);
+	for (int32 LocationIndex = 0; LocationIndex < NumLocations; ++LocationIndex)
+	{
+		for (int32 Attempt = 0; Attempt < MaxAttemptsPerLocation; ++Attempt)
+		{
+			const FIntPoint Texel = DescendToTexel(Level, Cells[CellTable.Sample(RandomStream)], RandomStream);
+			const FVector2D Location = WorldBounds.Min + (FVector2D(Texel) + FVector2D(RandomStream.FRand(), RandomStream.FRand())) * TexelSize;
+			if (Region.IsInside(Location))
+			{
+				OutLocations.Add(Location);
+				break;
+			}
+		}
+	}
+}
+
+float FDesignerDensityMap::GetCellWeight(int32 Level, int32 CellX, int32 CellY) const
+{
+	const FIntPoint& LevelSize = LevelSizes[Level];
+	if (CellX >= LevelSize.X || CellY >= LevelSize.Y)
+	{
+		return 0.F;
+	}
+	return Levels[Level][CellY * LevelSize.X + CellX];
+}
+
+FIntPoint FDesignerDensityMap::DescendToTexel(int32 Level, FIntPoint Cell, FRandomStream& RandomStream) const
+{
+	for (; Level > 0; --Level)
+	{
+		const int32 ChildLevel = Level - 1;
+		const FIntPoint FirstChild(Cell.X * 2, Cell.Y * 2);
+		const float ChildWeights[4] =
+		{
+			GetCellWeight(ChildLevel, FirstChild.X, FirstChild.Y),
+			GetCellWeight(ChildLevel, FirstChild.X + 1, FirstChild.Y),
+			GetCellWeight(ChildLevel, FirstChild.X, FirstChild.Y + 1),
+			GetCellWeight(ChildLevel, FirstChild.X + 1, FirstChild.Y + 1)
+		};
+
+		// The parent holds the sum of its children, float rounding can leave a sliver for the last one
+		float Pick = RandomStream.FRand() * (ChildWeights[0] + ChildWeights[1] + ChildWeights[2] + ChildWeights[3]);
+		int32 ChildIndex = 0;
+		for (; ChildIndex < 3; ++ChildIndex)
+		{
+			if (ChildWeights[ChildIndex] > 0.F && Pick < ChildWeights[ChildIndex])
+			{
+				break;
+			}
+			Pick -= ChildWeights[ChildIndex];
+		}
+		while (ChildWeights[ChildIndex] <= 0.F && ChildIndex > 0)
+		{
+			--ChildIndex;
+		}
+
+		Cell = FIntPoint(FirstChild.X + (ChildIndex & 1), FirstChild.Y + (ChildIndex >> 1));
+	}
+
+	return Cell;
+}
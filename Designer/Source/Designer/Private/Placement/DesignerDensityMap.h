@@ -0,0 +1,92 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Forward Declares
+class UDesignerSettings;
+class UWorld;
+
+/**
+ * A placement density mask over a world xy region, for importance sampling placement locations.
+ *
+ * The mask is kept as a pyramid where every cell holds the sum of the four cells below it. Sampling a region picks
+ * a cell of a coarse level that spans the region in a bounded number of cells and walks down to a single texel, so
+ * the cost of a sample does not depend on the resolution of the mask.
+ */
+class FDesignerDensityMap
+{
+public:
+	/** Builds the pyramid over a mask of Width x Height weights in [0, 1], the first row lies at the minimum y of WorldBounds */
+	FDesignerDensityMap(TArray<float>&& Weights, int32 Width, int32 Height, const FBox2D& WorldBounds);
+
+	/**
+	 * Returns the density map of the settings, from the landscape layer or the density texture.
+	 * The map is built from the CPU side source data on first use and cached until the source changes.
+	 * Returns nullptr if the settings have no density map or it could not be read.
+	 */
+	static TSharedPtr<const FDesignerDensityMap> FindOrBuild(UWorld* World, const UDesignerSettings* Settings);
+
+	/** Drops all cached density maps */
+	static void FlushCache();
+
+	/** The number of cached density maps and the memory they hold */
+	static void GetCacheSize(int32& OutNumCached, SIZE_T& OutAllocatedSize);
+
+	/** The memory held by the pyramid */
+	SIZE_T GetAllocatedSize() const;
+
+	/**
+	 * Draws the locations in the region for a density in placements per square meter at full weight.
+	 * The number of locations matches the painted density of the region, the fraction is resolved randomly.
+	 */
+	void DrawLocations(const FBox2D& Region, float Density, FRandomStream& RandomStream, TArray<FVector2D>& OutLocations) const;
+
+private:
+	/** The size of a level of the pyramid */
+	FIntPoint GetLevelSize(int32 Level) const
+	{
+		return LevelSizes[Level];
+	}
+
+	/** The summed weight of a cell, zero outside of the level */
+	float GetCellWeight(int32 Level, int32 CellX, int32 CellY) const;
+
+	/** Walks down from a cell to one of its texels, picking children by weight */
+	FIntPoint DescendToTexel(int32 Level, FIntPoint Cell, FRandomStream& RandomStream) const;
+
+private:
+	/** The levels of the pyramid, the first one holds the weights of the texels */
+	TArray<TArray<float>> Levels;
+	TArray<FIntPoint> LevelSizes;
+
+	/** The world xy region covered by the mask */
+	FBox2D WorldBounds;
+
+	/** The world size of a texel */
+	FVector2D TexelSize;
+};
@@ -0,0 +1,179 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerFootprint.h"
+
+// Engine Includes
+#include "CollisionQueryParams.h"
+#include "Engine/World.h"
+
+// Local Includes
+#include "Diagnostics/DesignerPerfHUD.h"
+
+namespace DesignerFootprint
+{
+	/** A plane needs at least three contacts that are not on a line */
+	static const int32 MinContacts = 3;
+
+	/** How far above and below the footprint the rays start and end, relative to its size */
+	static const float TraceHeightScale = 2.F;
+}
+
+FDesignerFootprintSampler::FDesignerFootprintSampler()
+	: SurfaceTransform(FTransform::Identity)
+{
+}
+
+void FDesignerFootprintSampler::Request(UWorld* InWorld, const FTransform& InSurfaceTransform, float HalfSize, int32 RaysPerAxis, const AActor* IgnoredActor)
+{
+	check(InWorld != nullptr);
+
+	FDesignerPerfScope PerfScope(EDesignerPerfCategory::Trace);
+
+	Cancel();
+
+	World = InWorld;
+	SurfaceTransform = InSurfaceTransform;
+	SurfaceTransform.SetScale3D(FVector::OneVector);
+
+	RaysPerAxis = FMath::Max(RaysPerAxis, 2);
+	HalfSize = FMath::Max(HalfSize, 1.F);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(DesignerFootprint), /*bTraceComplex*/true, IgnoredActor);
+	FCollisionObjectQueryParams ObjectQueryParams(FCollisionObjectQueryParams::InitType::AllStaticObjects);
+
+	const float TraceHeight = HalfSize * DesignerFootprint::TraceHeightScale;
+	const float Step = 2.F * HalfSize / (RaysPerAxis - 1);
+	for (int32 RayY = 0; RayY < RaysPerAxis; ++RayY)
+	{
+		for (int32 RayX = 0; RayX < RaysPerAxis; ++RayX)
+		{
+			const FVector LocalOffset(RayX * Step - HalfSize, RayY * Step - HalfSize, 0.F);
+			const FVector TraceStart = SurfaceTransform.TransformPosition(LocalOffset + FVector(0.F, 0.F, TraceHeight));
+			const FVector TraceEnd = SurfaceTransform.TransformPosition(LocalOffset - FVector(0.F, 0.F, TraceHeight));
+			TraceHandles.Add(InWorld->AsyncLineTraceByObjectType(EAsyncTraceType::Single, TraceStart, TraceEnd, ObjectQueryParams, QueryParams));
+		}
+	}
+
+	FDesignerPerfHUD::AddTraces(RaysPerAxis * RaysPerAxis);
+}
+
+bool FDesignerFootprintSampler::Poll(FDesignerFootprint& OutFootprint)
+{
+	FDesignerPerfScope PerfScope(EDesignerPerfCategory::Trace);
+
+	UWorld* TraceWorld = World.Get();
+	if (TraceWorld == nullptr || TraceHandles.Num() == 0)
+	{
+		Cancel();
+		return false;
+	}
+
+	FTraceDatum TraceDatum;
+	for (int32 HandleIndex = TraceHandles.Num() - 1; HandleIndex >= 0; --HandleIndex)
+	{
+		const FTraceHandle& TraceHandle = TraceHandles[HandleIndex];
+
+		// Trace data is only kept for a frame after it finished, a request that was not polled in time is dropped
+		if (!TraceWorld->IsTraceHandleValid(TraceHandle, /*bOverlapTrace*/false))
+		{
+			Cancel();
+			return false;
+		}
+
+		if (TraceWorld->QueryTraceData(TraceHandle, TraceDatum))
+		{
+			if (TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit)
+			{
+				Contacts.Add(TraceDatum.OutHits[0].ImpactPoint);
+			}
+			TraceHandles.RemoveAtSwap(HandleIndex, 1, /*bAllowShrinking*/false);
+		}
+	}
+
+	if (TraceHandles.Num() > 0)
+	{
+		return false;
+	}
+
+	const bool bFitted = FitFootprint(OutFootprint);
+	Contacts.Reset();
+	return bFitted;
+}
+
+void FDesignerFootprintSampler::Cancel()
+{
+	TraceHandles.Reset();
+	Contacts.Reset();
+}
+
+bool FDesignerFootprintSampler::FitFootprint(FDesignerFootprint& OutFootprint) const
+{
+	if (Contacts.Num() < DesignerFootprint::MinContacts)
+	{
+		return false;
+	}
+
+	// Least squares fit of z = A * x + B * y + C in the surface frame, solved with Cramer's rule
+	TArray<FVector, TInlineAllocator<64>> LocalContacts;
+	double SumXX = 0.0, SumXY = 0.0, SumYY = 0.0, SumX = 0.0, SumY = 0.0;
+	double SumXZ = 0.0, SumYZ = 0.0, SumZ = 0.0;
+	for (const FVector& Contact : Contacts)
+	{
+		const FVector& LocalContact = LocalContacts.Add_GetRef(SurfaceTransform.InverseTransformPosition(Contact));
+		SumXX += LocalContact.X * LocalContact.X;
+		SumXY += LocalContact.X * LocalContact.Y;
+		SumYY += LocalContact.Y * LocalContact.Y;
+		SumX += LocalContact.X;
+		SumY += LocalContact.Y;
+		SumXZ += LocalContact.X * LocalContact.Z;
+		SumYZ += LocalContact.Y * LocalContact.Z;
+		SumZ += LocalContact.Z;
+	}
+	const double Count = Contacts.Num();
+
+	const double Determinant = SumXX * (SumYY * Count - SumY * SumY) - SumXY * (SumXY * Count - SumY * SumX) + SumX * (SumXY * SumY - SumYY * SumX);
+	if (FMath::Abs(Determinant) <= KINDA_SMALL_NUMBER * SumXX * SumYY * Count)
+	{
+		// The contacts are on a line, there is no plane through them
+		return false;
+	}
+
+	const double A = (SumXZ * (SumYY * Count - SumY * SumY) - SumXY * (SumYZ * Count - SumY * SumZ) + SumX * (SumYZ * SumY - SumYY * SumZ)) / Determinant;
+	const double B = (SumXX * (SumYZ * Count - SumZ * SumY) - SumXZ * (SumXY * Count - SumY * SumX) + SumX * (SumXY * SumZ - SumYZ * SumX)) / Determinant;
+	const double C = (SumXX * (SumYY * SumZ - SumYZ * SumY) - SumXY * (SumXY * SumZ - SumYZ * SumX) + SumXZ * (SumXY * SumY - SumYY * SumX)) / Determinant;
+
+	// Lower the plane to the lowest contact so no part of the footprint floats above the surface
+	float ContactOffset = 0.F;
+	for (const FVector& LocalContact : LocalContacts)
+	{
+		ContactOffset = FMath::Min(ContactOffset, static_cast<float>(LocalContact.Z - (A * LocalContact.X + B * LocalContact.Y + C)));
+	}
+
+	OutFootprint.Location = SurfaceTransform.TransformPosition(FVector(0.F, 0.F, static_cast<float>(C) + ContactOffset));
+	OutFootprint.Normal = SurfaceTransform.TransformVectorNoScale(FVector(static_cast<float>(-A), static_cast<float>(-B), 1.F).GetSafeNormal());
+	OutFootprint.NumContacts = Contacts.Num();
+	return true;
+}
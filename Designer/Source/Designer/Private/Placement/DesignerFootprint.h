@@ -0,0 +1,94 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "WorldCollision.h"
+
+// Forward Declares
+class AActor;
+class UWorld;
+
+/**
+ * The surface under the footprint of an asset
+ */
+struct FDesignerFootprint
+{
+	/** The point under the center of the footprint, lowered so the footprint touches the lowest contact */
+	FVector Location;
+
+	/** The normal of the plane fitted through the contacts */
+	FVector Normal;
+
+	/** The number of rays that hit the surface */
+	int32 NumContacts;
+};
+
+/**
+ * Samples the surface under a square footprint with a grid of asynchronous traces.
+ *
+ * The traces are run by the world between frames, so requesting a footprint never blocks the game thread.
+ * Poll returns the fitted surface once all traces of the latest request are in, older requests are dropped.
+ */
+class FDesignerFootprintSampler
+{
+public:
+	FDesignerFootprintSampler();
+
+	/**
+	 * Starts tracing a footprint of HalfSize cm around the origin of SurfaceTransform, in the plane of its x and y axes.
+	 * Replaces a request that is still pending.
+	 */
+	void Request(UWorld* World, const FTransform& SurfaceTransform, float HalfSize, int32 RaysPerAxis, const AActor* IgnoredActor);
+
+	/** Collects the finished traces. Returns true when the latest request completed with enough contacts to fit a plane */
+	bool Poll(FDesignerFootprint& OutFootprint);
+
+	/** Drops the pending request */
+	void Cancel();
+
+	bool IsPending() const
+	{
+		return TraceHandles.Num() > 0;
+	}
+
+private:
+	/** Fits a plane through the contacts in the frame of the surface transform */
+	bool FitFootprint(FDesignerFootprint& OutFootprint) const;
+
+private:
+	/** The world the traces were requested in */
+	TWeakObjectPtr<UWorld> World;
+
+	/** The frame of the pending request */
+	FTransform SurfaceTransform;
+
+	/** The traces of the pending request that did not finish yet */
+	TArray<FTraceHandle> TraceHandles;
+
+	/** The contacts of the pending request, in world space */
+	TArray<FVector> Contacts;
+};
@@ -0,0 +1,315 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerLandscapeHeightfield.h"
+
+// Engine Includes
+#include "Engine/Texture2D.h"
+#include "Engine/World.h"
+#include "LandscapeComponent.h"
+#include "LandscapeDataAccess.h"
+#include "LandscapeEdit.h"
+#include "LandscapeInfo.h"
+#include "LandscapeInfoMap.h"
+#include "LandscapeProxy.h"
+#include "UObject/ObjectKey.h"
+
+// Local Includes
+#include "Diagnostics/DesignerMemory.h"
+
+namespace DesignerLandscapeHeightfield
+{
+	/** A cached heightfield together with the hash of the landscape state it was built from */
+	struct FCachedHeightfield
+	{
+		uint32 SourceHash;
+		TSharedPtr<const FDesignerLandscapeHeightfield> Heightfield;
+	};
+
+	static TMap<FObjectKey, FCachedHeightfield>& GetCache()
+	{
+		static TMap<FObjectKey, FCachedHeightfield> Cache;
+		return Cache;
+	}
+
+	/** Changes whenever the landscape is sculpted, painted or moved, every edit gives the texture sources a new id */
+	static uint32 GetLandscapeHash(ULandscapeInfo* LandscapeInfo, const FTransform& LandscapeToWorld)
+	{
+		uint32 Hash = HashCombine(GetTypeHash(LandscapeToWorld.GetLocation()), GetTypeHash(LandscapeToWorld.GetScale3D()));
+		Hash = HashCombine(Hash, GetTypeHash(LandscapeToWorld.GetRotation().Euler()));
+		for (const TPair<FIntPoint, ULandscapeComponent*>& Pair : LandscapeInfo->XYtoComponentMap)
+		{
+			Hash = HashCombine(Hash, GetTypeHash(Pair.Key));
+			if (UTexture2D* HeightmapTexture = Pair.Value->GetHeightmap())
+			{
+				Hash = HashCombine(Hash, GetTypeHash(HeightmapTexture->Source.GetId()));
+			}
+			for (UTexture2D* WeightmapTexture : Pair.Value->GetWeightmapTextures())
+			{
+				if (WeightmapTexture != nullptr)
+				{
+					Hash = HashCombine(Hash, GetTypeHash(WeightmapTexture->Source.GetId()));
+				}
+			}
+		}
+		return Hash;
+	}
+
+	/** Reads the heights and holes of every landscape vertex */
+	static TSharedPtr<const FDesignerLandscapeHeightfield> BuildHeightfield(ULandscapeInfo* LandscapeInfo, const FTransform& LandscapeToWorld)
+	{
+		int32 MinX, MinY, MaxX, MaxY;
+		if (!LandscapeInfo->GetLandscapeExtent(MinX, MinY, MaxX, MaxY) || MaxX <= MinX || MaxY <= MinY)
+		{
+			return nullptr;
+		}
+
+		const int32 Width = MaxX - MinX + 1;
+		const int32 Height = MaxY - MinY + 1;
+
+		FLandscapeEditDataInterface LandscapeEdit(LandscapeInfo);
+
+		TArray<uint16> HeightData;
+		HeightData.SetNumZeroed(Width * Height);
+		LandscapeEdit.GetHeightDataFast(MinX, MinY, MaxX, MaxY, HeightData.GetData(), 0);
+
+		TArray<float> Heights;
+		Heights.SetNumUninitialized(HeightData.Num());
+		for (int32 VertexIndex = 0; VertexIndex < HeightData.Num(); ++VertexIndex)
+		{
+			Heights[VertexIndex] = LandscapeDataAccess::GetLocalHeight(HeightData[VertexIndex]);
+		}
+
+		// Any visibility weight counts as a hole, those quads are left to the physics traces which know the exact shape
+		TArray<bool> Holes;
+		if (LandscapeInfo->GetLayerInfoIndex(ALandscapeProxy::VisibilityLayer) != INDEX_NONE)
+		{
+			TArray<uint8> HoleData;
+			HoleData.SetNumZeroed(Width * Height);
+			LandscapeEdit.GetWeightDataFast(ALandscapeProxy::VisibilityLayer, MinX, MinY, MaxX, MaxY, HoleData.GetData(), 0);
+
+			Holes.SetNumUninitialized(HoleData.Num());
+			for (int32 VertexIndex = 0; VertexIndex < HoleData.Num(); ++VertexIndex)
+			{
+				Holes[VertexIndex] = HoleData[VertexIndex] > 0;
+			}
+		}
+
+		return MakeShared<FDesignerLandscapeHeightfield>(MoveTemp(Heights), MoveTemp(Holes), Width, Height, FIntPoint(MinX, MinY), LandscapeToWorld);
+	}
+}
+
+FDesignerLandscapeHeightfield::FDesignerLandscapeHeightfield(TArray<float>&& InHeights, TArray<bool>&& InHoles, int32 InWidth, int32 InHeight, const FIntPoint& InMinVertex, const FTransform& InLandscapeToWorld)
+	: Heights(MoveTemp(InHeights))
+	, Holes(MoveTemp(InHoles))
+	, Width(InWidth)
+	, Height(InHeight)
+	, MinVertex(InMinVertex)
+	, LandscapeToWorld(InLandscapeToWorld)
+	, WorldBounds(ForceInit)
+{
+	check(Width > 1 && Height > 1 && Heights.Num() == Width * Height);
+	check(Holes.Num() == 0 || Holes.Num() == Heights.Num());
+
+	// Without pitch or roll the vertex coordinates of a world location do not depend on its height
+	VertexOrigin = FVector2D(LandscapeToWorld.InverseTransformPosition(FVector::ZeroVector)) - FVector2D(MinVertex);
+	VertexAxisX = FVector2D(LandscapeToWorld.InverseTransformVector(FVector::ForwardVector));
+	VertexAxisY = FVector2D(LandscapeToWorld.InverseTransformVector(FVector::RightVector));
+
+	for (const FIntPoint& Corner : { FIntPoint(0, 0), FIntPoint(Width - 1, 0), FIntPoint(0, Height - 1), FIntPoint(Width - 1, Height - 1) })
+	{
+		WorldBounds += FVector2D(LandscapeToWorld.TransformPosition(FVector(FVector2D(MinVertex + Corner), 0.F)));
+	}
+}
+
+void FDesignerLandscapeHeightfield::FindOrBuild(UWorld* World, const FBox& Region, TArray<TSharedPtr<const FDesignerLandscapeHeightfield>>& OutHeightfields)
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Caches);
+
+	using namespace DesignerLandscapeHeightfield;
+
+	check(World != nullptr);
+
+	const FBox2D Region2D(FVector2D(Region.Min), FVector2D(Region.Max));
+	for (const TPair<FGuid, ULandscapeInfo*>& Pair : ULandscapeInfoMap::GetLandscapeInfoMap(World).Map)
+	{
+		ULandscapeInfo* LandscapeInfo = Pair.Value;
+		ALandscapeProxy* LandscapeProxy = LandscapeInfo != nullptr ? LandscapeInfo->GetLandscapeProxy() : nullptr;
+		if (LandscapeProxy == nullptr)
+		{
+			continue;
+		}
+
+		const FTransform LandscapeToWorld = LandscapeProxy->LandscapeActorToWorld();
+		if (!LandscapeToWorld.GetRotation().GetAxisZ().Equals(FVector::UpVector, KINDA_SMALL_NUMBER))
+		{
+			continue;
+		}
+
+		TSharedPtr<const FDesignerLandscapeHeightfield> Heightfield;
+		const uint32 SourceHash = GetLandscapeHash(LandscapeInfo, LandscapeToWorld);
+		FCachedHeightfield* CachedHeightfield = GetCache().Find(FObjectKey(LandscapeInfo));
+		if (CachedHeightfield != nullptr && CachedHeightfield->SourceHash == SourceHash)
+		{
+			Heightfield = CachedHeightfield->Heightfield;
+		}
+		else
+		{
+			Heightfield = BuildHeightfield(LandscapeInfo, LandscapeToWorld);
+			GetCache().Add(FObjectKey(LandscapeInfo), { SourceHash, Heightfield });
+		}
+
+		if (Heightfield.IsValid() && Heightfield->GetWorldBounds().Intersect(Region2D))
+		{
+			OutHeightfields.Add(Heightfield);
+		}
+	}
+}
+
+void FDesignerLandscapeHeightfield::FlushCache()
+{
+	DesignerLandscapeHeightfield::GetCache().Empty();
+}
+
+void FDesignerLandscapeHeightfield::GetCacheSize(int32& OutNumCached, SIZE_T& OutAllocatedSize)
+{
+	const TMap<FObjectKey, DesignerLandscapeHeightfield::FCachedHeightfield>& Cache = DesignerLandscapeHeightfield::GetCache();
+
+	OutNumCached = Cache.Num();
+	OutAllocatedSize = Cache.GetAllocatedSize();
+	for (const TPair<FObjectKey, DesignerLandscapeHeightfield::FCachedHeightfield>& Pair : Cache)
+	{
+		if (Pair.Value.Heightfield.IsValid())
+		{
+			OutAllocatedSize += sizeof(FDesignerLandscapeHeightfield) + Pair.Value.Heightfield->GetAllocatedSize();
+		}
+	}
+}
+
+void FDesignerLandscapeHeightfield::Sample(TArrayView<const FVector2D> Locations, TArrayView<FVector> OutLocations, TArrayView<FVector> OutNormals, TArrayView<bool> OutValid) const
+{
+	check(OutLocations.Num() >= Locations.Num() && OutNormals.Num() >= Locations.Num() && OutValid.Num() >= Locations.Num());
+
+	const VectorRegister Zero = VectorZero();
+	const VectorRegister OriginX = VectorSetFloat1(VertexOrigin.X);
+	const VectorRegister OriginY = VectorSetFloat1(VertexOrigin.Y);
+	const VectorRegister AxisXX = VectorSetFloat1(VertexAxisX.X);
+	const VectorRegister AxisXY = VectorSetFloat1(VertexAxisX.Y);
+	const VectorRegister AxisYX = VectorSetFloat1(VertexAxisY.X);
+	const VectorRegister AxisYY = VectorSetFloat1(VertexAxisY.Y);
+	const VectorRegister MaxVertexX = VectorSetFloat1(Width - 1);
+	const VectorRegister MaxVertexY = VectorSetFloat1(Height - 1);
+	const VectorRegister MaxQuadX = VectorSetFloat1(Width - 2);
+	const VectorRegister MaxQuadY = VectorSetFloat1(Height - 2);
+
+	// Normals transform with the inverse scale
+	const FQuat Rotation = LandscapeToWorld.GetRotation();
+	const FVector InverseScale = FTransform::GetSafeScaleReciprocal(LandscapeToWorld.GetScale3D());
+
+	for (int32 FirstLocation = 0; FirstLocation < Locations.Num(); FirstLocation += 4)
+	{
+		const int32 NumLanes = FMath::Min(4, Locations.Num() - FirstLocation);
+
+		// Unused lanes repeat the last location so every lane reads valid vertices
+		float WorldX[4];
+		float WorldY[4];
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			const FVector2D& Location = Locations[FirstLocation + FMath::Min(Lane, NumLanes - 1)];
+			WorldX[Lane] = Location.X;
+			WorldY[Lane] = Location.Y;
+		}
+
+		const VectorRegister LocationX = VectorLoad(WorldX);
+		const VectorRegister LocationY = VectorLoad(WorldY);
+		const VectorRegister VertexX = VectorMultiplyAdd(LocationY, AxisYX, VectorMultiplyAdd(LocationX, AxisXX, OriginX));
+		const VectorRegister VertexY = VectorMultiplyAdd(LocationY, AxisYY, VectorMultiplyAdd(LocationX, AxisXY, OriginY));
+		const int32 InsideMask = VectorMaskBits(VectorBitwiseAnd(
+			VectorBitwiseAnd(VectorCompareGE(VertexX, Zero), VectorCompareGE(MaxVertexX, VertexX)),
+			VectorBitwiseAnd(VectorCompareGE(VertexY, Zero), VectorCompareGE(MaxVertexY, VertexY))));
+
+		// The last row and column of vertices are sampled from the quads before them
+		const VectorRegister ClampedX = VectorMin(VectorMax(VertexX, Zero), MaxVertexX);
+		const VectorRegister ClampedY = VectorMin(VectorMax(VertexY, Zero), MaxVertexY);
+		const VectorRegister QuadX = VectorMin(VectorTruncate(ClampedX), MaxQuadX);
+		const VectorRegister QuadY = VectorMin(VectorTruncate(ClampedY), MaxQuadY);
+
+		float QuadXs[4];
+		float QuadYs[4];
+		VectorStore(QuadX, QuadXs);
+		VectorStore(QuadY, QuadYs);
+
+		float Heights00[4];
+		float Heights10[4];
+		float Heights01[4];
+		float Heights11[4];
+		bool bOnHole[4];
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			const int32 Vertex00 = static_cast<int32>(QuadYs[Lane]) * Width + static_cast<int32>(QuadXs[Lane]);
+			Heights00[Lane] = Heights[Vertex00];
+			Heights10[Lane] = Heights[Vertex00 + 1];
+			Heights01[Lane] = Heights[Vertex00 + Width];
+			Heights11[Lane] = Heights[Vertex00 + Width + 1];
+			bOnHole[Lane] = Holes.Num() > 0 && (Holes[Vertex00] || Holes[Vertex00 + 1] || Holes[Vertex00 + Width] || Holes[Vertex00 + Width + 1]);
+		}
+
+		// The slopes along the near and far edge give both the height and its gradient
+		const VectorRegister FractionX = VectorSubtract(ClampedX, QuadX);
+		const VectorRegister FractionY = VectorSubtract(ClampedY, QuadY);
+		const VectorRegister Height00 = VectorLoad(Heights00);
+		const VectorRegister Height01 = VectorLoad(Heights01);
+		const VectorRegister NearSlope = VectorSubtract(VectorLoad(Heights10), Height00);
+		const VectorRegister FarSlope = VectorSubtract(VectorLoad(Heights11), Height01);
+		const VectorRegister NearHeight = VectorMultiplyAdd(FractionX, NearSlope, Height00);
+		const VectorRegister FarHeight = VectorMultiplyAdd(FractionX, FarSlope, Height01);
+		const VectorRegister SlopeY = VectorSubtract(FarHeight, NearHeight);
+		const VectorRegister LocalHeight = VectorMultiplyAdd(FractionY, SlopeY, NearHeight);
+		const VectorRegister SlopeX = VectorMultiplyAdd(FractionY, VectorSubtract(FarSlope, NearSlope), NearSlope);
+
+		float VertexXs[4];
+		float VertexYs[4];
+		float LocalHeights[4];
+		float SlopesX[4];
+		float SlopesY[4];
+		VectorStore(ClampedX, VertexXs);
+		VectorStore(ClampedY, VertexYs);
+		VectorStore(LocalHeight, LocalHeights);
+		VectorStore(SlopeX, SlopesX);
+		VectorStore(SlopeY, SlopesY);
+
+		for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+		{
+			const int32 LocationIndex = FirstLocation + Lane;
+			OutValid[LocationIndex] = (InsideMask & (1 << Lane)) != 0 && !bOnHole[Lane];
+			if (OutValid[LocationIndex])
+			{
+				const FVector LocalLocation(MinVertex.X + VertexXs[Lane], MinVertex.Y + VertexYs[Lane], LocalHeights[Lane]);
+				OutLocations[LocationIndex] = LandscapeToWorld.TransformPosition(LocalLocation);
+				OutNormals[LocationIndex] = Rotation.RotateVector(FVector(-SlopesX[Lane], -SlopesY[Lane], 1.F) * InverseScale).GetSafeNormal();
+			}
+		}
+	}
+}
@@ -0,0 +1,100 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Forward Declares
+class ULandscapeInfo;
+class UWorld;
+
+/**
+ * A CPU copy of the heights of a landscape, answering surface queries without going through the physics scene.
+ *
+ * Heights are sampled bilinearly between the landscape vertices, four locations at a time. Quads touching a painted
+ * hole are not answered, so the caller can fall back to a trace there. Only landscapes rotated around z are supported.
+ */
+class FDesignerLandscapeHeightfield
+{
+public:
+	/** Takes the local heights of Width x Height vertices, the first vertex lies at MinVertex in the landscape space */
+	FDesignerLandscapeHeightfield(TArray<float>&& Heights, TArray<bool>&& Holes, int32 Width, int32 Height, const FIntPoint& MinVertex, const FTransform& LandscapeToWorld);
+
+	/**
+	 * Appends the heightfields of the landscapes overlapping the region to OutHeightfields.
+	 * Heightfields are read from the landscape edit data on first use and cached until the landscape is sculpted or moved.
+	 */
+	static void FindOrBuild(UWorld* World, const FBox& Region, TArray<TSharedPtr<const FDesignerLandscapeHeightfield>>& OutHeightfields);
+
+	/** Drops all cached heightfields */
+	static void FlushCache();
+
+	/** The number of cached heightfields and the memory they hold */
+	static void GetCacheSize(int32& OutNumCached, SIZE_T& OutAllocatedSize);
+
+	/** The memory held by the heights and holes */
+	SIZE_T GetAllocatedSize() const
+	{
+		return Heights.GetAllocatedSize() + Holes.GetAllocatedSize();
+	}
+
+	/**
+	 * Samples the surface below the world xy locations.
+	 * OutValid is set to false for locations outside of the landscape or on a quad touching a hole, their location and normal are left untouched.
+	 */
+	void Sample(TArrayView<const FVector2D> Locations, TArrayView<FVector> OutLocations, TArrayView<FVector> OutNormals, TArrayView<bool> OutValid) const;
+
+	/** The xy region covered by the heightfield */
+	const FBox2D& GetWorldBounds() const
+	{
+		return WorldBounds;
+	}
+
+private:
+	/** The local heights of the vertices, row by row */
+	TArray<float> Heights;
+
+	/** Whether a vertex is painted as a hole */
+	TArray<bool> Holes;
+
+	/** The number of vertices along x and y */
+	int32 Width;
+	int32 Height;
+
+	/** The landscape space location of the first vertex */
+	FIntPoint MinVertex;
+
+	/** The landscape space of the world, rotations around z only */
+	FTransform LandscapeToWorld;
+
+	/** Maps world xy to vertex coordinates relative to MinVertex: Origin + X * AxisX + Y * AxisY */
+	FVector2D VertexOrigin;
+	FVector2D VertexAxisX;
+	FVector2D VertexAxisY;
+
+	/** The xy region covered by the heightfield */
+	FBox2D WorldBounds;
+};
@@ -0,0 +1,506 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerOverlapFilter.h"
+
+// Engine Includes
+#include "Async/ParallelFor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+// Local Includes
+#include "DesignerInstanceContainer.h"
+#include "Placement/DesignerPlacement.h"
+
+namespace DesignerOverlapFilter
+{
+	/** The number of placements tested by a single parallel task */
+	static const int32 BatchSize = 256;
+
+	/** Boxes covering more cells than this along an axis are tested against every placement instead of being put in the grid */
+	static const int32 MaxCellsPerAxis = 64;
+
+	/** Keeps the separating axis test robust when edges are close to parallel */
+	static const float ParallelEpsilon = 1.E-4F;
+
+	/**
+	 * A uniform grid over the xy plane holding the indices of the boxes that cover each cell.
+	 * A pair of boxes is only tested in the first cell both of them cover, so no pair is tested twice.
+	 * Queries only walk the cells between the occupied extent of the grid, and walk the occupied cells instead when they are fewer.
+	 */
+	class FBoxGrid
+	{
+	public:
+		FBoxGrid(TArrayView<const FDesignerOrientedBox> InBoxes, float InCellSize)
+			: Boxes(InBoxes)
+			, CellSize(InCellSize)
+			, OccupiedMinCell(MAX_int32, MAX_int32)
+			, OccupiedMaxCell(MIN_int32, MIN_int32)
+		{
+			BoxMinCells.SetNumUninitialized(Boxes.Num());
+		}
+
+		/** Adds a box of the view the grid was created with */
+		void Add(int32 BoxIndex, const FBox& BoundingBox)
+		{
+			FIntPoint MinCell = GetCell(BoundingBox.Min);
+			FIntPoint MaxCell = GetCell(BoundingBox.Max);
+			BoxMinCells[BoxIndex] = MinCell;
+
+			if (MaxCell.X - MinCell.X >= MaxCellsPerAxis || MaxCell.Y - MinCell.Y >= MaxCellsPerAxis)
+			{
+				OversizedBoxes.Add(BoxIndex);
+				return;
+			}
+
+			OccupiedMinCell = OccupiedMinCell.ComponentMin(MinCell);
+			OccupiedMaxCell = OccupiedMaxCell.ComponentMax(MaxCell);
+
+			for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+			{
+				for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+				{
+					Cells.FindOrAdd(FIntPoint(CellX, CellY)).Add(BoxIndex);
+				}
+			}
+		}
+
+		/** Calls Visitor with the index of every box in the grid that intersects the box, until Visitor returns false */
+		template<typename VisitorType>
+		void ForEachIntersecting(const FDesignerOrientedBox& Box, const FBox& BoundingBox, VisitorType Visitor) const
+		{
+			for (int32 BoxIndex : OversizedBoxes)
+			{
+				if (FDesignerOrientedBox::Intersect(Box, Boxes[BoxIndex]) && !Visitor(BoxIndex))
+				{
+					return;
+				}
+			}
+
+			const FIntPoint MinCell = GetCell(BoundingBox.Min);
+			const FIntPoint MaxCell = GetCell(BoundingBox.Max);
+
+			// Cells outside the occupied extent are empty, so a box much larger than the placements only walks the cells that can hold anything
+			const FIntPoint FirstCell = MinCell.ComponentMax(OccupiedMinCell);
+			const FIntPoint LastCell = MaxCell.ComponentMin(OccupiedMaxCell);
+			if (FirstCell.X > LastCell.X || FirstCell.Y > LastCell.Y)
+			{
+				return;
+			}
+
+			auto VisitCell = [&](const FIntPoint& CellCoordinates, const TArray<int32>& Cell) -> bool
+			{
+				for (int32 BoxIndex : Cell)
+				{
+					const FIntPoint& BoxMinCell = BoxMinCells[BoxIndex];
+					if (FMath::Max(MinCell.X, BoxMinCell.X) != CellCoordinates.X || FMath::Max(MinCell.Y, BoxMinCell.Y) != CellCoordinates.Y)
+					{
+						continue;
+					}
+
+					if (FDesignerOrientedBox::Intersect(Box, Boxes[BoxIndex]) && !Visitor(BoxIndex))
+					{
+						return false;
+					}
+				}
+				return true;
+			};
+
+			const int64 NumRangeCells = (int64)(LastCell.X - FirstCell.X + 1) * (LastCell.Y - FirstCell.Y + 1);
+			if (NumRangeCells > Cells.Num())
+			{
+				for (const TPair<FIntPoint, TArray<int32>>& Cell : Cells)
+				{
+					const FIntPoint& CellCoordinates = Cell.Key;
+					if (CellCoordinates.X >= FirstCell.X && CellCoordinates.X <= LastCell.X && CellCoordinates.Y >= FirstCell.Y && CellCoordinates.Y <= LastCell.Y
+						&& !VisitCell(CellCoordinates, Cell.Value))
+					{
+						return;
+					}
+				}
+				return;
+			}
+
+			for (int32 CellY = FirstCell.Y; CellY <= LastCell.Y; ++CellY)
+			{
+				for (int32 CellX = FirstCell.X; CellX <= LastCell.X; ++CellX)
+				{
+					const FIntPoint CellCoordinates(CellX, CellY);
+					const TArray<int32>* Cell = Cells.Find(CellCoordinates);
+					if (Cell != nullptr && !VisitCell(CellCoordinates, *Cell))
+					{
+						return;
+					}
+				}
+			}
+		}
+
+	private:
+		FIntPoint GetCell(const FVector& Location) const
+		{
+			return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+		}
+
+	private:
+		TArrayView<const FDesignerOrientedBox> Boxes;
+		float CellSize;
+		TArray<FIntPoint> BoxMinCells;
+		TArray<int32> OversizedBoxes;
+		TMap<FIntPoint, TArray<int32>> Cells;
+
+		/** The extent of the cells that hold any box, empty while there are none */
+		FIntPoint OccupiedMinCell;
+		FIntPoint OccupiedMaxCell;
+	};
+
+	/** The local bounds of the static mesh asset, false if the asset is not a static mesh */
+	static bool GetAssetBounds(const FSoftObjectPath& AssetPath, FBox& OutLocalBox)
+	{
+		UStaticMesh* StaticMesh = Cast<UStaticMesh>(AssetPath.TryLoad());
+		if (StaticMesh == nullptr)
+		{
+			return false;
+		}
+
+		OutLocalBox = StaticMesh->GetBoundingBox();
+		return true;
+	}
+
+	/** Gathers the boxes of everything placed by the Designer tools that touches the region */
+	static void GatherPlacedContent(UWorld* World, const FBox& Region, TArray<FDesignerOrientedBox>& OutBoxes)
+	{
+		TInlineComponentArray<UStaticMeshComponent*> Components;
+		for (TActorIterator<AActor> It(World); It; ++It)
+		{
+			AActor* Actor = *It;
+			if (!Actor->IsA<ADesignerInstanceContainer>() && !FDesignerPlacement::IsPlaced(Actor))
+			{
+				continue;
+			}
+
+			Actor->GetComponents(Components);
+			for (UStaticMeshComponent* Component : Components)
+			{
+				if (Component->GetStaticMesh() == nullptr || !Component->IsRegistered() || !Component->Bounds.GetBox().Intersect(Region))
+				{
+					continue;
+				}
+
+				const FBox LocalBox = Component->GetStaticMesh()->GetBoundingBox();
+
+				UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(Component);
+				if (InstancedComponent == nullptr)
+				{
+					OutBoxes.Add(FDesignerOrientedBox::Make(LocalBox, Component->GetComponentTransform()));
+					continue;
+				}
+
+				for (int32 InstanceIndex = 0; InstanceIndex < InstancedComponent->GetInstanceCount(); ++InstanceIndex)
+				{
+					FTransform InstanceTransform;
+					InstancedComponent->GetInstanceTransform(InstanceIndex, InstanceTransform, /*bWorldSpace*/true);
+
+					FDesignerOrientedBox Box = FDesignerOrientedBox::Make(LocalBox, InstanceTransform);
+					if (Box.GetBoundingBox().Intersect(Region))
+					{
+						OutBoxes.Add(Box);
+					}
+				}
+			}
+		}
+	}
+}
+
+FDesignerOrientedBox FDesignerOrientedBox::Make(const FBox& LocalBox, const FTransform& Transform, float Padding)
+{
+	FDesignerOrientedBox Box;
+	Box.Center = Transform.TransformPosition(LocalBox.GetCenter());
+	Box.Axes[0] = Transform.GetUnitAxis(EAxis::X);
+	Box.Axes[1] = Transform.GetUnitAxis(EAxis::Y);
+	Box.Axes[2] = Transform.GetUnitAxis(EAxis::Z);
+	Box.Extent = LocalBox.GetExtent() * Transform.GetScale3D().GetAbs() + FVector(Padding);
+	return Box;
+}
+
+FBox FDesignerOrientedBox::GetBoundingBox() const
+{
+	const FVector WorldExtent = Axes[0].GetAbs() * Extent.X + Axes[1].GetAbs() * Extent.Y + Axes[2].GetAbs() * Extent.Z;
+	return FBox(Center - WorldExtent, Center + WorldExtent);
+}
+
+bool FDesignerOrientedBox::Intersect(const FDesignerOrientedBox& A, const FDesignerOrientedBox& B)
+{
+	// Gottschalk's separating axis test, each group of three axes is tested at once. The w lanes are zero and never separate.
+	// Row i of R holds the dot products of axis i of A with the axes of B, so R expresses B in the frame of A.
+	const VectorRegister BTransposedX = MakeVectorRegister(B.Axes[0].X, B.Axes[1].X, B.Axes[2].X, 0.F);
+	const VectorRegister BTransposedY = MakeVectorRegister(B.Axes[0].Y, B.Axes[1].Y, B.Axes[2].Y, 0.F);
+	const VectorRegister BTransposedZ = MakeVectorRegister(B.Axes[0].Z, B.Axes[1].Z, B.Axes[2].Z, 0.F);
+
+	VectorRegister R[3];
+	VectorRegister AbsR[3];
+	const VectorRegister Epsilon = MakeVectorRegister(DesignerOverlapFilter::ParallelEpsilon, DesignerOverlapFilter::ParallelEpsilon, DesignerOverlapFilter::ParallelEpsilon, 0.F);
+	for (int32 AxisIndex = 0; AxisIndex < 3; ++AxisIndex)
+	{
+		const FVector& Axis = A.Axes[AxisIndex];
+		R[AxisIndex] = VectorMultiplyAdd(VectorSetFloat1(Axis.X), BTransposedX, VectorMultiplyAdd(VectorSetFloat1(Axis.Y), BTransposedY, VectorMultiply(VectorSetFloat1(Axis.Z), BTransposedZ)));
+		AbsR[AxisIndex] = VectorAdd(VectorAbs(R[AxisIndex]), Epsilon);
+	}
+
+	// The offset between the centers in the frame of A
+	const FVector Offset = B.Center - A.Center;
+	const float T[3] = { Offset | A.Axes[0], Offset | A.Axes[1], Offset | A.Axes[2] };
+	const VectorRegister TVector = MakeVectorRegister(T[0], T[1], T[2], 0.F);
+
+	const VectorRegister ExtentA = VectorLoadFloat3_W0(&A.Extent);
+	const VectorRegister ExtentB = VectorLoadFloat3_W0(&B.Extent);
+
+	// The columns of AbsR, needed to project B on the axes of A
+	const VectorRegister AbsRColumn0 = MakeVectorRegister(VectorGetComponent(AbsR[0], 0), VectorGetComponent(AbsR[1], 0), VectorGetComponent(AbsR[2], 0), 0.F);
+	const VectorRegister AbsRColumn1 = MakeVectorRegister(VectorGetComponent(AbsR[0], 1), VectorGetComponent(AbsR[1], 1), VectorGetComponent(AbsR[2], 1), 0.F);
+	const VectorRegister AbsRColumn2 = MakeVectorRegister(VectorGetComponent(AbsR[0], 2), VectorGetComponent(AbsR[1], 2), VectorGetComponent(AbsR[2], 2), 0.F);
+
+	// The axes of A
+	{
+		const VectorRegister RadiusB = VectorMultiplyAdd(VectorReplicate(ExtentB, 0), AbsRColumn0, VectorMultiplyAdd(VectorReplicate(ExtentB, 1), AbsRColumn1, VectorMultiply(VectorReplicate(ExtentB, 2), AbsRColumn2)));
+		if (VectorAnyGreaterThan(VectorAbs(TVector), VectorAdd(ExtentA, RadiusB)))
+		{
+			return false;
+		}
+	}
+
+	const VectorRegister T0 = VectorSetFloat1(T[0]);
+	const VectorRegister T1 = VectorSetFloat1(T[1]);
+	const VectorRegister T2 = VectorSetFloat1(T[2]);
+	const VectorRegister ExtentA0 = VectorReplicate(ExtentA, 0);
+	const VectorRegister ExtentA1 = VectorReplicate(ExtentA, 1);
+	const VectorRegister ExtentA2 = VectorReplicate(ExtentA, 2);
+
+	// The axes of B
+	{
+		const VectorRegister Distance = VectorMultiplyAdd(T0, R[0], VectorMultiplyAdd(T1, R[1], VectorMultiply(T2, R[2])));
+		const VectorRegister RadiusA = VectorMultiplyAdd(ExtentA0, AbsR[0], VectorMultiplyAdd(ExtentA1, AbsR[1], VectorMultiply(ExtentA2, AbsR[2])));
+		if (VectorAnyGreaterThan(VectorAbs(Distance), VectorAdd(RadiusA, ExtentB)))
+		{
+			return false;
+		}
+	}
+
+	// The cross products of axis i of A with the three axes of B
+	const VectorRegister ExtentBYZX = VectorSwizzle(ExtentB, 1, 2, 0, 3);
+	const VectorRegister ExtentBZXY = VectorSwizzle(ExtentB, 2, 0, 1, 3);
+	auto RadiusB = [&](const VectorRegister& AbsRRow)
+	{
+		return VectorMultiplyAdd(ExtentBYZX, VectorSwizzle(AbsRRow, 2, 0, 1, 3), VectorMultiply(ExtentBZXY, VectorSwizzle(AbsRRow, 1, 2, 0, 3)));
+	};
+
+	{
+		const VectorRegister Distance = VectorSubtract(VectorMultiply(T2, R[1]), VectorMultiply(T1, R[2]));
+		const VectorRegister RadiusA = VectorMultiplyAdd(ExtentA1, AbsR[2], VectorMultiply(ExtentA2, AbsR[1]));
+		if (VectorAnyGreaterThan(VectorAbs(Distance), VectorAdd(RadiusA, RadiusB(AbsR[0]))))
+		{
+			return false;
+		}
+	}
+
+	{
+		const VectorRegister Distance = VectorSubtract(VectorMultiply(T0, R[2]), VectorMultiply(T2, R[0]));
+		const VectorRegister RadiusA = VectorMultiplyAdd(ExtentA0, AbsR[2], VectorMultiply(ExtentA2, AbsR[0]));
+		if (VectorAnyGreaterThan(VectorAbs(Distance), VectorAdd(RadiusA, RadiusB(AbsR[1]))))
+		{
+			return false;
+		}
+	}
+
+	{
+		const VectorRegister Distance = VectorSubtract(VectorMultiply(T1, R[0]), VectorMultiply(T0, R[1]));
+		const VectorRegister RadiusA = VectorMultiplyAdd(ExtentA0, AbsR[1], VectorMultiply(ExtentA1, AbsR[0]));
+		if (VectorAnyGreaterThan(VectorAbs(Distance), VectorAdd(RadiusA, RadiusB(AbsR[2]))))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int32 FDesignerOverlapFilter::RejectOverlaps(UWorld* World, FDesignerPlacementBatch& Batch, int32 FirstInstance, TArrayView<const float> AssetPadding)
+{
+	using namespace DesignerOverlapFilter;
+
+	check(World != nullptr);
+	check(AssetPadding.Num() == 0 || AssetPadding.Num() == Batch.Assets.Num());
+
+	const int32 NumCandidates = Batch.Instances.Num() - FirstInstance;
+	if (NumCandidates <= 0)
+	{
+		return 0;
+	}
+
+	// Loading has to happen on this thread, so the bounds of every asset are looked up once before the parallel part
+	TArray<FBox> AssetBounds;
+	TArray<bool> AssetHasBounds;
+	AssetBounds.SetNumZeroed(Batch.Assets.Num());
+	AssetHasBounds.SetNumZeroed(Batch.Assets.Num());
+	for (int32 AssetIndex = 0; AssetIndex < Batch.Assets.Num(); ++AssetIndex)
+	{
+		AssetHasBounds[AssetIndex] = GetAssetBounds(Batch.Assets[AssetIndex], AssetBounds[AssetIndex]);
+	}
+
+	TArray<FDesignerOrientedBox> CandidateBoxes;
+	TArray<FBox> CandidateBoundingBoxes;
+	TArray<bool> CandidateTested;
+	CandidateBoxes.SetNumUninitialized(NumCandidates);
+	CandidateBoundingBoxes.SetNumUninitialized(NumCandidates);
+	CandidateTested.SetNumUninitialized(NumCandidates);
+
+	const int32 NumBatches = FMath::DivideAndRoundUp(NumCandidates, BatchSize);
+	ParallelFor(NumBatches, [&](int32 BatchIndex)
+	{
+		const int32 LastCandidate = FMath::Min((BatchIndex + 1) * BatchSize, NumCandidates);
+		for (int32 CandidateIndex = BatchIndex * BatchSize; CandidateIndex < LastCandidate; ++CandidateIndex)
+		{
+			const FDesignerPlacementInstance& Instance = Batch.Instances[FirstInstance + CandidateIndex];
+			CandidateTested[CandidateIndex] = AssetHasBounds[Instance.AssetIndex];
+			if (CandidateTested[CandidateIndex])
+			{
+				const float Padding = AssetPadding.Num() > 0 ? AssetPadding[Instance.AssetIndex] : 0.F;
+				CandidateBoxes[CandidateIndex] = FDesignerOrientedBox::Make(AssetBounds[Instance.AssetIndex], Instance.Transform, Padding);
+				CandidateBoundingBoxes[CandidateIndex] = CandidateBoxes[CandidateIndex].GetBoundingBox();
+			}
+		}
+	});
+
+	FBox Region(ForceInit);
+	float AverageSize = 0.F;
+	int32 NumTested = 0;
+	for (int32 CandidateIndex = 0; CandidateIndex < NumCandidates; ++CandidateIndex)
+	{
+		if (CandidateTested[CandidateIndex])
+		{
+			const FBox& BoundingBox = CandidateBoundingBoxes[CandidateIndex];
+			Region += BoundingBox;
+			AverageSize += FMath::Max(BoundingBox.Max.X - BoundingBox.Min.X, BoundingBox.Max.Y - BoundingBox.Min.Y);
+			++NumTested;
+		}
+	}
+
+	if (NumTested == 0)
+	{
+		return 0;
+	}
+
+	// Cells about twice the size of a placement keep the number of cells per query small without crowding them
+	const float CellSize = FMath::Clamp(2.F * AverageSize / NumTested, 50.F, 10000.F);
+
+	TArray<FDesignerOrientedBox> ContentBoxes;
+	GatherPlacedContent(World, Region, ContentBoxes);
+
+	FBoxGrid ContentGrid(ContentBoxes, CellSize);
+	for (int32 BoxIndex = 0; BoxIndex < ContentBoxes.Num(); ++BoxIndex)
+	{
+		ContentGrid.Add(BoxIndex, ContentBoxes[BoxIndex].GetBoundingBox());
+	}
+
+	FBoxGrid CandidateGrid(CandidateBoxes, CellSize);
+	for (int32 CandidateIndex = 0; CandidateIndex < NumCandidates; ++CandidateIndex)
+	{
+		if (CandidateTested[CandidateIndex])
+		{
+			CandidateGrid.Add(CandidateIndex, CandidateBoundingBoxes[CandidateIndex]);
+		}
+	}
+
+	// Every batch collects the earlier candidates each of its candidates overlaps, the actual rejection is resolved in order afterwards
+	TArray<bool> OverlapsContent;
+	TArray<TArray<TPair<int32, int32>>> BatchOverlaps;
+	OverlapsContent.SetNumZeroed(NumCandidates);
+	BatchOverlaps.SetNum(NumBatches);
+
+	ParallelFor(NumBatches, [&](int32 BatchIndex)
+	{
+		TArray<TPair<int32, int32>>& Overlaps = BatchOverlaps[BatchIndex];
+		const int32 LastCandidate = FMath::Min((BatchIndex + 1) * BatchSize, NumCandidates);
+		for (int32 CandidateIndex = BatchIndex * BatchSize; CandidateIndex < LastCandidate; ++CandidateIndex)
+		{
+			if (!CandidateTested[CandidateIndex])
+			{
+				continue;
+			}
+
+			const FDesignerOrientedBox& Box = CandidateBoxes[CandidateIndex];
+			const FBox& BoundingBox = CandidateBoundingBoxes[CandidateIndex];
+
+			ContentGrid.ForEachIntersecting(Box, BoundingBox, [&](int32)
+			{
+				OverlapsContent[CandidateIndex] = true;
+				return false;
+			});
+
+			if (!OverlapsContent[CandidateIndex])
+			{
+				CandidateGrid.ForEachIntersecting(Box, BoundingBox, [&](int32 OtherIndex)
+				{
+					if (OtherIndex < CandidateIndex)
+					{
+						Overlaps.Emplace(CandidateIndex, OtherIndex);
+					}
+					return true;
+				});
+			}
+		}
+	});
+
+	// The batches are in candidate order and so are the overlaps within a batch
+	TArray<bool> Keep;
+	Keep.SetNumUninitialized(NumCandidates);
+	int32 NumKept = 0;
+	for (int32 BatchIndex = 0; BatchIndex < NumBatches; ++BatchIndex)
+	{
+		const TArray<TPair<int32, int32>>& Overlaps = BatchOverlaps[BatchIndex];
+		int32 OverlapIndex = 0;
+
+		const int32 LastCandidate = FMath::Min((BatchIndex + 1) * BatchSize, NumCandidates);
+		for (int32 CandidateIndex = BatchIndex * BatchSize; CandidateIndex < LastCandidate; ++CandidateIndex)
+		{
+			bool bKeep = !OverlapsContent[CandidateIndex];
+			for (; OverlapIndex < Overlaps.Num() && Overlaps[OverlapIndex].Key == CandidateIndex; ++OverlapIndex)
+			{
+				bKeep &= !Keep[Overlaps[OverlapIndex].Value];
+			}
+
+			Keep[CandidateIndex] = bKeep;
+			if (bKeep)
+			{
+				Batch.Instances[FirstInstance + NumKept++] = Batch.Instances[FirstInstance + CandidateIndex];
+			}
+		}
+	}
+
+	Batch.Instances.SetNum(FirstInstance + NumKept, /*bAllowShrinking*/false);
+	return NumCandidates - NumKept;
+}
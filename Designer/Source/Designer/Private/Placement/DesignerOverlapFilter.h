@@ -0,0 +1,74 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Forward Declares
+class UWorld;
+struct FDesignerPlacementBatch;
+
+/**
+ * An oriented bounding box in world space
+ */
+struct FDesignerOrientedBox
+{
+	/** The world space center */
+	FVector Center;
+
+	/** The unit length local axes in world space */
+	FVector Axes[3];
+
+	/** The half size along each of the axes */
+	FVector Extent;
+
+	/** Places a local space box with a transform, grown by Padding cm on every side */
+	static FDesignerOrientedBox Make(const FBox& LocalBox, const FTransform& Transform, float Padding = 0.F);
+
+	/** The world space axis aligned box enclosing this box */
+	FBox GetBoundingBox() const;
+
+	/** Separating axis test of two boxes, touching boxes do not intersect */
+	static bool Intersect(const FDesignerOrientedBox& A, const FDesignerOrientedBox& B);
+};
+
+/**
+ * Rejects placements whose bounds overlap content placed earlier by the Designer tools, or overlap each other.
+ *
+ * The existing content is put in a uniform grid around the placements. The placements are tested in parallel batches
+ * against the grid and against each other, earlier placements in the batch take precedence over later ones, so the
+ * result does not depend on the scheduling of the batches.
+ */
+class FDesignerOverlapFilter
+{
+public:
+	/**
+	 * Removes the instances of the batch from FirstInstance on that overlap existing content or an earlier kept instance.
+	 * AssetPadding is either empty or has the padding in cm of every asset of the batch. Assets without static mesh bounds are always kept.
+	 * Returns the number of instances that were removed.
+	 */
+	static int32 RejectOverlaps(UWorld* World, FDesignerPlacementBatch& Batch, int32 FirstInstance, TArrayView<const float> AssetPadding);
+};
@@ -0,0 +1,356 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerPlacedContentIndex.h"
+
+// Engine Includes
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+// Local Includes
+#include "DesignerInstanceContainer.h"
+#include "Diagnostics/DesignerMemory.h"
+#include "Placement/DesignerPlacement.h"
+
+namespace DesignerPlacedContentIndex
+{
+	/** The size of a grid cell in cm, brushes of a few meters touch a handful of cells */
+	static const float CellSize = 1000.F;
+}
+
+FDesignerPlacedContentIndex::FDesignerPlacedContentIndex()
+{
+}
+
+void FDesignerPlacedContentIndex::Build(UWorld* InWorld)
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Caches);
+
+	Reset();
+	World = InWorld;
+
+	if (InWorld == nullptr)
+	{
+		return;
+	}
+
+	for (TActorIterator<AActor> It(InWorld); It; ++It)
+	{
+		IndexActor(*It);
+	}
+}
+
+void FDesignerPlacedContentIndex::Reset()
+{
+	World.Reset();
+	Items.Reset();
+	FreeItems.Reset();
+	Cells.Reset();
+	ActorItems.Reset();
+	ComponentItems.Reset();
+	ContainerComponents.Reset();
+	PendingActors.Reset();
+}
+
+void FDesignerPlacedContentIndex::AddActor(AActor* Actor)
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Caches);
+
+	RemoveActor(Actor);
+
+	if (!IndexActor(Actor) && Actor != nullptr)
+	{
+		PendingActors.Add(Actor);
+	}
+}
+
+void FDesignerPlacedContentIndex::RemoveActor(const AActor* Actor)
+{
+	const FObjectKey ActorKey(Actor);
+
+	int32 ItemIndex;
+	if (ActorItems.RemoveAndCopyValue(ActorKey, ItemIndex))
+	{
+		RemoveItem(ItemIndex);
+	}
+
+	FContainerItems RemovedContainerItems;
+	if (ContainerComponents.RemoveAndCopyValue(ActorKey, RemovedContainerItems))
+	{
+		for (const FObjectKey& ComponentKey : RemovedContainerItems.ComponentKeys)
+		{
+			RemoveComponent(ComponentKey);
+		}
+	}
+}
+
+void FDesignerPlacedContentIndex::UpdateComponent(UHierarchicalInstancedStaticMeshComponent* Component)
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Caches);
+
+	const FObjectKey ComponentKey(Component);
+	RemoveComponent(ComponentKey);
+
+	ADesignerInstanceContainer* Container = Cast<ADesignerInstanceContainer>(Component->GetOwner());
+	if (Container == nullptr)
+	{
+		return;
+	}
+
+	ContainerComponents.FindOrAdd(FObjectKey(Container)).ComponentKeys.AddUnique(ComponentKey);
+
+	FComponentItems& NewComponentItems = ComponentItems.Add(ComponentKey);
+	NewComponentItems.Component = Component;
+	NewComponentItems.ItemIndices.Reserve(Component->GetInstanceCount());
+
+	FDesignerPlacedItem Item;
+	Item.Actor = Container;
+	Item.Component = Component;
+	for (int32 InstanceIndex = 0; InstanceIndex < Component->GetInstanceCount(); ++InstanceIndex)
+	{
+		FTransform InstanceTransform;
+		Component->GetInstanceTransform(InstanceIndex, InstanceTransform, /*bWorldSpace*/true);
+		Item.Location = InstanceTransform.GetLocation();
+		Item.InstanceIndex = InstanceIndex;
+		NewComponentItems.ItemIndices.Add(AddItem(Item));
+	}
+}
+
+void FDesignerPlacedContentIndex::RemoveInstances(const UHierarchicalInstancedStaticMeshComponent* Component, TArrayView<const int32> SortedInstanceIndices)
+{
+	FComponentItems* RemovedComponentItems = ComponentItems.Find(FObjectKey(Component));
+	if (RemovedComponentItems == nullptr)
+	{
+		return;
+	}
+
+	// Compact the items the same way the instances were compacted, the remaining items take the index of their instance
+	TArray<int32>& ItemIndices = RemovedComponentItems->ItemIndices;
+	int32 NextRemoved = 0;
+	int32 NumKept = 0;
+	for (int32 InstanceIndex = 0; InstanceIndex < ItemIndices.Num(); ++InstanceIndex)
+	{
+		if (NextRemoved < SortedInstanceIndices.Num() && SortedInstanceIndices[NextRemoved] == InstanceIndex)
+		{
+			RemoveItem(ItemIndices[InstanceIndex]);
+			++NextRemoved;
+			continue;
+		}
+
+		Items[ItemIndices[InstanceIndex]].InstanceIndex = NumKept;
+		ItemIndices[NumKept++] = ItemIndices[InstanceIndex];
+	}
+	ItemIndices.SetNum(NumKept, /*bAllowShrinking*/false);
+
+	// The caller keeps the index in step with the container, so the change it just made does not need a re-index
+	const ADesignerInstanceContainer* Container = Cast<ADesignerInstanceContainer>(Component->GetOwner());
+	FContainerItems* IndexedContainerItems = Container != nullptr ? ContainerComponents.Find(FObjectKey(Container)) : nullptr;
+	if (IndexedContainerItems != nullptr)
+	{
+		IndexedContainerItems->InstanceChangeStamp = Container->GetInstanceChangeStamp();
+	}
+}
+
+void FDesignerPlacedContentIndex::Refresh()
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Caches);
+
+	for (const TWeakObjectPtr<AActor>& PendingActor : PendingActors)
+	{
+		if (PendingActor.IsValid() && !ActorItems.Contains(FObjectKey(PendingActor.Get())))
+		{
+			IndexActor(PendingActor.Get());
+		}
+	}
+	PendingActors.Reset();
+
+	// Instances can be rewritten at the same count, e.g. by regenerating a spline or by undo, so the change stamp decides
+	TArray<FObjectKey> RemovedContainers;
+	TArray<ADesignerInstanceContainer*> ChangedContainers;
+	for (const TPair<FObjectKey, FContainerItems>& Pair : ContainerComponents)
+	{
+		ADesignerInstanceContainer* Container = Cast<ADesignerInstanceContainer>(Pair.Key.ResolveObjectPtr());
+		if (Container == nullptr || Container->IsPendingKill())
+		{
+			RemovedContainers.Add(Pair.Key);
+		}
+		else if (Container->GetInstanceChangeStamp() != Pair.Value.InstanceChangeStamp)
+		{
+			ChangedContainers.Add(Container);
+		}
+	}
+
+	for (const FObjectKey& ContainerKey : RemovedContainers)
+	{
+		FContainerItems RemovedContainerItems;
+		ContainerComponents.RemoveAndCopyValue(ContainerKey, RemovedContainerItems);
+		for (const FObjectKey& ComponentKey : RemovedContainerItems.ComponentKeys)
+		{
+			RemoveComponent(ComponentKey);
+		}
+	}
+
+	for (ADesignerInstanceContainer* Container : ChangedContainers)
+	{
+		RemoveActor(Container);
+		IndexActor(Container);
+	}
+}
+
+void FDesignerPlacedContentIndex::FindInRadius(const FVector& Center, float Radius, TArray<FDesignerPlacedItem>& OutItems) const
+{
+	const FIntPoint MinCell = GetCell(Center - FVector(Radius));
+	const FIntPoint MaxCell = GetCell(Center + FVector(Radius));
+	const float RadiusSquared = FMath::Square(Radius);
+
+	for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+	{
+		for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+		{
+			const TArray<int32>* CellItems = Cells.Find(FIntPoint(CellX, CellY));
+			if (CellItems == nullptr)
+			{
+				continue;
+			}
+
+			for (int32 ItemIndex : *CellItems)
+			{
+				const FDesignerPlacedItem& Item = Items[ItemIndex];
+				if (FVector::DistSquared(Item.Location, Center) <= RadiusSquared)
+				{
+					OutItems.Add(Item);
+				}
+			}
+		}
+	}
+}
+
+bool FDesignerPlacedContentIndex::IndexActor(AActor* Actor)
+{
+	if (Actor == nullptr || Actor->IsPendingKill())
+	{
+		return false;
+	}
+
+	// Containers carry the placed tag as well, their instances are indexed instead of the actor itself
+	if (ADesignerInstanceContainer* Container = Cast<ADesignerInstanceContainer>(Actor))
+	{
+		ContainerComponents.Add(FObjectKey(Container)).InstanceChangeStamp = Container->GetInstanceChangeStamp();
+		for (UHierarchicalInstancedStaticMeshComponent* Component : Container->GetInstanceComponents())
+		{
+			if (Component != nullptr)
+			{
+				UpdateComponent(Component);
+			}
+		}
+		return true;
+	}
+
+	if (FDesignerPlacement::IsPlaced(Actor))
+	{
+		FDesignerPlacedItem Item;
+		Item.Location = Actor->GetActorLocation();
+		Item.Actor = Actor;
+		Item.InstanceIndex = INDEX_NONE;
+		ActorItems.Add(FObjectKey(Actor), AddItem(Item));
+		return true;
+	}
+
+	return false;
+}
+
+int32 FDesignerPlacedContentIndex::AddItem(const FDesignerPlacedItem& Item)
+{
+	int32 ItemIndex;
+	if (FreeItems.Num() > 0)
+	{
+		ItemIndex = FreeItems.Pop(/*bAllowShrinking*/false);
+		Items[ItemIndex] = Item;
+	}
+	else
+	{
+		ItemIndex = Items.Add(Item);
+	}
+
+	Cells.FindOrAdd(GetCell(Item.Location)).Add(ItemIndex);
+	return ItemIndex;
+}
+
+void FDesignerPlacedContentIndex::RemoveItem(int32 ItemIndex)
+{
+	const FIntPoint Cell = GetCell(Items[ItemIndex].Location);
+	TArray<int32>* CellItems = Cells.Find(Cell);
+	if (CellItems != nullptr)
+	{
+		CellItems->RemoveSingleSwap(ItemIndex, /*bAllowShrinking*/false);
+		if (CellItems->Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+
+	Items[ItemIndex].Actor.Reset();
+	Items[ItemIndex].Component.Reset();
+	FreeItems.Add(ItemIndex);
+}
+
+void FDesignerPlacedContentIndex::RemoveComponent(const FObjectKey& ComponentKey)
+{
+	FComponentItems RemovedComponentItems;
+	if (ComponentItems.RemoveAndCopyValue(ComponentKey, RemovedComponentItems))
+	{
+		for (int32 ItemIndex : RemovedComponentItems.ItemIndices)
+		{
+			RemoveItem(ItemIndex);
+		}
+	}
+}
+
+SIZE_T FDesignerPlacedContentIndex::GetAllocatedSize() const
+{
+	SIZE_T AllocatedSize = Items.GetAllocatedSize() + FreeItems.GetAllocatedSize() + Cells.GetAllocatedSize() + ActorItems.GetAllocatedSize()
+		+ ComponentItems.GetAllocatedSize() + ContainerComponents.GetAllocatedSize() + PendingActors.GetAllocatedSize();
+	for (const TPair<FIntPoint, TArray<int32>>& Pair : Cells)
+	{
+		AllocatedSize += Pair.Value.GetAllocatedSize();
+	}
+	for (const TPair<FObjectKey, FComponentItems>& Pair : ComponentItems)
+	{
+		AllocatedSize += Pair.Value.ItemIndices.GetAllocatedSize();
+	}
+	for (const TPair<FObjectKey, FContainerItems>& Pair : ContainerComponents)
+	{
+		AllocatedSize += Pair.Value.ComponentKeys.GetAllocatedSize();
+	}
+	return AllocatedSize;
+}
+
+FIntPoint FDesignerPlacedContentIndex::GetCell(const FVector& Location) const
+{
+	return FIntPoint(
+		FMath::FloorToInt(Location.X / DesignerPlacedContentIndex::CellSize),
+		FMath::FloorToInt(Location.Y / DesignerPlacedContentIndex::CellSize));
+}
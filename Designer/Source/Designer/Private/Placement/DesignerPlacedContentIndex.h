@@ -0,0 +1,164 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+// Forward Declares
+class AActor;
+class UHierarchicalInstancedStaticMeshComponent;
+class UWorld;
+
+/**
+ * A single piece of content placed by the Designer tools, either a placed actor or one instance of an instance container
+ */
+struct FDesignerPlacedItem
+{
+	FVector Location;
+
+	/** The placed actor, or the instance container owning the instance */
+	TWeakObjectPtr<AActor> Actor;
+
+	/** The instanced component holding the instance, unset for actors */
+	TWeakObjectPtr<UHierarchicalInstancedStaticMeshComponent> Component;
+
+	/** The index of the instance in its component, INDEX_NONE for actors */
+	int32 InstanceIndex;
+};
+
+/**
+ * The placed actors and container instances of a world, bucketed in a uniform grid over the xy plane for radius lookups.
+ *
+ * Instances are indexed one by one and keep their index in the component, so removing instances through the index
+ * shifts the indices of the instances after them the same way the container does.
+ */
+class FDesignerPlacedContentIndex
+{
+public:
+	FDesignerPlacedContentIndex();
+
+	/** Indexes every placed actor and container instance of the world, replacing the current content */
+	void Build(UWorld* World);
+
+	/** Removes all items */
+	void Reset();
+
+	/**
+	 * Indexes a placed actor or all instances of a container, replacing the items it already had.
+	 * Other actors are checked again on the next Refresh, since the placed tag is only added after an actor is spawned.
+	 */
+	void AddActor(AActor* Actor);
+
+	/** Removes the items of the actor */
+	void RemoveActor(const AActor* Actor);
+
+	/** Re-indexes all instances of a container component */
+	void UpdateComponent(UHierarchicalInstancedStaticMeshComponent* Component);
+
+	/**
+	 * Removes the items of the instances that were just removed from the component, SortedInstanceIndices is sorted ascending.
+	 * Call it once the container finished its changes, the index then takes the container as up to date.
+	 */
+	void RemoveInstances(const UHierarchicalInstancedStaticMeshComponent* Component, TArrayView<const int32> SortedInstanceIndices);
+
+	/** Indexes the actors that were tagged as placed, and re-indexes the containers whose instances changed without the index being told */
+	void Refresh();
+
+	/** Appends the items within the radius of the center */
+	void FindInRadius(const FVector& Center, float Radius, TArray<FDesignerPlacedItem>& OutItems) const;
+
+	/** The world the index was built for */
+	UWorld* GetWorld() const
+	{
+		return World.Get();
+	}
+
+	/** The number of indexed items */
+	int32 Num() const
+	{
+		return Items.Num() - FreeItems.Num();
+	}
+
+	/** The memory held by the index */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	/** The items of one container component, in instance order */
+	struct FComponentItems
+	{
+		TWeakObjectPtr<UHierarchicalInstancedStaticMeshComponent> Component;
+		TArray<int32> ItemIndices;
+	};
+
+	/** The indexed components of one container */
+	struct FContainerItems
+	{
+		TArray<FObjectKey> ComponentKeys;
+
+		/** The instance change stamp of the container when it was indexed */
+		uint64 InstanceChangeStamp = 0;
+	};
+
+	/** Indexes the actor if it is placed content. Returns false if it is not */
+	bool IndexActor(AActor* Actor);
+
+	/** Adds an item to its grid cell, reusing a free slot if there is one */
+	int32 AddItem(const FDesignerPlacedItem& Item);
+
+	/** Removes an item from its grid cell and frees its slot */
+	void RemoveItem(int32 ItemIndex);
+
+	/** Removes the items of a component */
+	void RemoveComponent(const FObjectKey& ComponentKey);
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+private:
+	/** The world the index was built for */
+	TWeakObjectPtr<UWorld> World;
+
+	/** All item slots, including free ones */
+	TArray<FDesignerPlacedItem> Items;
+
+	/** The slots of removed items */
+	TArray<int32> FreeItems;
+
+	/** The items in every occupied grid cell */
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	/** The item of every indexed placed actor */
+	TMap<FObjectKey, int32> ActorItems;
+
+	/** The items of every indexed container component */
+	TMap<FObjectKey, FComponentItems> ComponentItems;
+
+	/** The indexed components of every container */
+	TMap<FObjectKey, FContainerItems> ContainerComponents;
+
+	/** Actors added since the last refresh that were not placed content yet */
+	TArray<TWeakObjectPtr<AActor>> PendingActors;
+};
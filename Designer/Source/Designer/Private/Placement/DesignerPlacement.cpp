@@ -0,0 +1,306 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerPlacement.h"
+
+// Engine Includes
+#include "AssetSelection.h"
+#include "Engine/Level.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "Serialization/Archive.h"
+
+// Local Includes
+#include "DesignerInstanceContainer.h"
+#include "DesignerModule.h"
+#include "Diagnostics/DesignerMemory.h"
+#include "Diagnostics/DesignerPerfHUD.h"
+#include "Placement/DesignerBulkEditScope.h"
+
+namespace DesignerPlacementBatchFile
+{
+	/** "DPLB" */
+	static const uint32 Magic = 0x44504C42;
+	static const int32 Version = 1;
+}
+
+const FName FDesignerPlacement::PlacedActorTag(TEXT("DesignerPlaced"));
+
+FArchive& operator<<(FArchive& Ar, FDesignerPlacementInstance& Instance)
+{
+	Ar << Instance.Transform;
+	Ar << Instance.AssetIndex;
+	Ar << Instance.Seed;
+	return Ar;
+}
+
+int32 FDesignerPlacementBatch::FindOrAddAsset(const FSoftObjectPath& AssetPath)
+{
+	int32 AssetIndex = Assets.IndexOfByKey(AssetPath);
+	if (AssetIndex == INDEX_NONE)
+	{
+		AssetIndex = Assets.Add(AssetPath);
+	}
+	return AssetIndex;
+}
+
+void FDesignerPlacementBatch::Append(const FDesignerPlacementBatch& Other)
+{
+	TArray<int32> AssetRemap;
+	AssetRemap.Reserve(Other.Assets.Num());
+	for (const FSoftObjectPath& AssetPath : Other.Assets)
+	{
+		AssetRemap.Add(FindOrAddAsset(AssetPath));
+	}
+
+	Instances.Reserve(Instances.Num() + Other.Instances.Num());
+	for (const FDesignerPlacementInstance& OtherInstance : Other.Instances)
+	{
+		FDesignerPlacementInstance& Instance = Instances.Add_GetRef(OtherInstance);
+		Instance.AssetIndex = AssetRemap[OtherInstance.AssetIndex];
+	}
+}
+
+void FDesignerPlacementBatch::Reset()
+{
+	Assets.Reset();
+	Instances.Reset();
+}
+
+bool FDesignerPlacementBatch::SaveToFile(const FString& Filename) const
+{
+	// Write to a temporary file first so readers never see a partially written batch
+	const FString TempFilename = Filename + TEXT(".tmp");
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempFilename));
+	if (!Writer.IsValid())
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Could not open %s for writing."), *TempFilename);
+		return false;
+	}
+
+	*Writer << const_cast<FDesignerPlacementBatch&>(*this);
+	bool bSuccess = Writer->Close();
+	Writer.Reset();
+
+	return bSuccess && IFileManager::Get().Move(*Filename, *TempFilename, /*Replace*/true);
+}
+
+bool FDesignerPlacementBatch::LoadFromFile(const FString& Filename)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename));
+	if (!Reader.IsValid())
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Could not open %s for reading."), *Filename);
+		return false;
+	}
+
+	*Reader << *this;
+	return !Reader->IsError();
+}
+
+FArchive& operator<<(FArchive& Ar, FDesignerPlacementBatch& Batch)
+{
+	uint32 Magic = DesignerPlacementBatchFile::Magic;
+	int32 Version = DesignerPlacementBatchFile::Version;
+	Ar << Magic;
+	Ar << Version;
+
+	if (Ar.IsLoading() && (Magic != DesignerPlacementBatchFile::Magic || Version != DesignerPlacementBatchFile::Version))
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Unsupported placement batch (magic %08x, version %d)."), Magic, Version);
+		Ar.SetError();
+		return Ar;
+	}
+
+	int32 NumAssets = Batch.Assets.Num();
+	Ar << NumAssets;
+	if (Ar.IsLoading())
+	{
+		// Every asset path takes at least its length prefix, so a count larger than the rest of the archive is corrupt
+		const int64 RemainingSize = Ar.TotalSize() - Ar.Tell();
+		if (NumAssets < 0 || (Ar.TotalSize() >= 0 && NumAssets > RemainingSize))
+		{
+			UE_LOG(LogDesigner, Error, TEXT("Placement batch has an invalid asset count (%d)."), NumAssets);
+			Ar.SetError();
+			return Ar;
+		}
+		Batch.Assets.SetNum(NumAssets);
+	}
+	for (FSoftObjectPath& AssetPath : Batch.Assets)
+	{
+		FString AssetPathString = AssetPath.ToString();
+		Ar << AssetPathString;
+		if (Ar.IsLoading())
+		{
+			AssetPath.SetPath(AssetPathString);
+		}
+	}
+
+	Ar << Batch.Instances;
+
+	if (Ar.IsLoading() && !Ar.IsError())
+	{
+		// Asset indices are used unchecked by CommitBatch and Append, so a batch that refers outside its asset table is rejected as a whole
+		for (const FDesignerPlacementInstance& Instance : Batch.Instances)
+		{
+			if (!Batch.Assets.IsValidIndex(Instance.AssetIndex))
+			{
+				UE_LOG(LogDesigner, Error, TEXT("Placement batch refers to asset %d, but only has %d assets."), Instance.AssetIndex, Batch.Assets.Num());
+				Batch.Reset();
+				Ar.SetError();
+				break;
+			}
+		}
+	}
+
+	return Ar;
+}
+
+void FDesignerPlacement::MarkAsPlaced(AActor* Actor)
+{
+	Actor->Tags.AddUnique(PlacedActorTag);
+}
+
+bool FDesignerPlacement::IsPlaced(const AActor* Actor)
+{
+	return Actor != nullptr && Actor->ActorHasTag(PlacedActorTag);
+}
+
+const UObject* FDesignerPlacement::GetPlacedAsset(const AActor* Actor)
+{
+	if (Actor == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (const AStaticMeshActor* StaticMeshActor = Cast<AStaticMeshActor>(Actor))
+	{
+		return StaticMeshActor->GetStaticMeshComponent()->GetStaticMesh();
+	}
+
+	UClass* ActorClass = Actor->GetClass();
+	return ActorClass->ClassGeneratedBy != nullptr ? ActorClass->ClassGeneratedBy : ActorClass;
+}
+
+int32 FDesignerPlacement::CommitBatch(const FDesignerPlacementBatch& Batch, ULevel* Level, ADesignerInstanceContainer* Container, TArray<AActor*>* OutSpawnedActors, FDesignerPlacementBatch* OutActorBatch)
+{
+	check(Level != nullptr);
+
+	FDesignerBulkEditScope BulkEditScope;
+	FDesignerBulkEditScope::MarkLevelDirty(Level);
+
+	int32 NumCommitted = 0;
+
+	TArray<UObject*> AssetObjects;
+	TArray<UActorFactory*> ActorFactories;
+	AssetObjects.Reserve(Batch.Assets.Num());
+	ActorFactories.Reserve(Batch.Assets.Num());
+	for (const FSoftObjectPath& AssetPath : Batch.Assets)
+	{
+		UObject* Asset = AssetPath.TryLoad();
+		UActorFactory* ActorFactory = nullptr;
+		if (Asset == nullptr)
+		{
+			UE_LOG(LogDesigner, Warning, TEXT("Could not load %s, its placements are skipped."), *AssetPath.ToString());
+		}
+		else if (Container == nullptr || !Asset->IsA<UStaticMesh>())
+		{
+			ActorFactory = FActorFactoryAssetProxy::GetFactoryForAssetObject(Asset);
+			if (ActorFactory == nullptr)
+			{
+				UE_LOG(LogDesigner, Warning, TEXT("%s has no actor factory, its placements are skipped."), *AssetPath.ToString());
+			}
+		}
+		AssetObjects.Add(Asset);
+		ActorFactories.Add(ActorFactory);
+	}
+
+	// Gather the instances per static mesh so each instanced component is only touched once
+	TArray<TArray<FTransform>> InstanceTransforms;
+	TArray<TArray<int32>> InstanceSeeds;
+	InstanceTransforms.SetNum(Batch.Assets.Num());
+	InstanceSeeds.SetNum(Batch.Assets.Num());
+
+	// The index of each asset in the asset table of the actor batch, added when its first placement is deferred
+	TArray<int32> ActorBatchAssetIndices;
+	ActorBatchAssetIndices.Init(INDEX_NONE, Batch.Assets.Num());
+
+	for (const FDesignerPlacementInstance& Instance : Batch.Instances)
+	{
+		if (!ensureMsgf(AssetObjects.IsValidIndex(Instance.AssetIndex), TEXT("Placement refers to asset %d outside the batch asset table."), Instance.AssetIndex))
+		{
+			continue;
+		}
+
+		UObject* Asset = AssetObjects[Instance.AssetIndex];
+		UActorFactory* ActorFactory = ActorFactories[Instance.AssetIndex];
+
+		if (ActorFactory != nullptr && OutActorBatch != nullptr)
+		{
+			int32& ActorBatchAssetIndex = ActorBatchAssetIndices[Instance.AssetIndex];
+			if (ActorBatchAssetIndex == INDEX_NONE)
+			{
+				ActorBatchAssetIndex = OutActorBatch->FindOrAddAsset(Batch.Assets[Instance.AssetIndex]);
+			}
+
+			FDesignerPlacementInstance& ActorInstance = OutActorBatch->Instances.Add_GetRef(Instance);
+			ActorInstance.AssetIndex = ActorBatchAssetIndex;
+		}
+		else if (ActorFactory != nullptr)
+		{
+			AActor* Actor = ActorFactory->CreateActor(Asset, Level, Instance.Transform);
+			if (Actor != nullptr)
+			{
+				MarkAsPlaced(Actor);
+				if (OutSpawnedActors != nullptr)
+				{
+					OutSpawnedActors->Add(Actor);
+				}
+				++NumCommitted;
+			}
+		}
+		else if (Asset != nullptr && Container != nullptr)
+		{
+			InstanceTransforms[Instance.AssetIndex].Add(Instance.Transform);
+			InstanceSeeds[Instance.AssetIndex].Add(Instance.Seed);
+		}
+	}
+
+	for (int32 AssetIndex = 0; AssetIndex < Batch.Assets.Num(); ++AssetIndex)
+	{
+		if (InstanceTransforms[AssetIndex].Num() > 0)
+		{
+			Container->AddInstances(CastChecked<UStaticMesh>(AssetObjects[AssetIndex]), InstanceTransforms[AssetIndex], InstanceSeeds[AssetIndex]);
+			NumCommitted += InstanceTransforms[AssetIndex].Num();
+		}
+	}
+
+	FDesignerPerfHUD::AddPlacements(NumCommitted);
+
+	return NumCommitted;
+}
@@ -0,0 +1,107 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+
+// Forward Declares
+class AActor;
+class ADesignerInstanceContainer;
+class ULevel;
+
+/**
+ * A single placement produced by the bulk placement code
+ */
+struct FDesignerPlacementInstance
+{
+	/** The world transform of the placed asset */
+	FTransform Transform;
+
+	/** Index into the asset table of the owning batch */
+	int32 AssetIndex;
+
+	/** The seed the random values of this placement were drawn from */
+	int32 Seed;
+
+	friend FArchive& operator<<(FArchive& Ar, FDesignerPlacementInstance& Instance);
+};
+
+/**
+ * A set of placements together with the table of assets they refer to
+ */
+struct FDesignerPlacementBatch
+{
+	/** The assets referenced by the instances */
+	TArray<FSoftObjectPath> Assets;
+
+	/** The placements, in the order they were generated */
+	TArray<FDesignerPlacementInstance> Instances;
+
+	/** Returns the index of the asset in the asset table, adding it if needed */
+	int32 FindOrAddAsset(const FSoftObjectPath& AssetPath);
+
+	/** Appends all instances of another batch, remapping its asset indices into this batch */
+	void Append(const FDesignerPlacementBatch& Other);
+
+	/** Removes all instances and assets while keeping the allocations */
+	void Reset();
+
+	/** Writes the batch to disk. Returns true if it was successful */
+	bool SaveToFile(const FString& Filename) const;
+
+	/** Reads a batch written by SaveToFile. Returns true if it was successful */
+	bool LoadFromFile(const FString& Filename);
+
+	friend FArchive& operator<<(FArchive& Ar, FDesignerPlacementBatch& Batch);
+};
+
+/**
+ * Helpers for content placed by the Designer tools
+ */
+class FDesignerPlacement
+{
+public:
+	/** Tag added to every actor placed by the Designer tools */
+	static const FName PlacedActorTag;
+
+	/** Marks the actor as placed by the Designer tools */
+	static void MarkAsPlaced(AActor* Actor);
+
+	/** Was this actor placed by the Designer tools? */
+	static bool IsPlaced(const AActor* Actor);
+
+	/** The asset a placed actor was spawned from: its static mesh, its blueprint or otherwise its class */
+	static const UObject* GetPlacedAsset(const AActor* Actor);
+
+	/**
+	 * Commits a batch to a level.
+	 * Static meshes are added as instances to the container when one is given, everything else is spawned through its actor factory.
+	 * When OutActorBatch is given, the placements that need an actor are added to it instead of spawned, to hand them to the spawn queue.
+	 * Returns the number of placements that were committed.
+	 */
+	static int32 CommitBatch(const FDesignerPlacementBatch& Batch, ULevel* Level, ADesignerInstanceContainer* Container, TArray<AActor*>* OutSpawnedActors = nullptr, FDesignerPlacementBatch* OutActorBatch = nullptr);
+};
@@ -0,0 +1,143 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerPlacementRules.h"
+
+// Local Includes
+#include "DesignerSettings.h"
+
+namespace DesignerPlacementRules
+{
+	/** Surfaces with a horizontal normal shorter than this are level and do not face any direction, about half a degree of slope */
+	static const float MinFacingNormalSizeSquared = 1.E-4F;
+}
+
+void FDesignerCandidateBuffer::SetNum(int32 InNum)
+{
+	NumCandidates = InNum;
+
+	const int32 NumPadded = Align(InNum, 4);
+	for (TArray<float>* Component : { &LocationX, &LocationY, &LocationZ, &NormalX, &NormalY, &NormalZ })
+	{
+		Component->SetNumZeroed(NumPadded);
+	}
+	PhysicalMaterials.SetNumZeroed(InNum);
+}
+
+FDesignerPlacementRules::FDesignerPlacementRules(const UDesignerSettings* Settings)
+	: bLimitSlope(Settings->bLimitSlope)
+	, bLimitHeight(Settings->bLimitHeight)
+	, bLimitFacing(Settings->bLimitFacing)
+	, MinNormalZ(FMath::Cos(FMath::DegreesToRadians(Settings->MaxSlopeAngle)) - KINDA_SMALL_NUMBER)
+	, MaxNormalZ(FMath::Cos(FMath::DegreesToRadians(Settings->MinSlopeAngle)) + KINDA_SMALL_NUMBER)
+	, MinHeight(Settings->MinHeight)
+	, MaxHeight(Settings->MaxHeight)
+	, FacingDirection(FMath::Cos(FMath::DegreesToRadians(Settings->FacingYaw)), FMath::Sin(FMath::DegreesToRadians(Settings->FacingYaw)))
+	, MinFacingCosine(FMath::Cos(FMath::DegreesToRadians(Settings->MaxFacingAngle)))
+{
+	for (const UPhysicalMaterial* PhysicalMaterial : Settings->ExcludedPhysicalMaterials)
+	{
+		if (PhysicalMaterial != nullptr)
+		{
+			ExcludedPhysicalMaterials.AddUnique(PhysicalMaterial);
+		}
+	}
+}
+
+void FDesignerPlacementRules::Filter(const FDesignerCandidateBuffer& Candidates, int32 First, int32 Count, TArrayView<bool> InOutAccepted) const
+{
+	using namespace DesignerPlacementRules;
+
+	check(First % 4 == 0 && First + Count <= Candidates.Num() && InOutAccepted.Num() >= Candidates.Num());
+
+	if (IsEmpty())
+	{
+		return;
+	}
+
+	const VectorRegister AllLanes = VectorCompareGE(VectorZero(), VectorZero());
+	const VectorRegister Zero = VectorZero();
+	const VectorRegister MinNormalZs = VectorSetFloat1(MinNormalZ);
+	const VectorRegister MaxNormalZs = VectorSetFloat1(MaxNormalZ);
+	const VectorRegister MinHeights = VectorSetFloat1(MinHeight);
+	const VectorRegister MaxHeights = VectorSetFloat1(MaxHeight);
+	const VectorRegister FacingX = VectorSetFloat1(FacingDirection.X);
+	const VectorRegister FacingY = VectorSetFloat1(FacingDirection.Y);
+	const VectorRegister FacingCosineSquared = VectorSetFloat1(MinFacingCosine * MinFacingCosine);
+	const VectorRegister MinFacingNormalSizesSquared = VectorSetFloat1(MinFacingNormalSizeSquared);
+
+	for (int32 FirstLane = First; FirstLane < First + Count; FirstLane += 4)
+	{
+		VectorRegister Passed = AllLanes;
+
+		if (bLimitSlope)
+		{
+			const VectorRegister NormalZ = VectorLoad(&Candidates.NormalZ[FirstLane]);
+			Passed = VectorBitwiseAnd(Passed, VectorBitwiseAnd(VectorCompareGE(NormalZ, MinNormalZs), VectorCompareGE(MaxNormalZs, NormalZ)));
+		}
+
+		if (bLimitHeight)
+		{
+			const VectorRegister LocationZ = VectorLoad(&Candidates.LocationZ[FirstLane]);
+			Passed = VectorBitwiseAnd(Passed, VectorBitwiseAnd(VectorCompareGE(LocationZ, MinHeights), VectorCompareGE(MaxHeights, LocationZ)));
+		}
+
+		if (bLimitFacing)
+		{
+			// The angle to the facing direction is within the limit when Dot >= Cosine * |Normal.XY|, compared squared to avoid the root
+			const VectorRegister NormalX = VectorLoad(&Candidates.NormalX[FirstLane]);
+			const VectorRegister NormalY = VectorLoad(&Candidates.NormalY[FirstLane]);
+			const VectorRegister Dot = VectorMultiplyAdd(NormalY, FacingY, VectorMultiply(NormalX, FacingX));
+			const VectorRegister SizeSquared = VectorMultiplyAdd(NormalY, NormalY, VectorMultiply(NormalX, NormalX));
+			const VectorRegister DotSquared = VectorMultiply(Dot, Dot);
+			const VectorRegister LimitSquared = VectorMultiply(FacingCosineSquared, SizeSquared);
+			const VectorRegister Facing = MinFacingCosine >= 0.F
+				? VectorBitwiseAnd(VectorCompareGE(Dot, Zero), VectorCompareGE(DotSquared, LimitSquared))
+				: VectorBitwiseOr(VectorCompareGE(Dot, Zero), VectorCompareGE(LimitSquared, DotSquared));
+			Passed = VectorBitwiseAnd(Passed, VectorBitwiseAnd(Facing, VectorCompareGT(SizeSquared, MinFacingNormalSizesSquared)));
+		}
+
+		const int32 PassedMask = VectorMaskBits(Passed);
+		const int32 NumLanes = FMath::Min(4, First + Count - FirstLane);
+		for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+		{
+			if ((PassedMask & (1 << Lane)) == 0)
+			{
+				InOutAccepted[FirstLane + Lane] = false;
+			}
+		}
+	}
+
+	if (ExcludedPhysicalMaterials.Num() > 0)
+	{
+		for (int32 CandidateIndex = First; CandidateIndex < First + Count; ++CandidateIndex)
+		{
+			if (InOutAccepted[CandidateIndex] && ExcludedPhysicalMaterials.Contains(Candidates.PhysicalMaterials[CandidateIndex]))
+			{
+				InOutAccepted[CandidateIndex] = false;
+			}
+		}
+	}
+}
@@ -0,0 +1,126 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Forward Declares
+class UDesignerSettings;
+class UPhysicalMaterial;
+
+/**
+ * The surfaces found for a batch of placement candidates, one array per component so rules can test four candidates at once.
+ * The float arrays are padded to a multiple of four, the padding is never accepted.
+ */
+struct FDesignerCandidateBuffer
+{
+	/** Resizes the buffer to a number of candidates, all values are zeroed */
+	void SetNum(int32 InNum);
+
+	int32 Num() const
+	{
+		return NumCandidates;
+	}
+
+	void SetSurface(int32 Index, const FVector& Location, const FVector& Normal)
+	{
+		LocationX[Index] = Location.X;
+		LocationY[Index] = Location.Y;
+		LocationZ[Index] = Location.Z;
+		NormalX[Index] = Normal.X;
+		NormalY[Index] = Normal.Y;
+		NormalZ[Index] = Normal.Z;
+	}
+
+	FVector GetLocation(int32 Index) const
+	{
+		return FVector(LocationX[Index], LocationY[Index], LocationZ[Index]);
+	}
+
+	FVector GetNormal(int32 Index) const
+	{
+		return FVector(NormalX[Index], NormalY[Index], NormalZ[Index]);
+	}
+
+	TArray<float> LocationX;
+	TArray<float> LocationY;
+	TArray<float> LocationZ;
+	TArray<float> NormalX;
+	TArray<float> NormalY;
+	TArray<float> NormalZ;
+
+	/** The physical material of every surface, only compared and never dereferenced. Null where it is unknown */
+	TArray<const UPhysicalMaterial*> PhysicalMaterials;
+
+private:
+	int32 NumCandidates = 0;
+};
+
+/**
+ * The placement rules of the settings, compiled into the constants of a few branch free comparisons.
+ * Slope and facing limits become limits on the normal, so no angle is computed per candidate.
+ * A compiled rule set only reads its own copies of the settings, so it can filter on any thread.
+ */
+class FDesignerPlacementRules
+{
+public:
+	explicit FDesignerPlacementRules(const UDesignerSettings* Settings);
+
+	/** Does any rule reject candidates? */
+	bool IsEmpty() const
+	{
+		return !bLimitSlope && !bLimitHeight && !bLimitFacing && ExcludedPhysicalMaterials.Num() == 0;
+	}
+
+	/** Do the rules need the physical material of the surfaces? */
+	bool NeedsPhysicalMaterials() const
+	{
+		return ExcludedPhysicalMaterials.Num() > 0;
+	}
+
+	/** Clears InOutAccepted for the candidates in [First, First + Count) that break a rule. First must be a multiple of four */
+	void Filter(const FDesignerCandidateBuffer& Candidates, int32 First, int32 Count, TArrayView<bool> InOutAccepted) const;
+
+private:
+	bool bLimitSlope;
+	bool bLimitHeight;
+	bool bLimitFacing;
+
+	/** Slopes within the limits have normals with a z between these, widened a little so level surfaces pass a zero limit */
+	float MinNormalZ;
+	float MaxNormalZ;
+
+	float MinHeight;
+	float MaxHeight;
+
+	/** The horizontal direction slopes have to face */
+	FVector2D FacingDirection;
+
+	/** The cosine of the largest angle between the horizontal normal and the facing direction */
+	float MinFacingCosine;
+
+	TArray<const UPhysicalMaterial*> ExcludedPhysicalMaterials;
+};
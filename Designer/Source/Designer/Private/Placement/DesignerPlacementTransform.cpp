@@ -0,0 +1,255 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerPlacementTransform.h"
+
+// Engine Includes
+#include "Editor.h"
+#include "Settings/LevelEditorViewportSettings.h"
+
+// Local Includes
+#include "DesignerModule.h"
+#include "DesignerPalette.h"
+#include "DesignerSettings.h"
+
+FDesignerRotationGrid::FDesignerRotationGrid()
+	: bEnabled(false)
+	, GridSize(FRotator::ZeroRotator)
+{
+}
+
+FDesignerRotationGrid FDesignerRotationGrid::GetEditorGrid()
+{
+	check(IsInGameThread());
+
+	// Same state FSnappingUtils::SnapRotatorToGrid reads
+	FDesignerRotationGrid RotationGrid;
+	if (GEditor != nullptr)
+	{
+		RotationGrid.bEnabled = GetDefault<ULevelEditorViewportSettings>()->RotGridEnabled;
+		RotationGrid.GridSize = GEditor->GetRotGridSize();
+	}
+	return RotationGrid;
+}
+
+FRotator FDesignerRotationGrid::Snap(const FRotator& Rotation) const
+{
+	return bEnabled ? Rotation.GridSnap(GridSize) : Rotation;
+}
+
+FRotator FDesignerPlacementTransform::MakeAlignedRotation(const UDesignerSettings* Settings, const FVector& InForwardVector, const FVector& InUpVector, bool* bOutUsedFallbackRotation)
+{
+	FVector ForwardVector = InForwardVector;
+	FVector UpVector = InUpVector;
+
+	// if they're almost same, we need to find arbitrary vector
+	if (FMath::IsNearlyEqual(FMath::Abs(ForwardVector | UpVector), 1.f))
+	{
+		// make sure we don't ever pick the same as NewX
+		if (FMath::Abs(ForwardVector.Z) < (1.f - KINDA_SMALL_NUMBER))
+		{
+			UpVector = FVector(0, 0, 1.f);
+		}
+		else
+		{
+			UpVector = FVector(1.f, 0, 0);
+		}
+	}
+
+	FVector RightVector = (UpVector ^ ForwardVector).GetSafeNormal();
+	UpVector = ForwardVector ^ RightVector;
+
+	FVector SwizzledForwardVector = FVector::ZeroVector;
+	FVector SwizzledRightVector = FVector::ZeroVector;
+	FVector SwizzledUpVector = FVector::ZeroVector;
+
+	switch (Settings->AxisToAlignWithNormal)
+	{
+	case EAxisType::Forward:
+		SwizzledForwardVector = UpVector;
+		break;
+	case EAxisType::Backward:
+		SwizzledForwardVector = -UpVector;
+		break;
+	case EAxisType::Right:
+		SwizzledRightVector = UpVector;
+		break;
+	case EAxisType::Left:
+		SwizzledRightVector = -UpVector;
+		break;
+	case EAxisType::Down:
+		SwizzledUpVector = -UpVector;
+		break;
+	default: // Axis type none or up
+		SwizzledUpVector = UpVector;
+		break;
+	}
+
+	switch (Settings->AxisToAlignWithCursor)
+	{
+	case EAxisType::Backward:
+		SwizzledForwardVector = -ForwardVector;
+		break;
+	case EAxisType::Right:
+		SwizzledRightVector = ForwardVector;
+		break;
+	case EAxisType::Left:
+		SwizzledRightVector = -ForwardVector;
+		break;
+	case EAxisType::Up:
+		SwizzledUpVector = ForwardVector;
+		break;
+	case EAxisType::Down:
+		SwizzledUpVector = -ForwardVector;
+		break;
+	default: // Axis type none or forward
+		SwizzledForwardVector = ForwardVector;
+		break;
+	}
+
+	bool bIsForwardVectorSet = !SwizzledForwardVector.IsNearlyZero();
+	bool bIsRightVectorSet = !SwizzledRightVector.IsNearlyZero();
+	bool bIsUpVectorSet = !SwizzledUpVector.IsNearlyZero();
+
+	FRotator AlignedRotation;
+
+	if (!bIsForwardVectorSet && bIsRightVectorSet && bIsUpVectorSet)
+	{
+		AlignedRotation = FRotationMatrix::MakeFromZY(SwizzledUpVector, SwizzledRightVector).Rotator();
+	}
+	else if (!bIsRightVectorSet && bIsForwardVectorSet && bIsUpVectorSet)
+	{
+		AlignedRotation = FRotationMatrix::MakeFromZX(SwizzledUpVector, SwizzledForwardVector).Rotator();
+	}
+	else if (!bIsUpVectorSet && bIsForwardVectorSet && bIsRightVectorSet)
+	{
+		AlignedRotation = FRotationMatrix::MakeFromXY(SwizzledForwardVector, SwizzledRightVector).Rotator();
+	}
+	else
+	{
+		// Default rotation of everything else fails
+		AlignedRotation = FMatrix(ForwardVector, RightVector, UpVector, FVector::ZeroVector).Rotator();
+		if (bOutUsedFallbackRotation != nullptr)
+		{
+			*bOutUsedFallbackRotation = true;
+		}
+	}
+
+	return AlignedRotation;
+}
+
+FRotator FDesignerPlacementTransform::ApplyRotationSettings(const UDesignerSettings* Settings, const FDesignerRotationGrid& RotationGrid, const FRotator& AlignedRotation, const FRotator& RandomRotationOffset)
+{
+	FRotator Rotation = AlignedRotation;
+
+	// Apply the generated random rotation offset if the user has set the bApplyRandomRotation setting
+	if (Settings->bApplyRandomRotation)
+	{
+		Rotation = FRotator(Rotation.Quaternion() * RandomRotationOffset.Quaternion());
+	}
+
+	// Snap the axes to the grid if the user has set bSnapToGridRotation
+	FRotator RotationSnapped = RotationGrid.Snap(Rotation);
+	Rotation.Roll = Settings->bSnapToGridRotationX ? RotationSnapped.Roll : Rotation.Roll;
+	Rotation.Pitch = Settings->bSnapToGridRotationY ? RotationSnapped.Pitch : Rotation.Pitch;
+	Rotation.Yaw = Settings->bSnapToGridRotationZ ? RotationSnapped.Yaw : Rotation.Yaw;
+
+	return Rotation;
+}
+
+FRotator FDesignerPlacementTransform::MakeSurfaceRotation(const UDesignerSettings* Settings, const FDesignerRotationGrid& RotationGrid, const FVector& SurfaceNormal)
+{
+	FVector ZAxis = SurfaceNormal;
+	if (Settings->AxisToAlignWithNormal == EAxisType::None)
+	{
+		ZAxis = FVector::UpVector;
+	}
+
+	FRotator SurfaceRotation = FRotationMatrix::MakeFromZX(ZAxis, FVector::ForwardVector).Rotator();
+
+	FRotator SurfaceRotationSnapped = RotationGrid.Snap(SurfaceRotation);
+	SurfaceRotation.Roll = Settings->bSnapToGridRotationX ? SurfaceRotationSnapped.Roll : SurfaceRotation.Roll;
+	SurfaceRotation.Pitch = Settings->bSnapToGridRotationY ? SurfaceRotationSnapped.Pitch : SurfaceRotation.Pitch;
+	SurfaceRotation.Yaw = Settings->bSnapToGridRotationZ ? SurfaceRotationSnapped.Yaw : SurfaceRotation.Yaw;
+
+	return SurfaceRotation;
+}
+
+FRotator FDesignerPlacementTransform::GetRandomRotationOffset(const UDesignerSettings* Settings, FRandomStream& RandomStream, const FDesignerPaletteEntry* PaletteEntry)
+{
+	const bool bUseEntry = PaletteEntry != nullptr && PaletteEntry->bOverrideRandomRotation;
+
+	float RandomX = (bUseEntry ? PaletteEntry->RandomRotationX : Settings->RandomRotationX).GetRandomValue(RandomStream);
+	float RandomY = (bUseEntry ? PaletteEntry->RandomRotationY : Settings->RandomRotationY).GetRandomValue(RandomStream);
+	float RandomZ = (bUseEntry ? PaletteEntry->RandomRotationZ : Settings->RandomRotationZ).GetRandomValue(RandomStream);
+
+	return FRotator(RandomY, RandomZ, RandomX); // Pitch, Yaw, Roll = Y, Z, X.
+}
+
+FVector FDesignerPlacementTransform::GetRandomScale(const UDesignerSettings* Settings, FRandomStream& RandomStream, const FDesignerPaletteEntry* PaletteEntry)
+{
+	const bool bUseEntry = PaletteEntry != nullptr && PaletteEntry->bOverrideRandomScale;
+
+	FVector RandomScale(
+		(bUseEntry ? PaletteEntry->RandomScaleX : Settings->RandomScaleX).GetRandomValue(RandomStream),
+		(bUseEntry ? PaletteEntry->RandomScaleY : Settings->RandomScaleY).GetRandomValue(RandomStream),
+		(bUseEntry ? PaletteEntry->RandomScaleZ : Settings->RandomScaleZ).GetRandomValue(RandomStream)
+	);
+
+	return Settings->bApplyRandomScale ? RandomScale : FVector::OneVector;
+}
+
+FTransform FDesignerPlacementTransform::MakeDirectedTransform(const UDesignerSettings* Settings, const FDesignerRotationGrid& RotationGrid, const FVector& Location, const FVector& ForwardVector, const FVector& UpVector, int32 Seed, float Scale, const FDesignerPaletteEntry* PaletteEntry, bool* bOutUsedFallbackRotation)
+{
+	FRandomStream RandomStream(Seed);
+
+	FRotator AlignedRotation = MakeAlignedRotation(Settings, ForwardVector, UpVector, bOutUsedFallbackRotation);
+
+	// Always draw both so the stream is consumed identically regardless of which settings are enabled
+	FRotator RandomRotationOffset = GetRandomRotationOffset(Settings, RandomStream, PaletteEntry);
+	FVector RandomScale = GetRandomScale(Settings, RandomStream, PaletteEntry);
+
+	FQuat Rotation = ApplyRotationSettings(Settings, RotationGrid, AlignedRotation, RandomRotationOffset).Quaternion();
+
+	FVector PlacementLocation = Location + Settings->WorldLocationOffset + Rotation.RotateVector(Settings->RelativeLocationOffset);
+
+	return FTransform(Rotation, PlacementLocation, RandomScale * Scale);
+}
+
+FTransform FDesignerPlacementTransform::MakeSurfaceTransform(const UDesignerSettings* Settings, const FDesignerRotationGrid& RotationGrid, const FVector& Location, const FVector& SurfaceNormal, int32 Seed, float Scale, const FDesignerPaletteEntry* PaletteEntry, bool* bOutUsedFallbackRotation)
+{
+	// Without cursor input the cursor direction is the forward vector of the surface frame, same as on mouse click down
+	FQuat SurfaceRotation = MakeSurfaceRotation(Settings, RotationGrid, SurfaceNormal).Quaternion();
+
+	return MakeDirectedTransform(Settings, RotationGrid, Location, SurfaceRotation.GetForwardVector(), SurfaceRotation.GetUpVector(), Seed, Scale, PaletteEntry, bOutUsedFallbackRotation);
+}
+
+void FDesignerPlacementTransform::WarnFallbackRotations(int32 NumFallbackRotations)
+{
+	if (NumFallbackRotations > 0)
+	{
+		UE_LOG(LogDesigner, Warning, TEXT("Falling back to default rotation for %d placements."), NumFallbackRotations);
+	}
+}
@@ -0,0 +1,95 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Forward Declares
+class UDesignerSettings;
+struct FDesignerPaletteEntry;
+
+/**
+ * The rotation grid of the level editor.
+ * It is read on the game thread and passed in by value, so the transform functions never touch the editor viewport settings.
+ */
+struct FDesignerRotationGrid
+{
+	/** Is rotation snapping enabled in the level editor? */
+	bool bEnabled;
+
+	/** The rotation grid size of the level editor */
+	FRotator GridSize;
+
+	FDesignerRotationGrid();
+
+	/** Reads the current rotation grid of the level editor. Only call this on the game thread */
+	static FDesignerRotationGrid GetEditorGrid();
+
+	/** Returns the rotation snapped to the grid, or unchanged if snapping is disabled */
+	FRotator Snap(const FRotator& Rotation) const;
+};
+
+/**
+ * The transform logic shared by the interactive tools and the bulk placement code.
+ * Everything in here only reads from the settings and the rotation grid it is given, so it is safe to call from worker threads.
+ * Nothing in here logs, rotations that fell back to the default frame are reported through bOutUsedFallbackRotation instead.
+ */
+class FDesignerPlacementTransform
+{
+public:
+	/**
+	 * Builds the rotation that aligns the settings AxisToAlignWithNormal with UpVector and AxisToAlignWithCursor with ForwardVector.
+	 * No random offset or grid snapping is applied.
+	 */
+	static FRotator MakeAlignedRotation(const UDesignerSettings* Settings, const FVector& ForwardVector, const FVector& UpVector, bool* bOutUsedFallbackRotation = nullptr);
+
+	/** Applies the random rotation offset (if enabled) and the grid snapping from the settings to an aligned rotation */
+	static FRotator ApplyRotationSettings(const UDesignerSettings* Settings, const FDesignerRotationGrid& RotationGrid, const FRotator& AlignedRotation, const FRotator& RandomRotationOffset);
+
+	/** The rotation of the surface frame at a hit, with the grid snapping of the settings applied. Matches the spawn rotation of the spawn asset tool */
+	static FRotator MakeSurfaceRotation(const UDesignerSettings* Settings, const FDesignerRotationGrid& RotationGrid, const FVector& SurfaceNormal);
+
+	/** Draws a random rotation offset from the settings ranges, or from the ranges of the palette entry if it overrides them */
+	static FRotator GetRandomRotationOffset(const UDesignerSettings* Settings, FRandomStream& RandomStream, const FDesignerPaletteEntry* PaletteEntry = nullptr);
+
+	/** Draws a random scale from the settings ranges or the palette entry overrides, or one if random scale is disabled */
+	static FVector GetRandomScale(const UDesignerSettings* Settings, FRandomStream& RandomStream, const FDesignerPaletteEntry* PaletteEntry = nullptr);
+
+	/**
+	 * Builds the full placement transform for a location with a given forward and up direction, e.g. along a path.
+	 * The forward vector takes the place of the cursor direction. The result only depends on the settings, the grid, the inputs and the seed.
+	 */
+	static FTransform MakeDirectedTransform(const UDesignerSettings* Settings, const FDesignerRotationGrid& RotationGrid, const FVector& Location, const FVector& ForwardVector, const FVector& UpVector, int32 Seed, float Scale = 1.F, const FDesignerPaletteEntry* PaletteEntry = nullptr, bool* bOutUsedFallbackRotation = nullptr);
+
+	/**
+	 * Builds the full placement transform for a surface hit without any cursor input.
+	 * The result only depends on the settings, the grid, the inputs and the seed.
+	 */
+	static FTransform MakeSurfaceTransform(const UDesignerSettings* Settings, const FDesignerRotationGrid& RotationGrid, const FVector& Location, const FVector& SurfaceNormal, int32 Seed, float Scale = 1.F, const FDesignerPaletteEntry* PaletteEntry = nullptr, bool* bOutUsedFallbackRotation = nullptr);
+
+	/** Logs a single warning for the placements of one operation whose rotation fell back to the default frame. Does nothing if there are none */
+	static void WarnFallbackRotations(int32 NumFallbackRotations);
+};
@@ -0,0 +1,516 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerPointImporter.h"
+
+// Engine Includes
+#include "Async/ParallelFor.h"
+#include "Editor.h"
+#include "Engine/World.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopedSlowTask.h"
+#include "ScopedTransaction.h"
+
+// Local Includes
+#include "DesignerInstanceContainer.h"
+#include "DesignerModule.h"
+#include "DesignerSettings.h"
+#include "Diagnostics/DesignerMemory.h"
+#include "Placement/DesignerBulkEditScope.h"
+#include "Placement/DesignerPlacementTransform.h"
+#include "Placement/DesignerSpawnQueue.h"
+
+#define LOCTEXT_NAMESPACE "DesignerPointImporter"
+
+static_assert(sizeof(FDesignerPointRecord) == 36, "FDesignerPointRecord must match the binary point format");
+static_assert(sizeof(FDesignerPointFileHeader) == 16, "FDesignerPointFileHeader must match the binary point format");
+
+namespace DesignerPointImporter
+{
+	/** The size of the read buffer used for CSV files, also the maximum length of a line */
+	static const int32 CSVReadBufferSize = 1024 * 1024;
+
+	/** The number of values on a CSV line */
+	static const int32 CSVNumFields = 9;
+}
+
+FDesignerPointImporter::FDesignerPointImporter(const UDesignerSettings* InSettings, const TArray<FSoftObjectPath>& InAssets, int32 InChunkSize)
+	: Settings(InSettings)
+	, ChunkSize(FMath::Max(InChunkSize, 1))
+	, NumSkippedRecords(0)
+	, NumFallbackRotations(0)
+{
+	check(Settings != nullptr);
+	ChunkBatch.Assets = InAssets;
+}
+
+bool FDesignerPointImporter::Import(const FString& Filename, FOnChunkImported OnChunkImported)
+{
+	NumSkippedRecords = 0;
+	NumFallbackRotations = 0;
+
+	bool bSuccess = FPaths::GetExtension(Filename).Equals(TEXT("csv"), ESearchCase::IgnoreCase)
+		? ImportCSV(Filename, OnChunkImported)
+		: ImportBinary(Filename, OnChunkImported);
+
+	if (NumSkippedRecords > 0)
+	{
+		UE_LOG(LogDesigner, Warning, TEXT("Skipped %lld records of %s with an invalid asset index or format."), NumSkippedRecords, *Filename);
+	}
+	FDesignerPlacementTransform::WarnFallbackRotations(NumFallbackRotations);
+
+	return bSuccess;
+}
+
+bool FDesignerPointImporter::ImportBinary(const FString& Filename, FOnChunkImported OnChunkImported)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	TUniquePtr<IMappedFileHandle> MappedFile(PlatformFile.OpenMapped(*Filename));
+	TUniquePtr<IFileHandle> FileHandle;
+
+	// Not every platform file supports mapping and mapping a region can still fail, e.g. when the address space is exhausted.
+	// The rest of the file is then read one chunk at a time instead.
+	auto FallBackToRead = [&]() -> bool
+	{
+		MappedFile.Reset();
+		FileHandle.Reset(PlatformFile.OpenRead(*Filename));
+		if (!FileHandle.IsValid())
+		{
+			UE_LOG(LogDesigner, Error, TEXT("Could not open %s."), *Filename);
+			return false;
+		}
+		return true;
+	};
+
+	if (!MappedFile.IsValid() && !FallBackToRead())
+	{
+		return false;
+	}
+
+	const int64 FileSize = MappedFile.IsValid() ? MappedFile->GetFileSize() : FileHandle->Size();
+
+	FDesignerPointFileHeader Header;
+	if (FileSize < (int64)sizeof(Header))
+	{
+		UE_LOG(LogDesigner, Error, TEXT("%s is not a point file."), *Filename);
+		return false;
+	}
+
+	bool bHeaderRead = false;
+	if (MappedFile.IsValid())
+	{
+		TUniquePtr<IMappedFileRegion> HeaderRegion(MappedFile->MapRegion(0, sizeof(Header)));
+		if (HeaderRegion.IsValid())
+		{
+			FMemory::Memcpy(&Header, HeaderRegion->GetMappedPtr(), sizeof(Header));
+			bHeaderRead = true;
+		}
+		else if (!FallBackToRead())
+		{
+			return false;
+		}
+	}
+
+	if (!bHeaderRead && !FileHandle->Read(reinterpret_cast<uint8*>(&Header), sizeof(Header)))
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Could not read %s."), *Filename);
+		return false;
+	}
+
+	if (Header.Magic != FDesignerPointFileHeader::ExpectedMagic || Header.Version != FDesignerPointFileHeader::ExpectedVersion)
+	{
+		UE_LOG(LogDesigner, Error, TEXT("%s is not a supported point file (magic %08x, version %u)."), *Filename, Header.Magic, Header.Version);
+		return false;
+	}
+
+	const uint64 MaxRecords = (FileSize - sizeof(Header)) / sizeof(FDesignerPointRecord);
+	if (Header.NumRecords > MaxRecords)
+	{
+		UE_LOG(LogDesigner, Error, TEXT("%s is truncated, it should hold %llu records but only holds %llu."), *Filename, Header.NumRecords, MaxRecords);
+		return false;
+	}
+
+	for (uint64 FirstRecord = 0; FirstRecord < Header.NumRecords; FirstRecord += ChunkSize)
+	{
+		const int32 NumRecords = (int32)FMath::Min<uint64>(ChunkSize, Header.NumRecords - FirstRecord);
+		const int64 ChunkOffset = sizeof(Header) + FirstRecord * sizeof(FDesignerPointRecord);
+		const int64 ChunkBytes = NumRecords * sizeof(FDesignerPointRecord);
+		const float Progress = (float)(FirstRecord + NumRecords) / (float)Header.NumRecords;
+
+		// Only the current chunk is mapped, so the resident memory does not grow with the file
+		TUniquePtr<IMappedFileRegion> ChunkRegion;
+		if (MappedFile.IsValid())
+		{
+			ChunkRegion.Reset(MappedFile->MapRegion(ChunkOffset, ChunkBytes));
+			if (!ChunkRegion.IsValid() && !FallBackToRead())
+			{
+				return false;
+			}
+		}
+
+		bool bContinue = true;
+		if (ChunkRegion.IsValid())
+		{
+			const FDesignerPointRecord* Records = reinterpret_cast<const FDesignerPointRecord*>(ChunkRegion->GetMappedPtr());
+			bContinue = TransformChunk(TArrayView<const FDesignerPointRecord>(Records, NumRecords), Progress, OnChunkImported);
+		}
+		else
+		{
+			ChunkRecords.SetNumUninitialized(NumRecords, /*bAllowShrinking*/false);
+			FileHandle->Seek(ChunkOffset);
+			if (!FileHandle->Read(reinterpret_cast<uint8*>(ChunkRecords.GetData()), ChunkBytes))
+			{
+				UE_LOG(LogDesigner, Error, TEXT("Could not read %s."), *Filename);
+				return false;
+			}
+			bContinue = TransformChunk(ChunkRecords, Progress, OnChunkImported);
+		}
+
+		if (!bContinue)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FDesignerPointImporter::ImportCSV(const FString& Filename, FOnChunkImported OnChunkImported)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	TUniquePtr<IFileHandle> FileHandle(PlatformFile.OpenRead(*Filename));
+	if (!FileHandle.IsValid())
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Could not open %s."), *Filename);
+		return false;
+	}
+
+	const int64 FileSize = FileHandle->Size();
+
+	// One extra character so the last line can always be null terminated
+	TArray<ANSICHAR> ReadBuffer;
+	ReadBuffer.SetNumUninitialized(DesignerPointImporter::CSVReadBufferSize + 1);
+
+	ChunkRecords.Reset(ChunkSize);
+
+	int64 BytesRead = 0;
+	int32 NumBuffered = 0;
+	bool bFirstLine = true;
+
+	auto ParseLine = [&](ANSICHAR* Line) -> bool
+	{
+		FDesignerPointRecord Record;
+		if (ParseCSVLine(Line, Record))
+		{
+			ChunkRecords.Add(Record);
+		}
+		else if (!bFirstLine && *Line != '\0' && *Line != '\r')
+		{
+			// The first line is allowed to be a header, empty lines are ignored
+			++NumSkippedRecords;
+		}
+		bFirstLine = false;
+
+		if (ChunkRecords.Num() == ChunkSize)
+		{
+			bool bContinue = TransformChunk(ChunkRecords, (float)BytesRead / (float)FileSize, OnChunkImported);
+			ChunkRecords.Reset();
+			return bContinue;
+		}
+		return true;
+	};
+
+	while (true)
+	{
+		const int32 BytesToRead = (int32)FMath::Min<int64>(DesignerPointImporter::CSVReadBufferSize - NumBuffered, FileSize - BytesRead);
+		if (BytesToRead > 0)
+		{
+			if (!FileHandle->Read(reinterpret_cast<uint8*>(ReadBuffer.GetData() + NumBuffered), BytesToRead))
+			{
+				UE_LOG(LogDesigner, Error, TEXT("Could not read %s."), *Filename);
+				return false;
+			}
+			NumBuffered += BytesToRead;
+			BytesRead += BytesToRead;
+		}
+
+		const bool bEndOfFile = BytesRead >= FileSize;
+
+		int32 LineStart = 0;
+		for (int32 Index = 0; Index < NumBuffered; ++Index)
+		{
+			if (ReadBuffer[Index] == '\n')
+			{
+				ReadBuffer[Index] = '\0';
+				if (!ParseLine(ReadBuffer.GetData() + LineStart))
+				{
+					return false;
+				}
+				LineStart = Index + 1;
+			}
+		}
+
+		if (bEndOfFile)
+		{
+			if (LineStart < NumBuffered)
+			{
+				ReadBuffer[NumBuffered] = '\0';
+				if (!ParseLine(ReadBuffer.GetData() + LineStart))
+				{
+					return false;
+				}
+			}
+			break;
+		}
+
+		if (LineStart == 0 && NumBuffered == DesignerPointImporter::CSVReadBufferSize)
+		{
+			UE_LOG(LogDesigner, Error, TEXT("%s contains a line longer than %d characters."), *Filename, DesignerPointImporter::CSVReadBufferSize);
+			return false;
+		}
+
+		// Keep the partial last line for the next read
+		NumBuffered -= LineStart;
+		FMemory::Memmove(ReadBuffer.GetData(), ReadBuffer.GetData() + LineStart, NumBuffered);
+	}
+
+	if (ChunkRecords.Num() > 0)
+	{
+		bool bContinue = TransformChunk(ChunkRecords, 1.F, OnChunkImported);
+		ChunkRecords.Reset();
+		return bContinue;
+	}
+
+	return true;
+}
+
+bool FDesignerPointImporter::ParseCSVLine(ANSICHAR* Line, FDesignerPointRecord& OutRecord)
+{
+	ANSICHAR* Fields[DesignerPointImporter::CSVNumFields];
+	int32 NumFields = 0;
+
+	Fields[NumFields++] = Line;
+	for (ANSICHAR* Cursor = Line; *Cursor != '\0'; ++Cursor)
+	{
+		if (*Cursor == ',')
+		{
+			if (NumFields == DesignerPointImporter::CSVNumFields)
+			{
+				return false;
+			}
+			*Cursor = '\0';
+			Fields[NumFields++] = Cursor + 1;
+		}
+	}
+
+	if (NumFields != DesignerPointImporter::CSVNumFields)
+	{
+		return false;
+	}
+
+	// Reject header lines and other text
+	const ANSICHAR* FirstValue = Fields[0];
+	while (*FirstValue == ' ' || *FirstValue == '\t')
+	{
+		++FirstValue;
+	}
+	if (!FCharAnsi::IsDigit(*FirstValue) && *FirstValue != '-' && *FirstValue != '+' && *FirstValue != '.')
+	{
+		return false;
+	}
+
+	OutRecord.Position = FVector(FCStringAnsi::Atof(Fields[0]), FCStringAnsi::Atof(Fields[1]), FCStringAnsi::Atof(Fields[2]));
+	OutRecord.Normal = FVector(FCStringAnsi::Atof(Fields[3]), FCStringAnsi::Atof(Fields[4]), FCStringAnsi::Atof(Fields[5]));
+	OutRecord.AssetIndex = (uint32)FCStringAnsi::Strtoui64(Fields[6], nullptr, 10);
+	OutRecord.Seed = (uint32)FCStringAnsi::Strtoui64(Fields[7], nullptr, 10);
+	OutRecord.Scale = FCStringAnsi::Atof(Fields[8]);
+
+	return true;
+}
+
+bool FDesignerPointImporter::TransformChunk(TArrayView<const FDesignerPointRecord> Records, float Progress, FOnChunkImported OnChunkImported)
+{
+	const int32 NumAssets = ChunkBatch.Assets.Num();
+
+	ChunkBatch.Instances.SetNumUninitialized(Records.Num(), /*bAllowShrinking*/false);
+
+	// Chunks are transformed on the game thread, the worker threads only get the grid
+	const FDesignerRotationGrid RotationGrid = FDesignerRotationGrid::GetEditorGrid();
+	FThreadSafeCounter NumChunkFallbackRotations;
+
+	ParallelFor(Records.Num(), [&](int32 RecordIndex)
+	{
+		const FDesignerPointRecord& Record = Records[RecordIndex];
+		FDesignerPlacementInstance& Instance = ChunkBatch.Instances[RecordIndex];
+
+		if (Record.AssetIndex < (uint32)NumAssets)
+		{
+			FVector Normal = Record.Normal.GetSafeNormal(SMALL_NUMBER, FVector::UpVector);
+			float Scale = Record.Scale > 0.F ? Record.Scale : 1.F;
+
+			bool bUsedFallbackRotation = false;
+			Instance.Transform = FDesignerPlacementTransform::MakeSurfaceTransform(Settings, RotationGrid, Record.Position, Normal, (int32)Record.Seed, Scale, nullptr, &bUsedFallbackRotation);
+			if (bUsedFallbackRotation)
+			{
+				NumChunkFallbackRotations.Increment();
+			}
+			Instance.AssetIndex = (int32)Record.AssetIndex;
+			Instance.Seed = (int32)Record.Seed;
+		}
+		else
+		{
+			Instance.AssetIndex = INDEX_NONE;
+		}
+	});
+
+	// Remove the records with an invalid asset index while keeping the file order
+	int32 NumValid = 0;
+	for (int32 RecordIndex = 0; RecordIndex < Records.Num(); ++RecordIndex)
+	{
+		if (ChunkBatch.Instances[RecordIndex].AssetIndex != INDEX_NONE)
+		{
+			if (NumValid != RecordIndex)
+			{
+				ChunkBatch.Instances[NumValid] = ChunkBatch.Instances[RecordIndex];
+			}
+			++NumValid;
+		}
+	}
+	NumSkippedRecords += Records.Num() - NumValid;
+	NumFallbackRotations += NumChunkFallbackRotations.GetValue();
+	ChunkBatch.Instances.SetNum(NumValid, /*bAllowShrinking*/false);
+
+	return OnChunkImported(ChunkBatch, Progress);
+}
+
+/**
+ * designer.importpoints <File> <Asset> [Asset...]
+ * Imports a point file into the current level. The asset index of every record selects one of the given assets.
+ */
+static void ImportPointsCommand(const TArray<FString>& Args)
+{
+	if (Args.Num() < 2)
+	{
+		UE_LOG(LogDesigner, Display, TEXT("Usage: designer.importpoints <File.dpts|File.csv> <Asset> [Asset...]"));
+		return;
+	}
+
+	UWorld* World = GEditor->GetEditorWorldContext().World();
+	ULevel* Level = World->GetCurrentLevel();
+
+	TArray<FSoftObjectPath> Assets;
+	for (int32 ArgIndex = 1; ArgIndex < Args.Num(); ++ArgIndex)
+	{
+		Assets.Add(FSoftObjectPath(Args[ArgIndex]));
+	}
+
+	const FString& Filename = Args[0];
+
+	FScopedTransaction Transaction(LOCTEXT("ImportPointsTransaction", "Designer: Import Points"));
+	FDesignerBulkEditScope BulkEditScope;
+
+	FScopedSlowTask SlowTask(1.F, FText::Format(LOCTEXT("ImportingPoints", "Importing {0}"), FText::FromString(FPaths::GetCleanFilename(Filename))));
+	SlowTask.MakeDialog(/*bShowCancelButton*/true);
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.OverrideLevel = Level;
+	ADesignerInstanceContainer* Container = World->SpawnActor<ADesignerInstanceContainer>(SpawnParameters);
+	Container->SetActorLabel(FString::Printf(TEXT("DesignerImport_%s"), *FPaths::GetBaseFilename(Filename)));
+
+	// The placements that need an actor are handed to the spawn queue chunk by chunk, so the import never holds those of the whole file.
+	// The jobs are kept to take them back if the import fails, together with whatever they spawned by then
+	TArray<int32> SpawnJobIds;
+	TSharedRef<TArray<TWeakObjectPtr<AActor>>> JobActors = MakeShared<TArray<TWeakObjectPtr<AActor>>>();
+	FDesignerSpawnJobParams SpawnJobParams;
+	SpawnJobParams.Title = LOCTEXT("ImportPointsTransaction", "Designer: Import Points");
+	SpawnJobParams.OnFinished = [JobActors](const TArray<AActor*>& SpawnedActors, bool bCancelled)
+	{
+		JobActors->Append(SpawnedActors);
+	};
+
+	FDesignerPlacementBatch ChunkActorBatch;
+	int64 NumQueued = 0;
+	int64 NumPlaced = 0;
+	float LastProgress = 0.F;
+	double StartTime = FPlatformTime::Seconds();
+
+	FDesignerPointImporter Importer(UDesignerSettings::GetActiveSettings(), Assets);
+	bool bSuccess = Importer.Import(Filename, [&](const FDesignerPlacementBatch& Chunk, float Progress)
+	{
+		ChunkActorBatch.Reset();
+		NumPlaced += FDesignerPlacement::CommitBatch(Chunk, Level, Container, /*OutSpawnedActors*/nullptr, &ChunkActorBatch);
+		if (ChunkActorBatch.Instances.Num() > 0)
+		{
+			NumQueued += ChunkActorBatch.Instances.Num();
+			SpawnJobIds.Add(FDesignerSpawnQueue::Get().Enqueue(MoveTemp(ChunkActorBatch), Level, SpawnJobParams));
+		}
+
+		SlowTask.EnterProgressFrame(Progress - LastProgress, FText::Format(LOCTEXT("ImportedPoints", "Imported {0} points"), FText::AsNumber(NumPlaced + NumQueued)));
+		LastProgress = Progress;
+
+		return !SlowTask.ShouldCancel();
+	});
+
+	if (!bSuccess)
+	{
+		// Leave the level as it was. The queue only spawns on the editor tick, but a commandlet runs the jobs right away
+		for (int32 SpawnJobId : SpawnJobIds)
+		{
+			FDesignerSpawnQueue::Get().Cancel(SpawnJobId);
+		}
+		for (const TWeakObjectPtr<AActor>& JobActor : *JobActors)
+		{
+			if (JobActor.IsValid())
+			{
+				World->EditorDestroyActor(JobActor.Get(), false);
+			}
+		}
+		World->EditorDestroyActor(Container, false);
+		Transaction.Cancel();
+
+		UE_LOG(LogDesigner, Warning, TEXT("Import of %s was cancelled or failed, nothing was placed."), *Filename);
+		return;
+	}
+
+	if (Container->GetInstanceCount() == 0)
+	{
+		World->EditorDestroyActor(Container, false);
+	}
+
+	UE_LOG(LogDesigner, Display, TEXT("Imported %lld instances from %s in %.2f seconds, %lld actors are spawned by the spawn queue."), NumPlaced, *Filename, FPlatformTime::Seconds() - StartTime, NumQueued);
+}
+
+static FAutoConsoleCommand ImportPointsConsoleCommand(
+	TEXT("designer.importpoints"),
+	TEXT("Imports a binary (.dpts) or CSV point file into the current level. Usage: designer.importpoints <File> <Asset> [Asset...]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&ImportPointsCommand));
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,120 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Local Includes
+#include "Placement/DesignerPlacement.h"
+
+// Forward Declares
+class UDesignerSettings;
+
+/**
+ * A single point of an imported point set. This is also the exact record layout of the binary point format.
+ *
+ * Binary point format (little endian):
+ *   FDesignerPointFileHeader
+ *   FDesignerPointRecord[NumRecords]
+ *
+ * CSV point format, one record per line with an optional header line:
+ *   PositionX,PositionY,PositionZ,NormalX,NormalY,NormalZ,AssetIndex,Seed,Scale
+ */
+struct FDesignerPointRecord
+{
+	FVector Position;
+	FVector Normal;
+	uint32 AssetIndex;
+	uint32 Seed;
+	float Scale;
+};
+
+/**
+ * The header of the binary point format
+ */
+struct FDesignerPointFileHeader
+{
+	/** "DPTS" */
+	static const uint32 ExpectedMagic = 0x53545044;
+	static const uint32 ExpectedVersion = 1;
+
+	uint32 Magic;
+	uint32 Version;
+	uint64 NumRecords;
+};
+
+/**
+ * Imports point sets from external tools and turns them into placements.
+ *
+ * The points are read and transformed in fixed size chunks, binary files are memory mapped one chunk at a time and
+ * CSV files are parsed from a fixed size read buffer, so the memory used by the importer does not depend on the file size.
+ */
+class FDesignerPointImporter
+{
+public:
+	/**
+	 * Called for every chunk of placements with the import progress in [0, 1].
+	 * The chunk is only valid during the call. Return false to cancel the import.
+	 */
+	typedef TFunctionRef<bool(const FDesignerPlacementBatch& Chunk, float Progress)> FOnChunkImported;
+
+	FDesignerPointImporter(const UDesignerSettings* InSettings, const TArray<FSoftObjectPath>& InAssets, int32 InChunkSize = 65536);
+
+	/** Imports a .dpts or .csv file. Returns false if the file could not be read or the import was cancelled */
+	bool Import(const FString& Filename, FOnChunkImported OnChunkImported);
+
+private:
+	/** Imports the binary point format by mapping one chunk of the file at a time */
+	bool ImportBinary(const FString& Filename, FOnChunkImported OnChunkImported);
+
+	/** Imports the CSV point format by streaming it through a fixed size buffer */
+	bool ImportCSV(const FString& Filename, FOnChunkImported OnChunkImported);
+
+	/** Parses a single null terminated CSV line into a record. Returns false if it is not a valid record */
+	static bool ParseCSVLine(ANSICHAR* Line, FDesignerPointRecord& OutRecord);
+
+	/** Runs the records through the placement transform and hands them to the callback */
+	bool TransformChunk(TArrayView<const FDesignerPointRecord> Records, float Progress, FOnChunkImported OnChunkImported);
+
+private:
+	/** The settings the placement transforms are built with */
+	const UDesignerSettings* Settings;
+
+	/** The number of records processed at a time */
+	int32 ChunkSize;
+
+	/** The placements of the current chunk, reused for every chunk */
+	FDesignerPlacementBatch ChunkBatch;
+
+	/** Records parsed from the current part of a CSV file, reused for every chunk */
+	TArray<FDesignerPointRecord> ChunkRecords;
+
+	/** The number of records skipped because their asset index was out of range */
+	int64 NumSkippedRecords;
+
+	/** The number of placements whose rotation fell back to the default frame */
+	int32 NumFallbackRotations;
+};
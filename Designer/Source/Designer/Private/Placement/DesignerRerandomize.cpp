@@ -0,0 +1,283 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerRerandomize.h"
+
+// Engine Includes
+#include "Async/ParallelFor.h"
+#include "CollisionQueryParams.h"
+#include "Editor.h"
+#include "Engine/Selection.h"
+#include "Engine/World.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Parse.h"
+#include "ScopedTransaction.h"
+
+// Local Includes
+#include "DesignerModule.h"
+#include "DesignerPalette.h"
+#include "DesignerSettings.h"
+#include "Diagnostics/DesignerMemory.h"
+#include "Placement/DesignerBulkEditScope.h"
+#include "Placement/DesignerPlacement.h"
+#include "Placement/DesignerPlacementTransform.h"
+
+#define LOCTEXT_NAMESPACE "DesignerRerandomize"
+
+namespace DesignerRerandomize
+{
+	/** The minimum distance traced to either side of the recovered surface point when re-aligning, in cm */
+	static const float MinTraceDistance = 500.F;
+
+	/** The world direction of an actor axis, None falls back to Fallback */
+	static FVector GetActorAxis(const FQuat& Rotation, EAxisType Axis, EAxisType Fallback)
+	{
+		switch (Axis == EAxisType::None ? Fallback : Axis)
+		{
+		case EAxisType::Forward:
+			return Rotation.GetForwardVector();
+		case EAxisType::Backward:
+			return -Rotation.GetForwardVector();
+		case EAxisType::Right:
+			return Rotation.GetRightVector();
+		case EAxisType::Left:
+			return -Rotation.GetRightVector();
+		case EAxisType::Down:
+			return -Rotation.GetUpVector();
+		default:
+			return Rotation.GetUpVector();
+		}
+	}
+
+	/** Everything needed to re-randomize an actor off the game thread */
+	struct FActorFrame
+	{
+		/** The point on the surface the actor was placed at */
+		FVector SurfaceLocation;
+
+		/** The recovered surface normal and cursor direction */
+		FVector Normal;
+		FVector Forward;
+
+		/** The current transform, kept when the actor cannot be re-randomized */
+		FTransform Transform;
+
+		/** How far to trace to either side of the surface location when re-aligning */
+		float TraceDistance;
+
+		int32 Seed;
+
+		const FDesignerPaletteEntry* PaletteEntry;
+
+		bool bValid;
+	};
+}
+
+void FDesignerRerandomize::ComputeTransforms(UWorld* World, const UDesignerSettings* Settings, const TArray<AActor*>& Actors, const FDesignerRerandomizeParams& Params, TArray<FTransform>& OutTransforms)
+{
+	using namespace DesignerRerandomize;
+
+	check(Settings != nullptr);
+
+	OutTransforms.SetNumUninitialized(Actors.Num());
+
+	TMap<const UObject*, const FDesignerPaletteEntry*> PaletteEntries;
+	if (Settings->Palette != nullptr)
+	{
+		for (const FDesignerPaletteEntry& Entry : Settings->Palette->Entries)
+		{
+			PaletteEntries.Add(Entry.Asset, &Entry);
+		}
+	}
+
+	FRandomStream SeedStream(Params.Seed != 0 ? Params.Seed : FMath::Rand());
+
+	// Reading actors is not safe off the game thread, so everything the workers need is gathered up front
+	TArray<FActorFrame> Frames;
+	Frames.SetNumUninitialized(Actors.Num());
+	for (int32 ActorIndex = 0; ActorIndex < Actors.Num(); ++ActorIndex)
+	{
+		const AActor* Actor = Actors[ActorIndex];
+		FActorFrame& Frame = Frames[ActorIndex];
+
+		// Always draw the seed so an actor gets the same one regardless of the actors before it
+		Frame.Seed = SeedStream.GetUnsignedInt();
+		Frame.bValid = Actor != nullptr && Actor->GetRootComponent() != nullptr;
+		if (!Frame.bValid)
+		{
+			Frame.Transform = FTransform::Identity;
+			continue;
+		}
+
+		Frame.Transform = Actor->GetActorTransform();
+
+		const FQuat Rotation = Frame.Transform.GetRotation();
+		Frame.SurfaceLocation = Frame.Transform.GetLocation() - Settings->WorldLocationOffset - Rotation.RotateVector(Settings->RelativeLocationOffset);
+		Frame.Normal = GetActorAxis(Rotation, Settings->AxisToAlignWithNormal, EAxisType::Up);
+		Frame.Forward = GetActorAxis(Rotation, Settings->AxisToAlignWithCursor, EAxisType::Forward);
+
+		const FDesignerPaletteEntry* const* PaletteEntry = PaletteEntries.Find(FDesignerPlacement::GetPlacedAsset(Actor));
+		Frame.PaletteEntry = PaletteEntry != nullptr ? *PaletteEntry : nullptr;
+
+		const FBox Bounds = Actor->GetComponentsBoundingBox();
+		Frame.TraceDistance = FMath::Max(MinTraceDistance, Bounds.IsValid ? Bounds.GetSize().GetMax() : 0.F);
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(DesignerRerandomize), /*bTraceComplex*/true);
+	if (Params.bRealign)
+	{
+		// The actors must not align to each other, or to themselves
+		for (AActor* Actor : Actors)
+		{
+			QueryParams.AddIgnoredActor(Actor);
+		}
+	}
+	const FCollisionObjectQueryParams ObjectQueryParams(FCollisionObjectQueryParams::AllStaticObjects);
+
+	const FDesignerRotationGrid RotationGrid = FDesignerRotationGrid::GetEditorGrid();
+	FThreadSafeCounter NumFallbackRotations;
+
+	ParallelFor(Actors.Num(), [&](int32 ActorIndex)
+	{
+		const FActorFrame& Frame = Frames[ActorIndex];
+		if (!Frame.bValid)
+		{
+			OutTransforms[ActorIndex] = Frame.Transform;
+			return;
+		}
+
+		FVector SurfaceLocation = Frame.SurfaceLocation;
+		FVector Normal = Frame.Normal;
+
+		if (Params.bRealign)
+		{
+			TArray<FHitResult> Hits;
+			const FVector TraceStart = Frame.SurfaceLocation + Frame.Normal * Frame.TraceDistance;
+			const FVector TraceEnd = Frame.SurfaceLocation - Frame.Normal * Frame.TraceDistance;
+			World->LineTraceMultiByObjectType(Hits, TraceStart, TraceEnd, ObjectQueryParams, QueryParams);
+
+			// The surface the actor sits on is the hit closest to where it was placed, not the first one along the trace
+			float ClosestDistanceSquared = MAX_flt;
+			for (const FHitResult& Hit : Hits)
+			{
+				const float DistanceSquared = FVector::DistSquared(Hit.ImpactPoint, Frame.SurfaceLocation);
+				if (DistanceSquared < ClosestDistanceSquared)
+				{
+					ClosestDistanceSquared = DistanceSquared;
+					SurfaceLocation = Hit.ImpactPoint;
+					Normal = Hit.ImpactNormal;
+				}
+			}
+		}
+
+		bool bUsedFallbackRotation = false;
+		FTransform Transform = Settings->bApplyRandomRotation
+			? FDesignerPlacementTransform::MakeSurfaceTransform(Settings, RotationGrid, SurfaceLocation, Normal, Frame.Seed, 1.F, Frame.PaletteEntry, &bUsedFallbackRotation)
+			: FDesignerPlacementTransform::MakeDirectedTransform(Settings, RotationGrid, SurfaceLocation, Frame.Forward, Normal, Frame.Seed, 1.F, Frame.PaletteEntry, &bUsedFallbackRotation);
+		if (bUsedFallbackRotation)
+		{
+			NumFallbackRotations.Increment();
+		}
+
+		if (!Settings->bApplyRandomScale)
+		{
+			Transform.SetScale3D(Frame.Transform.GetScale3D());
+		}
+
+		OutTransforms[ActorIndex] = Transform;
+	});
+
+	FDesignerPlacementTransform::WarnFallbackRotations(NumFallbackRotations.GetValue());
+}
+
+int32 FDesignerRerandomize::Rerandomize(UWorld* World, const UDesignerSettings* Settings, const TArray<AActor*>& Actors, const FDesignerRerandomizeParams& Params)
+{
+	TArray<FTransform> Transforms;
+	ComputeTransforms(World, Settings, Actors, Params, Transforms);
+
+	FDesignerBulkEditScope BulkEditScope;
+
+	int32 NumMoved = 0;
+	for (int32 ActorIndex = 0; ActorIndex < Actors.Num(); ++ActorIndex)
+	{
+		AActor* Actor = Actors[ActorIndex];
+		if (Actor == nullptr || Actor->GetActorTransform().Equals(Transforms[ActorIndex]))
+		{
+			continue;
+		}
+
+		{
+			DESIGNER_LLM_SCOPE(EDesignerLLMTag::Transactions);
+			Actor->Modify();
+		}
+		Actor->SetActorTransform(Transforms[ActorIndex]);
+		Actor->PostEditMove(/*bFinished*/true);
+		FDesignerBulkEditScope::MarkLevelDirty(Actor->GetLevel());
+		++NumMoved;
+	}
+
+	return NumMoved;
+}
+
+/**
+ * designer.rerandomize [align] [seed=<Seed>]
+ * Re-rolls the random rotation and scale of the selected actors, optionally aligning them to the surface again.
+ */
+static void RerandomizeCommand(const TArray<FString>& Args)
+{
+	FDesignerRerandomizeParams Params;
+	for (const FString& Arg : Args)
+	{
+		FParse::Value(*Arg, TEXT("seed="), Params.Seed);
+		Params.bRealign |= Arg.Equals(TEXT("align"), ESearchCase::IgnoreCase);
+	}
+
+	TArray<AActor*> Actors;
+	GEditor->GetSelectedActors()->GetSelectedObjects<AActor>(Actors);
+	if (Actors.Num() == 0)
+	{
+		UE_LOG(LogDesigner, Display, TEXT("Select the actors to re-randomize first."));
+		return;
+	}
+
+	FScopedTransaction Transaction(LOCTEXT("RerandomizeTransaction", "Designer: Re-randomize Actors"));
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 NumMoved = FDesignerRerandomize::Rerandomize(GEditor->GetEditorWorldContext().World(), UDesignerSettings::GetActiveSettings(), Actors, Params);
+	if (NumMoved == 0)
+	{
+		Transaction.Cancel();
+	}
+
+	UE_LOG(LogDesigner, Display, TEXT("Re-randomized %d of %d actors in %.2f seconds."), NumMoved, Actors.Num(), FPlatformTime::Seconds() - StartTime);
+}
+
+static FAutoConsoleCommand RerandomizeConsoleCommand(
+	TEXT("designer.rerandomize"),
+	TEXT("Re-rolls the random rotation and scale of the selected actors in one transaction. Usage: designer.rerandomize [align] [seed=<Seed>]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RerandomizeCommand));
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,69 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Forward Declares
+class AActor;
+class UDesignerSettings;
+class UWorld;
+
+/**
+ * How placed actors are re-randomized
+ */
+struct FDesignerRerandomizeParams
+{
+	FDesignerRerandomizeParams()
+		: Seed(0)
+		, bRealign(false)
+	{
+	}
+
+	/** The seed the per actor seeds are drawn from, zero draws a new one */
+	int32 Seed;
+
+	/** Traces the surface under every actor again and aligns the actor to it */
+	bool bRealign;
+};
+
+/**
+ * Re-rolls the random rotation and scale of placed actors, the bulk version of right-clicking while spawning.
+ *
+ * The surface frame of an actor is recovered from its transform and the alignment settings, i.e. the actor axis
+ * that is aligned with the normal and the one aligned with the cursor. Random rotation draws a new offset from the
+ * surface frame, otherwise the current heading is kept. Re-aligning replaces the recovered frame with the surface
+ * found by tracing along the normal axis, which also undoes any tilt of an earlier random rotation.
+ */
+class FDesignerRerandomize
+{
+public:
+	/** Computes the new transform of every actor in parallel, actors that cannot be re-randomized keep their transform */
+	static void ComputeTransforms(UWorld* World, const UDesignerSettings* Settings, const TArray<AActor*>& Actors, const FDesignerRerandomizeParams& Params, TArray<FTransform>& OutTransforms);
+
+	/** Computes the new transforms and moves the actors to them, recorded in the current transaction. Returns the number of actors that were moved */
+	static int32 Rerandomize(UWorld* World, const UDesignerSettings* Settings, const TArray<AActor*>& Actors, const FDesignerRerandomizeParams& Params = FDesignerRerandomizeParams());
+};
@@ -0,0 +1,372 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerScatter.h"
+
+// Engine Includes
+#include "Async/ParallelFor.h"
+#include "CollisionQueryParams.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "LandscapeHeightfieldCollisionComponent.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+// Local Includes
+#include "DesignerPalette.h"
+#include "DesignerSettings.h"
+#include "Placement/DesignerDensityMap.h"
+#include "Placement/DesignerLandscapeHeightfield.h"
+#include "Placement/DesignerOverlapFilter.h"
+#include "Placement/DesignerPlacement.h"
+#include "Placement/DesignerPlacementRules.h"
+#include "Placement/DesignerPlacementTransform.h"
+
+namespace DesignerScatter
+{
+	/** The number of locations sampled from the heightfields by a single parallel task */
+	static const int32 HeightfieldBatchSize = 1024;
+
+	/** The number of candidates filtered and transformed by a single parallel task, a multiple of four */
+	static const int32 CandidateBatchSize = 1024;
+
+	/** The coverage mask has at most this many cells along each axis */
+	static const int32 MaxCoverageCellsPerAxis = 256;
+
+	/**
+	 * The cells of a region where a trace could hit anything but a landscape.
+	 * Built from the bounds of the static content overlapping the region, instances are covered one by one.
+	 */
+	class FCoverageMask
+	{
+	public:
+		FCoverageMask(UWorld* World, const FBox& Region)
+			: Origin(Region.Min)
+		{
+			const FVector RegionSize = Region.GetSize();
+			CellSize = FMath::Max(FMath::Max(RegionSize.X, RegionSize.Y) / MaxCoverageCellsPerAxis, 1.F);
+			NumCellsX = FMath::Clamp(FMath::CeilToInt(RegionSize.X / CellSize), 1, MaxCoverageCellsPerAxis);
+			NumCellsY = FMath::Clamp(FMath::CeilToInt(RegionSize.Y / CellSize), 1, MaxCoverageCellsPerAxis);
+			Cells.Init(false, NumCellsX * NumCellsY);
+
+			TArray<FOverlapResult> Overlaps;
+			FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(DesignerScatterCoverage));
+			FCollisionObjectQueryParams ObjectQueryParams(FCollisionObjectQueryParams::InitType::AllStaticObjects);
+			World->OverlapMultiByObjectType(Overlaps, Region.GetCenter(), FQuat::Identity, ObjectQueryParams, FCollisionShape::MakeBox(Region.GetExtent()), QueryParams);
+
+			for (const FOverlapResult& Overlap : Overlaps)
+			{
+				UPrimitiveComponent* Component = Overlap.GetComponent();
+				if (Component == nullptr || Component->IsA<ULandscapeHeightfieldCollisionComponent>())
+				{
+					continue;
+				}
+
+				FTransform InstanceTransform;
+				UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(Component);
+				if (InstancedComponent != nullptr && InstancedComponent->GetStaticMesh() != nullptr && InstancedComponent->GetInstanceTransform(Overlap.ItemIndex, InstanceTransform, /*bWorldSpace*/true))
+				{
+					Cover(InstancedComponent->GetStaticMesh()->GetBoundingBox().TransformBy(InstanceTransform));
+				}
+				else
+				{
+					Cover(Component->Bounds.GetBox());
+				}
+			}
+		}
+
+		bool IsCovered(const FVector2D& Location) const
+		{
+			const FIntPoint Cell = GetCell(Location);
+			return Cells[Cell.Y * NumCellsX + Cell.X];
+		}
+
+	private:
+		void Cover(const FBox& Box)
+		{
+			const FIntPoint MinCell = GetCell(FVector2D(Box.Min));
+			const FIntPoint MaxCell = GetCell(FVector2D(Box.Max));
+			for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+			{
+				for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+				{
+					Cells[CellY * NumCellsX + CellX] = true;
+				}
+			}
+		}
+
+		FIntPoint GetCell(const FVector2D& Location) const
+		{
+			return FIntPoint(
+				FMath::Clamp(FMath::FloorToInt((Location.X - Origin.X) / CellSize), 0, NumCellsX - 1),
+				FMath::Clamp(FMath::FloorToInt((Location.Y - Origin.Y) / CellSize), 0, NumCellsY - 1));
+		}
+
+	private:
+		TBitArray<> Cells;
+		FVector2D Origin;
+		float CellSize;
+		int32 NumCellsX;
+		int32 NumCellsY;
+	};
+
+	/**
+	 * Answers the locations on open terrain from the heightfields, the highest landscape within the height of the region wins.
+	 * Sets OutOnHeightfield for the locations that were answered, the rest have to be traced.
+	 */
+	static void SampleHeightfields(UWorld* World, const FBox& Region, TArrayView<const TSharedPtr<const FDesignerLandscapeHeightfield>> Heightfields, TArrayView<const FVector2D> Locations,
+		FDesignerCandidateBuffer& OutSurfaces, TArrayView<bool> OutOnHeightfield)
+	{
+		const FCoverageMask CoverageMask(World, Region);
+
+		const int32 NumBatches = FMath::DivideAndRoundUp(Locations.Num(), HeightfieldBatchSize);
+		ParallelFor(NumBatches, [&](int32 BatchIndex)
+		{
+			const int32 FirstLocation = BatchIndex * HeightfieldBatchSize;
+			const int32 NumLocations = FMath::Min(HeightfieldBatchSize, Locations.Num() - FirstLocation);
+
+			FVector HitLocations[HeightfieldBatchSize];
+			FVector HitNormals[HeightfieldBatchSize];
+			bool bHits[HeightfieldBatchSize];
+			for (const TSharedPtr<const FDesignerLandscapeHeightfield>& Heightfield : Heightfields)
+			{
+				Heightfield->Sample(Locations.Slice(FirstLocation, NumLocations), MakeArrayView(HitLocations, NumLocations), MakeArrayView(HitNormals, NumLocations), MakeArrayView(bHits, NumLocations));
+
+				for (int32 HitIndex = 0; HitIndex < NumLocations; ++HitIndex)
+				{
+					const int32 LocationIndex = FirstLocation + HitIndex;
+					if (bHits[HitIndex] && HitLocations[HitIndex].Z >= Region.Min.Z && HitLocations[HitIndex].Z <= Region.Max.Z
+						&& (!OutOnHeightfield[LocationIndex] || HitLocations[HitIndex].Z > OutSurfaces.LocationZ[LocationIndex]))
+					{
+						OutSurfaces.SetSurface(LocationIndex, HitLocations[HitIndex], HitNormals[HitIndex]);
+						OutOnHeightfield[LocationIndex] = true;
+					}
+				}
+			}
+
+			for (int32 LocationIndex = FirstLocation; LocationIndex < FirstLocation + NumLocations; ++LocationIndex)
+			{
+				OutOnHeightfield[LocationIndex] = OutOnHeightfield[LocationIndex] && !CoverageMask.IsCovered(Locations[LocationIndex]);
+			}
+		});
+	}
+}
+
+int32 FDesignerScatter::Scatter(UWorld* World, const UDesignerSettings* Settings, const FDesignerScatterParams& Params, FDesignerPlacementBatch& OutBatch)
+{
+	check(World != nullptr);
+	check(Settings != nullptr);
+
+	// Every palette entry gets a slot in the asset table, entries that share an asset share the slot
+	const UDesignerPalette* Palette = Settings->Palette;
+	TArray<int32> EntryAssetIndices;
+	if (Palette != nullptr)
+	{
+		EntryAssetIndices.SetNumUninitialized(Palette->Entries.Num());
+		for (int32 EntryIndex = 0; EntryIndex < Palette->Entries.Num(); ++EntryIndex)
+		{
+			const UObject* Asset = Palette->Entries[EntryIndex].Asset;
+			EntryAssetIndices[EntryIndex] = Asset != nullptr ? OutBatch.FindOrAddAsset(FSoftObjectPath(Asset)) : INDEX_NONE;
+		}
+	}
+	else
+	{
+		check(OutBatch.Assets.Num() > 0);
+	}
+
+	FRandomStream RandomStream(Params.Seed);
+
+	// All random values are drawn up front on this thread so the result does not depend on the scheduling of the traces
+	TArray<FVector2D> CandidateLocations;
+	const FBox2D Region(FVector2D(Params.Bounds.Min), FVector2D(Params.Bounds.Max));
+	TSharedPtr<const FDesignerDensityMap> DensityMap = FDesignerDensityMap::FindOrBuild(World, Settings);
+	if (DensityMap.IsValid())
+	{
+		DensityMap->DrawLocations(Region, Params.Density, RandomStream, CandidateLocations);
+	}
+	else
+	{
+		// The expected number of candidates, the fraction is resolved randomly so density is preserved on small regions
+		const FVector2D RegionSize = Region.GetSize();
+		const float ExpectedCount = (RegionSize.X * RegionSize.Y / 10000.F) * Params.Density;
+		int32 NumLocations = FMath::FloorToInt(ExpectedCount);
+		if (RandomStream.FRand() < ExpectedCount - NumLocations)
+		{
+			++NumLocations;
+		}
+
+		CandidateLocations.SetNumUninitialized(FMath::Max(NumLocations, 0));
+		for (FVector2D& CandidateLocation : CandidateLocations)
+		{
+			CandidateLocation = FVector2D(
+				RandomStream.FRandRange(Region.Min.X, Region.Max.X),
+				RandomStream.FRandRange(Region.Min.Y, Region.Max.Y));
+		}
+	}
+
+	const int32 NumCandidates = CandidateLocations.Num();
+	if (NumCandidates <= 0)
+	{
+		return 0;
+	}
+
+	TArray<FDesignerPlacementInstance> Candidates;
+	TArray<int32> CandidateEntries;
+	TArray<bool> CandidateHits;
+	Candidates.SetNumUninitialized(NumCandidates);
+	CandidateEntries.SetNumUninitialized(NumCandidates);
+	CandidateHits.SetNumZeroed(NumCandidates);
+
+	for (int32 CandidateIndex = 0; CandidateIndex < NumCandidates; ++CandidateIndex)
+	{
+		if (Palette != nullptr)
+		{
+			const int32 EntryIndex = Palette->PickEntry(RandomStream);
+			CandidateEntries[CandidateIndex] = EntryIndex;
+			Candidates[CandidateIndex].AssetIndex = EntryIndex != INDEX_NONE ? EntryAssetIndices[EntryIndex] : INDEX_NONE;
+		}
+		else
+		{
+			CandidateEntries[CandidateIndex] = INDEX_NONE;
+			Candidates[CandidateIndex].AssetIndex = RandomStream.RandRange(0, OutBatch.Assets.Num() - 1);
+		}
+		Candidates[CandidateIndex].Seed = static_cast<int32>(RandomStream.GetUnsignedInt());
+	}
+
+	const FDesignerPlacementRules Rules(Settings);
+
+	// Candidates on open terrain are answered from the landscape heightfields, everything else is traced.
+	// Heightfields do not know the physical material of the surface, so rules on it need every candidate traced
+	FDesignerCandidateBuffer Surfaces;
+	Surfaces.SetNum(NumCandidates);
+
+	TArray<TSharedPtr<const FDesignerLandscapeHeightfield>> Heightfields;
+	if (!Rules.NeedsPhysicalMaterials())
+	{
+		FDesignerLandscapeHeightfield::FindOrBuild(World, Params.Bounds, Heightfields);
+	}
+	if (Heightfields.Num() > 0)
+	{
+		DesignerScatter::SampleHeightfields(World, Params.Bounds, Heightfields, CandidateLocations, Surfaces, CandidateHits);
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(DesignerScatter), /*bTraceComplex*/true);
+	QueryParams.bReturnPhysicalMaterial = Rules.NeedsPhysicalMaterials();
+	FCollisionObjectQueryParams ObjectQueryParams(FCollisionObjectQueryParams::InitType::AllStaticObjects);
+
+	ParallelFor(NumCandidates, [&](int32 CandidateIndex)
+	{
+		// An empty palette places nothing
+		if (CandidateHits[CandidateIndex] || Candidates[CandidateIndex].AssetIndex == INDEX_NONE)
+		{
+			return;
+		}
+
+		const FVector2D& CandidateLocation = CandidateLocations[CandidateIndex];
+		FVector TraceStart(CandidateLocation.X, CandidateLocation.Y, Params.Bounds.Max.Z);
+		FVector TraceEnd(CandidateLocation.X, CandidateLocation.Y, Params.Bounds.Min.Z);
+
+		FHitResult Hit;
+		if (World->LineTraceSingleByObjectType(Hit, TraceStart, TraceEnd, ObjectQueryParams, QueryParams))
+		{
+			Surfaces.SetSurface(CandidateIndex, Hit.Location, Hit.ImpactNormal);
+			Surfaces.PhysicalMaterials[CandidateIndex] = Hit.PhysMaterial.Get();
+			CandidateHits[CandidateIndex] = true;
+		}
+	});
+
+	// The rules run over whole batches of surfaces before any transform is built, rejected candidates go no further
+	const FDesignerRotationGrid RotationGrid = FDesignerRotationGrid::GetEditorGrid();
+	FThreadSafeCounter NumFallbackRotations;
+	const int32 NumCandidateBatches = FMath::DivideAndRoundUp(NumCandidates, DesignerScatter::CandidateBatchSize);
+	ParallelFor(NumCandidateBatches, [&](int32 BatchIndex)
+	{
+		const int32 FirstCandidate = BatchIndex * DesignerScatter::CandidateBatchSize;
+		const int32 NumBatchCandidates = FMath::Min(DesignerScatter::CandidateBatchSize, NumCandidates - FirstCandidate);
+		Rules.Filter(Surfaces, FirstCandidate, NumBatchCandidates, CandidateHits);
+
+		for (int32 CandidateIndex = FirstCandidate; CandidateIndex < FirstCandidate + NumBatchCandidates; ++CandidateIndex)
+		{
+			if (!CandidateHits[CandidateIndex] || Candidates[CandidateIndex].AssetIndex == INDEX_NONE)
+			{
+				CandidateHits[CandidateIndex] = false;
+				continue;
+			}
+
+			FDesignerPlacementInstance& Candidate = Candidates[CandidateIndex];
+			const int32 EntryIndex = CandidateEntries[CandidateIndex];
+			const FDesignerPaletteEntry* PaletteEntry = EntryIndex != INDEX_NONE ? &Palette->Entries[EntryIndex] : nullptr;
+			bool bUsedFallbackRotation = false;
+			Candidate.Transform = FDesignerPlacementTransform::MakeSurfaceTransform(Settings, RotationGrid, Surfaces.GetLocation(CandidateIndex), Surfaces.GetNormal(CandidateIndex), Candidate.Seed, 1.F, PaletteEntry, &bUsedFallbackRotation);
+			if (bUsedFallbackRotation)
+			{
+				NumFallbackRotations.Increment();
+			}
+		}
+	});
+	FDesignerPlacementTransform::WarnFallbackRotations(NumFallbackRotations.GetValue());
+
+	const int32 FirstInstance = OutBatch.Instances.Num();
+	OutBatch.Instances.Reserve(FirstInstance + NumCandidates);
+	for (int32 CandidateIndex = 0; CandidateIndex < NumCandidates; ++CandidateIndex)
+	{
+		if (CandidateHits[CandidateIndex])
+		{
+			OutBatch.Instances.Add(Candidates[CandidateIndex]);
+		}
+	}
+
+	if (Settings->bRejectOverlaps)
+	{
+		// Palette entries that share an asset share its slot, the largest padding of them is used
+		TArray<float> AssetPadding;
+		AssetPadding.Init(Settings->OverlapPadding, OutBatch.Assets.Num());
+		if (Palette != nullptr)
+		{
+			TArray<bool> AssetPaddingOverridden;
+			AssetPaddingOverridden.SetNumZeroed(OutBatch.Assets.Num());
+			for (int32 EntryIndex = 0; EntryIndex < Palette->Entries.Num(); ++EntryIndex)
+			{
+				const FDesignerPaletteEntry& PaletteEntry = Palette->Entries[EntryIndex];
+				const int32 AssetIndex = EntryAssetIndices[EntryIndex];
+				if (AssetIndex != INDEX_NONE && PaletteEntry.bOverrideOverlapPadding)
+				{
+					AssetPadding[AssetIndex] = AssetPaddingOverridden[AssetIndex] ? FMath::Max(AssetPadding[AssetIndex], PaletteEntry.OverlapPadding) : PaletteEntry.OverlapPadding;
+					AssetPaddingOverridden[AssetIndex] = true;
+				}
+			}
+		}
+
+		FDesignerOverlapFilter::RejectOverlaps(World, OutBatch, FirstInstance, AssetPadding);
+	}
+
+	return OutBatch.Instances.Num() - FirstInstance;
+}
+
+int32 FDesignerScatter::MakeRegionSeed(int32 BaseSeed, int32 RegionIndex)
+{
+	return static_cast<int32>(HashCombine(GetTypeHash(BaseSeed), GetTypeHash(RegionIndex)));
+}
@@ -0,0 +1,77 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Forward Declares
+class UDesignerSettings;
+class UWorld;
+struct FDesignerPlacementBatch;
+
+/**
+ * The region and density of a single scatter run
+ */
+struct FDesignerScatterParams
+{
+	FDesignerScatterParams()
+		: Bounds(ForceInit)
+		, Density(0.F)
+		, Seed(0)
+	{
+	}
+
+	/** The region to scatter in. Candidates are traced from the top to the bottom of the bounds */
+	FBox Bounds;
+
+	/** The number of placements per square meter, scaled by the density map of the settings when it has one */
+	float Density;
+
+	/** The seed all random values of this run are derived from */
+	int32 Seed;
+};
+
+/**
+ * Scatters assets over the surfaces in a region.
+ * The result only depends on the world, the settings and the params, so the same region always produces the same placements.
+ */
+class FDesignerScatter
+{
+public:
+	/**
+	 * Appends the placements for the region to OutBatch.
+	 * The assets are picked by weight from the palette of the settings when it has one, and are added to the asset table of OutBatch.
+	 * Otherwise they are picked uniformly from the asset table of OutBatch, which must not be empty then.
+	 * Locations on open landscape are sampled from a cached copy of its heightfield, everything else is traced.
+	 * Surfaces that break the placement rules of the settings are rejected before any transform is built.
+	 * When the settings reject overlaps, placements overlapping placed content or each other are left out.
+	 * Returns the number of placements that were added.
+	 */
+	static int32 Scatter(UWorld* World, const UDesignerSettings* Settings, const FDesignerScatterParams& Params, FDesignerPlacementBatch& OutBatch);
+
+	/** Combines a base seed with a sub region index into the seed of that sub region */
+	static int32 MakeRegionSeed(int32 BaseSeed, int32 RegionIndex);
+};
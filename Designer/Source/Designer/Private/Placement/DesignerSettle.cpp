@@ -0,0 +1,374 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerSettle.h"
+
+// Engine Includes
+#include "Components/BoxComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Editor.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/Selection.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Parse.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "PreviewScene.h"
+#include "ScopedTransaction.h"
+
+// Local Includes
+#include "DesignerModule.h"
+#include "Diagnostics/DesignerMemory.h"
+#include "Placement/DesignerBulkEditScope.h"
+
+#define LOCTEXT_NAMESPACE "DesignerSettle"
+
+namespace DesignerSettle
+{
+	/** The maximum number of samples along each side of the region when approximating surfaces that cannot be copied */
+	static const int32 MaxSurfaceSamplesPerAxis = 64;
+
+	/** The minimum distance between two surface samples in cm */
+	static const float MinSurfaceSampleSpacing = 25.F;
+
+	/** Checking whether everything sleeps touches every body, so it is only done every few steps */
+	static const int32 StepsPerRestCheck = 10;
+
+	/** Returns the static mesh root of the actor if it can be simulated */
+	static UStaticMeshComponent* GetSimulatedComponent(const AActor* Actor)
+	{
+		UStaticMeshComponent* Component = Actor != nullptr ? Cast<UStaticMeshComponent>(Actor->GetRootComponent()) : nullptr;
+		if (Component == nullptr || Component->IsA<UInstancedStaticMeshComponent>() || Component->GetStaticMesh() == nullptr)
+		{
+			return nullptr;
+		}
+
+		// Dynamic bodies can only use simple collision
+		const UBodySetup* BodySetup = Component->GetStaticMesh()->BodySetup;
+		if (BodySetup == nullptr || BodySetup->AggGeom.GetElementCount() == 0)
+		{
+			return nullptr;
+		}
+
+		return Component;
+	}
+
+	/** Creates an invisible static mesh component in the scene, instanced if the source is */
+	static UStaticMeshComponent* AddStaticMeshCopy(FPreviewScene& Scene, const UStaticMeshComponent* Source)
+	{
+		UStaticMeshComponent* Copy = Source->IsA<UInstancedStaticMeshComponent>()
+			? NewObject<UInstancedStaticMeshComponent>(GetTransientPackage())
+			: NewObject<UStaticMeshComponent>(GetTransientPackage());
+		Copy->SetStaticMesh(Source->GetStaticMesh());
+		Copy->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		Copy->SetVisibility(false);
+		Scene.AddComponent(Copy, Source->GetComponentTransform());
+		return Copy;
+	}
+
+	/** Approximates surfaces that cannot be copied with a box under every sample of a grid over the region */
+	static void AddSampledSurfaces(FPreviewScene& Scene, const TArray<UPrimitiveComponent*>& Surfaces, const FBox& Region)
+	{
+		const FVector RegionSize = Region.GetSize();
+		const float Spacing = FMath::Max(MinSurfaceSampleSpacing, FMath::Max(RegionSize.X, RegionSize.Y) / MaxSurfaceSamplesPerAxis);
+		const int32 NumSamplesX = FMath::CeilToInt(RegionSize.X / Spacing) + 1;
+		const int32 NumSamplesY = FMath::CeilToInt(RegionSize.Y / Spacing) + 1;
+
+		// The boxes overlap their neighbours slightly so bodies cannot fall through the seams
+		const FVector BoxExtent(Spacing * 0.55F, Spacing * 0.55F, Spacing * 0.5F);
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(DesignerSettle), /*bTraceComplex*/true);
+		for (int32 SampleY = 0; SampleY < NumSamplesY; ++SampleY)
+		{
+			for (int32 SampleX = 0; SampleX < NumSamplesX; ++SampleX)
+			{
+				const FVector2D SampleLocation(Region.Min.X + SampleX * Spacing, Region.Min.Y + SampleY * Spacing);
+				const FVector TraceStart(SampleLocation, Region.Max.Z);
+				const FVector TraceEnd(SampleLocation, Region.Min.Z);
+
+				// The highest surface is the one bodies fall onto
+				FHitResult BestHit;
+				BestHit.ImpactPoint.Z = -WORLD_MAX;
+				for (UPrimitiveComponent* Surface : Surfaces)
+				{
+					FHitResult Hit;
+					if (Surface->LineTraceComponent(Hit, TraceStart, TraceEnd, QueryParams) && Hit.ImpactPoint.Z > BestHit.ImpactPoint.Z)
+					{
+						BestHit = Hit;
+					}
+				}
+
+				if (BestHit.ImpactPoint.Z == -WORLD_MAX)
+				{
+					continue;
+				}
+
+				const FQuat BoxRotation = FRotationMatrix::MakeFromZ(BestHit.ImpactNormal).ToQuat();
+				UBoxComponent* Box = NewObject<UBoxComponent>(GetTransientPackage());
+				Box->SetBoxExtent(BoxExtent, /*bUpdateOverlaps*/false);
+				Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+				Scene.AddComponent(Box, FTransform(BoxRotation, BestHit.ImpactPoint - BestHit.ImpactNormal * BoxExtent.Z));
+			}
+		}
+	}
+}
+
+int32 FDesignerSettle::Simulate(UWorld* World, const TArray<AActor*>& Actors, const FDesignerSettleParams& Params, TArray<FTransform>& OutTransforms)
+{
+	using namespace DesignerSettle;
+
+	check(World != nullptr);
+
+	OutTransforms.SetNumUninitialized(Actors.Num());
+	for (int32 ActorIndex = 0; ActorIndex < Actors.Num(); ++ActorIndex)
+	{
+		OutTransforms[ActorIndex] = Actors[ActorIndex] != nullptr ? Actors[ActorIndex]->GetActorTransform() : FTransform::Identity;
+	}
+
+	TArray<int32> SimulatedActors;
+	FBox Region(ForceInit);
+	for (int32 ActorIndex = 0; ActorIndex < Actors.Num(); ++ActorIndex)
+	{
+		if (UStaticMeshComponent* Component = GetSimulatedComponent(Actors[ActorIndex]))
+		{
+			SimulatedActors.Add(ActorIndex);
+			Region += Component->Bounds.GetBox();
+		}
+	}
+
+	if (SimulatedActors.Num() == 0)
+	{
+		return 0;
+	}
+
+	// Bodies fall down, so the region reaches further below the actors than around them
+	Region = Region.ExpandBy(FVector(Params.SurroundingsMargin, Params.SurroundingsMargin, Region.GetSize().Z + Params.SurroundingsMargin), FVector(Params.SurroundingsMargin));
+
+	FPreviewScene::ConstructionValues SceneValues;
+	SceneValues.bCreatePhysicsScene = true;
+	SceneValues.bShouldSimulatePhysics = true;
+	SceneValues.bTransactional = false;
+	SceneValues.bDefaultLighting = false;
+	SceneValues.bAllowAudioPlayback = false;
+	FPreviewScene Scene(SceneValues);
+
+	// Copy the static surroundings, the settled actors are left out so they do not collide with themselves
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(DesignerSettle), /*bTraceComplex*/false);
+	for (int32 ActorIndex : SimulatedActors)
+	{
+		QueryParams.AddIgnoredActor(Actors[ActorIndex]);
+	}
+
+	TArray<FOverlapResult> Overlaps;
+	World->OverlapMultiByObjectType(Overlaps, Region.GetCenter(), FQuat::Identity, FCollisionObjectQueryParams(FCollisionObjectQueryParams::InitType::AllStaticObjects), FCollisionShape::MakeBox(Region.GetExtent()), QueryParams);
+
+	TMap<UInstancedStaticMeshComponent*, UInstancedStaticMeshComponent*> InstancedCopies;
+	TSet<UPrimitiveComponent*> CopiedComponents;
+	TArray<UPrimitiveComponent*> SampledSurfaces;
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		UPrimitiveComponent* Component = Overlap.GetComponent();
+		if (Component == nullptr)
+		{
+			continue;
+		}
+
+		// Every overlapping instance is reported separately
+		if (UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(Component))
+		{
+			UInstancedStaticMeshComponent*& InstancedCopy = InstancedCopies.FindOrAdd(InstancedComponent);
+			if (InstancedCopy == nullptr)
+			{
+				InstancedCopy = CastChecked<UInstancedStaticMeshComponent>(AddStaticMeshCopy(Scene, InstancedComponent));
+			}
+
+			FTransform InstanceTransform;
+			if (InstancedComponent->GetInstanceTransform(Overlap.ItemIndex, InstanceTransform, /*bWorldSpace*/true))
+			{
+				InstancedCopy->AddInstanceWorldSpace(InstanceTransform);
+			}
+			continue;
+		}
+
+		bool bAlreadyCopied = false;
+		CopiedComponents.Add(Component, &bAlreadyCopied);
+		if (bAlreadyCopied)
+		{
+			continue;
+		}
+
+		if (UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(Component))
+		{
+			if (StaticMeshComponent->GetStaticMesh() != nullptr)
+			{
+				AddStaticMeshCopy(Scene, StaticMeshComponent);
+			}
+		}
+		else
+		{
+			SampledSurfaces.Add(Component);
+		}
+	}
+
+	if (SampledSurfaces.Num() > 0)
+	{
+		AddSampledSurfaces(Scene, SampledSurfaces, Region);
+	}
+
+	TArray<UStaticMeshComponent*> Bodies;
+	Bodies.Reserve(SimulatedActors.Num());
+	for (int32 ActorIndex : SimulatedActors)
+	{
+		const UStaticMeshComponent* Source = GetSimulatedComponent(Actors[ActorIndex]);
+
+		UStaticMeshComponent* Body = NewObject<UStaticMeshComponent>(GetTransientPackage());
+		Body->SetStaticMesh(Source->GetStaticMesh());
+		Body->SetMobility(EComponentMobility::Movable);
+		Body->SetCollisionProfileName(UCollisionProfile::PhysicsActor_ProfileName);
+		Body->SetSimulatePhysics(true);
+		Body->SetVisibility(false);
+		Scene.AddComponent(Body, Source->GetComponentTransform());
+		Bodies.Add(Body);
+	}
+
+	// The physics scene of the preview world runs its simulation on the task graph workers
+	UWorld* SimulationWorld = Scene.GetWorld();
+	const int32 MaxSteps = FMath::CeilToInt(Params.MaxSeconds / Params.StepSeconds);
+	int32 NumSteps = 0;
+	while (NumSteps < MaxSteps)
+	{
+		SimulationWorld->Tick(LEVELTICK_All, Params.StepSeconds);
+		++NumSteps;
+
+		if (NumSteps % StepsPerRestCheck == 0 && !Bodies.ContainsByPredicate([](const UStaticMeshComponent* Body) { return Body->RigidBodyIsAwake(); }))
+		{
+			break;
+		}
+	}
+
+	UE_LOG(LogDesigner, Verbose, TEXT("Settled %d bodies in %d steps."), Bodies.Num(), NumSteps);
+
+	// The simulated component is the root, so the actor moves along with it
+	int32 NumUnsettled = 0;
+	for (int32 BodyIndex = 0; BodyIndex < Bodies.Num(); ++BodyIndex)
+	{
+		const int32 ActorIndex = SimulatedActors[BodyIndex];
+
+		// A body that left the copied surroundings fell past them, one still awake never came to rest. Both keep their transform
+		const UStaticMeshComponent* Body = Bodies[BodyIndex];
+		if (Body->RigidBodyIsAwake() || !Region.IsInside(Body->GetComponentLocation()))
+		{
+			++NumUnsettled;
+			continue;
+		}
+
+		const FTransform& SourceComponentTransform = Actors[ActorIndex]->GetRootComponent()->GetComponentTransform();
+		const FTransform RootToActor = Actors[ActorIndex]->GetActorTransform().GetRelativeTransform(SourceComponentTransform);
+		OutTransforms[ActorIndex] = RootToActor * Body->GetComponentTransform();
+	}
+
+	if (NumUnsettled > 0)
+	{
+		UE_LOG(LogDesigner, Warning, TEXT("%d of %d actors did not come to rest on their surroundings within %.1f seconds, they keep their transform."), NumUnsettled, Bodies.Num(), Params.MaxSeconds);
+	}
+
+	return Bodies.Num();
+}
+
+int32 FDesignerSettle::Settle(UWorld* World, const TArray<AActor*>& Actors, const FDesignerSettleParams& Params)
+{
+	TArray<FTransform> RestingTransforms;
+	const int32 NumSimulated = Simulate(World, Actors, Params, RestingTransforms);
+	if (NumSimulated == 0)
+	{
+		return 0;
+	}
+
+	FDesignerBulkEditScope BulkEditScope;
+
+	int32 NumMoved = 0;
+	for (int32 ActorIndex = 0; ActorIndex < Actors.Num(); ++ActorIndex)
+	{
+		AActor* Actor = Actors[ActorIndex];
+		if (Actor == nullptr || Actor->GetActorTransform().Equals(RestingTransforms[ActorIndex]))
+		{
+			continue;
+		}
+
+		{
+			DESIGNER_LLM_SCOPE(EDesignerLLMTag::Transactions);
+			Actor->Modify();
+		}
+		Actor->SetActorTransform(RestingTransforms[ActorIndex]);
+		Actor->PostEditMove(/*bFinished*/true);
+		FDesignerBulkEditScope::MarkLevelDirty(Actor->GetLevel());
+		++NumMoved;
+	}
+
+	return NumMoved;
+}
+
+/**
+ * designer.settle [seconds=<Max>] [step=<Seconds>]
+ * Drops the selected actors onto their surroundings in an isolated physics simulation.
+ */
+static void SettleCommand(const TArray<FString>& Args)
+{
+	FDesignerSettleParams Params;
+	for (const FString& Arg : Args)
+	{
+		FParse::Value(*Arg, TEXT("seconds="), Params.MaxSeconds);
+		FParse::Value(*Arg, TEXT("step="), Params.StepSeconds);
+	}
+	Params.StepSeconds = FMath::Max(Params.StepSeconds, 1.F / 1000.F);
+
+	TArray<AActor*> Actors;
+	GEditor->GetSelectedActors()->GetSelectedObjects<AActor>(Actors);
+	if (Actors.Num() == 0)
+	{
+		UE_LOG(LogDesigner, Display, TEXT("Select the actors to settle first."));
+		return;
+	}
+
+	FScopedTransaction Transaction(LOCTEXT("SettleTransaction", "Designer: Settle Actors"));
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 NumMoved = FDesignerSettle::Settle(GEditor->GetEditorWorldContext().World(), Actors, Params);
+	if (NumMoved == 0)
+	{
+		Transaction.Cancel();
+	}
+
+	UE_LOG(LogDesigner, Display, TEXT("Settled %d of %d actors in %.2f seconds."), NumMoved, Actors.Num(), FPlatformTime::Seconds() - StartTime);
+}
+
+static FAutoConsoleCommand SettleConsoleCommand(
+	TEXT("designer.settle"),
+	TEXT("Drops the selected actors onto their surroundings with an isolated physics simulation. Usage: designer.settle [seconds=<Max>] [step=<Seconds>]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&SettleCommand));
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,76 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Forward Declares
+class AActor;
+class UWorld;
+
+/**
+ * The stepping of a settle simulation
+ */
+struct FDesignerSettleParams
+{
+	FDesignerSettleParams()
+		: StepSeconds(1.F / 120.F)
+		, MaxSeconds(10.F)
+		, SurroundingsMargin(200.F)
+	{
+	}
+
+	/** The length of a single physics step, short steps keep small debris from tunneling */
+	float StepSeconds;
+
+	/** The simulation stops after this time even if not everything came to rest */
+	float MaxSeconds;
+
+	/** How far around the settled actors the static surroundings are copied, in cm */
+	float SurroundingsMargin;
+};
+
+/**
+ * Drops actors onto their surroundings with a physics simulation, without simulating the editor world.
+ *
+ * The actors and the static content around them are copied into an isolated preview scene that only contains them.
+ * Static mesh surroundings are copied as they are, other static surfaces such as landscapes are approximated with
+ * a grid of boxes sampled from them. The scene is stepped with short fixed steps until all bodies sleep.
+ * Only actors with a static mesh root component that has simple collision can be settled.
+ */
+class FDesignerSettle
+{
+public:
+	/**
+	 * Simulates the actors until they come to rest. OutTransforms has the resting transform of every actor,
+	 * actors that cannot be settled, fall out of their surroundings or are still moving at the time limit keep their transform.
+	 * Returns the number of actors that were simulated.
+	 */
+	static int32 Simulate(UWorld* World, const TArray<AActor*>& Actors, const FDesignerSettleParams& Params, TArray<FTransform>& OutTransforms);
+
+	/** Simulates the actors and moves them to their resting transforms, recorded in the current transaction. Returns the number of actors that were moved */
+	static int32 Settle(UWorld* World, const TArray<AActor*>& Actors, const FDesignerSettleParams& Params = FDesignerSettleParams());
+};
@@ -0,0 +1,422 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerSnapIndex.h"
+
+// Engine Includes
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshSocket.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+
+// Local Includes
+#include "Diagnostics/DesignerMemory.h"
+
+namespace DesignerSnapIndex
+{
+	/** The tree is only rebuilt once the pending or removed points exceed this or a fraction of the tree */
+	static const int32 MinPointsBeforeRebuild = 1024;
+	static const int32 PendingFractionBeforeRebuild = 8;
+	static const int32 RemovedFractionBeforeRebuild = 4;
+
+	/** Reorders the range so the element at Nth is the one a sort by Less would put there, with no larger element before it and no smaller one after it */
+	template<typename PredicateType>
+	static void SelectNth(TArray<int32>& Indices, int32 Begin, int32 End, int32 Nth, PredicateType Less)
+	{
+		while (End - Begin > 1)
+		{
+			// Hoare partition around the middle element
+			const int32 Pivot = Indices[(Begin + End) / 2];
+			int32 Left = Begin;
+			int32 Right = End - 1;
+			while (Left <= Right)
+			{
+				while (Less(Indices[Left], Pivot))
+				{
+					++Left;
+				}
+				while (Less(Pivot, Indices[Right]))
+				{
+					--Right;
+				}
+				if (Left <= Right)
+				{
+					Swap(Indices[Left], Indices[Right]);
+					++Left;
+					--Right;
+				}
+			}
+
+			if (Nth <= Right)
+			{
+				End = Right + 1;
+			}
+			else if (Nth >= Left)
+			{
+				Begin = Left;
+			}
+			else
+			{
+				return;
+			}
+		}
+	}
+}
+
+FDesignerSnapIndex::FDesignerSnapIndex()
+	: NumRemoved(0)
+{
+}
+
+void FDesignerSnapIndex::Build(UWorld* InWorld)
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Caches);
+
+	Reset();
+	World = InWorld;
+
+	if (InWorld == nullptr)
+	{
+		return;
+	}
+
+	for (TActorIterator<AActor> It(InWorld); It; ++It)
+	{
+		const int32 FirstPoint = Points.Num();
+		GatherSnapPoints(*It, Points);
+		if (Points.Num() > FirstPoint)
+		{
+			TArray<int32>& PointIndices = ActorPoints.Add(FObjectKey(*It));
+			for (int32 PointIndex = FirstPoint; PointIndex < Points.Num(); ++PointIndex)
+			{
+				PointIndices.Add(PointIndex);
+			}
+		}
+	}
+
+	Rebuild();
+}
+
+void FDesignerSnapIndex::Reset()
+{
+	World.Reset();
+	Points.Reset();
+	TreeOrder.Reset();
+	PendingPoints.Reset();
+	ActorPoints.Reset();
+	PendingActors.Reset();
+	NumRemoved = 0;
+}
+
+void FDesignerSnapIndex::AddActor(const AActor* Actor)
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Caches);
+
+	RemoveActor(Actor);
+
+	if (!IndexActor(Actor) && Actor != nullptr)
+	{
+		PendingActors.Add(Actor);
+	}
+}
+
+bool FDesignerSnapIndex::IndexActor(const AActor* Actor)
+{
+	const int32 FirstPoint = Points.Num();
+	GatherSnapPoints(Actor, Points);
+	if (Points.Num() == FirstPoint)
+	{
+		return false;
+	}
+
+	TArray<int32>& PointIndices = ActorPoints.Add(FObjectKey(Actor));
+	for (int32 PointIndex = FirstPoint; PointIndex < Points.Num(); ++PointIndex)
+	{
+		PointIndices.Add(PointIndex);
+		PendingPoints.Add(PointIndex);
+	}
+
+	RebuildIfNeeded();
+	return true;
+}
+
+void FDesignerSnapIndex::IndexPendingActors()
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Caches);
+
+	for (const TWeakObjectPtr<const AActor>& PendingActor : PendingActors)
+	{
+		if (PendingActor.IsValid() && !ActorPoints.Contains(FObjectKey(PendingActor.Get())))
+		{
+			IndexActor(PendingActor.Get());
+		}
+	}
+	PendingActors.Reset();
+}
+
+void FDesignerSnapIndex::RemoveActor(const AActor* Actor)
+{
+	TArray<int32> PointIndices;
+	if (!ActorPoints.RemoveAndCopyValue(FObjectKey(Actor), PointIndices))
+	{
+		return;
+	}
+
+	for (int32 PointIndex : PointIndices)
+	{
+		Points[PointIndex].bRemoved = true;
+	}
+	NumRemoved += PointIndices.Num();
+
+	RebuildIfNeeded();
+}
+
+bool FDesignerSnapIndex::FindSnap(TArrayView<const FDesignerSnapPoint> GhostPoints, float MaxDistance, const AActor* IgnoredActor, FVector& OutOffset)
+{
+	if (PendingActors.Num() > 0)
+	{
+		IndexPendingActors();
+	}
+
+	const FObjectKey IgnoredActorKey(IgnoredActor);
+
+	float BestDistanceSquared = FMath::Square(MaxDistance);
+	int32 BestPoint = INDEX_NONE;
+	int32 BestGhostPoint = INDEX_NONE;
+
+	for (int32 GhostIndex = 0; GhostIndex < GhostPoints.Num(); ++GhostIndex)
+	{
+		const FDesignerSnapPoint& Ghost = GhostPoints[GhostIndex];
+		int32 GhostBestPoint = INDEX_NONE;
+
+		// Every ghost point only has to beat the best distance of the previous ones
+		SearchSubtree(0, TreeOrder.Num(), 0, Ghost, IgnoredActorKey, BestDistanceSquared, GhostBestPoint);
+
+		for (int32 PointIndex : PendingPoints)
+		{
+			const FDesignerSnapPoint& Point = Points[PointIndex];
+			const float DistanceSquared = FVector::DistSquared(Point.Location, Ghost.Location);
+			if (DistanceSquared < BestDistanceSquared && IsCandidate(Point, Ghost, IgnoredActorKey))
+			{
+				BestDistanceSquared = DistanceSquared;
+				GhostBestPoint = PointIndex;
+			}
+		}
+
+		if (GhostBestPoint != INDEX_NONE)
+		{
+			BestPoint = GhostBestPoint;
+			BestGhostPoint = GhostIndex;
+		}
+	}
+
+	if (BestPoint == INDEX_NONE)
+	{
+		return false;
+	}
+
+	OutOffset = Points[BestPoint].Location - GhostPoints[BestGhostPoint].Location;
+	return true;
+}
+
+void FDesignerSnapIndex::GatherSnapPoints(const AActor* Actor, TArray<FDesignerSnapPoint>& OutPoints)
+{
+	if (Actor == nullptr || Actor->IsPendingKillPending())
+	{
+		return;
+	}
+
+	FDesignerSnapPoint SnapPoint;
+	SnapPoint.Actor = FObjectKey(Actor);
+	SnapPoint.bRemoved = false;
+
+	TInlineComponentArray<UStaticMeshComponent*> Components;
+	Actor->GetComponents(Components);
+	for (const UStaticMeshComponent* Component : Components)
+	{
+		// Instances are not modular pieces, and there can be far too many of them
+		if (Component->GetStaticMesh() == nullptr || Component->IsEditorOnly() || Component->IsA<UInstancedStaticMeshComponent>())
+		{
+			continue;
+		}
+
+		const FTransform& ComponentTransform = Component->GetComponentTransform();
+
+		SnapPoint.Type = EDesignerSnapPointType::BoundsFace;
+		const FBox LocalBox = Component->GetStaticMesh()->GetBoundingBox();
+		const FVector LocalCenter = LocalBox.GetCenter();
+		const FVector LocalExtent = LocalBox.GetExtent();
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			FVector FaceOffset = FVector::ZeroVector;
+			FaceOffset[Axis] = LocalExtent[Axis];
+
+			SnapPoint.Location = ComponentTransform.TransformPosition(LocalCenter + FaceOffset);
+			OutPoints.Add(SnapPoint);
+			SnapPoint.Location = ComponentTransform.TransformPosition(LocalCenter - FaceOffset);
+			OutPoints.Add(SnapPoint);
+		}
+
+		// The sockets of a static mesh component are the sockets of its mesh, read in place to not copy their names
+		SnapPoint.Type = EDesignerSnapPointType::Socket;
+		for (const UStaticMeshSocket* Socket : Component->GetStaticMesh()->Sockets)
+		{
+			if (Socket != nullptr)
+			{
+				SnapPoint.Location = Component->GetSocketLocation(Socket->SocketName);
+				OutPoints.Add(SnapPoint);
+			}
+		}
+	}
+}
+
+SIZE_T FDesignerSnapIndex::GetAllocatedSize() const
+{
+	SIZE_T AllocatedSize = Points.GetAllocatedSize() + TreeOrder.GetAllocatedSize() + PendingPoints.GetAllocatedSize() + ActorPoints.GetAllocatedSize()
+		+ PendingActors.GetAllocatedSize();
+	for (const TPair<FObjectKey, TArray<int32>>& Pair : ActorPoints)
+	{
+		AllocatedSize += Pair.Value.GetAllocatedSize();
+	}
+	return AllocatedSize;
+}
+
+void FDesignerSnapIndex::RebuildIfNeeded()
+{
+	using namespace DesignerSnapIndex;
+
+	const int32 NumInTree = TreeOrder.Num();
+	if (PendingPoints.Num() > FMath::Max(MinPointsBeforeRebuild, NumInTree / PendingFractionBeforeRebuild)
+		|| NumRemoved > FMath::Max(MinPointsBeforeRebuild, NumInTree / RemovedFractionBeforeRebuild))
+	{
+		Rebuild();
+	}
+}
+
+void FDesignerSnapIndex::Rebuild()
+{
+	// Compact the points, the point indices of the actors move with them
+	if (NumRemoved > 0)
+	{
+		TArray<int32> Remap;
+		Remap.SetNumUninitialized(Points.Num());
+
+		int32 NumKept = 0;
+		for (int32 PointIndex = 0; PointIndex < Points.Num(); ++PointIndex)
+		{
+			Remap[PointIndex] = Points[PointIndex].bRemoved ? INDEX_NONE : NumKept;
+			if (!Points[PointIndex].bRemoved)
+			{
+				Points[NumKept++] = Points[PointIndex];
+			}
+		}
+		Points.SetNum(NumKept, /*bAllowShrinking*/false);
+
+		for (TPair<FObjectKey, TArray<int32>>& Pair : ActorPoints)
+		{
+			for (int32& PointIndex : Pair.Value)
+			{
+				PointIndex = Remap[PointIndex];
+			}
+		}
+
+		NumRemoved = 0;
+	}
+
+	TreeOrder.SetNumUninitialized(Points.Num());
+	for (int32 PointIndex = 0; PointIndex < Points.Num(); ++PointIndex)
+	{
+		TreeOrder[PointIndex] = PointIndex;
+	}
+	PendingPoints.Reset();
+
+	BuildSubtree(0, TreeOrder.Num(), 0);
+}
+
+void FDesignerSnapIndex::BuildSubtree(int32 Begin, int32 End, int32 Depth)
+{
+	while (End - Begin > 1)
+	{
+		const int32 Axis = Depth % 3;
+		const int32 Middle = (Begin + End) / 2;
+		DesignerSnapIndex::SelectNth(TreeOrder, Begin, End, Middle, [this, Axis](int32 A, int32 B)
+		{
+			return Points[A].Location[Axis] < Points[B].Location[Axis];
+		});
+
+		// Recurse into the lower half and loop on the upper one, which halves the recursion
+		BuildSubtree(Begin, Middle, Depth + 1);
+		Begin = Middle + 1;
+		++Depth;
+	}
+}
+
+void FDesignerSnapIndex::SearchSubtree(int32 Begin, int32 End, int32 Depth, const FDesignerSnapPoint& Ghost, const FObjectKey& IgnoredActor, float& InOutBestDistanceSquared, int32& InOutBestPoint) const
+{
+	while (Begin < End)
+	{
+		const int32 Middle = (Begin + End) / 2;
+		const FDesignerSnapPoint& Point = Points[TreeOrder[Middle]];
+
+		const float DistanceSquared = FVector::DistSquared(Point.Location, Ghost.Location);
+		if (DistanceSquared < InOutBestDistanceSquared && IsCandidate(Point, Ghost, IgnoredActor))
+		{
+			InOutBestDistanceSquared = DistanceSquared;
+			InOutBestPoint = TreeOrder[Middle];
+		}
+
+		const int32 Axis = Depth % 3;
+		const float AxisDelta = Ghost.Location[Axis] - Point.Location[Axis];
+
+		// Search the side of the split the ghost is on first, the other side only if the best distance crosses the split
+		const bool bNearIsLower = AxisDelta < 0.F;
+		if (bNearIsLower)
+		{
+			SearchSubtree(Begin, Middle, Depth + 1, Ghost, IgnoredActor, InOutBestDistanceSquared, InOutBestPoint);
+		}
+		else
+		{
+			SearchSubtree(Middle + 1, End, Depth + 1, Ghost, IgnoredActor, InOutBestDistanceSquared, InOutBestPoint);
+		}
+
+		if (FMath::Square(AxisDelta) >= InOutBestDistanceSquared)
+		{
+			return;
+		}
+
+		if (bNearIsLower)
+		{
+			Begin = Middle + 1;
+		}
+		else
+		{
+			End = Middle;
+		}
+		++Depth;
+	}
+}
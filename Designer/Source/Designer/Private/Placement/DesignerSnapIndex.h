@@ -0,0 +1,160 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+// Forward Declares
+class AActor;
+class UWorld;
+
+/**
+ * What a snap point marks on a placed actor. Points only snap to points of the same type
+ */
+enum class EDesignerSnapPointType : uint8
+{
+	/** A socket of a static mesh */
+	Socket,
+
+	/** The center of a face of the bounds of a static mesh */
+	BoundsFace
+};
+
+/**
+ * A world space point other actors can snap to
+ */
+struct FDesignerSnapPoint
+{
+	FVector Location;
+
+	/** The actor the point belongs to */
+	FObjectKey Actor;
+
+	EDesignerSnapPointType Type;
+
+	/** Removed points stay in the index until it is rebuilt */
+	bool bRemoved;
+};
+
+/**
+ * The snap points of all static mesh actors of a world, in a k-d tree for nearest neighbour lookups.
+ *
+ * Changes are applied incrementally: new points are kept in a small list that is searched linearly and removed points
+ * are marked, until either grows large enough relative to the tree that rebuilding the tree is cheaper.
+ *
+ * Actors are reported as added from inside SpawnActor, before an actor factory assigns their mesh. Actors without any
+ * snap points at that time are kept aside and gathered again on the next FindSnap.
+ */
+class FDesignerSnapIndex
+{
+public:
+	FDesignerSnapIndex();
+
+	/** Indexes every actor of the world, replacing the current content */
+	void Build(UWorld* World);
+
+	/** Removes all points */
+	void Reset();
+
+	/** Adds the snap points of the actor, replacing the ones it already had. Actors without snap points are checked again on the next FindSnap */
+	void AddActor(const AActor* Actor);
+
+	/** Removes the snap points of the actor */
+	void RemoveActor(const AActor* Actor);
+
+	/**
+	 * Finds the pair of a point of the ghost and an indexed point of the same type that are closest to each other, within MaxDistance.
+	 * Points of IgnoredActor are skipped. Returns true if a pair was found, OutOffset moves the ghost point onto the indexed point.
+	 * Adds the points of the actors that had none when they were added first.
+	 */
+	bool FindSnap(TArrayView<const FDesignerSnapPoint> GhostPoints, float MaxDistance, const AActor* IgnoredActor, FVector& OutOffset);
+
+	/** Appends the snap points of the actor in its current location */
+	static void GatherSnapPoints(const AActor* Actor, TArray<FDesignerSnapPoint>& OutPoints);
+
+	/** The world the index was built for */
+	UWorld* GetWorld() const
+	{
+		return World.Get();
+	}
+
+	/** The number of points that were not removed */
+	int32 Num() const
+	{
+		return Points.Num() - NumRemoved;
+	}
+
+	/** The memory held by the index */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	/** Gathers the points of the actor and adds them as pending points. Returns false if the actor has no snap points */
+	bool IndexActor(const AActor* Actor);
+
+	/** Indexes the actors that had no snap points when they were added */
+	void IndexPendingActors();
+
+	/** Compacts the points and rebuilds the tree if there are too many pending or removed points */
+	void RebuildIfNeeded();
+
+	/** Drops the removed points and rebuilds the tree over all points */
+	void Rebuild();
+
+	/** Builds the subtree over a range of TreeOrder, the median of the range along the split axis is the root */
+	void BuildSubtree(int32 Begin, int32 End, int32 Depth);
+
+	/** Searches the subtree over a range of TreeOrder for the point closest to Location, improving on InOutBestDistanceSquared */
+	void SearchSubtree(int32 Begin, int32 End, int32 Depth, const FDesignerSnapPoint& Ghost, const FObjectKey& IgnoredActor, float& InOutBestDistanceSquared, int32& InOutBestPoint) const;
+
+	/** Returns true if the indexed point can be snapped to by the ghost point */
+	static bool IsCandidate(const FDesignerSnapPoint& Point, const FDesignerSnapPoint& Ghost, const FObjectKey& IgnoredActor)
+	{
+		return !Point.bRemoved && Point.Type == Ghost.Type && Point.Actor != IgnoredActor;
+	}
+
+private:
+	/** The world the index was built for */
+	TWeakObjectPtr<UWorld> World;
+
+	/** All points, including removed ones */
+	TArray<FDesignerSnapPoint> Points;
+
+	/** The indices of the points in the tree, the implicit k-d tree splits every range at its middle */
+	TArray<int32> TreeOrder;
+
+	/** The indices of the points added since the tree was built */
+	TArray<int32> PendingPoints;
+
+	/** The indices of the points of every indexed actor */
+	TMap<FObjectKey, TArray<int32>> ActorPoints;
+
+	/** Actors added since the last FindSnap that had no snap points yet */
+	TArray<TWeakObjectPtr<const AActor>> PendingActors;
+
+	/** The number of points marked as removed */
+	int32 NumRemoved;
+};
@@ -0,0 +1,610 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerSnapshot.h"
+
+// Engine Includes
+#include "Async/ParallelFor.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Editor.h"
+#include "Engine/Level.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/Float16.h"
+#include "Misc/Paths.h"
+#include "ScopedTransaction.h"
+
+// Local Includes
+#include "DesignerInstanceContainer.h"
+#include "DesignerModule.h"
+#include "Diagnostics/DesignerMemory.h"
+#include "Placement/DesignerBulkEditScope.h"
+#include "Placement/DesignerPlacement.h"
+#include "Placement/DesignerSpawnQueue.h"
+
+#define LOCTEXT_NAMESPACE "DesignerSnapshot"
+
+// Raw transforms are read straight into the instance buffers
+static_assert(sizeof(FInstancedStaticMeshInstanceData) == sizeof(FMatrix), "FInstancedStaticMeshInstanceData must only hold the instance matrix");
+
+namespace DesignerSnapshotFile
+{
+	/** "DSNP" */
+	static const uint32 Magic = 0x504E5344;
+	static const int32 Version = 1;
+
+	/** The transforms are quantized instead of stored as raw matrices */
+	static const uint32 Flag_Quantized = 1 << 0;
+
+	/** The number of bits per quantized position component, three of them are packed in a uint64 */
+	static const int32 PositionBits = 21;
+
+	/** The number of bits per quantized quaternion component, the two bit index of the largest component is packed with them */
+	static const int32 RotationBits = 20;
+
+	/** The range of the three smallest quaternion components is [-1/sqrt(2), 1/sqrt(2)] */
+	static const float RotationRange = 0.707106781F;
+}
+
+namespace DesignerSnapshot
+{
+	/** What a group of transforms is placed as */
+	enum class EGroupType : uint8
+	{
+		/** Instances of a static mesh in an instance container */
+		Instances,
+		/** Static mesh actors of a static mesh */
+		StaticMeshActors,
+		/** Actors of a class */
+		Actors,
+	};
+
+	/** All transforms of a single asset in a snapshot */
+	struct FGroup
+	{
+		EGroupType Type;
+		int32 AssetIndex;
+		TArray<FMatrix> Transforms;
+		TArray<int32> Seeds;
+	};
+
+	/** Buffers reused while reading quantized transforms */
+	struct FQuantizedStreams
+	{
+		TArray<uint64> Positions;
+		TArray<uint64> Rotations;
+		TArray<FFloat16> Scales;
+	};
+
+	static uint64 PackPosition(const FVector& Position, const FBox& Bounds)
+	{
+		const uint64 MaxValue = (1ull << DesignerSnapshotFile::PositionBits) - 1;
+		const FVector Extent = Bounds.Max - Bounds.Min;
+
+		uint64 Packed = 0;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			float Alpha = Extent[Axis] > 0.F ? (Position[Axis] - Bounds.Min[Axis]) / Extent[Axis] : 0.F;
+			uint64 Value = (uint64)FMath::RoundToInt(FMath::Clamp(Alpha, 0.F, 1.F) * MaxValue);
+			Packed |= Value << (Axis * DesignerSnapshotFile::PositionBits);
+		}
+		return Packed;
+	}
+
+	static FVector UnpackPosition(uint64 Packed, const FBox& Bounds)
+	{
+		const uint64 MaxValue = (1ull << DesignerSnapshotFile::PositionBits) - 1;
+		const FVector Extent = Bounds.Max - Bounds.Min;
+
+		FVector Position;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			uint64 Value = (Packed >> (Axis * DesignerSnapshotFile::PositionBits)) & MaxValue;
+			Position[Axis] = Bounds.Min[Axis] + Extent[Axis] * ((float)Value / (float)MaxValue);
+		}
+		return Position;
+	}
+
+	/** Smallest three encoding: the largest component is dropped and rebuilt from the unit length */
+	static uint64 PackRotation(const FQuat& InRotation)
+	{
+		const uint64 MaxValue = (1ull << DesignerSnapshotFile::RotationBits) - 1;
+
+		FQuat Rotation = InRotation.GetNormalized();
+		const float Components[4] = { Rotation.X, Rotation.Y, Rotation.Z, Rotation.W };
+
+		int32 LargestIndex = 0;
+		for (int32 Index = 1; Index < 4; ++Index)
+		{
+			if (FMath::Abs(Components[Index]) > FMath::Abs(Components[LargestIndex]))
+			{
+				LargestIndex = Index;
+			}
+		}
+
+		// q and -q are the same rotation, flip so the dropped component is positive
+		const float Sign = Components[LargestIndex] < 0.F ? -1.F : 1.F;
+
+		uint64 Packed = (uint64)LargestIndex;
+		int32 Shift = 2;
+		for (int32 Index = 0; Index < 4; ++Index)
+		{
+			if (Index != LargestIndex)
+			{
+				float Alpha = Components[Index] * Sign / DesignerSnapshotFile::RotationRange * 0.5F + 0.5F;
+				uint64 Value = (uint64)FMath::RoundToInt(FMath::Clamp(Alpha, 0.F, 1.F) * MaxValue);
+				Packed |= Value << Shift;
+				Shift += DesignerSnapshotFile::RotationBits;
+			}
+		}
+		return Packed;
+	}
+
+	static FQuat UnpackRotation(uint64 Packed)
+	{
+		const uint64 MaxValue = (1ull << DesignerSnapshotFile::RotationBits) - 1;
+
+		const int32 LargestIndex = (int32)(Packed & 3);
+
+		float Components[4];
+		float SumSquared = 0.F;
+		int32 Shift = 2;
+		for (int32 Index = 0; Index < 4; ++Index)
+		{
+			if (Index != LargestIndex)
+			{
+				uint64 Value = (Packed >> Shift) & MaxValue;
+				Components[Index] = ((float)Value / (float)MaxValue * 2.F - 1.F) * DesignerSnapshotFile::RotationRange;
+				SumSquared += Components[Index] * Components[Index];
+				Shift += DesignerSnapshotFile::RotationBits;
+			}
+		}
+		Components[LargestIndex] = FMath::Sqrt(FMath::Max(1.F - SumSquared, 0.F));
+
+		return FQuat(Components[0], Components[1], Components[2], Components[3]);
+	}
+
+	static void WriteTransforms(FArchive& Ar, TArray<FMatrix>& Transforms, bool bQuantize)
+	{
+		const int32 NumTransforms = Transforms.Num();
+
+		if (!bQuantize)
+		{
+			Ar.Serialize(Transforms.GetData(), NumTransforms * sizeof(FMatrix));
+			return;
+		}
+
+		FBox Bounds(ForceInit);
+		for (const FMatrix& Transform : Transforms)
+		{
+			Bounds += Transform.GetOrigin();
+		}
+		Ar << Bounds.Min;
+		Ar << Bounds.Max;
+
+		FQuantizedStreams Streams;
+		Streams.Positions.SetNumUninitialized(NumTransforms);
+		Streams.Rotations.SetNumUninitialized(NumTransforms);
+		Streams.Scales.SetNumUninitialized(NumTransforms * 3);
+
+		ParallelFor(NumTransforms, [&](int32 Index)
+		{
+			FTransform Transform(Transforms[Index]);
+			Streams.Positions[Index] = PackPosition(Transform.GetLocation(), Bounds);
+			Streams.Rotations[Index] = PackRotation(Transform.GetRotation());
+
+			const FVector Scale = Transform.GetScale3D();
+			Streams.Scales[Index * 3 + 0] = FFloat16(Scale.X);
+			Streams.Scales[Index * 3 + 1] = FFloat16(Scale.Y);
+			Streams.Scales[Index * 3 + 2] = FFloat16(Scale.Z);
+		});
+
+		Ar.Serialize(Streams.Positions.GetData(), NumTransforms * sizeof(uint64));
+		Ar.Serialize(Streams.Rotations.GetData(), NumTransforms * sizeof(uint64));
+		Ar.Serialize(Streams.Scales.GetData(), NumTransforms * 3 * sizeof(FFloat16));
+	}
+
+	/** Reads transforms written by WriteTransforms into OutTransforms, which must have room for NumTransforms */
+	static void ReadTransforms(FArchive& Ar, int32 NumTransforms, bool bQuantized, FMatrix* OutTransforms, FQuantizedStreams& Streams)
+	{
+		if (!bQuantized)
+		{
+			// Large reads go straight from the file into the destination buffer
+			Ar.Serialize(OutTransforms, NumTransforms * sizeof(FMatrix));
+			return;
+		}
+
+		FBox Bounds(ForceInit);
+		Ar << Bounds.Min;
+		Ar << Bounds.Max;
+
+		Streams.Positions.SetNumUninitialized(NumTransforms, /*bAllowShrinking*/false);
+		Streams.Rotations.SetNumUninitialized(NumTransforms, /*bAllowShrinking*/false);
+		Streams.Scales.SetNumUninitialized(NumTransforms * 3, /*bAllowShrinking*/false);
+		Ar.Serialize(Streams.Positions.GetData(), NumTransforms * sizeof(uint64));
+		Ar.Serialize(Streams.Rotations.GetData(), NumTransforms * sizeof(uint64));
+		Ar.Serialize(Streams.Scales.GetData(), NumTransforms * 3 * sizeof(FFloat16));
+
+		if (Ar.IsError())
+		{
+			return;
+		}
+
+		ParallelFor(NumTransforms, [&](int32 Index)
+		{
+			FVector Scale(Streams.Scales[Index * 3 + 0], Streams.Scales[Index * 3 + 1], Streams.Scales[Index * 3 + 2]);
+			FTransform Transform(UnpackRotation(Streams.Rotations[Index]), UnpackPosition(Streams.Positions[Index], Bounds), Scale);
+			OutTransforms[Index] = Transform.ToMatrixWithScale();
+		});
+	}
+
+	static FGroup& FindOrAddGroup(TArray<FGroup>& Groups, TArray<FString>& Strings, EGroupType Type, const FString& AssetPath)
+	{
+		int32 AssetIndex = Strings.AddUnique(AssetPath);
+		for (FGroup& Group : Groups)
+		{
+			if (Group.Type == Type && Group.AssetIndex == AssetIndex)
+			{
+				return Group;
+			}
+		}
+
+		FGroup& Group = Groups.AddDefaulted_GetRef();
+		Group.Type = Type;
+		Group.AssetIndex = AssetIndex;
+		return Group;
+	}
+}
+
+bool FDesignerSnapshot::Export(ULevel* Level, const FString& Filename, bool bQuantize)
+{
+	using namespace DesignerSnapshot;
+
+	check(Level != nullptr);
+
+	TArray<FString> Strings;
+	TArray<FGroup> Groups;
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (!FDesignerPlacement::IsPlaced(Actor) || Actor->IsPendingKill())
+		{
+			continue;
+		}
+
+		if (ADesignerInstanceContainer* Container = Cast<ADesignerInstanceContainer>(Actor))
+		{
+			for (UHierarchicalInstancedStaticMeshComponent* Component : Container->GetInstanceComponents())
+			{
+				if (Component == nullptr || Component->GetStaticMesh() == nullptr)
+				{
+					continue;
+				}
+
+				FGroup& Group = FindOrAddGroup(Groups, Strings, EGroupType::Instances, Component->GetStaticMesh()->GetPathName());
+
+				const int32 NumInstances = Component->PerInstanceSMData.Num();
+				const FMatrix ComponentToWorld = Component->GetComponentTransform().ToMatrixWithScale();
+				const int32 FirstTransform = Group.Transforms.AddUninitialized(NumInstances);
+				ParallelFor(NumInstances, [&](int32 InstanceIndex)
+				{
+					Group.Transforms[FirstTransform + InstanceIndex] = Component->PerInstanceSMData[InstanceIndex].Transform * ComponentToWorld;
+				});
+
+				// Instances added by other tools have no seed
+				const TArray<int32>& Seeds = Container->GetInstanceSeeds(Component);
+				const int32 NumSeeds = FMath::Min(Seeds.Num(), NumInstances);
+				Group.Seeds.Append(Seeds.GetData(), NumSeeds);
+				Group.Seeds.AddZeroed(NumInstances - NumSeeds);
+			}
+		}
+		else
+		{
+			AStaticMeshActor* StaticMeshActor = Cast<AStaticMeshActor>(Actor);
+			UStaticMesh* StaticMesh = StaticMeshActor != nullptr ? StaticMeshActor->GetStaticMeshComponent()->GetStaticMesh() : nullptr;
+
+			FGroup& Group = StaticMesh != nullptr
+				? FindOrAddGroup(Groups, Strings, EGroupType::StaticMeshActors, StaticMesh->GetPathName())
+				: FindOrAddGroup(Groups, Strings, EGroupType::Actors, Actor->GetClass()->GetPathName());
+
+			Group.Transforms.Add(Actor->GetActorTransform().ToMatrixWithScale());
+			Group.Seeds.Add(0);
+		}
+	}
+
+	// Write to a temporary file first so readers never see a partially written snapshot
+	const FString TempFilename = Filename + TEXT(".tmp");
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempFilename));
+	if (!Writer.IsValid())
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Could not open %s for writing."), *TempFilename);
+		return false;
+	}
+
+	FArchive& Ar = *Writer;
+
+	uint32 Magic = DesignerSnapshotFile::Magic;
+	int32 Version = DesignerSnapshotFile::Version;
+	uint32 Flags = bQuantize ? DesignerSnapshotFile::Flag_Quantized : 0;
+	Ar << Magic;
+	Ar << Version;
+	Ar << Flags;
+	Ar << Strings;
+
+	int32 NumGroups = Groups.Num();
+	Ar << NumGroups;
+
+	int64 NumTransforms = 0;
+	for (FGroup& Group : Groups)
+	{
+		uint8 Type = (uint8)Group.Type;
+		int32 NumInstances = Group.Transforms.Num();
+		Ar << Type;
+		Ar << Group.AssetIndex;
+		Ar << NumInstances;
+
+		// The payload size lets readers skip groups whose asset can not be loaded
+		const int64 PayloadSizeOffset = Ar.Tell();
+		int64 PayloadSize = 0;
+		Ar << PayloadSize;
+
+		Ar.Serialize(Group.Seeds.GetData(), NumInstances * sizeof(int32));
+		WriteTransforms(Ar, Group.Transforms, bQuantize);
+
+		const int64 PayloadEnd = Ar.Tell();
+		PayloadSize = PayloadEnd - PayloadSizeOffset - sizeof(PayloadSize);
+		Ar.Seek(PayloadSizeOffset);
+		Ar << PayloadSize;
+		Ar.Seek(PayloadEnd);
+
+		NumTransforms += NumInstances;
+	}
+
+	bool bSuccess = Writer->Close();
+	Writer.Reset();
+
+	if (!bSuccess || !IFileManager::Get().Move(*Filename, *TempFilename, /*Replace*/true))
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Could not write %s."), *Filename);
+		return false;
+	}
+
+	UE_LOG(LogDesigner, Display, TEXT("Exported %lld placements of %d assets to %s."), NumTransforms, Strings.Num(), *Filename);
+	return true;
+}
+
+bool FDesignerSnapshot::Import(ULevel* Level, const FString& Filename)
+{
+	using namespace DesignerSnapshot;
+
+	check(Level != nullptr);
+
+	UWorld* World = Level->OwningWorld;
+
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename));
+	if (!Reader.IsValid())
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Could not open %s for reading."), *Filename);
+		return false;
+	}
+
+	FArchive& Ar = *Reader;
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	uint32 Flags = 0;
+	Ar << Magic;
+	Ar << Version;
+	Ar << Flags;
+
+	if (Magic != DesignerSnapshotFile::Magic || Version != DesignerSnapshotFile::Version)
+	{
+		UE_LOG(LogDesigner, Error, TEXT("%s is not a supported snapshot (magic %08x, version %d)."), *Filename, Magic, Version);
+		return false;
+	}
+
+	const bool bQuantized = (Flags & DesignerSnapshotFile::Flag_Quantized) != 0;
+
+	TArray<FString> Strings;
+	int32 NumGroups = 0;
+	Ar << Strings;
+	Ar << NumGroups;
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.OverrideLevel = Level;
+
+	ADesignerInstanceContainer* Container = nullptr;
+	FDesignerPlacementBatch ActorBatch;
+	FQuantizedStreams Streams;
+	TArray<FMatrix> Transforms;
+	TArray<int32> Seeds;
+	int64 NumPlaced = 0;
+
+	for (int32 GroupIndex = 0; GroupIndex < NumGroups && !Ar.IsError(); ++GroupIndex)
+	{
+		uint8 Type = 0;
+		int32 AssetIndex = INDEX_NONE;
+		int32 NumInstances = 0;
+		int64 PayloadSize = 0;
+		Ar << Type;
+		Ar << AssetIndex;
+		Ar << NumInstances;
+		Ar << PayloadSize;
+
+		const int64 PayloadEnd = Ar.Tell() + PayloadSize;
+
+		// Checked against the payload before anything is allocated, so a corrupt count can not request more than the file holds
+		const int64 TransformsSize = bQuantized
+			? 2 * sizeof(FVector) + (int64)NumInstances * (2 * sizeof(uint64) + 3 * sizeof(FFloat16))
+			: (int64)NumInstances * sizeof(FMatrix);
+		const int64 ExpectedPayloadSize = (int64)NumInstances * sizeof(int32) + TransformsSize;
+
+		if (!Strings.IsValidIndex(AssetIndex) || NumInstances < 0 || Type > (uint8)EGroupType::Actors
+			|| PayloadSize < ExpectedPayloadSize || PayloadEnd > Ar.TotalSize())
+		{
+			UE_LOG(LogDesigner, Error, TEXT("%s is corrupt."), *Filename);
+			Ar.SetError();
+			break;
+		}
+
+		UObject* Asset = FSoftObjectPath(Strings[AssetIndex]).TryLoad();
+		UStaticMesh* StaticMesh = Cast<UStaticMesh>(Asset);
+		UClass* ActorClass = Cast<UClass>(Asset);
+
+		if ((EGroupType)Type == EGroupType::Instances && StaticMesh != nullptr)
+		{
+			if (Container == nullptr)
+			{
+				// Transforms are stored in world space, so the container stays at the origin
+				Container = World->SpawnActor<ADesignerInstanceContainer>(SpawnParameters);
+				Container->SetActorLabel(FString::Printf(TEXT("DesignerSnapshot_%s"), *FPaths::GetBaseFilename(Filename)));
+			}
+
+			TArrayView<FInstancedStaticMeshInstanceData> InstanceData;
+			TArrayView<int32> InstanceSeeds;
+			Container->AddUninitializedInstances(StaticMesh, NumInstances, InstanceData, InstanceSeeds);
+
+			Ar.Serialize(InstanceSeeds.GetData(), NumInstances * sizeof(int32));
+			ReadTransforms(Ar, NumInstances, bQuantized, reinterpret_cast<FMatrix*>(InstanceData.GetData()), Streams);
+			NumPlaced += NumInstances;
+		}
+		else if (((EGroupType)Type == EGroupType::StaticMeshActors && StaticMesh != nullptr)
+			|| ((EGroupType)Type == EGroupType::Actors && ActorClass != nullptr && ActorClass->IsChildOf<AActor>()))
+		{
+			Seeds.SetNumUninitialized(NumInstances, /*bAllowShrinking*/false);
+			Transforms.SetNumUninitialized(NumInstances, /*bAllowShrinking*/false);
+			Ar.Serialize(Seeds.GetData(), NumInstances * sizeof(int32));
+			ReadTransforms(Ar, NumInstances, bQuantized, Transforms.GetData(), Streams);
+
+			// Actors are spawned by the spawn queue once the whole file was read, the actor factory of a static mesh makes a static mesh actor
+			const int32 BatchAssetIndex = ActorBatch.FindOrAddAsset(FSoftObjectPath(Asset));
+			const int32 FirstInstance = ActorBatch.Instances.AddUninitialized(NumInstances);
+			for (int32 InstanceIndex = 0; InstanceIndex < NumInstances; ++InstanceIndex)
+			{
+				FDesignerPlacementInstance& Instance = ActorBatch.Instances[FirstInstance + InstanceIndex];
+				Instance.Transform = FTransform(Transforms[InstanceIndex]);
+				Instance.AssetIndex = BatchAssetIndex;
+				Instance.Seed = Seeds[InstanceIndex];
+			}
+		}
+		else
+		{
+			UE_LOG(LogDesigner, Warning, TEXT("Could not load %s, its %d placements are skipped."), *Strings[AssetIndex], NumInstances);
+		}
+
+		Ar.Seek(PayloadEnd);
+	}
+
+	if (Ar.IsError())
+	{
+		// Leave the level as it was, the container may hold instances whose transforms were never read
+		if (Container != nullptr)
+		{
+			World->EditorDestroyActor(Container, false);
+		}
+
+		UE_LOG(LogDesigner, Error, TEXT("Could not read %s, nothing was placed."), *Filename);
+		return false;
+	}
+
+	if (Container != nullptr)
+	{
+		// The instances were read straight into the component, their bodies are created here so they can be traced
+		Container->FinishInstanceChanges(/*bUpdatePhysics*/true);
+	}
+
+	const int32 NumQueued = ActorBatch.Instances.Num();
+	if (NumQueued > 0)
+	{
+		FDesignerSpawnJobParams Params;
+		Params.Title = LOCTEXT("ImportSnapshotTransaction", "Designer: Import Snapshot");
+		FDesignerSpawnQueue::Get().Enqueue(MoveTemp(ActorBatch), Level, Params);
+	}
+
+	UE_LOG(LogDesigner, Display, TEXT("Imported %lld instances of %d assets from %s, %d actors are spawned by the spawn queue."), NumPlaced, Strings.Num(), *Filename, NumQueued);
+	return true;
+}
+
+/**
+ * designer.snapshot.export <File> [quantize]
+ */
+static void ExportSnapshotCommand(const TArray<FString>& Args)
+{
+	if (Args.Num() < 1)
+	{
+		UE_LOG(LogDesigner, Display, TEXT("Usage: designer.snapshot.export <File> [quantize]"));
+		return;
+	}
+
+	const bool bQuantize = Args.Num() > 1 && Args[1].Equals(TEXT("quantize"), ESearchCase::IgnoreCase);
+
+	double StartTime = FPlatformTime::Seconds();
+	if (FDesignerSnapshot::Export(GEditor->GetEditorWorldContext().World()->GetCurrentLevel(), Args[0], bQuantize))
+	{
+		UE_LOG(LogDesigner, Display, TEXT("Snapshot export took %.3f seconds."), FPlatformTime::Seconds() - StartTime);
+	}
+}
+
+/**
+ * designer.snapshot.import <File>
+ */
+static void ImportSnapshotCommand(const TArray<FString>& Args)
+{
+	if (Args.Num() < 1)
+	{
+		UE_LOG(LogDesigner, Display, TEXT("Usage: designer.snapshot.import <File>"));
+		return;
+	}
+
+	FScopedTransaction Transaction(LOCTEXT("ImportSnapshotTransaction", "Designer: Import Snapshot"));
+	FDesignerBulkEditScope BulkEditScope;
+
+	double StartTime = FPlatformTime::Seconds();
+	if (FDesignerSnapshot::Import(GEditor->GetEditorWorldContext().World()->GetCurrentLevel(), Args[0]))
+	{
+		UE_LOG(LogDesigner, Display, TEXT("Snapshot import took %.3f seconds."), FPlatformTime::Seconds() - StartTime);
+	}
+	else
+	{
+		Transaction.Cancel();
+	}
+}
+
+static FAutoConsoleCommand ExportSnapshotConsoleCommand(
+	TEXT("designer.snapshot.export"),
+	TEXT("Writes all Designer placed content of the current level to a snapshot file. Usage: designer.snapshot.export <File> [quantize]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&ExportSnapshotCommand));
+
+static FAutoConsoleCommand ImportSnapshotConsoleCommand(
+	TEXT("designer.snapshot.import"),
+	TEXT("Adds the content of a snapshot file to the current level. Usage: designer.snapshot.import <File>"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&ImportSnapshotCommand));
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,49 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Forward Declares
+class ULevel;
+
+/**
+ * Compact binary snapshot of the content placed by the Designer tools in a level.
+ * Transforms are stored as packed arrays per asset together with the per instance seeds and a string table of asset paths.
+ * Quantized snapshots store 22 bytes per transform instead of 64.
+ */
+class FDesignerSnapshot
+{
+public:
+	/** Writes all Designer placed content of the level to a snapshot file. Returns true if it was successful */
+	static bool Export(ULevel* Level, const FString& Filename, bool bQuantize);
+
+	/**
+	 * Adds the content of a snapshot file to the level. Instances are read straight into the instance buffers of a new instance container,
+	 * actors are queued on the spawn queue once the whole file was read. Returns true if it was successful, on failure nothing is added.
+	 */
+	static bool Import(ULevel* Level, const FString& Filename);
+};
@@ -0,0 +1,490 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerSpawnQueue.h"
+
+// Engine Includes
+#include "ActorFactories/ActorFactory.h"
+#include "AssetSelection.h"
+#include "Editor.h"
+#include "Engine/Level.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "LevelEditorViewport.h"
+#include "ScopedTransaction.h"
+#include "Widgets/Notifications/SNotificationList.h"
+
+// Local Includes
+#include "DesignerModule.h"
+#include "DesignerSettings.h"
+#include "Diagnostics/DesignerMemory.h"
+#include "Diagnostics/DesignerPerfHUD.h"
+#include "Placement/DesignerBulkEditScope.h"
+
+#define LOCTEXT_NAMESPACE "DesignerSpawnQueue"
+
+TUniquePtr<FDesignerSpawnQueue> FDesignerSpawnQueue::Instance;
+
+FDesignerSpawnQueue& FDesignerSpawnQueue::Get()
+{
+	if (!Instance.IsValid())
+	{
+		Instance.Reset(new FDesignerSpawnQueue());
+	}
+	return *Instance;
+}
+
+void FDesignerSpawnQueue::Shutdown()
+{
+	if (Instance.IsValid())
+	{
+		Instance->CancelAll();
+		Instance.Reset();
+	}
+}
+
+FDesignerSpawnQueue::FDesignerSpawnQueue()
+	: NextJobId(0)
+{
+	OnPrepareToCleanseEditorObjectHandle = FEditorSupportDelegates::PrepareToCleanseEditorObject.AddRaw(this, &FDesignerSpawnQueue::OnPrepareToCleanseEditorObject);
+}
+
+FDesignerSpawnQueue::~FDesignerSpawnQueue()
+{
+	FEditorSupportDelegates::PrepareToCleanseEditorObject.Remove(OnPrepareToCleanseEditorObjectHandle);
+}
+
+int32 FDesignerSpawnQueue::Enqueue(FDesignerPlacementBatch&& Batch, ULevel* Level, const FDesignerSpawnJobParams& Params)
+{
+	check(Level != nullptr);
+
+	TUniquePtr<FJob> Job = MakeUnique<FJob>();
+	Job->Id = NextJobId++;
+	Job->Batch = MoveTemp(Batch);
+	Job->Level = Level;
+	Job->Params = Params;
+	Job->NextInstance = 0;
+
+	const int32 NumAssets = Job->Batch.Assets.Num();
+	const int32 NumInvalid = Job->Batch.Instances.RemoveAll([NumAssets](const FDesignerPlacementInstance& Instance)
+	{
+		return Instance.AssetIndex < 0 || Instance.AssetIndex >= NumAssets;
+	});
+	if (NumInvalid > 0)
+	{
+		UE_LOG(LogDesigner, Warning, TEXT("%s: %d placements refer to assets that are not in the batch, they are skipped."), *Params.Title.ToString(), NumInvalid);
+	}
+
+	if (Params.Order == EDesignerSpawnOrder::NearestFirst)
+	{
+		const FVector Origin = Params.Origin;
+		Job->Batch.Instances.Sort([Origin](const FDesignerPlacementInstance& A, const FDesignerPlacementInstance& B)
+		{
+			return FVector::DistSquared(A.Transform.GetLocation(), Origin) < FVector::DistSquared(B.Transform.GetLocation(), Origin);
+		});
+	}
+
+	const int32 JobId = Job->Id;
+	Jobs.Add(MoveTemp(Job));
+
+	if (IsRunningCommandlet())
+	{
+		Flush();
+	}
+	else
+	{
+		UpdateNotification();
+	}
+
+	return JobId;
+}
+
+void FDesignerSpawnQueue::Cancel(int32 JobId)
+{
+	const int32 JobIndex = Jobs.IndexOfByPredicate([JobId](const TUniquePtr<FJob>& Job)
+	{
+		return Job->Id == JobId;
+	});
+
+	if (JobIndex == 0)
+	{
+		FinishFirstJob(/*bCancelled*/true);
+	}
+	else if (JobIndex != INDEX_NONE)
+	{
+		// Only the first job runs, the others have not spawned anything yet
+		TUniquePtr<FJob> Job = MoveTemp(Jobs[JobIndex]);
+		Jobs.RemoveAt(JobIndex);
+		if (Job->Params.OnFinished)
+		{
+			Job->Params.OnFinished(Job->SpawnedActors, /*bCancelled*/true);
+		}
+	}
+
+	UpdateNotification();
+}
+
+void FDesignerSpawnQueue::CancelAll()
+{
+	while (Jobs.Num() > 0)
+	{
+		Cancel(Jobs.Last()->Id);
+	}
+}
+
+void FDesignerSpawnQueue::Flush()
+{
+	while (Jobs.Num() > 0)
+	{
+		PrepareJob(*Jobs[0], /*bWait*/true);
+		RunJob(*Jobs[0], TNumericLimits<double>::Max());
+		FinishFirstJob(/*bCancelled*/false);
+	}
+
+	UpdateNotification();
+}
+
+int32 FDesignerSpawnQueue::GetNumQueued() const
+{
+	int32 NumQueued = 0;
+	for (const TUniquePtr<FJob>& Job : Jobs)
+	{
+		NumQueued += Job->Batch.Instances.Num() - Job->NextInstance;
+	}
+	return NumQueued;
+}
+
+float FDesignerSpawnQueue::GetProgress() const
+{
+	int32 NumPlacements = 0;
+	int32 NumSpawned = 0;
+	for (const TUniquePtr<FJob>& Job : Jobs)
+	{
+		NumPlacements += Job->Batch.Instances.Num();
+		NumSpawned += Job->NextInstance;
+	}
+	return NumPlacements > 0 ? (float)NumSpawned / NumPlacements : 1.F;
+}
+
+void FDesignerSpawnQueue::Tick(float DeltaTime)
+{
+	const UDesignerSettings* Settings = UDesignerSettings::GetActiveSettings();
+	const double EndTime = FPlatformTime::Seconds() + FMath::Max(Settings->SpawnBudgetMilliseconds, 1.F) / 1000.0;
+
+	// A job that finishes early leaves the rest of the budget to the next one
+	while (Jobs.Num() > 0 && FPlatformTime::Seconds() < EndTime)
+	{
+		FJob& Job = *Jobs[0];
+		if (!PrepareJob(Job, /*bWait*/false) || !RunJob(Job, EndTime))
+		{
+			break;
+		}
+		FinishFirstJob(/*bCancelled*/false);
+	}
+
+	UpdateNotification();
+}
+
+bool FDesignerSpawnQueue::IsTickable() const
+{
+	return Jobs.Num() > 0 || Notification.IsValid();
+}
+
+TStatId FDesignerSpawnQueue::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FDesignerSpawnQueue, STATGROUP_Tickables);
+}
+
+void FDesignerSpawnQueue::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for (TUniquePtr<FJob>& Job : Jobs)
+	{
+		Collector.AddReferencedObjects(Job->AssetObjects);
+		Collector.AddReferencedObjects(Job->ActorFactories);
+		Collector.AddReferencedObjects(Job->SpawnedActors);
+	}
+}
+
+bool FDesignerSpawnQueue::PrepareJob(FJob& Job, bool bWait)
+{
+	if (Job.AssetObjects.Num() == Job.Batch.Assets.Num())
+	{
+		return true;
+	}
+
+	if (!Job.LoadHandle.IsValid())
+	{
+		Job.LoadHandle = StreamableManager.RequestAsyncLoad(Job.Batch.Assets, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+	}
+
+	if (Job.LoadHandle.IsValid() && Job.LoadHandle->IsLoadingInProgress())
+	{
+		if (!bWait)
+		{
+			return false;
+		}
+		Job.LoadHandle->WaitUntilComplete();
+	}
+
+	Job.AssetObjects.Reserve(Job.Batch.Assets.Num());
+	Job.ActorFactories.Reserve(Job.Batch.Assets.Num());
+	for (const FSoftObjectPath& AssetPath : Job.Batch.Assets)
+	{
+		UObject* Asset = AssetPath.ResolveObject();
+		UActorFactory* ActorFactory = nullptr;
+		if (Asset == nullptr)
+		{
+			UE_LOG(LogDesigner, Warning, TEXT("Could not load %s, its placements are skipped."), *AssetPath.ToString());
+		}
+		else
+		{
+			ActorFactory = FActorFactoryAssetProxy::GetFactoryForAssetObject(Asset);
+			if (ActorFactory == nullptr)
+			{
+				UE_LOG(LogDesigner, Warning, TEXT("%s has no actor factory, its placements are skipped."), *AssetPath.ToString());
+			}
+		}
+		Job.AssetObjects.Add(Asset);
+		Job.ActorFactories.Add(ActorFactory);
+	}
+
+	return true;
+}
+
+bool FDesignerSpawnQueue::RunJob(FJob& Job, double EndTime)
+{
+	ULevel* Level = Job.Level.Get();
+	if (Level == nullptr)
+	{
+		return true;
+	}
+
+	FDesignerPerfScope PerfScope(EDesignerPerfCategory::Spawn);
+
+	// The transaction ends with the slice, a transaction left open across frames would also record unrelated edits
+	FScopedTransaction Transaction(Job.Params.Title);
+	FDesignerBulkEditScope BulkEditScope;
+
+	if (Job.NextInstance == 0)
+	{
+		Job.SpawnedActors.Reserve(Job.Batch.Instances.Num());
+	}
+
+	// At least one placement is spawned per call, so a job always makes progress
+	int32 NumSpawned = 0;
+	while (Job.NextInstance < Job.Batch.Instances.Num())
+	{
+		const FDesignerPlacementInstance& Instance = Job.Batch.Instances[Job.NextInstance++];
+		if (UActorFactory* ActorFactory = Job.ActorFactories[Instance.AssetIndex])
+		{
+			if (AActor* Actor = ActorFactory->CreateActor(Job.AssetObjects[Instance.AssetIndex], Level, Instance.Transform))
+			{
+				FDesignerPlacement::MarkAsPlaced(Actor);
+				Job.SpawnedActors.Add(Actor);
+				++NumSpawned;
+			}
+		}
+
+		if (FPlatformTime::Seconds() >= EndTime)
+		{
+			break;
+		}
+	}
+
+	if (NumSpawned > 0)
+	{
+		FDesignerBulkEditScope::MarkLevelDirty(Level);
+	}
+	else
+	{
+		Transaction.Cancel();
+	}
+
+	FDesignerPerfHUD::AddPlacements(NumSpawned);
+
+	return Job.NextInstance >= Job.Batch.Instances.Num();
+}
+
+void FDesignerSpawnQueue::FinishFirstJob(bool bCancelled)
+{
+	TUniquePtr<FJob> Job = MoveTemp(Jobs[0]);
+	Jobs.RemoveAt(0);
+
+	// Actors deleted while the job ran are no longer of interest to the caller
+	Job->SpawnedActors.RemoveAll([](AActor* Actor)
+	{
+		return !IsValid(Actor);
+	});
+
+	if (Job->Params.OnFinished)
+	{
+		// What the caller does with the actors, such as settling them, is undone before the actors themselves
+		FScopedTransaction Transaction(Job->Params.Title, /*bShouldActuallyTransact*/Job->SpawnedActors.Num() > 0);
+		FDesignerBulkEditScope BulkEditScope;
+		Job->Params.OnFinished(Job->SpawnedActors, bCancelled);
+	}
+
+	UE_LOG(LogDesigner, Display, TEXT("%s: spawned %d of %d placements%s."), *Job->Params.Title.ToString(), Job->SpawnedActors.Num(), Job->Batch.Instances.Num(), bCancelled ? TEXT(", cancelled") : TEXT(""));
+}
+
+void FDesignerSpawnQueue::UpdateNotification()
+{
+	TSharedPtr<SNotificationItem> NotificationItem = Notification.Pin();
+
+	if (Jobs.Num() == 0)
+	{
+		if (NotificationItem.IsValid())
+		{
+			NotificationItem->SetText(LOCTEXT("SpawningDone", "Spawning done"));
+			NotificationItem->SetCompletionState(SNotificationItem::CS_Success);
+			NotificationItem->ExpireAndFadeout();
+		}
+		Notification.Reset();
+		return;
+	}
+
+	if (IsRunningCommandlet())
+	{
+		return;
+	}
+
+	const int32 NumQueued = GetNumQueued();
+	const FText Text = FText::Format(LOCTEXT("SpawningProgress", "Spawning {0} actors ({1})"), FText::AsNumber(NumQueued), FText::AsPercent(GetProgress()));
+
+	if (!NotificationItem.IsValid())
+	{
+		FNotificationInfo Info(Text);
+		Info.bFireAndForget = false;
+		Info.ExpireDuration = 1.F;
+		Info.ButtonDetails.Add(FNotificationButtonInfo(LOCTEXT("CancelSpawning", "Cancel"), LOCTEXT("CancelSpawningTooltip", "Stops spawning, what was spawned so far stays"),
+			FSimpleDelegate::CreateRaw(this, &FDesignerSpawnQueue::CancelAll), SNotificationItem::CS_Pending));
+
+		NotificationItem = FSlateNotificationManager::Get().AddNotification(Info);
+		if (NotificationItem.IsValid())
+		{
+			NotificationItem->SetCompletionState(SNotificationItem::CS_Pending);
+		}
+		Notification = NotificationItem;
+	}
+	else
+	{
+		NotificationItem->SetText(Text);
+	}
+}
+
+void FDesignerSpawnQueue::OnPrepareToCleanseEditorObject(UObject* Object)
+{
+	if (Jobs.Num() > 0)
+	{
+		UE_LOG(LogDesigner, Warning, TEXT("The editor is cleaning up %s, spawning is cancelled."), *GetNameSafe(Object));
+		CancelAll();
+	}
+}
+
+/**
+ * designer.spawnqueue [cancel]
+ * Logs the placements waiting to be spawned, or cancels spawning.
+ */
+static void SpawnQueueCommand(const TArray<FString>& Args)
+{
+	FDesignerSpawnQueue& SpawnQueue = FDesignerSpawnQueue::Get();
+
+	if (Args.Num() > 0 && Args[0].Equals(TEXT("cancel"), ESearchCase::IgnoreCase))
+	{
+		SpawnQueue.CancelAll();
+		return;
+	}
+
+	UE_LOG(LogDesigner, Display, TEXT("%d placements waiting to be spawned, %.0f%% done."), SpawnQueue.GetNumQueued(), SpawnQueue.GetProgress() * 100.F);
+}
+
+/**
+ * designer.bench.spawnqueue [Count]
+ * Spawns a grid of cubes in front of the camera through the spawn queue and logs how long it took and how many frames it spanned.
+ */
+static void BenchmarkSpawnQueueCommand(const TArray<FString>& Args)
+{
+	const int32 NumActors = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 50000;
+
+	UWorld* World = GEditor->GetEditorWorldContext().World();
+	ULevel* Level = World->GetCurrentLevel();
+
+	FVector ViewLocation = FVector::ZeroVector;
+	FVector ViewDirection = FVector::ForwardVector;
+	if (GCurrentLevelEditingViewportClient != nullptr)
+	{
+		ViewLocation = GCurrentLevelEditingViewportClient->GetViewLocation();
+		ViewDirection = GCurrentLevelEditingViewportClient->GetViewRotation().Vector().GetSafeNormal2D(SMALL_NUMBER);
+		ViewDirection = ViewDirection.IsNearlyZero() ? FVector::ForwardVector : ViewDirection;
+	}
+
+	// A square grid starting a few meters in front of the camera
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt((float)NumActors));
+	const float Spacing = 200.F;
+	const FVector Right = FVector::CrossProduct(FVector::UpVector, ViewDirection);
+	const FVector Start = ViewLocation + ViewDirection * 500.F - Right * (GridSize * Spacing * 0.5F);
+
+	FDesignerPlacementBatch Batch;
+	const int32 AssetIndex = Batch.FindOrAddAsset(FSoftObjectPath(TEXT("/Engine/BasicShapes/Cube.Cube")));
+	Batch.Instances.SetNumUninitialized(NumActors);
+	for (int32 ActorIndex = 0; ActorIndex < NumActors; ++ActorIndex)
+	{
+		FDesignerPlacementInstance& Instance = Batch.Instances[ActorIndex];
+		Instance.Transform = FTransform(Start + ViewDirection * ((ActorIndex / GridSize) * Spacing) + Right * ((ActorIndex % GridSize) * Spacing));
+		Instance.AssetIndex = AssetIndex;
+		Instance.Seed = ActorIndex;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const uint64 StartFrame = GFrameCounter;
+
+	FDesignerSpawnJobParams Params;
+	Params.Title = LOCTEXT("BenchmarkSpawnQueueTransaction", "Designer: Benchmark Spawn Queue");
+	Params.Order = EDesignerSpawnOrder::NearestFirst;
+	Params.Origin = ViewLocation;
+	Params.OnFinished = [StartTime, StartFrame](const TArray<AActor*>& SpawnedActors, bool bCancelled)
+	{
+		const double Elapsed = FPlatformTime::Seconds() - StartTime;
+		const uint64 NumFrames = FMath::Max<uint64>(GFrameCounter - StartFrame, 1);
+
+		UE_LOG(LogDesigner, Display, TEXT("Spawned %d actors over %llu frames in %.2f seconds%s."), SpawnedActors.Num(), NumFrames, Elapsed, bCancelled ? TEXT(", cancelled") : TEXT(""));
+		UE_LOG(LogDesigner, Display, TEXT("  %.1f ms per frame, %.1f actors per second."), Elapsed * 1000.0 / NumFrames, Elapsed > 0.0 ? SpawnedActors.Num() / Elapsed : 0.0);
+	};
+
+	FDesignerSpawnQueue::Get().Enqueue(MoveTemp(Batch), Level, Params);
+}
+
+static FAutoConsoleCommand SpawnQueueConsoleCommand(
+	TEXT("designer.spawnqueue"),
+	TEXT("Logs the placements waiting to be spawned by Designer bulk operations, or cancels them. Usage: designer.spawnqueue [cancel]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&SpawnQueueCommand));
+
+static FAutoConsoleCommand BenchmarkSpawnQueueConsoleCommand(
+	TEXT("designer.bench.spawnqueue"),
+	TEXT("Spawns a grid of cubes in front of the camera through the spawn queue and logs how long the editor spent on it. Usage: designer.bench.spawnqueue [Count]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkSpawnQueueCommand));
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,181 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "TickableEditorObject.h"
+#include "UObject/GCObject.h"
+
+// Local Includes
+#include "Placement/DesignerPlacement.h"
+
+// Forward Declares
+class AActor;
+class SNotificationItem;
+class UActorFactory;
+class ULevel;
+
+/**
+ * The order the placements of a spawn job are spawned in
+ */
+enum class EDesignerSpawnOrder : uint8
+{
+	/** In the order of the batch */
+	Batch,
+	/** Nearest to the origin of the job first, so the part of the level being looked at fills in first */
+	NearestFirst,
+};
+
+/**
+ * How a batch is spawned by the spawn queue
+ */
+struct FDesignerSpawnJobParams
+{
+	/** Called with the spawned actors when the job finished or was cancelled, in a transaction of its own */
+	typedef TFunction<void(const TArray<AActor*>& SpawnedActors, bool bCancelled)> FOnFinished;
+
+	FDesignerSpawnJobParams()
+		: Order(EDesignerSpawnOrder::Batch)
+		, Origin(ForceInitToZero)
+	{
+	}
+
+	/** The title of the transactions the job is recorded in, starting with "Designer:" */
+	FText Title;
+
+	EDesignerSpawnOrder Order;
+
+	/** The location placements are sorted around for EDesignerSpawnOrder::NearestFirst, usually the camera */
+	FVector Origin;
+
+	FOnFinished OnFinished;
+};
+
+/**
+ * Spawns the actors of bulk operations over several frames, so placing tens of thousands of actors does not freeze the editor.
+ *
+ * Jobs run one after the other. Every editor frame spawns actors of the running job until the spawn budget of the active
+ * settings is used up, at least one actor per frame. The assets of a job are loaded asynchronously before it starts.
+ * The actors spawned in a frame are recorded in a transaction that ends within that frame, so the transaction buffer is
+ * never left open for other edits and every undo removes the actors of one frame. Jobs are cancelled before the editor
+ * cleans up a world. Cancelling a job keeps what was spawned so far. Commandlets do not tick, there jobs run to completion right away.
+ */
+class FDesignerSpawnQueue : public FTickableEditorObject, public FGCObject
+{
+public:
+	static FDesignerSpawnQueue& Get();
+
+	/** Cancels all jobs and destroys the queue, on module shutdown */
+	static void Shutdown();
+
+	virtual ~FDesignerSpawnQueue();
+
+	/** Queues the actors of a batch for spawning into the level, placements of assets missing from the batch are dropped. Returns the id of the job */
+	int32 Enqueue(FDesignerPlacementBatch&& Batch, ULevel* Level, const FDesignerSpawnJobParams& Params);
+
+	/** Stops a job, what it spawned so far stays */
+	void Cancel(int32 JobId);
+
+	/** Stops all jobs */
+	void CancelAll();
+
+	/** Runs all jobs to completion without a budget */
+	void Flush();
+
+	/** The number of placements waiting to be spawned by all jobs */
+	int32 GetNumQueued() const;
+
+	/** The fraction of the placements of all jobs that was spawned */
+	float GetProgress() const;
+
+	bool IsEmpty() const
+	{
+		return Jobs.Num() == 0;
+	}
+
+	//~ Begin FTickableEditorObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableEditorObject interface
+
+	//~ Begin FGCObject interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	//~ End FGCObject interface
+
+private:
+	/** A batch being spawned */
+	struct FJob
+	{
+		int32 Id;
+		FDesignerPlacementBatch Batch;
+		TWeakObjectPtr<ULevel> Level;
+		FDesignerSpawnJobParams Params;
+
+		/** The loaded assets and their actor factories, parallel to the asset table of the batch */
+		TArray<UObject*> AssetObjects;
+		TArray<UActorFactory*> ActorFactories;
+
+		/** Keeps the assets loaded while the job runs */
+		TSharedPtr<FStreamableHandle> LoadHandle;
+
+		/** The next placement to spawn */
+		int32 NextInstance;
+
+		TArray<AActor*> SpawnedActors;
+	};
+
+	FDesignerSpawnQueue();
+
+	/** Starts loading the assets of the job. Returns true once they are loaded and the job can spawn */
+	bool PrepareJob(FJob& Job, bool bWait);
+
+	/** Spawns placements of the job until the end time in a transaction of their own. Returns true if the job is done */
+	bool RunJob(FJob& Job, double EndTime);
+
+	/** Hands the spawned actors of the first job to its caller and removes it */
+	void FinishFirstJob(bool bCancelled);
+
+	/** Shows, updates or hides the progress notification */
+	void UpdateNotification();
+
+	/** Cancels all jobs before the editor cleans up a world */
+	void OnPrepareToCleanseEditorObject(UObject* Object);
+
+private:
+	TArray<TUniquePtr<FJob>> Jobs;
+	int32 NextJobId;
+
+	FStreamableManager StreamableManager;
+
+	FDelegateHandle OnPrepareToCleanseEditorObjectHandle;
+
+	/** The progress notification with its cancel button, while jobs run */
+	TWeakPtr<SNotificationItem> Notification;
+
+	static TUniquePtr<FDesignerSpawnQueue> Instance;
+};
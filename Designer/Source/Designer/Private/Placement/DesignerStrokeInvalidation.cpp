@@ -0,0 +1,98 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Placement/DesignerStrokeInvalidation.h"
+
+// Engine Includes
+#include "Components/ActorComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+FDesignerStrokeInvalidation::~FDesignerStrokeInvalidation()
+{
+	EndStroke();
+}
+
+void FDesignerStrokeInvalidation::BeginStroke(UWorld* World)
+{
+	EndStroke();
+
+	NavigationLock.Emplace(World, ENavigationLockReason::ContinuousEditorMove);
+}
+
+void FDesignerStrokeInvalidation::AddActor(AActor* Actor)
+{
+	check(IsInStroke());
+
+	if (Actor == nullptr || StrokeActors.Contains(Actor))
+	{
+		return;
+	}
+
+	StrokeActors.Add(Actor);
+
+	// Removing the components from the octree dirties their current bounds once, instead of every bounds they are dragged through
+	TInlineComponentArray<UActorComponent*> Components;
+	Actor->GetComponents(Components);
+	for (UActorComponent* Component : Components)
+	{
+		if (Component->CanEverAffectNavigation())
+		{
+			Component->SetCanEverAffectNavigation(false);
+			SuspendedComponents.Add(Component);
+		}
+	}
+}
+
+void FDesignerStrokeInvalidation::EndStroke()
+{
+	if (!IsInStroke())
+	{
+		return;
+	}
+
+	for (const TWeakObjectPtr<UActorComponent>& Component : SuspendedComponents)
+	{
+		if (Component.IsValid())
+		{
+			Component->SetCanEverAffectNavigation(true);
+		}
+	}
+
+	// A single finished move updates HLOD clusters, lighting and navigation for where the actor ended up
+	for (const TWeakObjectPtr<AActor>& Actor : StrokeActors)
+	{
+		if (Actor.IsValid() && !Actor->IsPendingKillPending())
+		{
+			Actor->PostEditMove(/*bFinished*/true);
+		}
+	}
+
+	SuspendedComponents.Reset();
+	StrokeActors.Reset();
+
+	// Releasing the lock rebuilds all dirty areas gathered during the stroke at once
+	NavigationLock.Reset();
+}
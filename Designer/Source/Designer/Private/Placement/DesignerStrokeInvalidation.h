@@ -0,0 +1,71 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "AI/NavigationSystemBase.h"
+
+// Forward Declares
+class AActor;
+class UActorComponent;
+class UWorld;
+
+/**
+ * Holds back the navigation and HLOD invalidation of the actors changed by a placement stroke.
+ *
+ * While an actor is dragged every transform change would dirty the navigation tiles and HLOD clusters it passes through.
+ * During a stroke the actors are taken out of the navigation octree and the navigation build is locked. When the stroke
+ * ends they are registered again and notified of their move once, so only their final state is rebuilt.
+ */
+class FDesignerStrokeInvalidation
+{
+public:
+	~FDesignerStrokeInvalidation();
+
+	/** Starts a stroke in the world, a stroke that is still in progress is ended first */
+	void BeginStroke(UWorld* World);
+
+	/** Holds back the invalidation of the actor until the end of the stroke */
+	void AddActor(AActor* Actor);
+
+	/** Sends the invalidation for the final state of all actors of the stroke */
+	void EndStroke();
+
+	bool IsInStroke() const
+	{
+		return NavigationLock.IsSet();
+	}
+
+private:
+	/** Keeps the navigation system from rebuilding while the stroke is in progress */
+	TOptional<FNavigationLockContext> NavigationLock;
+
+	/** The actors changed by the stroke */
+	TArray<TWeakObjectPtr<AActor>> StrokeActors;
+
+	/** The components that were taken out of the navigation octree for the stroke */
+	TArray<TWeakObjectPtr<UActorComponent>> SuspendedComponents;
+};
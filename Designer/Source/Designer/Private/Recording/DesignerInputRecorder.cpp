@@ -0,0 +1,363 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Recording/DesignerInputRecorder.h"
+
+// Engine Includes
+#include "AssetData.h"
+#include "Editor.h"
+#include "EditorViewportClient.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "Serialization/ObjectWriter.h"
+#include "UnrealClient.h"
+
+// Local Includes
+#include "DesignerModule.h"
+#include "DesignerSettings.h"
+
+namespace DesignerInputRecordingFile
+{
+	/** "DREC" */
+	static const uint32 Magic = 0x43455244;
+	static const int32 Version = 1;
+}
+
+bool FDesignerRecordedView::operator==(const FDesignerRecordedView& Other) const
+{
+	return Location == Other.Location
+		&& Rotation == Other.Rotation
+		&& FOV == Other.FOV
+		&& Size == Other.Size
+		&& ViewportType == Other.ViewportType
+		&& OrthoZoom == Other.OrthoZoom;
+}
+
+FArchive& operator<<(FArchive& Ar, FDesignerRecordedView& View)
+{
+	Ar << View.Location;
+	Ar << View.Rotation;
+	Ar << View.FOV;
+	Ar << View.Size;
+	Ar << View.ViewportType;
+	Ar << View.OrthoZoom;
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FDesignerInputEvent& Event)
+{
+	uint8 Type = (uint8)Event.Type;
+	Ar << Type;
+	Event.Type = (EDesignerInputEventType)Type;
+
+	Ar << Event.Time;
+
+	// Viewports are never larger than 32k pixels
+	int16 MouseX = (int16)Event.MouseX;
+	int16 MouseY = (int16)Event.MouseY;
+	Ar << MouseX;
+	Ar << MouseY;
+	Event.MouseX = MouseX;
+	Event.MouseY = MouseY;
+
+	switch (Event.Type)
+	{
+	case EDesignerInputEventType::Frame:
+	{
+		Ar << Event.DeltaTime;
+
+		uint8 bViewChanged = Event.bViewChanged ? 1 : 0;
+		Ar << bViewChanged;
+		Event.bViewChanged = bViewChanged != 0;
+
+		if (Event.bViewChanged)
+		{
+			Ar << Event.View;
+		}
+		break;
+	}
+	case EDesignerInputEventType::Key:
+		Ar << Event.NameIndex;
+		Ar << Event.InputEvent;
+		break;
+	case EDesignerInputEventType::Selection:
+		Ar << Event.NameIndices;
+		break;
+	default:
+		break;
+	}
+
+	return Ar;
+}
+
+int32 FDesignerInputRecording::FindOrAddName(const FString& Name)
+{
+	return Names.AddUnique(Name);
+}
+
+bool FDesignerInputRecording::SaveToFile(const FString& Filename) const
+{
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Writer.IsValid())
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Could not open %s for writing."), *Filename);
+		return false;
+	}
+
+	*Writer << const_cast<FDesignerInputRecording&>(*this);
+	return Writer->Close();
+}
+
+bool FDesignerInputRecording::LoadFromFile(const FString& Filename)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename));
+	if (!Reader.IsValid())
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Could not open %s for reading."), *Filename);
+		return false;
+	}
+
+	*Reader << *this;
+	if (Reader->IsError())
+	{
+		return false;
+	}
+
+	// Frames without a stored view use the view of the previous frame
+	FDesignerRecordedView View;
+	for (FDesignerInputEvent& Event : Events)
+	{
+		if (Event.Type == EDesignerInputEventType::Frame)
+		{
+			if (Event.bViewChanged)
+			{
+				View = Event.View;
+			}
+			else
+			{
+				Event.View = View;
+			}
+		}
+	}
+
+	return true;
+}
+
+FArchive& operator<<(FArchive& Ar, FDesignerInputRecording& Recording)
+{
+	uint32 Magic = DesignerInputRecordingFile::Magic;
+	int32 Version = DesignerInputRecordingFile::Version;
+	Ar << Magic;
+	Ar << Version;
+
+	if (Ar.IsLoading() && (Magic != DesignerInputRecordingFile::Magic || Version != DesignerInputRecordingFile::Version))
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Unsupported input recording (magic %08x, version %d)."), Magic, Version);
+		Ar.SetError();
+		return Ar;
+	}
+
+	Ar << Recording.MapName;
+	Ar << Recording.RandomSeed;
+	Ar << Recording.Settings;
+	Ar << Recording.Names;
+	Ar << Recording.Events;
+	return Ar;
+}
+
+FDesignerInputRecorder::FDesignerInputRecorder()
+	: bIsRecording(false)
+	, StartTime(0.0)
+{
+}
+
+FDesignerInputRecorder& FDesignerInputRecorder::Get()
+{
+	static FDesignerInputRecorder Recorder;
+	return Recorder;
+}
+
+void FDesignerInputRecorder::StartRecording(UDesignerSettings* Settings, UWorld* World)
+{
+	check(Settings != nullptr);
+	check(World != nullptr);
+
+	Recording = FDesignerInputRecording();
+	Recording.MapName = World->GetOutermost()->GetName();
+	Recording.RandomSeed = (int32)FPlatformTime::Cycles();
+
+	// The tools draw from the global random stream, so seeding it makes the session reproducible
+	FMath::RandInit(Recording.RandomSeed);
+	FMath::SRandInit(Recording.RandomSeed);
+
+	FObjectWriter SettingsWriter(Settings, Recording.Settings);
+
+	LastView = FDesignerRecordedView();
+	LastSelection.Reset();
+	StartTime = FPlatformTime::Seconds();
+	bIsRecording = true;
+}
+
+bool FDesignerInputRecorder::StopRecording(const FString& Filename)
+{
+	if (!bIsRecording)
+	{
+		return false;
+	}
+
+	bIsRecording = false;
+
+	bool bSuccess = Recording.SaveToFile(Filename);
+	if (bSuccess)
+	{
+		UE_LOG(LogDesigner, Display, TEXT("Wrote %d input events to %s."), Recording.Events.Num(), *Filename);
+	}
+
+	Recording = FDesignerInputRecording();
+	return bSuccess;
+}
+
+void FDesignerInputRecorder::RecordFrame(FEditorViewportClient* ViewportClient, FViewport* Viewport, float DeltaTime)
+{
+	if (!bIsRecording || Viewport == nullptr)
+	{
+		return;
+	}
+
+	FDesignerRecordedView View;
+	View.Location = ViewportClient->GetViewLocation();
+	View.Rotation = ViewportClient->GetViewRotation();
+	View.FOV = ViewportClient->ViewFOV;
+	View.Size = Viewport->GetSizeXY();
+	View.ViewportType = (uint8)ViewportClient->GetViewportType();
+	View.OrthoZoom = ViewportClient->GetOrthoZoom();
+
+	FDesignerInputEvent& Event = AddEvent(EDesignerInputEventType::Frame, Viewport->GetMouseX(), Viewport->GetMouseY());
+	Event.DeltaTime = DeltaTime;
+	Event.bViewChanged = !(View == LastView);
+	Event.View = View;
+
+	LastView = View;
+}
+
+void FDesignerInputRecorder::RecordKey(FViewport* Viewport, FKey Key, EInputEvent InputEvent)
+{
+	if (!bIsRecording)
+	{
+		return;
+	}
+
+	FDesignerInputEvent& Event = AddEvent(EDesignerInputEventType::Key, Viewport->GetMouseX(), Viewport->GetMouseY());
+	Event.NameIndex = Recording.FindOrAddName(Key.GetFName().ToString());
+	Event.InputEvent = (uint8)InputEvent;
+}
+
+void FDesignerInputRecorder::RecordMouseMove(int32 MouseX, int32 MouseY)
+{
+	if (!bIsRecording)
+	{
+		return;
+	}
+
+	AddEvent(EDesignerInputEventType::MouseMove, MouseX, MouseY);
+}
+
+void FDesignerInputRecorder::RecordSelectedAssets(const TArray<FAssetData>& SelectedAssets)
+{
+	if (!bIsRecording)
+	{
+		return;
+	}
+
+	TArray<int32> Selection;
+	Selection.Reserve(SelectedAssets.Num());
+	for (const FAssetData& AssetData : SelectedAssets)
+	{
+		Selection.Add(Recording.FindOrAddName(AssetData.ObjectPath.ToString()));
+	}
+
+	if (Selection != LastSelection)
+	{
+		FDesignerInputEvent& Event = AddEvent(EDesignerInputEventType::Selection, 0, 0);
+		Event.NameIndices = Selection;
+		LastSelection = MoveTemp(Selection);
+	}
+}
+
+FDesignerInputEvent& FDesignerInputRecorder::AddEvent(EDesignerInputEventType Type, int32 MouseX, int32 MouseY)
+{
+	FDesignerInputEvent& Event = Recording.Events.AddDefaulted_GetRef();
+	Event.Type = Type;
+	Event.Time = (float)(FPlatformTime::Seconds() - StartTime);
+	Event.MouseX = MouseX;
+	Event.MouseY = MouseY;
+	return Event;
+}
+
+/**
+ * designer.record.start
+ */
+static void StartRecordingCommand(const TArray<FString>& Args)
+{
+	UWorld* World = GEditor->GetEditorWorldContext().World();
+	UDesignerSettings* Settings = const_cast<UDesignerSettings*>(UDesignerSettings::GetActiveSettings());
+
+	FDesignerInputRecorder::Get().StartRecording(Settings, World);
+	UE_LOG(LogDesigner, Display, TEXT("Recording designer input, use designer.record.stop to write the recording."));
+}
+
+/**
+ * designer.record.stop [File]
+ */
+static void StopRecordingCommand(const TArray<FString>& Args)
+{
+	if (!FDesignerInputRecorder::Get().IsRecording())
+	{
+		UE_LOG(LogDesigner, Display, TEXT("No designer input recording in progress."));
+		return;
+	}
+
+	FString Filename = Args.Num() > 0
+		? Args[0]
+		: FPaths::ProjectSavedDir() / TEXT("Designer") / TEXT("Recordings") / FString::Printf(TEXT("%s.drec"), *FDateTime::Now().ToString());
+
+	if (FDesignerInputRecorder::Get().StopRecording(Filename))
+	{
+		UE_LOG(LogDesigner, Display, TEXT("Replay with -run=DesignerReplay -Recording=\"%s\""), *FPaths::ConvertRelativePathToFull(Filename));
+	}
+}
+
+static FAutoConsoleCommand StartRecordingConsoleCommand(
+	TEXT("designer.record.start"),
+	TEXT("Starts recording the input of the designer mode for a replay with the DesignerReplay commandlet."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&StartRecordingCommand));
+
+static FAutoConsoleCommand StopRecordingConsoleCommand(
+	TEXT("designer.record.stop"),
+	TEXT("Stops recording the input of the designer mode and writes it to a file. Usage: designer.record.stop [File]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&StopRecordingCommand));
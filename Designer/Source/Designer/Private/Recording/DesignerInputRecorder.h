@@ -0,0 +1,208 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "InputCoreTypes.h"
+
+// Forward Declares
+class FEditorViewportClient;
+class FViewport;
+class UDesignerSettings;
+class UWorld;
+struct FAssetData;
+
+/**
+ * The view of the viewport the input was recorded in
+ */
+struct FDesignerRecordedView
+{
+	FDesignerRecordedView()
+		: Location(ForceInitToZero)
+		, Rotation(ForceInitToZero)
+		, FOV(90.F)
+		, Size(ForceInitToZero)
+		, ViewportType(0)
+		, OrthoZoom(0.F)
+	{
+	}
+
+	FVector Location;
+	FRotator Rotation;
+	float FOV;
+	FIntPoint Size;
+
+	/** The ELevelViewportType of the viewport */
+	uint8 ViewportType;
+	float OrthoZoom;
+
+	bool operator==(const FDesignerRecordedView& Other) const;
+
+	friend FArchive& operator<<(FArchive& Ar, FDesignerRecordedView& View);
+};
+
+/**
+ * The kinds of input that are recorded
+ */
+enum class EDesignerInputEventType : uint8
+{
+	/** An editor frame, holds the delta time and the view */
+	Frame,
+	/** A key or mouse button going to FDesignerEdMode::InputKey */
+	Key,
+	/** A captured mouse move going to FSpawnAssetTool::CapturedMouseMove */
+	MouseMove,
+	/** The assets the spawn asset tool picks from changed */
+	Selection,
+};
+
+/**
+ * A single recorded input
+ */
+struct FDesignerInputEvent
+{
+	FDesignerInputEvent()
+		: Type(EDesignerInputEventType::Frame)
+		, Time(0.F)
+		, MouseX(0)
+		, MouseY(0)
+		, DeltaTime(0.F)
+		, bViewChanged(false)
+		, NameIndex(INDEX_NONE)
+		, InputEvent(0)
+	{
+	}
+
+	EDesignerInputEventType Type;
+
+	/** Seconds since the recording started */
+	float Time;
+
+	/** The cursor position in the viewport */
+	int32 MouseX;
+	int32 MouseY;
+
+	/** Frame only, the delta time of the frame */
+	float DeltaTime;
+
+	/** Frame only, the view is only stored when it differs from the previous frame */
+	bool bViewChanged;
+	FDesignerRecordedView View;
+
+	/** Key only, the key name in the name table and the EInputEvent */
+	int32 NameIndex;
+	uint8 InputEvent;
+
+	/** Selection only, the asset paths in the name table */
+	TArray<int32> NameIndices;
+
+	friend FArchive& operator<<(FArchive& Ar, FDesignerInputEvent& Event);
+};
+
+/**
+ * Everything needed to replay a Designer editing session: the map, the settings, the random seed and the input
+ */
+struct FDesignerInputRecording
+{
+	FDesignerInputRecording()
+		: RandomSeed(0)
+	{
+	}
+
+	/** The long package name of the map the input was recorded in */
+	FString MapName;
+
+	/** The seed FMath::RandInit was called with when the recording started */
+	int32 RandomSeed;
+
+	/** The serialized designer settings at the start of the recording */
+	TArray<uint8> Settings;
+
+	/** Key names and asset paths referenced by the events */
+	TArray<FString> Names;
+
+	/** The input in the order it was received */
+	TArray<FDesignerInputEvent> Events;
+
+	/** Returns the index of the name in the name table, adding it if needed */
+	int32 FindOrAddName(const FString& Name);
+
+	/** Writes the recording to disk. Returns true if it was successful */
+	bool SaveToFile(const FString& Filename) const;
+
+	/** Reads a recording written by SaveToFile. Returns true if it was successful */
+	bool LoadFromFile(const FString& Filename);
+
+	friend FArchive& operator<<(FArchive& Ar, FDesignerInputRecording& Recording);
+};
+
+/**
+ * Records the input of the designer ed mode so it can be replayed by the DesignerReplay commandlet
+ */
+class FDesignerInputRecorder
+{
+public:
+	FDesignerInputRecorder();
+
+	static FDesignerInputRecorder& Get();
+
+	/** Starts a new recording, the settings and the random seed are captured right away */
+	void StartRecording(UDesignerSettings* Settings, UWorld* World);
+
+	/** Stops recording and writes the recording to disk. Returns true if it was successful */
+	bool StopRecording(const FString& Filename);
+
+	bool IsRecording() const
+	{
+		return bIsRecording;
+	}
+
+	void RecordFrame(FEditorViewportClient* ViewportClient, FViewport* Viewport, float DeltaTime);
+
+	void RecordKey(FViewport* Viewport, FKey Key, EInputEvent Event);
+
+	void RecordMouseMove(int32 MouseX, int32 MouseY);
+
+	/** Only records the assets when they differ from the previously recorded ones */
+	void RecordSelectedAssets(const TArray<FAssetData>& SelectedAssets);
+
+private:
+	FDesignerInputEvent& AddEvent(EDesignerInputEventType Type, int32 MouseX, int32 MouseY);
+
+private:
+	bool bIsRecording;
+
+	/** The platform time the recording started */
+	double StartTime;
+
+	FDesignerInputRecording Recording;
+
+	/** The view of the last recorded frame */
+	FDesignerRecordedView LastView;
+
+	/** The name indices of the last recorded selection */
+	TArray<int32> LastSelection;
+};
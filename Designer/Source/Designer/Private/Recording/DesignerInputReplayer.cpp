@@ -0,0 +1,151 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "Recording/DesignerInputReplayer.h"
+
+// Engine Includes
+#include "AssetData.h"
+#include "EditorModeManager.h"
+#include "EditorModeRegistry.h"
+#include "EditorViewportClient.h"
+#include "Serialization/ObjectReader.h"
+
+// Local Includes
+#include "DesignerEdMode.h"
+#include "DesignerModule.h"
+#include "Recording/DesignerInputRecorder.h"
+#include "Tools/SpawnAssetTool.h"
+
+bool FDesignerInputReplayer::Replay(const FDesignerInputRecording& Recording, TArray<FDesignerReplayFrame>& OutFrames)
+{
+	OutFrames.Reset();
+
+	FEditorModeTools ModeTools;
+	TSharedPtr<FEdMode> EdMode = FEditorModeRegistry::Get().CreateMode(FDesignerEdMode::EM_DesignerEdModeId, ModeTools);
+	if (!EdMode.IsValid())
+	{
+		UE_LOG(LogDesigner, Error, TEXT("Could not create the designer ed mode."));
+		return false;
+	}
+
+	// Entering the mode keeps its snap and content indices up to date with the actors the replay places, without a toolkit since there is no level editor to host it
+	FDesignerEdMode* DesignerEdMode = static_cast<FDesignerEdMode*>(EdMode.Get());
+	DesignerEdMode->SetUsesToolkits(false);
+	DesignerEdMode->Enter();
+
+	if (Recording.Settings.Num() > 0)
+	{
+		TArray<uint8> SettingsBytes = Recording.Settings;
+		FObjectReader SettingsReader(DesignerEdMode->GetDesignerSettings(), SettingsBytes);
+	}
+
+	FEditorViewportClient ViewportClient(&ModeTools);
+	FDesignerReplayViewport Viewport(&ViewportClient);
+	ViewportClient.Viewport = &Viewport;
+
+	FMath::RandInit(Recording.RandomSeed);
+	FMath::SRandInit(Recording.RandomSeed);
+
+	double FrameStartTime = 0.0;
+	auto EndFrame = [&]()
+	{
+		if (OutFrames.Num() > 0)
+		{
+			OutFrames.Last().ReplayTimeMs = (float)((FPlatformTime::Seconds() - FrameStartTime) * 1000.0);
+		}
+	};
+
+	for (const FDesignerInputEvent& Event : Recording.Events)
+	{
+		Viewport.MouseX = Event.MouseX;
+		Viewport.MouseY = Event.MouseY;
+
+		switch (Event.Type)
+		{
+		case EDesignerInputEventType::Frame:
+		{
+			EndFrame();
+
+			const FDesignerRecordedView& View = Event.View;
+			ViewportClient.SetViewportType((ELevelViewportType)View.ViewportType);
+			ViewportClient.SetViewLocation(View.Location);
+			ViewportClient.SetViewRotation(View.Rotation);
+			ViewportClient.ViewFOV = View.FOV;
+			if (ViewportClient.IsOrtho())
+			{
+				ViewportClient.SetOrthoZoom(View.OrthoZoom);
+			}
+			Viewport.SetSize(View.Size);
+
+			FDesignerReplayFrame& Frame = OutFrames.AddDefaulted_GetRef();
+			Frame.RecordedDeltaTime = Event.DeltaTime;
+			Frame.ReplayTimeMs = 0.F;
+			FrameStartTime = FPlatformTime::Seconds();
+
+			DesignerEdMode->Tick(&ViewportClient, Event.DeltaTime);
+			break;
+		}
+		case EDesignerInputEventType::Key:
+			if (Recording.Names.IsValidIndex(Event.NameIndex))
+			{
+				FKey Key(FName(*Recording.Names[Event.NameIndex]));
+				Viewport.SetKeyState(Key, (EInputEvent)Event.InputEvent);
+				DesignerEdMode->InputKey(&ViewportClient, &Viewport, Key, (EInputEvent)Event.InputEvent);
+			}
+			break;
+		case EDesignerInputEventType::MouseMove:
+			DesignerEdMode->CapturedMouseMove(&ViewportClient, &Viewport, Event.MouseX, Event.MouseY);
+			break;
+		case EDesignerInputEventType::Selection:
+		{
+			TArray<FAssetData> SelectedAssets;
+			for (int32 NameIndex : Event.NameIndices)
+			{
+				UObject* Asset = Recording.Names.IsValidIndex(NameIndex) ? FSoftObjectPath(Recording.Names[NameIndex]).TryLoad() : nullptr;
+				if (Asset != nullptr)
+				{
+					SelectedAssets.Add(FAssetData(Asset));
+				}
+				else
+				{
+					UE_LOG(LogDesigner, Warning, TEXT("Could not load a recorded asset, the replay may diverge."));
+				}
+			}
+			DesignerEdMode->GetSpawnAssetTool()->SetSelectedAssetsOverride(SelectedAssets);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	EndFrame();
+
+	DesignerEdMode->GetSpawnAssetTool()->ClearSelectedAssetsOverride();
+	DesignerEdMode->Exit();
+	ViewportClient.Viewport = nullptr;
+
+	return true;
+}
@@ -0,0 +1,111 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "UnrealClient.h"
+
+// Forward Declares
+struct FDesignerInputRecording;
+
+/**
+ * The timing of a single replayed frame
+ */
+struct FDesignerReplayFrame
+{
+	/** The delta time of the frame when it was recorded, in seconds */
+	float RecordedDeltaTime;
+
+	/** The time spent replaying the input of the frame, in milliseconds */
+	float ReplayTimeMs;
+};
+
+/**
+ * Viewport that reports the recorded cursor position and size, also used to drive the tools from tests
+ */
+class FDesignerReplayViewport : public FDummyViewport
+{
+public:
+	FDesignerReplayViewport(FViewportClient* InViewportClient)
+		: FDummyViewport(InViewportClient)
+		, MouseX(0)
+		, MouseY(0)
+	{
+	}
+
+	//~ Begin FViewport interface
+	virtual int32 GetMouseX() const override
+	{
+		return MouseX;
+	}
+
+	virtual int32 GetMouseY() const override
+	{
+		return MouseY;
+	}
+
+	virtual bool KeyState(FKey Key) const override
+	{
+		return PressedKeys.Contains(Key);
+	}
+	//~ End FViewport interface
+
+	/** Tracks the keys that are held down, so modifier checks such as IsShiftPressed see the replayed keys */
+	void SetKeyState(const FKey& Key, EInputEvent Event)
+	{
+		if (Event == IE_Pressed)
+		{
+			PressedKeys.Add(Key);
+		}
+		else if (Event == IE_Released)
+		{
+			PressedKeys.Remove(Key);
+		}
+	}
+
+	void SetSize(const FIntPoint& Size)
+	{
+		SizeX = Size.X;
+		SizeY = Size.Y;
+	}
+
+	int32 MouseX;
+	int32 MouseY;
+
+private:
+	TSet<FKey> PressedKeys;
+};
+
+/**
+ * Replays recorded designer input without a viewport widget.
+ * The input goes through a designer ed mode of its own with a viewport that reports the recorded cursor and view.
+ */
+class FDesignerInputReplayer
+{
+public:
+	/** Replays the recording against the current editor world. Returns true if it was successful */
+	static bool Replay(const FDesignerInputRecording& Recording, TArray<FDesignerReplayFrame>& OutFrames);
+};
@@ -66,6 +66,9 @@ void SDesignerSettings::Construct(const FArguments & InArgs, TSharedRef<FDesigne
 	DetailsPanel->SetIsPropertyVisibleDelegate(FIsPropertyVisible::CreateSP(this, &SDesignerSettings::GetIsPropertyVisible));
 	DetailsPanel->SetDisableCustomDetailLayouts(false);
 
+	// Registered on this details panel only, so the module does not need the property editor at startup
+	DetailsPanel->RegisterInstancedCustomPropertyLayout(UDesignerSettings::StaticClass(), FOnGetDetailCustomizationInstance::CreateStatic(&FDesignerSettingsCustomization::MakeInstance));
+
 	DetailsPanel->SetRootObjectCustomizationInstance(MakeShareable(new FDesignerSettingsRootObjectCustomization));
 	if (FDesignerEdMode * DesignerEdMode = GetEditorMode())
 	{
@@ -0,0 +1,163 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Engine Includes
+#include "AssetData.h"
+#include "Editor.h"
+#include "EditorModeManager.h"
+#include "EditorModeRegistry.h"
+#include "EditorViewportClient.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "InputCoreTypes.h"
+#include "Misc/AutomationTest.h"
+
+// Local Includes
+#include "DesignerEdMode.h"
+#include "Diagnostics/DesignerAllocationCounter.h"
+#include "Recording/DesignerInputReplayer.h"
+#include "Tools/SpawnAssetTool.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define LOCTEXT_NAMESPACE "DesignerAllocationTest"
+
+namespace DesignerAllocationTest
+{
+	/** Far from the level content, so the cursor only hits the test floor */
+	static const FVector FloorLocation(0.F, 0.F, 200000.F);
+
+	static const FIntPoint ViewportSize(1280, 720);
+
+	/** The number of mouse moves in one pass of the drag */
+	static const int32 NumDragSteps = 60;
+
+	/** The radius of the circle the cursor is dragged along, in pixels */
+	static const float DragRadius = 200.F;
+
+	static const float DeltaTime = 1.F / 60.F;
+
+	/** Drags the cursor along a circle around the viewport center, with a tick after every move like the editor does */
+	static void Drag(FDesignerEdMode* DesignerEdMode, FEditorViewportClient& ViewportClient, FDesignerReplayViewport& Viewport)
+	{
+		for (int32 Step = 0; Step < NumDragSteps; ++Step)
+		{
+			const float Angle = 2.F * PI * Step / NumDragSteps;
+			Viewport.MouseX = ViewportSize.X / 2 + FMath::RoundToInt(FMath::Cos(Angle) * DragRadius);
+			Viewport.MouseY = ViewportSize.Y / 2 + FMath::RoundToInt(FMath::Sin(Angle) * DragRadius);
+
+			DesignerEdMode->CapturedMouseMove(&ViewportClient, &Viewport, Viewport.MouseX, Viewport.MouseY);
+			DesignerEdMode->Tick(&ViewportClient, DeltaTime);
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDesignerSpawnAssetToolAllocationTest, "Designer.Tools.SpawnAssetTool.SteadyDragDoesNotAllocate", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDesignerSpawnAssetToolAllocationTest::RunTest(const FString& Parameters)
+{
+	using namespace DesignerAllocationTest;
+
+	if (!FDesignerAllocationCounter::IsAvailable())
+	{
+		AddWarning(TEXT("The allocation counter is not installed, nothing was counted. Run the test in an editor started with -DesignerAllocs."));
+		return true;
+	}
+
+	UWorld* World = GEditor->GetEditorWorldContext().World();
+	UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!TestNotNull(TEXT("Editor world"), World) || !TestNotNull(TEXT("Cube mesh"), Cube))
+	{
+		return false;
+	}
+
+	// The mode is not entered, so it never opens a toolkit
+	FEditorModeTools ModeTools;
+	TSharedPtr<FEdMode> EdMode = FEditorModeRegistry::Get().CreateMode(FDesignerEdMode::EM_DesignerEdModeId, ModeTools);
+	if (!TestTrue(TEXT("Designer ed mode created"), EdMode.IsValid()))
+	{
+		return false;
+	}
+
+	FDesignerEdMode* DesignerEdMode = static_cast<FDesignerEdMode*>(EdMode.Get());
+
+	// Everything the test adds to the level, including the actor the tool spawns in a transaction of its own, is undone at the end
+	GEditor->BeginTransaction(LOCTEXT("AllocationTestTransaction", "Designer: Allocation Test"));
+
+	AStaticMeshActor* Floor = World->SpawnActor<AStaticMeshActor>(FloorLocation, FRotator::ZeroRotator);
+	Floor->GetStaticMeshComponent()->SetStaticMesh(Cube);
+	Floor->SetActorScale3D(FVector(100.F, 100.F, 1.F));
+
+	FEditorViewportClient ViewportClient(&ModeTools);
+	FDesignerReplayViewport Viewport(&ViewportClient);
+	ViewportClient.Viewport = &Viewport;
+	ViewportClient.SetViewLocation(FloorLocation + FVector(-1500.F, 0.F, 1500.F));
+	ViewportClient.SetViewRotation(FRotator(-45.F, 0.F, 0.F));
+	Viewport.SetSize(ViewportSize);
+	Viewport.MouseX = ViewportSize.X / 2;
+	Viewport.MouseY = ViewportSize.Y / 2;
+
+	DesignerEdMode->GetSpawnAssetTool()->SetSelectedAssetsOverride({ FAssetData(Cube) });
+
+	DesignerEdMode->InputKey(&ViewportClient, &Viewport, EKeys::LeftControl, IE_Pressed);
+	DesignerEdMode->Tick(&ViewportClient, DeltaTime);
+	DesignerEdMode->InputKey(&ViewportClient, &Viewport, EKeys::LeftMouseButton, IE_Pressed);
+
+	AActor* SpawnedActor = DesignerEdMode->GetSpawnAssetTool()->GetControlledActor();
+	if (TestNotNull(TEXT("Spawned actor"), SpawnedActor))
+	{
+		// The first pass grows the buffers the drag reuses, the second one must not allocate anymore
+		Drag(DesignerEdMode, ViewportClient, Viewport);
+
+		FDesignerAllocationCounter::Start();
+		Drag(DesignerEdMode, ViewportClient, Viewport);
+		const FDesignerAllocationCount Count = FDesignerAllocationCounter::Stop();
+
+		TestTrue(TEXT("The drag went through the allocation scopes"), Count.NumScopes > 0);
+		TestEqual(TEXT("Allocations while dragging"), Count.NumAllocations, (uint64)0);
+	}
+
+	// Releasing Control leaves the tool without placing the actor, it is removed below
+	DesignerEdMode->InputKey(&ViewportClient, &Viewport, EKeys::LeftControl, IE_Released);
+	DesignerEdMode->SwitchTool(nullptr);
+	DesignerEdMode->GetSpawnAssetTool()->ClearSelectedAssetsOverride();
+	ViewportClient.Viewport = nullptr;
+
+	GEditor->SelectNone(true, true, false);
+	if (SpawnedActor != nullptr)
+	{
+		World->EditorDestroyActor(SpawnedActor, false);
+	}
+	World->EditorDestroyActor(Floor, false);
+
+	GEditor->EndTransaction();
+	GEditor->UndoTransaction(/*bCanRedo*/false);
+
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -25,6 +25,82 @@
 // This Include
 #include "DesignerTool.h"
 
+// Engine Includes
+#include "CollisionQueryParams.h"
+#include "Components/PrimitiveComponent.h"
+#include "EditorViewportClient.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "SceneView.h"
+#include "Editor/UnrealEd/Private/Editor/ActorPositioning.h"
+
+// Local Includes
+#include "DesignerModule.h"
+#include "Diagnostics/DesignerPerfHUD.h"
+
+namespace DesignerTool
+{
+	/** Coherent hits closer than this to the bounds of their component in cm go to the world query, the cursor may be over a neighbour already */
+	static const float CoherenceEdgeMargin = 10.F;
+
+	/** Coherent hits closer than this to the bounds of their component in cm test for occlusion every time, content placed around it covers it there */
+	static const float CoherenceOcclusionEdgeBand = 100.F;
+
+	/** Away from the edges the occlusion test of a coherent hit runs once per this many frames, the hits in between reuse its answer */
+	static const uint64 CoherenceOcclusionInterval = 4;
+
+	/** How far along the ray the world hit is probed to find the component that was hit */
+	static const float CoherenceProbeLength = 10.F;
+
+	/** Trying the last hit component first can be turned off with designer.tracecoherence, to compare */
+	static bool bTraceCoherence = true;
+
+	/** The coherent traces since the last reset and how many of them did not need the world query */
+	static uint64 NumCoherenceTests = 0;
+	static uint64 NumCoherenceHits = 0;
+
+	/** Shrinks the bounds by the margin, axes thinner than twice the margin are not shrunk so flat landscape components keep their hits */
+	static FBox ShrinkBounds(const FBox& Bounds, float Margin)
+	{
+		const FVector Extent = Bounds.GetExtent();
+		const FVector AxisMargin(
+			Extent.X > 2.F * Margin ? Margin : 0.F,
+			Extent.Y > 2.F * Margin ? Margin : 0.F,
+			Extent.Z > 2.F * Margin ? Margin : 0.F);
+		return FBox(Bounds.Min + AxisMargin, Bounds.Max - AxisMargin);
+	}
+
+	/** Returns the component of the actor hit at the location by a ray along the direction */
+	static UPrimitiveComponent* FindHitComponent(AActor* Actor, const FVector& Location, const FVector& Direction)
+	{
+		if (Actor == nullptr)
+		{
+			return nullptr;
+		}
+
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(DesignerCoherentTrace), /*bTraceComplex*/true);
+		const FVector ProbeStart = Location - Direction * CoherenceProbeLength;
+		const FVector ProbeEnd = Location + Direction * CoherenceProbeLength;
+
+		TInlineComponentArray<UPrimitiveComponent*> Components(Actor);
+		for (UPrimitiveComponent* Component : Components)
+		{
+			FHitResult Hit;
+			if (Component->IsRegistered()
+				&& Component->IsCollisionEnabled()
+				&& Component->Bounds.GetBox().ExpandBy(CoherenceProbeLength).IsInside(Location)
+				&& Component->LineTraceComponent(Hit, ProbeStart, ProbeEnd, QueryParams)
+				&& FVector::DistSquared(Hit.Location, Location) < 1.F)
+			{
+				return Component;
+			}
+		}
+
+		return nullptr;
+	}
+}
+
 FString FDesignerTool::GetName() const 
 { 
 	return TEXT("DesignerTool"); 
@@ -35,4 +111,175 @@ bool FDesignerTool::IsSelectionAllowed(AActor* InActor, bool bInSelection) const
 	return true; 
 }
 
+bool FDesignerTool::TraceCursor(FEditorViewportClient* ViewportClient, FViewport* Viewport, FVector& OutLocation, FVector& OutSurfaceNormal)
+{
+	FDesignerPerfScope PerfScope(EDesignerPerfCategory::Trace);
+
+	if (TraceCoherentComponent(ViewportClient, Viewport, OutLocation, OutSurfaceNormal))
+	{
+		return true;
+	}
+
+	FDesignerPerfHUD::AddTraces(1);
+
+	FSceneViewFamilyContext ViewFamily(FSceneViewFamily::ConstructionValues(
+		Viewport,
+		ViewportClient->GetScene(),
+		ViewportClient->EngineShowFlags)
+		.SetRealtimeUpdate(ViewportClient->IsRealtime()));
+	// SceneView is deleted with the ViewFamily
+	FSceneView* SceneView = ViewportClient->CalcSceneView(&ViewFamily);
+
+	FViewportCursorLocation MouseViewportRay(SceneView, ViewportClient, Viewport->GetMouseX(), Viewport->GetMouseY());
+
+	FActorPositionTraceResult ActorPositionTraceResult = FActorPositioning::TraceWorldForPositionWithDefault(MouseViewportRay, *SceneView);
+
+	if (ActorPositionTraceResult.HitActor == nullptr)
+	{
+		CoherentComponent.Reset();
+		return false;
+	}
+
+	OutLocation = ActorPositionTraceResult.Location;
+	OutSurfaceNormal = ActorPositionTraceResult.SurfaceNormal;
+
+	if (DesignerTool::bTraceCoherence)
+	{
+		CoherentComponent = DesignerTool::FindHitComponent(ActorPositionTraceResult.HitActor.Get(), OutLocation, MouseViewportRay.GetDirection());
+
+		// The world trace already saw everything in front of the component
+		LastOcclusionTestFrame = GFrameCounter;
+	}
+
+	return true;
+}
+
+bool FDesignerTool::TraceCoherentComponent(FEditorViewportClient* ViewportClient, FViewport* Viewport, FVector& OutLocation, FVector& OutSurfaceNormal)
+{
+	using namespace DesignerTool;
+
+	// Orthographic rays start on the near plane, which may already be inside the content
+	UPrimitiveComponent* Component = CoherentComponent.Get();
+	if (!bTraceCoherence
+		|| Component == nullptr
+		|| !ViewportClient->IsPerspective()
+		|| !Component->IsRegistered()
+		|| Component->GetWorld() != ViewportClient->GetWorld()
+		|| Component->GetOwner() == nullptr
+		|| Component->GetOwner()->IsHiddenEd())
+	{
+		return false;
+	}
+
+	++NumCoherenceTests;
+
+	FVector RayOrigin;
+	FVector RayDirection;
+	DeprojectCursor(ViewportClient, Viewport, RayOrigin, RayDirection);
+
+	FHitResult Hit;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(DesignerCoherentTrace), /*bTraceComplex*/true);
+	if (!Component->LineTraceComponent(Hit, RayOrigin, RayOrigin + RayDirection * HALF_WORLD_MAX, QueryParams))
+	{
+		FDesignerPerfHUD::AddTraceCoherence(false);
+		return false;
+	}
+
+	const FBox Bounds = Component->Bounds.GetBox();
+	if (!ShrinkBounds(Bounds, CoherenceEdgeMargin).IsInside(Hit.Location))
+	{
+		FDesignerPerfHUD::AddTraceCoherence(false);
+		return false;
+	}
+
+	// The component only knows about itself, content in front of it such as an actor placed on top of it still needs the world.
+	// A yes or no query that stops at the first blocker is far cheaper than the positioning trace with its scene view, but it still
+	// walks the whole ray through the scene, so it only runs near the edges of the component or once every few frames
+	if (GFrameCounter - LastOcclusionTestFrame >= CoherenceOcclusionInterval || !ShrinkBounds(Bounds, CoherenceOcclusionEdgeBand).IsInside(Hit.Location))
+	{
+		LastOcclusionTestFrame = GFrameCounter;
+
+		QueryParams.AddIgnoredComponent(Component);
+		FDesignerPerfHUD::AddTraces(1);
+		if (ViewportClient->GetWorld()->LineTraceTestByObjectType(RayOrigin, Hit.Location - RayDirection, FCollisionObjectQueryParams(FCollisionObjectQueryParams::InitType::AllObjects), QueryParams))
+		{
+			FDesignerPerfHUD::AddTraceCoherence(false);
+			return false;
+		}
+	}
+
+	++NumCoherenceHits;
+	FDesignerPerfHUD::AddTraceCoherence(true);
+
+	OutLocation = Hit.Location;
+	OutSurfaceNormal = Hit.Normal;
+
+	return true;
+}
+
+void FDesignerTool::DeprojectCursor(FEditorViewportClient* ViewportClient, FViewport* Viewport, FVector& OutOrigin, FVector& OutDirection)
+{
+	const FIntPoint ViewportSize = Viewport->GetSizeXY();
+	if (CachedViewportClient != ViewportClient
+		|| CachedViewportType != ViewportClient->GetViewportType()
+		|| CachedViewportSize != ViewportSize
+		|| CachedViewLocation != ViewportClient->GetViewLocation()
+		|| CachedViewRotation != ViewportClient->GetViewRotation()
+		|| CachedViewFOV != ViewportClient->ViewFOV
+		|| CachedOrthoZoom != ViewportClient->GetOrthoZoom())
+	{
+		FSceneViewFamilyContext ViewFamily(FSceneViewFamily::ConstructionValues(
+			Viewport,
+			ViewportClient->GetScene(),
+			ViewportClient->EngineShowFlags)
+			.SetRealtimeUpdate(ViewportClient->IsRealtime()));
+		// SceneView is deleted with the ViewFamily
+		const FSceneView* SceneView = ViewportClient->CalcSceneView(&ViewFamily);
+
+		CachedViewportClient = ViewportClient;
+		CachedViewportType = ViewportClient->GetViewportType();
+		CachedViewportSize = ViewportSize;
+		CachedViewLocation = ViewportClient->GetViewLocation();
+		CachedViewRotation = ViewportClient->GetViewRotation();
+		CachedViewFOV = ViewportClient->ViewFOV;
+		CachedOrthoZoom = ViewportClient->GetOrthoZoom();
+		CachedInvViewProjectionMatrix = SceneView->ViewMatrices.GetInvViewProjectionMatrix();
+		CachedViewRect = SceneView->UnconstrainedViewRect;
+	}
+
+	const FVector2D ScreenPosition(Viewport->GetMouseX(), Viewport->GetMouseY());
+	FSceneView::DeprojectScreenToWorld(ScreenPosition, CachedViewRect, CachedInvViewProjectionMatrix, OutOrigin, OutDirection);
+}
+
+/**
+ * designer.tracecoherence [on|off|reset]
+ * Logs how many cursor traces were answered by the component hit last time, and turns trying it first on or off.
+ */
+static void TraceCoherenceCommand(const TArray<FString>& Args)
+{
+	using namespace DesignerTool;
+
+	if (Args.Num() > 0)
+	{
+		if (Args[0].Equals(TEXT("on"), ESearchCase::IgnoreCase) || Args[0].Equals(TEXT("off"), ESearchCase::IgnoreCase))
+		{
+			bTraceCoherence = Args[0].Equals(TEXT("on"), ESearchCase::IgnoreCase);
+		}
+		else if (!Args[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase))
+		{
+			UE_LOG(LogDesigner, Display, TEXT("Usage: designer.tracecoherence [on|off|reset]"));
+			return;
+		}
+
+		NumCoherenceTests = 0;
+		NumCoherenceHits = 0;
+	}
+
+	UE_LOG(LogDesigner, Display, TEXT("Trace coherence is %s. %llu of %llu coherent traces hit the last component (%.1f%%), the rest queried the world."),
+		bTraceCoherence ? TEXT("on") : TEXT("off"), NumCoherenceHits, NumCoherenceTests, NumCoherenceTests > 0 ? 100.0 * NumCoherenceHits / NumCoherenceTests : 0.0);
+}
 
+static FAutoConsoleCommand TraceCoherenceConsoleCommand(
+	TEXT("designer.tracecoherence"),
+	TEXT("Logs the hit rate of tracing the cursor against the last hit component first, or turns it on or off. Usage: designer.tracecoherence [on|off|reset]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&TraceCoherenceCommand));
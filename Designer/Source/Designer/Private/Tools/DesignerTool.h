@@ -26,8 +26,13 @@
 
 // Engine includes
 #include "CoreMinimal.h"
+#include "Editor/UnrealEdTypes.h"
 #include "EditorModeTools.h"
 #include "UObject/GCObject.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+// Forward Declares
+class UPrimitiveComponent;
 
 /**
  * Tool for spawning assets from the content browser.
@@ -55,5 +60,43 @@ public:
 
 	//~ Begin FGCObject interface
 	virtual void AddReferencedObjects(FReferenceCollector& Collector) {}
+	//~ End FGCObject interface
+
+protected:
+	/**
+	 * Traces the world under the cursor the same way the editor does when dropping assets. Returns true if something was hit.
+	 * The component hit last time is tried first, the world is only queried when the cursor left it or something is in front of it.
+	 */
+	bool TraceCursor(FEditorViewportClient* ViewportClient, FViewport* Viewport, FVector& OutLocation, FVector& OutSurfaceNormal);
+
+	/**
+	 * Returns the world ray under the cursor. The view matrices are kept until the camera or the viewport size changes,
+	 * so dragging with a still camera does not build a scene view every mouse move.
+	 * The origin of orthographic rays lies on the near plane, only use them as lines.
+	 */
+	void DeprojectCursor(FEditorViewportClient* ViewportClient, FViewport* Viewport, FVector& OutOrigin, FVector& OutDirection);
+
+private:
+	/** Traces the cursor against the component hit last time. Returns true if it is still hit away from its edges and nothing is in front of it */
+	bool TraceCoherentComponent(FEditorViewportClient* ViewportClient, FViewport* Viewport, FVector& OutLocation, FVector& OutSurfaceNormal);
+
+private:
+	/** The component hit by the last cursor trace, the cursor rarely leaves it between frames */
+	TWeakObjectPtr<UPrimitiveComponent> CoherentComponent;
+
+	/** The frame the cursor was last known to have a clear view of the coherent component */
+	uint64 LastOcclusionTestFrame = 0;
+
+	/** The camera the cached view matrices were built for */
+	const FEditorViewportClient* CachedViewportClient = nullptr;
+	ELevelViewportType CachedViewportType = LVT_Perspective;
+	FVector CachedViewLocation = FVector::ZeroVector;
+	FRotator CachedViewRotation = FRotator::ZeroRotator;
+	float CachedViewFOV = 0.F;
+	float CachedOrthoZoom = 0.F;
+	FIntPoint CachedViewportSize = FIntPoint::ZeroValue;
 
+	/** The view matrices used to deproject the cursor */
+	FMatrix CachedInvViewProjectionMatrix = FMatrix::Identity;
+	FIntRect CachedViewRect;
 };
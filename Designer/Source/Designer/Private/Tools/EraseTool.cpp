@@ -0,0 +1,332 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "EraseTool.h"
+
+// Engine Includes
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Editor.h"
+#include "EditorViewportClient.h"
+#include "Engine/World.h"
+#include "SceneManagement.h"
+#include "ScopedTransaction.h"
+
+// Local Includes
+#include "DesignerInstanceContainer.h"
+#include "DesignerPalette.h"
+#include "DesignerSettings.h"
+#include "Diagnostics/DesignerMemory.h"
+#include "Placement/DesignerBulkEditScope.h"
+#include "Placement/DesignerPlacement.h"
+
+#define LOCTEXT_NAMESPACE "EraseTool"
+
+namespace DesignerEraseTool
+{
+	/** The brush has to move this far before it erases again */
+	static const float MinEraseDistance = 1.F;
+
+	/** The asset an item was placed from, its static mesh, blueprint or class */
+	static const UObject* GetPlacedAsset(const FDesignerPlacedItem& Item)
+	{
+		if (const UHierarchicalInstancedStaticMeshComponent* Component = Item.Component.Get())
+		{
+			return Component->GetStaticMesh();
+		}
+
+		return FDesignerPlacement::GetPlacedAsset(Item.Actor.Get());
+	}
+}
+
+FEraseTool::FEraseTool(UDesignerSettings* InDesignerSettings, FDesignerPlacedContentIndex* InContentIndex)
+	: DesignerSettings(InDesignerSettings)
+	, ContentIndex(InContentIndex)
+	, BrushLocation(FVector::ZeroVector)
+	, BrushNormal(FVector::UpVector)
+	, bBrushOnSurface(false)
+	, StrokeSeed(0)
+	, NumErased(0)
+	, LastEraseLocation(FVector::ZeroVector)
+{
+	check(ContentIndex != nullptr);
+}
+
+FEraseTool::~FEraseTool()
+{
+	EndStroke();
+}
+
+void FEraseTool::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(DesignerSettings);
+}
+
+FString FEraseTool::GetName() const
+{
+	return TEXT("EraseTool");
+}
+
+void FEraseTool::EnterTool()
+{
+	bBrushOnSurface = false;
+}
+
+void FEraseTool::ExitTool()
+{
+	EndStroke();
+	bBrushOnSurface = false;
+}
+
+bool FEraseTool::IsSelectionAllowed(AActor* InActor, bool bInSelection) const
+{
+	return false;
+}
+
+bool FEraseTool::InputKey(FEditorViewportClient* ViewportClient, FViewport* Viewport, FKey Key, EInputEvent Event)
+{
+	if (Key != EKeys::LeftMouseButton)
+	{
+		return false;
+	}
+
+	if (Event == IE_Pressed)
+	{
+		bBrushOnSurface = TraceCursor(ViewportClient, Viewport, BrushLocation, BrushNormal);
+		if (bBrushOnSurface)
+		{
+			BeginStroke(ViewportClient->GetWorld());
+			EraseAt(ViewportClient->GetWorld(), BrushLocation);
+		}
+	}
+	else if (Event == IE_Released)
+	{
+		EndStroke();
+	}
+
+	return true;
+}
+
+void FEraseTool::Render(const FSceneView* View, FViewport* Viewport, FPrimitiveDrawInterface* PDI)
+{
+	if (!bBrushOnSurface)
+	{
+		return;
+	}
+
+	FVector BrushX;
+	FVector BrushY;
+	BrushNormal.FindBestAxisVectors(BrushX, BrushY);
+
+	const FLinearColor BrushColor = StrokeTransaction.IsValid() ? FLinearColor::Red : FLinearColor(1.F, 0.5F, 0.F);
+	DrawCircle(PDI, BrushLocation, BrushX, BrushY, BrushColor, DesignerSettings->EraseRadius, 48, SDPG_Foreground, 2.F);
+}
+
+void FEraseTool::Tick(FEditorViewportClient* ViewportClient, float DeltaTime)
+{
+	bBrushOnSurface = TraceCursor(ViewportClient, ViewportClient->Viewport, BrushLocation, BrushNormal);
+
+	if (StrokeTransaction.IsValid() && bBrushOnSurface && FVector::DistSquared(BrushLocation, LastEraseLocation) >= FMath::Square(DesignerEraseTool::MinEraseDistance))
+	{
+		EraseAt(ViewportClient->GetWorld(), BrushLocation);
+	}
+}
+
+void FEraseTool::BeginStroke(UWorld* World)
+{
+	EndStroke();
+
+	StrokeTransaction = MakeUnique<FScopedTransaction>(LOCTEXT("EraseTransaction", "Designer: Erase"));
+	StrokeInvalidation.BeginStroke(World);
+	StrokeSeed = static_cast<uint32>(FMath::Rand());
+	NumErased = 0;
+
+	// The index follows the actor notifications of the mode, instances written directly are picked up here
+	if (ContentIndex->GetWorld() != World)
+	{
+		ContentIndex->Build(World);
+	}
+	else
+	{
+		ContentIndex->Refresh();
+	}
+
+	FilterAssets.Reset();
+	if (DesignerSettings->EraseFilter == EEraseFilter::SelectedAssets)
+	{
+		if (const UDesignerPalette* Palette = DesignerSettings->Palette)
+		{
+			for (const FDesignerPaletteEntry& PaletteEntry : Palette->Entries)
+			{
+				FilterAssets.Add(PaletteEntry.Asset);
+			}
+		}
+		else
+		{
+			TArray<FAssetData> SelectedAssets;
+			GEditor->GetContentBrowserSelections(SelectedAssets);
+			for (const FAssetData& AssetData : SelectedAssets)
+			{
+				FilterAssets.Add(AssetData.GetAsset());
+			}
+		}
+	}
+}
+
+void FEraseTool::EraseAt(UWorld* World, const FVector& Location)
+{
+	LastEraseLocation = Location;
+
+	BrushItems.Reset();
+	ContentIndex->FindInRadius(Location, DesignerSettings->EraseRadius, BrushItems);
+
+	// The per component arrays are kept for the stroke, a component that was brushed before is usually brushed again
+	ErasedActors.Reset();
+	for (TPair<UHierarchicalInstancedStaticMeshComponent*, TArray<int32>>& Pair : ErasedInstances)
+	{
+		Pair.Value.Reset();
+	}
+
+	int32 NumErasedInstances = 0;
+	for (const FDesignerPlacedItem& Item : BrushItems)
+	{
+		if (!Item.Actor.IsValid() || !PassesFilter(Item) || !IsInErasedFraction(Item))
+		{
+			continue;
+		}
+
+		if (Item.InstanceIndex == INDEX_NONE)
+		{
+			ErasedActors.Add(Item.Actor.Get());
+		}
+		else if (UHierarchicalInstancedStaticMeshComponent* Component = Item.Component.Get())
+		{
+			ErasedInstances.FindOrAdd(Component).Add(Item.InstanceIndex);
+			++NumErasedInstances;
+		}
+	}
+
+	if (ErasedActors.Num() == 0 && NumErasedInstances == 0)
+	{
+		return;
+	}
+
+	FDesignerBulkEditScope BulkEditScope;
+
+	// Destroying the actors directly skips the reference checks and the per actor notifications of deleting a selection
+	bool bSelectionChanged = false;
+	for (AActor* Actor : ErasedActors)
+	{
+		if (Actor->IsSelected())
+		{
+			GEditor->SelectActor(Actor, /*bInSelected*/false, /*bNotify*/false);
+			bSelectionChanged = true;
+		}
+
+		ContentIndex->RemoveActor(Actor);
+		FDesignerBulkEditScope::MarkLevelDirty(Actor->GetLevel());
+		{
+			DESIGNER_LLM_SCOPE(EDesignerLLMTag::Transactions);
+			Actor->Modify();
+			World->EditorDestroyActor(Actor, /*bShouldModifyLevel*/true);
+		}
+	}
+
+	if (bSelectionChanged)
+	{
+		GEditor->NoteSelectionChange();
+	}
+
+	// Every touched component is compacted once per erase. Its instance bodies are compacted along with it,
+	// so the cursor trace stops hitting the erased instances right away without rebuilding the physics
+	for (TPair<UHierarchicalInstancedStaticMeshComponent*, TArray<int32>>& Pair : ErasedInstances)
+	{
+		if (Pair.Value.Num() == 0)
+		{
+			continue;
+		}
+
+		ADesignerInstanceContainer* Container = CastChecked<ADesignerInstanceContainer>(Pair.Key->GetOwner());
+		Pair.Value.Sort();
+
+		Container->RemoveInstances(Pair.Key, Pair.Value);
+		Container->FinishInstanceChanges();
+		ContentIndex->RemoveInstances(Pair.Key, Pair.Value);
+		FDesignerBulkEditScope::MarkLevelDirty(Container->GetLevel());
+
+		NumErased += Pair.Value.Num();
+	}
+
+	NumErased += ErasedActors.Num();
+}
+
+void FEraseTool::EndStroke()
+{
+	if (!StrokeTransaction.IsValid())
+	{
+		return;
+	}
+
+	ErasedActors.Reset();
+	ErasedInstances.Reset();
+
+	StrokeInvalidation.EndStroke();
+
+	if (NumErased == 0)
+	{
+		StrokeTransaction->Cancel();
+	}
+	StrokeTransaction.Reset();
+
+	GEditor->RedrawLevelEditingViewports();
+}
+
+bool FEraseTool::PassesFilter(const FDesignerPlacedItem& Item) const
+{
+	switch (DesignerSettings->EraseFilter)
+	{
+	case EEraseFilter::SelectedAssets:
+		return FilterAssets.Contains(DesignerEraseTool::GetPlacedAsset(Item));
+	case EEraseFilter::Actors:
+		return Item.InstanceIndex == INDEX_NONE;
+	case EEraseFilter::Instances:
+		return Item.InstanceIndex != INDEX_NONE;
+	default:
+		return true;
+	}
+}
+
+bool FEraseTool::IsInErasedFraction(const FDesignerPlacedItem& Item) const
+{
+	if (DesignerSettings->EraseFraction >= 1.F)
+	{
+		return true;
+	}
+
+	// Decided by the location of the item, so brushing over it again during the same stroke keeps the same outcome
+	const uint32 Hash = FCrc::MemCrc32(&Item.Location, sizeof(FVector), StrokeSeed);
+	return Hash < static_cast<uint32>(static_cast<double>(DesignerSettings->EraseFraction) * MAX_uint32);
+}
+
+#undef LOCTEXT_NAMESPACE
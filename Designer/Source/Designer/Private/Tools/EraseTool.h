@@ -0,0 +1,128 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Local Includes
+#include "Placement/DesignerPlacedContentIndex.h"
+#include "Placement/DesignerStrokeInvalidation.h"
+#include "Tools/DesignerTool.h"
+
+// Forward Declares
+class AActor;
+class FScopedTransaction;
+class UDesignerSettings;
+class UHierarchicalInstancedStaticMeshComponent;
+class UWorld;
+
+/**
+ * Brush that removes content placed by the Designer tools.
+ * Every stroke erases the placed actors and container instances under the brush in a single transaction.
+ */
+class FEraseTool : public FDesignerTool
+{
+public:
+	FEraseTool(UDesignerSettings* InDesignerSettings, FDesignerPlacedContentIndex* InContentIndex);
+	virtual ~FEraseTool();
+
+	//~ Begin FDesignerTool interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+	/** Returns the name that gets reported to the editor. */
+	virtual FString GetName() const override;
+
+	/** Called by the designer ed mode when switching to this tool */
+	virtual void EnterTool() override;
+
+	/** Called by the designer ed mode when switching to another tool from this tool */
+	virtual void ExitTool() override;
+
+	/** Check to see if an actor can be selected in this mode - no side effects */
+	virtual bool IsSelectionAllowed(AActor* InActor, bool bInSelection) const override;
+	//~ End FDesignerTool interface
+
+	//~ Begin FModeTool interface
+	virtual bool InputKey(FEditorViewportClient* ViewportClient, FViewport* Viewport, FKey Key, EInputEvent Event) override;
+
+	virtual void Render(const FSceneView* View, FViewport* Viewport, FPrimitiveDrawInterface* PDI) override;
+
+	virtual void Tick(FEditorViewportClient* ViewportClient, float DeltaTime) override;
+	//~ End FModeTool interface
+
+private:
+	/** Opens the transaction of a stroke and makes sure the content index is up to date */
+	void BeginStroke(UWorld* World);
+
+	/** Removes the content under the brush at the location */
+	void EraseAt(UWorld* World, const FVector& Location);
+
+	/** Closes the transaction of the stroke */
+	void EndStroke();
+
+	/** Is the item matched by the erase filter of the settings? */
+	bool PassesFilter(const FDesignerPlacedItem& Item) const;
+
+	/** Is the item among the fraction of the content this stroke removes? */
+	bool IsInErasedFraction(const FDesignerPlacedItem& Item) const;
+
+private:
+	/** The settings available to the user */
+	UDesignerSettings* DesignerSettings;
+
+	/** The placed content of the world, owned by the designer ed mode */
+	FDesignerPlacedContentIndex* ContentIndex;
+
+	/** The surface under the cursor */
+	FVector BrushLocation;
+	FVector BrushNormal;
+	bool bBrushOnSurface;
+
+	/** The transaction of the current stroke, unset when no stroke is in progress */
+	TUniquePtr<FScopedTransaction> StrokeTransaction;
+
+	/** Holds back the navigation updates of the erased actors until the stroke ends */
+	FDesignerStrokeInvalidation StrokeInvalidation;
+
+	/** Decides which fraction of the content the current stroke removes */
+	uint32 StrokeSeed;
+
+	/** The number of items removed by the current stroke */
+	int32 NumErased;
+
+	/** The location of the last erase of the current stroke */
+	FVector LastEraseLocation;
+
+	/** The assets removed with the SelectedAssets filter, gathered when the stroke starts */
+	TSet<const UObject*> FilterAssets;
+
+	/** The items under the brush, kept to avoid allocating while erasing */
+	TArray<FDesignerPlacedItem> BrushItems;
+
+	/** The actors and the instances per component removed by the current erase, kept for the stroke to avoid allocating while erasing */
+	TArray<AActor*> ErasedActors;
+	TMap<UHierarchicalInstancedStaticMeshComponent*, TArray<int32>> ErasedInstances;
+};
@@ -40,40 +40,90 @@
 #include "EditorViewportClient.h"
 #include "SnappingUtils.h"
 #include "Editor/UnrealEd/Private/Editor/ActorPositioning.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "ScopedTransaction.h"
 
 // Local Includes
+#include "DesignerInstanceContainer.h"
 #include "DesignerModule.h"
+#include "DesignerPalette.h"
 #include "DesignerSettings.h"
+#include "Diagnostics/DesignerAllocationCounter.h"
+#include "Diagnostics/DesignerMemory.h"
+#include "Diagnostics/DesignerPerfHUD.h"
+#include "Placement/DesignerArrayPlacement.h"
+#include "Placement/DesignerBulkEditScope.h"
+#include "Placement/DesignerPlacement.h"
+#include "Placement/DesignerPlacementTransform.h"
+#include "Placement/DesignerSettle.h"
+#include "Placement/DesignerSpawnQueue.h"
+#include "Recording/DesignerInputRecorder.h"
 
 
-FSpawnAssetTool::FSpawnAssetTool(UDesignerSettings* InDesignerSettings)
+#define LOCTEXT_NAMESPACE "SpawnAssetTool"
+
+namespace SpawnAssetTool
 {
-	DesignerSettings = InDesignerSettings;
+	/** The maximum number of items in a single array */
+	static const int32 MaxArrayItems = 65536;
 
-	UStaticMesh* StaticMesh = nullptr;
-	if (!IsRunningCommandlet())
-	{
-		UMaterialInterface* SpawnVisualizerMaterial = LoadObject<UMaterialInterface>(nullptr, TEXT("/Designer/MI_SpawnVisualizer.MI_SpawnVisualizer"), nullptr, LOAD_None, nullptr);
-		check(SpawnVisualizerMaterial != nullptr);
-		SpawnVisualizerMID = UMaterialInstanceDynamic::Create(SpawnVisualizerMaterial, GetTransientPackage());
-		check(SpawnVisualizerMID != nullptr);
-		StaticMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Designer/SM_SpawnVisualizer.SM_SpawnVisualizer"), nullptr, LOAD_None, nullptr);
-		check(StaticMesh != nullptr);
-	}
+	/** The assets of the spawn visualizer */
+	static const TCHAR* SpawnVisualizerMaterialPath = TEXT("/Designer/MI_SpawnVisualizer.MI_SpawnVisualizer");
+	static const TCHAR* SpawnVisualizerMeshPath = TEXT("/Designer/SM_SpawnVisualizer.SM_SpawnVisualizer");
+
+	/** The parameters of the spawn visualizer material, updated every mouse move while dragging */
+	static const FName CursorInputDownWorldLocationName(TEXT("CursorInputDownWorldLocation"));
+	static const FName CursorPlaneWorldLocationName(TEXT("CursorPlaneWorldLocation"));
+	static const FName ForwardAxisColorName(TEXT("ForwardAxisColor"));
+
+	/** The asset registry tags that tell whether a blueprint can be placed */
+	static const FName NativeParentClassTag(TEXT("NativeParentClass"));
+	static const FName ClassFlagsTag(TEXT("ClassFlags"));
+}
+
+FSpawnAssetTool::FSpawnAssetTool(UDesignerSettings* InDesignerSettings, FDesignerSnapIndex* InSnapIndex)
+	: SpawnVisualizerMID(nullptr)
+	, SpawnedActor(nullptr)
+	, SnapIndex(InSnapIndex)
+	, FootprintHalfSize(0.F)
+	, bReportedInvalidScale(false)
+	, ArrayMesh(nullptr)
+	, ArrayPreviewComponent(nullptr)
+	, bReportedArrayLimit(false)
+	, ArrayCounts(FIntVector::ZeroValue)
+	, ArrayStep(FVector::ZeroVector)
+	, ActivePaletteEntryIndex(INDEX_NONE)
+	, PaletteEntryRandomRotationOffset(FRotator::ZeroRotator)
+	, PaletteEntryRandomScale(FVector::OneVector)
+	, bUseSelectedAssetsOverride(false)
+{
+	DesignerSettings = InDesignerSettings;
 
+	// The mesh and material are assigned once they are loaded, see RequestSpawnVisualizerAssets
 	SpawnVisualizerComponent = NewObject<UStaticMeshComponent>(GetTransientPackage(), TEXT("SpawnVisualizerComponent"));
 	SpawnVisualizerComponent->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
 	SpawnVisualizerComponent->SetCollisionObjectType(ECC_WorldDynamic);
-	SpawnVisualizerComponent->SetStaticMesh(StaticMesh);
-	SpawnVisualizerComponent->SetMaterial(0, SpawnVisualizerMID);
 	SpawnVisualizerComponent->SetAbsolute(true, true, true);
 	SpawnVisualizerComponent->CastShadow = false;
 }
 
+FSpawnAssetTool::~FSpawnAssetTool()
+{
+	// The completion delegate points at this tool
+	if (SpawnVisualizerAssetsHandle.IsValid())
+	{
+		SpawnVisualizerAssetsHandle->CancelHandle();
+	}
+}
+
 void FSpawnAssetTool::AddReferencedObjects(FReferenceCollector& Collector)
 {
 	Collector.AddReferencedObject(DesignerSettings);
 	Collector.AddReferencedObject(SpawnVisualizerComponent);
+	Collector.AddReferencedObject(SpawnVisualizerMID);
+	Collector.AddReferencedObject(ArrayMesh);
+	Collector.AddReferencedObject(ArrayPreviewComponent);
 }
 
 FString FSpawnAssetTool::GetName() const
@@ -85,12 +135,19 @@ void FSpawnAssetTool::EnterTool()
 {
 	SpawnedActor = nullptr;
 
+	RequestSpawnVisualizerAssets();
+
 	SpawnVisualizerComponent->SetVisibility(true);
 }
 
 void FSpawnAssetTool::ExitTool()
 {
 	SpawnedActor = nullptr;
+	StrokeInvalidation.EndStroke();
+	FootprintSampler.Cancel();
+
+	// An array that is still being dragged out is discarded
+	EndArray();
 
 	if (SpawnVisualizerComponent->IsRegistered())
 	{
@@ -140,8 +197,19 @@ bool FSpawnAssetTool::LostFocus(FEditorViewportClient* ViewportClient, FViewport
 
 bool FSpawnAssetTool::CapturedMouseMove(FEditorViewportClient* InViewportClient, FViewport* InViewport, int32 InMouseX, int32 InMouseY)
 {
+	FDesignerAllocationScope AllocationScope;
+
+	FDesignerInputRecorder::Get().RecordMouseMove(InMouseX, InMouseY);
+
 	bool bHandled = false;
 
+	if (ArrayMesh != nullptr)
+	{
+		RecalculateMousePlaneIntersectionWorldLocation(InViewportClient, InViewport);
+		UpdateArray();
+		return true;
+	}
+
 	if (SpawnedActor == nullptr)
 	{
 		return bHandled;
@@ -151,6 +219,7 @@ bool FSpawnAssetTool::CapturedMouseMove(FEditorViewportClient* InViewportClient,
 		RecalculateMousePlaneIntersectionWorldLocation(InViewportClient, InViewport);
 		UpdateDesignerActorTransform();
 		UpdateSpawnVisualizerMaterialParameters();
+		RequestFootprint();
 
 		bHandled = true;
 	}
@@ -192,24 +261,21 @@ bool FSpawnAssetTool::InputKey(FEditorViewportClient* ViewportClient, FViewport*
 		{
 			GEditor->SelectNone(true, true, false);
 
-			TArray<FAssetData> ContentBrowserSelections;
-			GEditor->GetContentBrowserSelections(ContentBrowserSelections);
-
-			UClass* SelectedClass = GEditor->GetSelectedObjects()->GetTop<UClass>();
-
 			bool bPlaceable = true;
-			TArray<FAssetData> SelectedAssets;
-			AssetSelectionUtils::GetSelectedAssets(SelectedAssets);
+			GetSelectedAssets(SelectedAssets);
 			FAssetData TargetAssetData;
 
-			if (TargetAssetData.GetClass() == UClass::StaticClass())
+			ActivePaletteEntryIndex = INDEX_NONE;
+			if (UDesignerPalette* Palette = GetDesignerSettings()->Palette)
 			{
-				UClass* Class = Cast<UClass>(TargetAssetData.GetAsset());
-
-				bPlaceable = AssetSelectionUtils::IsClassPlaceable(Class);
+				FRandomStream RandomStream(FMath::Rand());
+				ActivePaletteEntryIndex = Palette->PickEntry(RandomStream);
+				if (ActivePaletteEntryIndex != INDEX_NONE)
+				{
+					TargetAssetData = FAssetData(Palette->Entries[ActivePaletteEntryIndex].Asset);
+				}
 			}
-
-			if (SelectedAssets.Num() > 0)
+			else if (SelectedAssets.Num() > 0)
 			{
 				TargetAssetData = SelectedAssets[FMath::RandRange(0, SelectedAssets.Num() - 1)];// SelectedAssets.Top();
 			}
@@ -223,13 +289,9 @@ bool FSpawnAssetTool::InputKey(FEditorViewportClient* ViewportClient, FViewport*
 			else if (TargetAssetData.GetClass() == UBlueprint::StaticClass())
 			{
 				// For blueprints, attempt to determine placeability from its tag information
-
-				const FName NativeParentClassTag = TEXT("NativeParentClass");
-				const FName ClassFlagsTag = TEXT("ClassFlags");
-
 				FString TagValue;
 
-				if (TargetAssetData.GetTagValue(NativeParentClassTag, TagValue) && !TagValue.IsEmpty())
+				if (TargetAssetData.GetTagValue(SpawnAssetTool::NativeParentClassTag, TagValue) && !TagValue.IsEmpty())
 				{
 					// If the native parent class can't be placed, neither can the blueprint.
 					UObject* Outer = nullptr;
@@ -239,7 +301,7 @@ bool FSpawnAssetTool::InputKey(FEditorViewportClient* ViewportClient, FViewport*
 					bPlaceable = AssetSelectionUtils::IsClassPlaceable(NativeParentClass);
 				}
 
-				if (bPlaceable && TargetAssetData.GetTagValue(ClassFlagsTag, TagValue) && !TagValue.IsEmpty())
+				if (bPlaceable && TargetAssetData.GetTagValue(SpawnAssetTool::ClassFlagsTag, TagValue) && !TagValue.IsEmpty())
 				{
 					// Check to see if this class is placeable from its class flags
 					const int32 NotPlaceableFlags = CLASS_NotPlaceable | CLASS_Deprecated | CLASS_Abstract;
@@ -251,7 +313,17 @@ bool FSpawnAssetTool::InputKey(FEditorViewportClient* ViewportClient, FViewport*
 
 			UObject* TargetAsset = TargetAssetData.GetAsset();
 
-			if (bPlaceable && IsValid(TargetAsset))
+			if (bPlaceable && IsValid(TargetAsset) && GetDesignerSettings()->PlacementMode == EPlacementMode::Array && TargetAsset->IsA<UStaticMesh>())
+			{
+				// Recalculate mouse down, if it fails, return.
+				if (!RecalculateSpawnTransform(ViewportClient, Viewport))
+					return bHandled;
+
+				BeginArray(ViewportClient->GetWorld(), CastChecked<UStaticMesh>(TargetAsset));
+
+				bHandled = true;
+			}
+			else if (bPlaceable && IsValid(TargetAsset))
 			{
 				UActorFactory* ActorFactory = FActorFactoryAssetProxy::GetFactoryForAssetObject(TargetAsset);
 				if (ActorFactory)
@@ -260,33 +332,53 @@ bool FSpawnAssetTool::InputKey(FEditorViewportClient* ViewportClient, FViewport*
 					if (!RecalculateSpawnTransform(ViewportClient, Viewport))
 						return bHandled;
 
-					SpawnedActor = GEditor->UseActorFactory(ActorFactory, TargetAssetData, &SpawnWorldTransform);
+					{
+						FDesignerPerfScope PerfScope(EDesignerPerfCategory::Spawn);
+						SpawnedActor = GEditor->UseActorFactory(ActorFactory, TargetAssetData, &SpawnWorldTransform);
+						FDesignerPlacement::MarkAsPlaced(SpawnedActor);
+						FDesignerPerfHUD::AddPlacements(1);
+					}
+
+					StrokeInvalidation.BeginStroke(ViewportClient->GetWorld());
+					StrokeInvalidation.AddActor(SpawnedActor);
 
 					DefaultDesignerActorExtent = SpawnedActor->CalculateComponentsBoundingBoxInLocalSpace(true).GetExtent();
+					bReportedInvalidScale = false;
 
 					// Properly reset data.
 					CursorPlaneIntersectionWorldLocation = SpawnWorldTransform.GetLocation();
 					SpawnTracePlane = FPlane();
+					FootprintSurfaceTransform = SpawnWorldTransform;
+					FootprintHalfSize = 0.F;
 
-					FTransform SpawnVisualizerTransform = SpawnWorldTransform;
-					SpawnVisualizerTransform.SetScale3D(FVector(10000));
-					SpawnVisualizerComponent->SetRelativeTransform(SpawnVisualizerTransform);
-
-					if (!SpawnVisualizerComponent->IsRegistered())
 					{
-						SpawnVisualizerComponent->RegisterComponentWithWorld(ViewportClient->GetWorld());
+						FDesignerPerfScope PerfScope(EDesignerPerfCategory::Visualizer);
+						FTransform SpawnVisualizerTransform = SpawnWorldTransform;
+						SpawnVisualizerTransform.SetScale3D(FVector(10000));
+						SpawnVisualizerComponent->SetRelativeTransform(SpawnVisualizerTransform);
+
+						if (!SpawnVisualizerComponent->IsRegistered())
+						{
+							SpawnVisualizerComponent->RegisterComponentWithWorld(ViewportClient->GetWorld());
+						}
 					}
 
 					RegenerateRandomRotationOffset();
 					RegenerateRandomScale();
 					UpdateDesignerActorTransform();
 					UpdateSpawnVisualizerMaterialParameters();
+					RequestFootprint();
 
 					bHandled = true;
 				}
 			}
 		}
 		/** Left mouse button released */
+		else if (Event == IE_Released && ArrayMesh != nullptr)
+		{
+			CommitArray(ViewportClient);
+			bHandled = true;
+		}
 		else if (Event == IE_Released)
 		{
 			if (SpawnedActor != nullptr && FMath::IsNearlyZero(SpawnedActor->GetActorScale3D().Size()))
@@ -299,6 +391,18 @@ bool FSpawnAssetTool::InputKey(FEditorViewportClient* ViewportClient, FViewport*
 				GEditor->SelectActor(SpawnedActor, true, true, true, true);
 			}
 
+			StrokeInvalidation.EndStroke();
+			FootprintSampler.Cancel();
+
+			if (SpawnedActor != nullptr && !SpawnedActor->IsPendingKillPending() && GetDesignerSettings()->bSettlePlacements)
+			{
+				FScopedTransaction Transaction(LOCTEXT("SettleTransaction", "Designer: Settle Actor"));
+				if (FDesignerSettle::Settle(ViewportClient->GetWorld(), { SpawnedActor }) == 0)
+				{
+					Transaction.Cancel();
+				}
+			}
+
 			SpawnedActor = nullptr;
 			DefaultDesignerActorExtent = FVector::ZeroVector;
 
@@ -316,7 +420,7 @@ bool FSpawnAssetTool::InputKey(FEditorViewportClient* ViewportClient, FViewport*
 
 void FSpawnAssetTool::Render(const FSceneView* View, FViewport* Viewport, FPrimitiveDrawInterface* PDI)
 {	
-	if (SpawnedActor == nullptr)
+	if (SpawnedActor == nullptr && ArrayMesh == nullptr)
 	{
 		DrawSphere(PDI, SpawnWorldTransform.GetLocation(), SpawnWorldTransform.GetRotation().Rotator(), FVector(5.F), 32, 32, GEngine->DebugEditorMaterial->GetRenderProxy(), SDPG_Foreground, false);
 	}
@@ -334,9 +438,13 @@ bool FSpawnAssetTool::EndModify()
 
 void FSpawnAssetTool::Tick(FEditorViewportClient* ViewportClient, float DeltaTime)
 {
-	if (SpawnedActor == nullptr)
+	if (SpawnedActor == nullptr && ArrayMesh == nullptr)
 		RecalculateSpawnTransform(ViewportClient, ViewportClient->Viewport);
-
+	else if (SpawnedActor != nullptr && FootprintSampler.IsPending())
+	{
+		FDesignerAllocationScope AllocationScope;
+		ApplyFootprint();
+	}
 }
 
 bool FSpawnAssetTool::BoxSelect(FBox& InBox, bool InSelect)
@@ -359,11 +467,84 @@ AActor* FSpawnAssetTool::GetControlledActor() const
 	return SpawnedActor; 
 }
 
+SIZE_T FSpawnAssetTool::GetPreviewResourceSize() const
+{
+	SIZE_T ResourceSize = ArrayTransforms.GetAllocatedSize() + DesignerActorSnapPoints.GetAllocatedSize() + SelectedAssets.GetAllocatedSize();
+	UObject* PreviewObjects[] = { SpawnVisualizerComponent, SpawnVisualizerMID, ArrayPreviewComponent };
+	for (UObject* PreviewObject : PreviewObjects)
+	{
+		if (PreviewObject != nullptr)
+		{
+			ResourceSize += PreviewObject->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		}
+	}
+	return ResourceSize;
+}
+
+void FSpawnAssetTool::SetSelectedAssetsOverride(const TArray<FAssetData>& InSelectedAssets)
+{
+	bUseSelectedAssetsOverride = true;
+	SelectedAssetsOverride = InSelectedAssets;
+}
+
+void FSpawnAssetTool::ClearSelectedAssetsOverride()
+{
+	bUseSelectedAssetsOverride = false;
+	SelectedAssetsOverride.Reset();
+}
+
+void FSpawnAssetTool::GetSelectedAssets(TArray<FAssetData>& OutSelectedAssets) const
+{
+	if (bUseSelectedAssetsOverride)
+	{
+		OutSelectedAssets = SelectedAssetsOverride;
+	}
+	else
+	{
+		AssetSelectionUtils::GetSelectedAssets(OutSelectedAssets);
+	}
+
+	FDesignerInputRecorder::Get().RecordSelectedAssets(OutSelectedAssets);
+}
+
+void FSpawnAssetTool::RequestSpawnVisualizerAssets()
+{
+	if (SpawnVisualizerAssetsHandle.IsValid() || IsRunningCommandlet())
+	{
+		return;
+	}
+
+	TArray<FSoftObjectPath> AssetsToLoad;
+	AssetsToLoad.Add(FSoftObjectPath(SpawnAssetTool::SpawnVisualizerMaterialPath));
+	AssetsToLoad.Add(FSoftObjectPath(SpawnAssetTool::SpawnVisualizerMeshPath));
+
+	SpawnVisualizerAssetsHandle = StreamableManager.RequestAsyncLoad(AssetsToLoad, FStreamableDelegate::CreateRaw(this, &FSpawnAssetTool::OnSpawnVisualizerAssetsLoaded));
+}
+
+void FSpawnAssetTool::OnSpawnVisualizerAssetsLoaded()
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Tools);
+
+	UMaterialInterface* SpawnVisualizerMaterial = Cast<UMaterialInterface>(FSoftObjectPath(SpawnAssetTool::SpawnVisualizerMaterialPath).ResolveObject());
+	UStaticMesh* StaticMesh = Cast<UStaticMesh>(FSoftObjectPath(SpawnAssetTool::SpawnVisualizerMeshPath).ResolveObject());
+	if (SpawnVisualizerMaterial == nullptr || StaticMesh == nullptr)
+	{
+		UE_LOG(LogDesigner, Warning, TEXT("Failed to load the spawn visualizer assets, the spawn visualizer is disabled."));
+		return;
+	}
+
+	SpawnVisualizerMID = UMaterialInstanceDynamic::Create(SpawnVisualizerMaterial, GetTransientPackage());
+	SpawnVisualizerComponent->SetStaticMesh(StaticMesh);
+	SpawnVisualizerComponent->SetMaterial(0, SpawnVisualizerMID);
+}
+
 bool FSpawnAssetTool::UpdateSpawnVisualizerMaterialParameters()
 {
+	FDesignerPerfScope PerfScope(EDesignerPerfCategory::Visualizer);
+
 	if (SpawnVisualizerMID)
 	{
-		SpawnVisualizerMID->SetVectorParameterValue(FName("CursorInputDownWorldLocation"), FLinearColor(SpawnWorldTransform.GetLocation()));
+		SpawnVisualizerMID->SetVectorParameterValue(SpawnAssetTool::CursorInputDownWorldLocationName, FLinearColor(SpawnWorldTransform.GetLocation()));
 
 		FVector Extent = DefaultDesignerActorExtent * SpawnedActor->GetActorScale3D();
 		EAxisType PositiveAxis = DesignerSettings->GetPositiveAxisToAlignWithCursor();
@@ -380,7 +561,7 @@ bool FSpawnAssetTool::UpdateSpawnVisualizerMaterialParameters()
 		}
 		ActorRadius = FMath::Abs(ActorRadius);
 
-		SpawnVisualizerMID->SetVectorParameterValue(FName("CursorPlaneWorldLocation"), FLinearColor(CursorPlaneIntersectionWorldLocation.X, CursorPlaneIntersectionWorldLocation.Y, CursorPlaneIntersectionWorldLocation.Z, ActorRadius));
+		SpawnVisualizerMID->SetVectorParameterValue(SpawnAssetTool::CursorPlaneWorldLocationName, FLinearColor(CursorPlaneIntersectionWorldLocation.X, CursorPlaneIntersectionWorldLocation.Y, CursorPlaneIntersectionWorldLocation.Z, ActorRadius));
 
 		FLinearColor ForwardVectorColor = FLinearColor::Red;
 		if (PositiveAxis == EAxisType::Up)
@@ -393,7 +574,7 @@ bool FSpawnAssetTool::UpdateSpawnVisualizerMaterialParameters()
 		}
 
 
-		SpawnVisualizerMID->SetVectorParameterValue(FName("ForwardAxisColor"), ForwardVectorColor);
+		SpawnVisualizerMID->SetVectorParameterValue(SpawnAssetTool::ForwardAxisColorName, ForwardVectorColor);
 
 
 		return true;
@@ -406,71 +587,16 @@ bool FSpawnAssetTool::RecalculateSpawnTransform(FEditorViewportClient* ViewportC
 {
 	FTransform NewSpawnTransform = FTransform(FQuat::Identity, FVector::ZeroVector, FVector::OneVector);
 
-	FSceneViewFamilyContext ViewFamily(FSceneViewFamily::ConstructionValues(
-		Viewport,
-		ViewportClient->GetScene(),
-		ViewportClient->EngineShowFlags)
-		.SetRealtimeUpdate(ViewportClient->IsRealtime()));
-	// SceneView is deleted with the ViewFamily
-	FSceneView* SceneView = ViewportClient->CalcSceneView(&ViewFamily);
-
-	FViewportCursorLocation MouseViewportRay(SceneView, ViewportClient, Viewport->GetMouseX(), Viewport->GetMouseY());
-
-	FVector TraceStartLocation = MouseViewportRay.GetOrigin();
-	FVector TraceDirection = MouseViewportRay.GetDirection();
-	FVector TraceEndLocation = TraceStartLocation + TraceDirection * WORLD_MAX;
-	if (ViewportClient->IsOrtho())
-	{
-		TraceStartLocation += -WORLD_MAX * TraceDirection;
-	}
-
-	FActorPositionTraceResult ActorPositionTraceResult = FActorPositioning::TraceWorldForPositionWithDefault(MouseViewportRay, *SceneView);
-
-	if (ActorPositionTraceResult.HitActor == nullptr)
+	FVector HitLocation;
+	FVector HitSurfaceNormal;
+	if (!TraceCursor(ViewportClient, Viewport, HitLocation, HitSurfaceNormal))
 	{
 		return false;
 	}
 
-	NewSpawnTransform.SetLocation(ActorPositionTraceResult.Location);
-
-	FVector ZAxis = ActorPositionTraceResult.SurfaceNormal;
-	if (GetDesignerSettings()->AxisToAlignWithNormal == EAxisType::None)
-	{
-		ZAxis = FVector::UpVector;
-	}
-	FVector XAxis = FVector::ForwardVector;
-
-	FRotator CursorWorldRotation = FRotationMatrix::MakeFromZX(ZAxis, XAxis).Rotator();
-
-	FRotator SpawnRotationSnapped = CursorWorldRotation;
-	FSnappingUtils::SnapRotatorToGrid(SpawnRotationSnapped);
+	NewSpawnTransform.SetLocation(HitLocation);
 
-	if (GetDesignerSettings()->bSnapToGridRotationX)
-	{
-		CursorWorldRotation.Roll = SpawnRotationSnapped.Roll;
-	}
-	else
-	{
-		CursorWorldRotation.Roll = CursorWorldRotation.Roll;
-	}
-
-	if (GetDesignerSettings()->bSnapToGridRotationY)
-	{
-		CursorWorldRotation.Pitch = SpawnRotationSnapped.Pitch;
-	}
-	else
-	{
-		CursorWorldRotation.Pitch = CursorWorldRotation.Pitch;
-	}
-
-	if (GetDesignerSettings()->bSnapToGridRotationZ)
-	{
-		CursorWorldRotation.Yaw = SpawnRotationSnapped.Yaw;
-	}
-	else
-	{
-		CursorWorldRotation.Yaw = CursorWorldRotation.Yaw;
-	}
+	FRotator CursorWorldRotation = FDesignerPlacementTransform::MakeSurfaceRotation(GetDesignerSettings(), FDesignerRotationGrid::GetEditorGrid(), HitSurfaceNormal);
 
 	NewSpawnTransform.SetRotation(CursorWorldRotation.Quaternion());
 
@@ -481,19 +607,10 @@ bool FSpawnAssetTool::RecalculateSpawnTransform(FEditorViewportClient* ViewportC
 
 void FSpawnAssetTool::RecalculateMousePlaneIntersectionWorldLocation(FEditorViewportClient* ViewportClient, FViewport* Viewport)
 {
-	FSceneViewFamilyContext ViewFamily(FSceneViewFamily::ConstructionValues(
-		Viewport,
-		ViewportClient->GetScene(),
-		ViewportClient->EngineShowFlags)
-		.SetRealtimeUpdate(ViewportClient->IsRealtime()));
-	// SceneView is deleted with the ViewFamily
-	FSceneView* SceneView = ViewportClient->CalcSceneView(&ViewFamily);
-	FViewportCursorLocation MouseViewportRay(SceneView, ViewportClient, Viewport->GetMouseX(), Viewport->GetMouseY());
+	FVector TraceStartLocation;
+	FVector TraceDirection;
+	DeprojectCursor(ViewportClient, Viewport, TraceStartLocation, TraceDirection);
 
-	FViewportCursorLocation ViewportCenterRay(SceneView, ViewportClient, Viewport->GetSizeXY().X * 0.5F, Viewport->GetSizeXY().Y * 0.5F);
-
-	FVector TraceStartLocation = MouseViewportRay.GetOrigin();
-	FVector TraceDirection = MouseViewportRay.GetDirection();
 	FVector TraceEndLocation = TraceStartLocation + TraceDirection * WORLD_MAX;
 
 	SpawnTracePlane = FPlane(SpawnWorldTransform.GetLocation(), SpawnWorldTransform.GetRotation().GetUpVector());
@@ -502,6 +619,8 @@ void FSpawnAssetTool::RecalculateMousePlaneIntersectionWorldLocation(FEditorView
 
 void FSpawnAssetTool::UpdateDesignerActorTransform()
 {
+	FDesignerPerfScope PerfScope(EDesignerPerfCategory::Transform);
+
 	FTransform NewDesignerActorTransform = SpawnWorldTransform;
 
 	FVector CursorDirection(0.F, 0.F, 0.F);
@@ -539,7 +658,13 @@ void FSpawnAssetTool::UpdateDesignerActorTransform()
 	if (NewScale.ContainsNaN())
 	{
 		NewScale = FVector::OneVector;
-		UE_LOG(LogDesigner, Warning, TEXT("New scale contained NaN, so it is set to one. DefaultDesignerActorExtent = %s."), *DefaultDesignerActorExtent.ToString());
+
+		// Once per spawn, the cursor keeps producing the same scale while it is dragged
+		if (!bReportedInvalidScale)
+		{
+			UE_LOG(LogDesigner, Warning, TEXT("New scale contained NaN, so it is set to one. DefaultDesignerActorExtent = %s."), *DefaultDesignerActorExtent.ToString());
+			bReportedInvalidScale = true;
+		}
 	}
 
 	NewDesignerActorTransform.SetScale3D(NewScale);
@@ -548,9 +673,93 @@ void FSpawnAssetTool::UpdateDesignerActorTransform()
 	SpawnedActor->SetActorTransform(NewDesignerActorTransform);
 	SpawnedActor->AddActorWorldOffset(GetDesignerSettings()->WorldLocationOffset);
 	SpawnedActor->AddActorLocalOffset(GetDesignerSettings()->RelativeLocationOffset);
+
+	SnapDesignerActor();
+}
+
+void FSpawnAssetTool::RequestFootprint()
+{
+	if (!GetDesignerSettings()->bAlignToFootprint)
+	{
+		return;
+	}
+
+	// The footprint is a square around the largest extent, so rotating the asset towards the cursor does not need new traces
+	const float HalfSize = (DefaultDesignerActorExtent * SpawnedActor->GetActorScale3D().GetAbs()).GetMax();
+	if (FootprintHalfSize > 0.F && FMath::IsNearlyEqual(HalfSize, FootprintHalfSize, FootprintHalfSize * 0.05F))
+	{
+		return;
+	}
+
+	FootprintHalfSize = FMath::Max(HalfSize, KINDA_SMALL_NUMBER);
+	FootprintSampler.Request(SpawnedActor->GetWorld(), FootprintSurfaceTransform, HalfSize, GetDesignerSettings()->FootprintRaysPerAxis, SpawnedActor);
+}
+
+void FSpawnAssetTool::ApplyFootprint()
+{
+	FDesignerFootprint Footprint;
+	if (!FootprintSampler.Poll(Footprint))
+	{
+		return;
+	}
+
+	SpawnWorldTransform.SetLocation(Footprint.Location);
+	SpawnWorldTransform.SetRotation(FDesignerPlacementTransform::MakeSurfaceRotation(GetDesignerSettings(), FDesignerRotationGrid::GetEditorGrid(), Footprint.Normal).Quaternion());
+
+	UpdateDesignerActorTransform();
+	UpdateSpawnVisualizerMaterialParameters();
+}
+
+void FSpawnAssetTool::SnapDesignerActor()
+{
+	if (SnapIndex == nullptr || !GetDesignerSettings()->bSnapToPlacedContent)
+	{
+		return;
+	}
+
+	// The index is built on first use and dropped by the ed mode whenever it can no longer be updated incrementally
+	UWorld* World = SpawnedActor->GetWorld();
+	if (SnapIndex->GetWorld() != World)
+	{
+		SnapIndex->Build(World);
+	}
+
+	DesignerActorSnapPoints.Reset();
+	FDesignerSnapIndex::GatherSnapPoints(SpawnedActor, DesignerActorSnapPoints);
+
+	FVector SnapOffset;
+	if (SnapIndex->FindSnap(DesignerActorSnapPoints, GetDesignerSettings()->SnapDistance, SpawnedActor, SnapOffset))
+	{
+		SpawnedActor->AddActorWorldOffset(SnapOffset);
+	}
+}
+
+const FDesignerPaletteEntry* FSpawnAssetTool::GetActivePaletteEntry() const
+{
+	const UDesignerPalette* Palette = GetDesignerSettings()->Palette;
+	if (Palette == nullptr || !Palette->Entries.IsValidIndex(ActivePaletteEntryIndex))
+	{
+		return nullptr;
+	}
+
+	return &Palette->Entries[ActivePaletteEntryIndex];
 }
+
 void FSpawnAssetTool::RegenerateRandomRotationOffset()
 {
+	// The palette is a shared asset, the values drawn from its ranges are kept in the tool
+	const FDesignerPaletteEntry* PaletteEntry = GetActivePaletteEntry();
+	if (PaletteEntry != nullptr && PaletteEntry->bOverrideRandomRotation)
+	{
+		FRandomStream RandomStream(FMath::Rand());
+		PaletteEntryRandomRotationOffset = FRotator( // Pitch, Yaw, Roll = Y, Z, X.
+			PaletteEntry->RandomRotationY.GetRandomValue(RandomStream),
+			PaletteEntry->RandomRotationZ.GetRandomValue(RandomStream),
+			PaletteEntry->RandomRotationX.GetRandomValue(RandomStream)
+		);
+		return;
+	}
+
 	GetDesignerSettings()->RandomRotationX.RegenerateRandomValue();
 	GetDesignerSettings()->RandomRotationY.RegenerateRandomValue();
 	GetDesignerSettings()->RandomRotationZ.RegenerateRandomValue();
@@ -558,6 +767,12 @@ void FSpawnAssetTool::RegenerateRandomRotationOffset()
 
 FRotator FSpawnAssetTool::GetRandomRotationOffset() const
 {
+	const FDesignerPaletteEntry* PaletteEntry = GetActivePaletteEntry();
+	if (PaletteEntry != nullptr && PaletteEntry->bOverrideRandomRotation)
+	{
+		return PaletteEntryRandomRotationOffset;
+	}
+
 	return FRotator( // Pitch, Yaw, Roll = Y, Z, X.
 		GetDesignerSettings()->RandomRotationY.GetCurrentRandomValue(),
 		GetDesignerSettings()->RandomRotationZ.GetCurrentRandomValue(),
@@ -567,6 +782,18 @@ FRotator FSpawnAssetTool::GetRandomRotationOffset() const
 
 void FSpawnAssetTool::RegenerateRandomScale()
 {
+	const FDesignerPaletteEntry* PaletteEntry = GetActivePaletteEntry();
+	if (PaletteEntry != nullptr && PaletteEntry->bOverrideRandomScale)
+	{
+		FRandomStream RandomStream(FMath::Rand());
+		PaletteEntryRandomScale = FVector(
+			PaletteEntry->RandomScaleX.GetRandomValue(RandomStream),
+			PaletteEntry->RandomScaleY.GetRandomValue(RandomStream),
+			PaletteEntry->RandomScaleZ.GetRandomValue(RandomStream)
+		);
+		return;
+	}
+
 	GetDesignerSettings()->RandomScaleX.RegenerateRandomValue();
 	GetDesignerSettings()->RandomScaleY.RegenerateRandomValue();
 	GetDesignerSettings()->RandomScaleZ.RegenerateRandomValue();
@@ -574,6 +801,12 @@ void FSpawnAssetTool::RegenerateRandomScale()
 
 FVector FSpawnAssetTool::GetRandomScale() const
 {
+	const FDesignerPaletteEntry* PaletteEntry = GetActivePaletteEntry();
+	if (PaletteEntry != nullptr && PaletteEntry->bOverrideRandomScale)
+	{
+		return PaletteEntryRandomScale;
+	}
+
 	return FVector(
 		GetDesignerSettings()->RandomScaleX.GetCurrentRandomValue(),
 		GetDesignerSettings()->RandomScaleY.GetCurrentRandomValue(),
@@ -598,108 +831,210 @@ FRotator FSpawnAssetTool::GetDesignerActorRotation()
 	}
 	FVector UpVector = SpawnWorldTransform.GetRotation().GetUpVector();
 
-	// if they're almost same, we need to find arbitrary vector
-	if (FMath::IsNearlyEqual(FMath::Abs(ForwardVector | UpVector), 1.f))
-	{
-		// make sure we don't ever pick the same as NewX
-		if (FMath::Abs(ForwardVector.Z) < (1.f - KINDA_SMALL_NUMBER))
-		{
-			UpVector = FVector(0, 0, 1.f);
-		}
-		else
-		{
-			UpVector = FVector(1.f, 0, 0);
-		}
-	}
+	bool bUsedFallbackRotation = false;
+	FRotator DesignerActorRotation = FDesignerPlacementTransform::MakeAlignedRotation(GetDesignerSettings(), ForwardVector, UpVector, &bUsedFallbackRotation);
+	FDesignerPlacementTransform::WarnFallbackRotations(bUsedFallbackRotation ? 1 : 0);
 
-	FVector RightVector = (UpVector ^ ForwardVector).GetSafeNormal();
-	UpVector = ForwardVector ^ RightVector;
+	// Apply the random rotation offset and grid snapping set by the user
+	DesignerActorRotation = FDesignerPlacementTransform::ApplyRotationSettings(GetDesignerSettings(), FDesignerRotationGrid::GetEditorGrid(), DesignerActorRotation, GetRandomRotationOffset());
 
-	FVector SwizzledForwardVector = FVector::ZeroVector;
-	FVector SwizzledRightVector = FVector::ZeroVector;
-	FVector SwizzledUpVector = FVector::ZeroVector;
+	return DesignerActorRotation;
+}
 
-	switch (GetDesignerSettings()->AxisToAlignWithNormal)
+void FSpawnAssetTool::BeginArray(UWorld* World, UStaticMesh* StaticMesh)
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Tools);
+
+	ArrayMesh = StaticMesh;
+	ArrayCounts = FIntVector::ZeroValue;
+	ArrayStep = FVector::ZeroVector;
+	bReportedArrayLimit = false;
+
+	// Properly reset data.
+	CursorPlaneIntersectionWorldLocation = SpawnWorldTransform.GetLocation();
+	SpawnTracePlane = FPlane();
+
+	if (ArrayPreviewComponent == nullptr)
 	{
-	case EAxisType::Forward:
-		SwizzledForwardVector = UpVector;
-		break;
-	case EAxisType::Backward:
-		SwizzledForwardVector = -UpVector;
-		break;
-	case EAxisType::Right:
-		SwizzledRightVector = UpVector;
-		break;
-	case EAxisType::Left:
-		SwizzledRightVector = -UpVector;
-		break;
-	case EAxisType::Down:
-		SwizzledUpVector = -UpVector;
-		break;
-	default: // Axis type none or up
-		SwizzledUpVector = UpVector;
-		break;
+		ArrayPreviewComponent = NewObject<UHierarchicalInstancedStaticMeshComponent>(GetTransientPackage(), TEXT("ArrayPreviewComponent"));
+		ArrayPreviewComponent->bAutoRebuildTreeOnInstanceChanges = false;
+		ArrayPreviewComponent->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+		ArrayPreviewComponent->SetAbsolute(true, true, true);
+		ArrayPreviewComponent->CastShadow = false;
 	}
 
-	switch (GetDesignerSettings()->AxisToAlignWithCursor)
+	ArrayPreviewComponent->SetStaticMesh(StaticMesh);
+
+	if (!ArrayPreviewComponent->IsRegistered())
 	{
-	case EAxisType::Backward:
-		SwizzledForwardVector = -ForwardVector;
-		break;
-	case EAxisType::Right:
-		SwizzledRightVector = ForwardVector;
-		break;
-	case EAxisType::Left:
-		SwizzledRightVector = -ForwardVector;
-		break;
-	case EAxisType::Up:
-		SwizzledUpVector = ForwardVector;
-		break;
-	case EAxisType::Down:
-		SwizzledUpVector = -ForwardVector;
-		break;
-	default: // Axis type none or forward
-		SwizzledForwardVector = ForwardVector;
-		break;
+		ArrayPreviewComponent->RegisterComponentWithWorld(World);
 	}
 
-	bool bIsForwardVectorSet = !SwizzledForwardVector.IsNearlyZero();
-	bool bIsRightVectorSet = !SwizzledRightVector.IsNearlyZero();
-	bool bIsUpVectorSet = !SwizzledUpVector.IsNearlyZero();
+	UpdateArray();
+}
+
+void FSpawnAssetTool::UpdateArray()
+{
+	DESIGNER_LLM_SCOPE(EDesignerLLMTag::Tools);
+	FDesignerPerfScope PerfScope(EDesignerPerfCategory::Transform);
+
+	const UDesignerSettings* Settings = GetDesignerSettings();
+
+	const FVector MeshSize = ArrayMesh->GetBoundingBox().GetSize();
+	const FVector Spacing(
+		FMath::Max(Settings->ArraySpacing.X > 0.F ? Settings->ArraySpacing.X : MeshSize.X, 1.F),
+		FMath::Max(Settings->ArraySpacing.Y > 0.F ? Settings->ArraySpacing.Y : MeshSize.Y, 1.F),
+		FMath::Max(Settings->ArraySpacing.Z > 0.F ? Settings->ArraySpacing.Z : MeshSize.Z, 1.F));
+
+	// The lattice follows the surface frame of the spawn point and grows towards the cursor
+	const FQuat SpawnRotation = SpawnWorldTransform.GetRotation();
+	const FVector LocalCursor = SpawnRotation.UnrotateVector(CursorPlaneIntersectionWorldLocation - SpawnWorldTransform.GetLocation());
 
-	FRotator DesignerActorRotation;
+	FIntVector Counts(
+		FMath::FloorToInt(FMath::Abs(LocalCursor.X) / Spacing.X) + 1,
+		FMath::FloorToInt(FMath::Abs(LocalCursor.Y) / Spacing.Y) + 1,
+		FMath::Clamp(Settings->ArrayLayers, 1, SpawnAssetTool::MaxArrayItems));
 
-	if (!bIsForwardVectorSet && bIsRightVectorSet && bIsUpVectorSet)
+	// Dragging past the limit shrinks both sides by the same factor, so the array keeps following the cursor
+	const int32 MaxLayerItems = SpawnAssetTool::MaxArrayItems / Counts.Z;
+	if ((int64)Counts.X * Counts.Y > MaxLayerItems)
 	{
-		DesignerActorRotation = FRotationMatrix::MakeFromZY(SwizzledUpVector, SwizzledRightVector).Rotator();
+		const float Shrink = FMath::Sqrt((float)MaxLayerItems / ((float)Counts.X * Counts.Y));
+		Counts.X = FMath::Clamp(FMath::FloorToInt(Counts.X * Shrink), 1, MaxLayerItems);
+		Counts.Y = FMath::Clamp(FMath::FloorToInt(Counts.Y * Shrink), 1, MaxLayerItems / Counts.X);
+
+		if (!bReportedArrayLimit)
+		{
+			UE_LOG(LogDesigner, Warning, TEXT("Arrays are limited to %d items, the array is clamped to %d by %d by %d."), SpawnAssetTool::MaxArrayItems, Counts.X, Counts.Y, Counts.Z);
+			bReportedArrayLimit = true;
+		}
 	}
-	else if (!bIsRightVectorSet && bIsForwardVectorSet && bIsUpVectorSet)
+
+	const FVector Step(
+		LocalCursor.X < 0.F ? -Spacing.X : Spacing.X,
+		LocalCursor.Y < 0.F ? -Spacing.Y : Spacing.Y,
+		Spacing.Z);
+
+	if (Counts == ArrayCounts && Step == ArrayStep)
 	{
-		DesignerActorRotation = FRotationMatrix::MakeFromZX(SwizzledUpVector, SwizzledForwardVector).Rotator();
+		return;
 	}
-	else if (!bIsUpVectorSet && bIsForwardVectorSet && bIsRightVectorSet)
+
+	ArrayCounts = Counts;
+	ArrayStep = Step;
+
+	// Items are aligned like a single placement, but without the random offsets so the pattern stays regular
+	bool bUsedFallbackRotation = false;
+	FQuat ItemRotation = FDesignerPlacementTransform::ApplyRotationSettings(Settings, FDesignerRotationGrid::GetEditorGrid(),
+		FDesignerPlacementTransform::MakeAlignedRotation(Settings, SpawnRotation.GetForwardVector(), SpawnRotation.GetUpVector(), &bUsedFallbackRotation),
+		FRotator::ZeroRotator).Quaternion();
+	FDesignerPlacementTransform::WarnFallbackRotations(bUsedFallbackRotation ? 1 : 0);
+
+	FVector Origin = SpawnWorldTransform.GetLocation() + Settings->WorldLocationOffset + ItemRotation.RotateVector(Settings->RelativeLocationOffset);
+
+	FDesignerArrayPlacement::GenerateLattice(Origin, SpawnRotation, ArrayCounts, ArrayStep, ItemRotation, ArrayTransforms);
+
+	// The instance data is written in one pass and the tree built once, instead of one instance at a time.
+	// The preview sits at the origin, so the world transforms are its component space transforms
+	TArray<FInstancedStaticMeshInstanceData>& InstanceData = ArrayPreviewComponent->PerInstanceSMData;
+	InstanceData.SetNumUninitialized(ArrayTransforms.Num(), /*bAllowShrinking*/false);
+	for (int32 ItemIndex = 0; ItemIndex < ArrayTransforms.Num(); ++ItemIndex)
 	{
-		DesignerActorRotation = FRotationMatrix::MakeFromXY(SwizzledForwardVector, SwizzledRightVector).Rotator();
+		InstanceData[ItemIndex].Transform = ArrayTransforms[ItemIndex].ToMatrixWithScale();
 	}
-	else
+#if WITH_EDITOR
+	ArrayPreviewComponent->SelectedInstances.Init(false, ArrayTransforms.Num());
+#endif
+	ArrayPreviewComponent->BuildTreeIfOutdated(/*Async*/true, /*ForceUpdate*/true);
+	ArrayPreviewComponent->MarkRenderStateDirty();
+}
+
+void FSpawnAssetTool::CommitArray(FEditorViewportClient* ViewportClient)
+{
+	FDesignerPerfScope PerfScope(EDesignerPerfCategory::Spawn);
+
+	UWorld* World = ViewportClient->GetWorld();
+	ULevel* Level = World->GetCurrentLevel();
+
+	FDesignerPlacementBatch Batch;
+	Batch.Assets.Add(FSoftObjectPath(ArrayMesh));
+	Batch.Instances.SetNumUninitialized(ArrayTransforms.Num());
+	for (int32 ItemIndex = 0; ItemIndex < ArrayTransforms.Num(); ++ItemIndex)
 	{
-		// Default rotation of everything else fails
-		DesignerActorRotation = FMatrix(ForwardVector, RightVector, UpVector, FVector::ZeroVector).Rotator();
-		UE_LOG(LogDesigner, Warning, TEXT("Falling back to default rotation."));
+		FDesignerPlacementInstance& Instance = Batch.Instances[ItemIndex];
+		Instance.Transform = ArrayTransforms[ItemIndex];
+		Instance.AssetIndex = 0;
+		Instance.Seed = 0;
 	}
 
-	// Apply the generated random rotation offset if the user has set the bApplyRandomRotation setting
-	if (GetDesignerSettings()->bApplyRandomRotation)
+	if (!GetDesignerSettings()->bCommitArrayAsInstances)
 	{
-		DesignerActorRotation = FRotator(DesignerActorRotation.Quaternion() * GetRandomRotationOffset().Quaternion());
+		// Large arrays take many frames to spawn, the actors are settled and selected once all of them are in
+		const bool bSettlePlacements = GetDesignerSettings()->bSettlePlacements;
+		TWeakObjectPtr<UWorld> WeakWorld(World);
+
+		FDesignerSpawnJobParams Params;
+		Params.Title = LOCTEXT("PlaceArrayTransaction", "Designer: Place Array");
+		Params.Order = EDesignerSpawnOrder::NearestFirst;
+		Params.Origin = ViewportClient->GetViewLocation();
+		Params.OnFinished = [WeakWorld, bSettlePlacements](const TArray<AActor*>& SpawnedActors, bool bCancelled)
+		{
+			UWorld* SpawnWorld = WeakWorld.Get();
+			if (SpawnWorld == nullptr || SpawnedActors.Num() == 0)
+			{
+				return;
+			}
+
+			if (bSettlePlacements)
+			{
+				FDesignerSettle::Settle(SpawnWorld, SpawnedActors);
+			}
+
+			FDesignerBulkEditScope::SelectNone();
+			for (AActor* SpawnedActor : SpawnedActors)
+			{
+				FDesignerBulkEditScope::SelectActor(SpawnedActor);
+			}
+		};
+
+		FDesignerSpawnQueue::Get().Enqueue(MoveTemp(Batch), Level, Params);
+
+		EndArray();
+		return;
 	}
 
-	// Snap the axes to the grid if the user has set bSnapToGridRotation
-	FRotator SpawnRotationSnapped = DesignerActorRotation;
-	FSnappingUtils::SnapRotatorToGrid(SpawnRotationSnapped);
-	DesignerActorRotation.Roll = GetDesignerSettings()->bSnapToGridRotationX ? SpawnRotationSnapped.Roll : DesignerActorRotation.Roll;
-	DesignerActorRotation.Pitch = GetDesignerSettings()->bSnapToGridRotationY ? SpawnRotationSnapped.Pitch : DesignerActorRotation.Pitch;
-	DesignerActorRotation.Yaw = GetDesignerSettings()->bSnapToGridRotationZ ? SpawnRotationSnapped.Yaw : DesignerActorRotation.Yaw;
+	// Instances are cheap to add, they are committed right away
+	FScopedTransaction Transaction(LOCTEXT("PlaceArrayTransaction", "Designer: Place Array"));
+	FDesignerBulkEditScope BulkEditScope;
 
-	return DesignerActorRotation;
-}
\ No newline at end of file
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.OverrideLevel = Level;
+	ADesignerInstanceContainer* Container = World->SpawnActor<ADesignerInstanceContainer>(SpawnParameters);
+	Container->SetActorLabel(FString::Printf(TEXT("DesignerArray_%s"), *ArrayMesh->GetName()));
+
+	FDesignerPlacement::CommitBatch(Batch, Level, Container);
+
+	FDesignerBulkEditScope::SelectNone();
+	FDesignerBulkEditScope::SelectActor(Container);
+
+	EndArray();
+}
+
+void FSpawnAssetTool::EndArray()
+{
+	ArrayMesh = nullptr;
+	ArrayCounts = FIntVector::ZeroValue;
+	ArrayStep = FVector::ZeroVector;
+	ArrayTransforms.Reset();
+
+	if (ArrayPreviewComponent != nullptr)
+	{
+		ArrayPreviewComponent->ClearInstances();
+		if (ArrayPreviewComponent->IsRegistered())
+		{
+			ArrayPreviewComponent->UnregisterComponent();
+		}
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -27,15 +27,24 @@
 // Engine Includes
 #include "CoreMinimal.h"
 #include "UObject/GCObject.h"
+#include "AssetData.h"
+#include "Engine/StreamableManager.h"
 
 // Local Includes
+#include "Placement/DesignerFootprint.h"
+#include "Placement/DesignerSnapIndex.h"
+#include "Placement/DesignerStrokeInvalidation.h"
 #include "Tools/DesignerTool.h"
 
 // Forward Declares
 class AActor;
 class UDesignerSettings;
+class UHierarchicalInstancedStaticMeshComponent;
 class UMaterialInstanceDynamic;
+class UStaticMesh;
 class UStaticMeshComponent;
+class UWorld;
+struct FDesignerPaletteEntry;
 
 /**
  * Tool for spawning assets from the content browser.
@@ -44,7 +53,8 @@ class FSpawnAssetTool : public FDesignerTool
 {
 
 public:
-	FSpawnAssetTool(UDesignerSettings* InDesignerSettings);
+	FSpawnAssetTool(UDesignerSettings* InDesignerSettings, FDesignerSnapIndex* InSnapIndex);
+	virtual ~FSpawnAssetTool();
 
 	//~ Begin FDesignerTool interface
 	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
@@ -100,7 +110,40 @@ public:
 
 	AActor* GetControlledActor() const;
 
+	/** Is an asset or an array being dragged out? */
+	bool IsDragging() const
+	{
+		return SpawnedActor != nullptr || ArrayMesh != nullptr;
+	}
+
+	/** The number of placements waiting to be spawned, the items of the array being dragged out */
+	int32 GetNumQueuedSpawns() const
+	{
+		return ArrayMesh != nullptr ? ArrayTransforms.Num() : 0;
+	}
+
+	/** The memory held by the spawn visualizer and the array preview */
+	SIZE_T GetPreviewResourceSize() const;
+
+	/** Makes the tool pick from these assets instead of the content browser selection, used when replaying recorded input */
+	void SetSelectedAssetsOverride(const TArray<FAssetData>& InSelectedAssets);
+
+	/** Makes the tool pick from the content browser selection again */
+	void ClearSelectedAssetsOverride();
+
 private:
+	/** The assets the tool picks from when spawning */
+	void GetSelectedAssets(TArray<FAssetData>& OutSelectedAssets) const;
+
+	/** The palette entry of the spawned asset, nullptr if it was not picked from a palette */
+	const FDesignerPaletteEntry* GetActivePaletteEntry() const;
+
+	/** Starts loading the spawn visualizer assets in the background, the first time the tool is used */
+	void RequestSpawnVisualizerAssets();
+
+	/** Assigns the spawn visualizer assets to the spawn visualizer component once they are loaded */
+	void OnSpawnVisualizerAssetsLoaded();
+
 	/** Update the material parameters for the spawn visualizer component. Returns true if it was successful */
 	bool UpdateSpawnVisualizerMaterialParameters();
 
@@ -113,6 +156,15 @@ private:
 	/** Updates the designer actor transform so it matches with all the changes made to DesignerActorTransformExcludingOffset */
 	void UpdateDesignerActorTransform();
 
+	/** Starts tracing the footprint of the designer actor when footprint alignment is enabled and its size changed */
+	void RequestFootprint();
+
+	/** Aligns the spawn transform to the footprint once its traces are in */
+	void ApplyFootprint();
+
+	/** Moves the designer actor onto the closest snap point of the placed actors around it, if snapping is enabled */
+	void SnapDesignerActor();
+
 	/** Generate new random rotation offset */
 	void RegenerateRandomRotationOffset();
 
@@ -128,13 +180,31 @@ private:
 	/** Get the designer actor rotation with all settings applied to it */
 	FRotator GetDesignerActorRotation();
 
+	/** Starts dragging out an array of the static mesh from the spawn transform */
+	void BeginArray(UWorld* World, UStaticMesh* StaticMesh);
+
+	/** Regenerates the array lattice and its preview when the cursor changed the item counts */
+	void UpdateArray();
+
+	/** Places the items of the array. Actors are spawned by the spawn queue, nearest to the camera first, instances in a single transaction */
+	void CommitArray(FEditorViewportClient* ViewportClient);
+
+	/** Stops dragging the array and hides its preview */
+	void EndArray();
+
 private:
 	/** The static mesh of the Spawn visualizer component */
 	UStaticMeshComponent* SpawnVisualizerComponent;
 
-	/** The material instance dynamic of the Spawn visualizer component */
+	/** The material instance dynamic of the Spawn visualizer component, nullptr until the visualizer assets are loaded */
 	UMaterialInstanceDynamic* SpawnVisualizerMID;
 
+	/** Loads the spawn visualizer assets */
+	FStreamableManager StreamableManager;
+
+	/** The pending or completed load of the spawn visualizer assets, invalid until the tool is first entered */
+	TSharedPtr<FStreamableHandle> SpawnVisualizerAssetsHandle;
+
 	/** The plane we trace against when transforming the placed actor */
 	FPlane SpawnTracePlane;
 
@@ -150,6 +220,61 @@ private:
 	/** The actor currently controlled by the designer editor mode */
 	AActor* SpawnedActor;
 
+	/** The snap points of the actors in the world, owned by the designer ed mode */
+	FDesignerSnapIndex* SnapIndex;
+
+	/** The snap points of the designer actor, kept to avoid allocating while dragging */
+	TArray<FDesignerSnapPoint> DesignerActorSnapPoints;
+
+	/** Traces the surface under the designer actor without blocking the preview */
+	FDesignerFootprintSampler FootprintSampler;
+
+	/** The surface frame under the cursor on mouse click down, the footprint is always traced from it */
+	FTransform FootprintSurfaceTransform;
+
+	/** The half size of the last requested footprint, zero if none was requested yet */
+	float FootprintHalfSize;
+
+	/** Holds back the navigation and HLOD updates of the spawned actor while it is dragged */
+	FDesignerStrokeInvalidation StrokeInvalidation;
+
 	/** The local box extent of the selected designer actor in cm when scale is uniform 1 */
 	FVector DefaultDesignerActorExtent;
+
+	/** Has the invalid scale of the designer actor been reported since it was spawned? */
+	bool bReportedInvalidScale;
+
+	/** The static mesh of the array being dragged out, nullptr when no array is being dragged */
+	UStaticMesh* ArrayMesh;
+
+	/** Instanced preview of the array being dragged out, its tree is built once per change like the instance containers do */
+	UHierarchicalInstancedStaticMeshComponent* ArrayPreviewComponent;
+
+	/** Has the array been reported as clamped to the maximum number of items since it was started? */
+	bool bReportedArrayLimit;
+
+	/** The number of array items along the forward, right and up axis of the spawn transform */
+	FIntVector ArrayCounts;
+
+	/** The offset between array items along the forward, right and up axis of the spawn transform */
+	FVector ArrayStep;
+
+	/** The world transforms of the array items */
+	TArray<FTransform> ArrayTransforms;
+
+	/** The index of the palette entry of the spawned asset, INDEX_NONE if it was not picked from a palette */
+	int32 ActivePaletteEntryIndex;
+
+	/** The random rotation offset drawn from the ranges of the active palette entry, used when it overrides the settings */
+	FRotator PaletteEntryRandomRotationOffset;
+
+	/** The random scale drawn from the ranges of the active palette entry, used when it overrides the settings */
+	FVector PaletteEntryRandomScale;
+
+	/** Replaces the content browser selection when set */
+	bool bUseSelectedAssetsOverride;
+	TArray<FAssetData> SelectedAssetsOverride;
+
+	/** The assets picked from on the last click, kept to reuse its allocation */
+	TArray<FAssetData> SelectedAssets;
 };
@@ -0,0 +1,157 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// This Include
+#include "SplinePlacementTool.h"
+
+// Engine Includes
+#include "AssetSelection.h"
+#include "Components/SplineComponent.h"
+#include "Editor.h"
+#include "EditorViewportClient.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "ScopedTransaction.h"
+
+// Local Includes
+#include "DesignerModule.h"
+#include "DesignerSettings.h"
+#include "DesignerSplinePlacer.h"
+
+#define LOCTEXT_NAMESPACE "SplinePlacementTool"
+
+FSplinePlacementTool::FSplinePlacementTool(UDesignerSettings* InDesignerSettings)
+	: DesignerSettings(InDesignerSettings)
+{
+}
+
+void FSplinePlacementTool::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(DesignerSettings);
+}
+
+FString FSplinePlacementTool::GetName() const
+{
+	return TEXT("SplinePlacementTool");
+}
+
+void FSplinePlacementTool::EnterTool()
+{
+	SplinePlacer.Reset();
+}
+
+void FSplinePlacementTool::ExitTool()
+{
+	if (SplinePlacer.IsValid())
+	{
+		GEditor->SelectNone(false, true, false);
+		GEditor->SelectActor(SplinePlacer.Get(), true, true, true);
+	}
+
+	SplinePlacer.Reset();
+}
+
+bool FSplinePlacementTool::InputKey(FEditorViewportClient* ViewportClient, FViewport* Viewport, FKey Key, EInputEvent Event)
+{
+	if (Key != EKeys::LeftMouseButton)
+	{
+		return false;
+	}
+
+	if (Event != IE_Pressed)
+	{
+		return true;
+	}
+
+	FVector HitLocation;
+	FVector HitSurfaceNormal;
+	if (!TraceCursor(ViewportClient, Viewport, HitLocation, HitSurfaceNormal))
+	{
+		return true;
+	}
+
+	FScopedTransaction Transaction(LOCTEXT("AddSplinePointTransaction", "Designer: Add Spline Point"));
+
+	if (!SplinePlacer.IsValid())
+	{
+		SplinePlacer = SpawnSplinePlacer(ViewportClient->GetWorld(), HitLocation);
+		if (!SplinePlacer.IsValid())
+		{
+			Transaction.Cancel();
+			return true;
+		}
+	}
+	else
+	{
+		USplineComponent* Spline = SplinePlacer->GetSpline();
+		SplinePlacer->Modify();
+		Spline->Modify();
+		Spline->AddSplinePoint(HitLocation, ESplineCoordinateSpace::World, /*bUpdateSpline*/true);
+	}
+
+	// Only the segments next to the new point are generated
+	SplinePlacer->UpdatePlacements();
+
+	return true;
+}
+
+ADesignerSplinePlacer* FSplinePlacementTool::SpawnSplinePlacer(UWorld* World, const FVector& Location)
+{
+	TArray<FAssetData> SelectedAssets;
+	AssetSelectionUtils::GetSelectedAssets(SelectedAssets);
+
+	TArray<UStaticMesh*> Meshes;
+	for (const FAssetData& AssetData : SelectedAssets)
+	{
+		if (AssetData.GetClass() != nullptr && AssetData.GetClass()->IsChildOf<UStaticMesh>())
+		{
+			Meshes.Add(CastChecked<UStaticMesh>(AssetData.GetAsset()));
+		}
+	}
+
+	// A palette in the settings replaces the selection
+	if (Meshes.Num() == 0 && DesignerSettings->Palette == nullptr)
+	{
+		UE_LOG(LogDesigner, Warning, TEXT("Select one or more static meshes in the content browser or set a palette to draw a spline."));
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.OverrideLevel = World->GetCurrentLevel();
+
+	ADesignerSplinePlacer* NewSplinePlacer = World->SpawnActor<ADesignerSplinePlacer>(Location, FRotator::ZeroRotator, SpawnParameters);
+	NewSplinePlacer->Meshes = Meshes;
+	NewSplinePlacer->GetSettings()->CopySettingsFrom(DesignerSettings);
+	NewSplinePlacer->Seed = FMath::Rand();
+
+	// Start with a single point at the click location instead of the default spline
+	USplineComponent* Spline = NewSplinePlacer->GetSpline();
+	Spline->ClearSplinePoints(/*bUpdateSpline*/false);
+	Spline->AddSplinePoint(Location, ESplineCoordinateSpace::World, /*bUpdateSpline*/true);
+	Spline->bSplineHasBeenEdited = true;
+
+	return NewSplinePlacer;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,74 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Local Includes
+#include "Tools/DesignerTool.h"
+
+// Forward Declares
+class ADesignerSplinePlacer;
+class UDesignerSettings;
+class UWorld;
+
+/**
+ * Tool for drawing splines that distribute the static meshes selected in the content browser.
+ * Every click adds a point to the spline of the current stroke. A new stroke starts every time the tool is entered.
+ */
+class FSplinePlacementTool : public FDesignerTool
+{
+public:
+	FSplinePlacementTool(UDesignerSettings* InDesignerSettings);
+
+	//~ Begin FDesignerTool interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+	/** Returns the name that gets reported to the editor. */
+	virtual FString GetName() const override;
+
+	/** Called by the designer ed mode when switching to this tool */
+	virtual void EnterTool() override;
+
+	/** Called by the designer ed mode when switching to another tool from this tool */
+	virtual void ExitTool() override;
+	//~ End FDesignerTool interface
+
+	//~ Begin FModeTool interface
+	virtual bool InputKey(FEditorViewportClient* ViewportClient, FViewport* Viewport, FKey Key, EInputEvent Event) override;
+	//~ End FModeTool interface
+
+private:
+	/** Spawns a spline placer for a new stroke with the static meshes selected in the content browser. Returns nullptr if none are selected */
+	ADesignerSplinePlacer* SpawnSplinePlacer(UWorld* World, const FVector& Location);
+
+private:
+	/** The settings available to the user, copied to every new spline placer */
+	UDesignerSettings* DesignerSettings;
+
+	/** The spline placer receiving the points of the current stroke */
+	TWeakObjectPtr<ADesignerSplinePlacer> SplinePlacer;
+};
@@ -29,17 +29,22 @@
 #include "EdMode.h"
 
 // Local includes
+#include "Placement/DesignerPlacedContentIndex.h"
+#include "Placement/DesignerSnapIndex.h"
 #include "Tools/SpawnAssetTool.h"
 
 // Forward Declares
 class UDesignerSettings;
+class FEraseTool;
 class FSpawnAssetTool;
+class FSplinePlacementTool;
 
 class FDesignerEdMode : public FEdMode
 {
 
 public:
 	FDesignerEdMode();
+	virtual ~FDesignerEdMode();
 
 	//~ Begin FGCObject interface
 	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
@@ -54,6 +59,10 @@ public:
 	bool LostFocus(FEditorViewportClient * ViewportClient, FViewport * Viewport);
 	bool InputKey(FEditorViewportClient * ViewportClient, FViewport * Viewport, FKey Key, EInputEvent Event);
 
+	virtual void Tick(FEditorViewportClient* ViewportClient, float DeltaTime) override;
+
+	virtual void DrawHUD(FEditorViewportClient* ViewportClient, FViewport* Viewport, const FSceneView* View, FCanvas* Canvas) override;
+
 	/** If the Edmode is handling its own mouse deltas, it can disable the MouseDeltaTacker */
 	virtual bool DisallowMouseDeltaTracking() const;
 
@@ -67,6 +76,12 @@ public:
 	//~ End FEdMode interface
 
 
+	/** Whether the mode opens its toolkit when it is entered, off for modes that run without the level editor such as replays */
+	void SetUsesToolkits(bool bInUsesToolkits)
+	{
+		bUsesToolkits = bInUsesToolkits;
+	}
+
 	/** Set the current tool to the new designer tool while also calling ExitTool on the previous DesignerTool and EnterTool on the NewDesignerTool */
 	void SwitchTool(FDesignerTool* NewDesignerTool);
 
@@ -76,10 +91,51 @@ public:
 		return DesignerSettings; 
 	}
 
+	/** The tool used for spawning assets from the content browser */
+	FSpawnAssetTool* GetSpawnAssetTool() const
+	{
+		return SpawnAssetTool;
+	}
+
+	/** The snap points of the actors in the world */
+	const FDesignerSnapIndex& GetSnapIndex() const
+	{
+		return SnapIndex;
+	}
+
+	/** The placed content of the world */
+	const FDesignerPlacedContentIndex& GetContentIndex() const
+	{
+		return ContentIndex;
+	}
+
 public:
 	const static FEditorModeID EM_DesignerEdModeId;
 
+private:
+	/** Keep the snap and content indices up to date with the actors of the world */
+	void OnLevelActorAdded(AActor* Actor);
+	void OnLevelActorDeleted(AActor* Actor);
+	void OnActorMoved(AActor* Actor);
+	void OnPostUndoRedo();
+
 private:
 	UDesignerSettings* DesignerSettings;
+
+	/** The snap points of the actors in the world, built by the spawn asset tool the first time it snaps */
+	FDesignerSnapIndex SnapIndex;
+
+	/** The placed content of the world, built by the erase tool the first time it erases */
+	FDesignerPlacedContentIndex ContentIndex;
+
+	FDelegateHandle OnLevelActorAddedHandle;
+	FDelegateHandle OnLevelActorDeletedHandle;
+	FDelegateHandle OnActorMovedHandle;
+	FDelegateHandle OnPostUndoRedoHandle;
+
+	bool bUsesToolkits;
+
 	FSpawnAssetTool* SpawnAssetTool;
+	FSplinePlacementTool* SplinePlacementTool;
+	FEraseTool* EraseTool;
 };
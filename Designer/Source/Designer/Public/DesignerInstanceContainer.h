@@ -0,0 +1,150 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+// Generated Include
+#include "DesignerInstanceContainer.generated.h"
+
+// Forward Declares
+class UHierarchicalInstancedStaticMeshComponent;
+class UStaticMesh;
+struct FInstancedStaticMeshInstanceData;
+
+/**
+ * The per instance seeds of a single instanced component
+ */
+USTRUCT()
+struct FDesignerInstanceSeeds
+{
+	GENERATED_BODY()
+
+public:
+	/** The seed of every instance, in instance order */
+	UPROPERTY()
+	TArray<int32> Seeds;
+};
+
+/**
+ * Actor holding the content placed by the Designer tools as instances, usually one instanced component per static mesh
+ */
+UCLASS(NotBlueprintable, ConversionRoot)
+class DESIGNER_API ADesignerInstanceContainer : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ADesignerInstanceContainer(const FObjectInitializer& ObjectInitializer);
+
+	//~ Begin AActor interface
+#if WITH_EDITOR
+	virtual void PostEditUndo() override;
+#endif
+	//~ End AActor interface
+
+	/** Returns the instanced component used for the static mesh, creating it if needed */
+	UHierarchicalInstancedStaticMeshComponent* FindOrAddComponent(UStaticMesh* StaticMesh);
+
+	/** Always creates a new instanced component for the static mesh, for instances that need their own component settings */
+	UHierarchicalInstancedStaticMeshComponent* AddComponent(UStaticMesh* StaticMesh);
+
+	/** Adds world space instances of the static mesh. Seeds is either empty or has one entry per transform */
+	void AddInstances(UStaticMesh* StaticMesh, TArrayView<const FTransform> WorldTransforms, TArrayView<const int32> Seeds);
+
+	/** Adds world space instances to one of the instanced components of this container. Seeds is either empty or has one entry per transform */
+	void AddInstancesToComponent(UHierarchicalInstancedStaticMeshComponent* Component, TArrayView<const FTransform> WorldTransforms, TArrayView<const int32> Seeds);
+
+	/**
+	 * Appends uninitialized instances of the static mesh and returns views of their component space instance data and seeds.
+	 * The views are only valid until the next change to this container. Call FinishInstanceChanges once they are filled in.
+	 */
+	void AddUninitializedInstances(UStaticMesh* StaticMesh, int32 NumInstances, TArrayView<FInstancedStaticMeshInstanceData>& OutInstanceData, TArrayView<int32>& OutSeeds);
+
+	/**
+	 * Replaces a range of instances of one of the instanced components with uninitialized instances and returns views of their
+	 * component space instance data and seeds, the instances after the range keep their order.
+	 * The views are only valid until the next change to this container. Call FinishComponentChanges once they are filled in.
+	 */
+	void ReplaceUninitializedInstances(UHierarchicalInstancedStaticMeshComponent* Component, int32 FirstInstance, int32 NumReplaced, int32 NumInstances, TArrayView<FInstancedStaticMeshInstanceData>& OutInstanceData, TArrayView<int32>& OutSeeds);
+
+	/**
+	 * Removes instances from one of the instanced components of this container, the remaining instances keep their order.
+	 * Their bodies are removed with them, so the physics stays valid without recreating it.
+	 * SortedInstanceIndices must be sorted ascending. Call FinishInstanceChanges once all removals are done.
+	 */
+	void RemoveInstances(UHierarchicalInstancedStaticMeshComponent* Component, TArrayView<const int32> SortedInstanceIndices);
+
+	/**
+	 * Updates the instanced components after their instance data was written directly.
+	 * The instance bodies are only recreated when bUpdatePhysics is set, which is costly on large components.
+	 */
+	void FinishInstanceChanges(bool bUpdatePhysics = false);
+
+	/** Updates one of the instanced components after its instance data was written directly, for changes that leave the other components as they are */
+	void FinishComponentChanges(UHierarchicalInstancedStaticMeshComponent* Component, bool bUpdatePhysics = false);
+
+	/** Removes all instances but keeps the instanced components, so they can be refilled */
+	void EmptyInstances();
+
+	/** Removes all instances and instanced components */
+	void ClearInstances();
+
+	/** The total number of instances in this container */
+	int32 GetInstanceCount() const;
+
+	/** The instanced components of this container */
+	const TArray<UHierarchicalInstancedStaticMeshComponent*>& GetInstanceComponents() const
+	{
+		return InstanceComponents;
+	}
+
+	/** The per instance seeds of one of the instanced components of this container */
+	const TArray<int32>& GetInstanceSeeds(const UHierarchicalInstancedStaticMeshComponent* Component) const;
+
+	/** Changes whenever instances are added, removed or rewritten, or restored by undo, so caches of the instances can tell they are outdated */
+	uint64 GetInstanceChangeStamp() const
+	{
+		return InstanceChangeStamp;
+	}
+
+private:
+	/** Gives the instances a new change stamp */
+	void MarkInstancesChanged();
+
+private:
+	/** The instanced components, one per static mesh unless added with AddComponent */
+	UPROPERTY()
+	TArray<UHierarchicalInstancedStaticMeshComponent*> InstanceComponents;
+
+	/** The seeds of the instances, parallel to InstanceComponents */
+	UPROPERTY()
+	TArray<FDesignerInstanceSeeds> InstanceSeeds;
+
+	/** Unique among all containers, zero until the instances first change */
+	uint64 InstanceChangeStamp = 0;
+};
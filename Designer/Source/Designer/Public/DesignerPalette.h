@@ -0,0 +1,148 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+
+// Local Includes
+#include "DesignerSettings.h"
+
+// Generated Include
+#include "DesignerPalette.generated.h"
+
+/**
+ * Samples indices with a probability proportional to their weight in constant time, no matter how many weights there are.
+ * Built with Vose's alias method: every column holds the probability of keeping its own index and the index to use otherwise.
+ */
+struct DESIGNER_API FDesignerAliasTable
+{
+public:
+	/** Builds the table. Negative weights count as zero */
+	void Build(TArrayView<const float> Weights);
+
+	/** Draws an index. Returns INDEX_NONE if the table is empty or all weights were zero */
+	int32 Sample(FRandomStream& RandomStream) const;
+
+	bool IsEmpty() const
+	{
+		return Probabilities.Num() == 0;
+	}
+
+private:
+	/** The probability of keeping the index of a column */
+	TArray<float> Probabilities;
+
+	/** The index used when a column is not kept */
+	TArray<int32> Aliases;
+};
+
+/**
+ * A single asset of a placement palette
+ */
+USTRUCT()
+struct FDesignerPaletteEntry
+{
+	GENERATED_BODY()
+
+public:
+	FDesignerPaletteEntry();
+
+	/** The asset to place */
+	UPROPERTY(EditAnywhere)
+	UObject* Asset;
+
+	/** How often this asset is placed relative to the other entries */
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0"))
+	float Weight;
+
+	/** Use the random rotation ranges of this entry instead of the ones of the settings. Random rotation still has to be enabled in the settings */
+	UPROPERTY(EditAnywhere)
+	bool bOverrideRandomRotation;
+
+	UPROPERTY(EditAnywhere, meta = (EditCondition = "bOverrideRandomRotation"))
+	FRandomMinMaxFloat RandomRotationX;
+
+	UPROPERTY(EditAnywhere, meta = (EditCondition = "bOverrideRandomRotation"))
+	FRandomMinMaxFloat RandomRotationY;
+
+	UPROPERTY(EditAnywhere, meta = (EditCondition = "bOverrideRandomRotation"))
+	FRandomMinMaxFloat RandomRotationZ;
+
+	/** Use the random scale ranges of this entry instead of the ones of the settings. Random scale still has to be enabled in the settings */
+	UPROPERTY(EditAnywhere)
+	bool bOverrideRandomScale;
+
+	UPROPERTY(EditAnywhere, meta = (EditCondition = "bOverrideRandomScale"))
+	FRandomMinMaxFloat RandomScaleX;
+
+	UPROPERTY(EditAnywhere, meta = (EditCondition = "bOverrideRandomScale"))
+	FRandomMinMaxFloat RandomScaleY;
+
+	UPROPERTY(EditAnywhere, meta = (EditCondition = "bOverrideRandomScale"))
+	FRandomMinMaxFloat RandomScaleZ;
+
+	/** Use the overlap padding of this entry instead of the one of the settings. Overlap rejection still has to be enabled in the settings */
+	UPROPERTY(EditAnywhere)
+	bool bOverrideOverlapPadding;
+
+	UPROPERTY(EditAnywhere, meta = (EditCondition = "bOverrideOverlapPadding"))
+	float OverlapPadding;
+};
+
+/**
+ * A weighted set of assets to place, e.g. mostly small rocks and occasionally a boulder.
+ * The assets are hard references, so picking an entry never has to load anything.
+ */
+UCLASS(BlueprintType)
+class DESIGNER_API UDesignerPalette : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** Picks an entry with a probability proportional to its weight. Returns INDEX_NONE if no entry can be placed */
+	int32 PickEntry(FRandomStream& RandomStream) const;
+
+	/** Rebuilds the sampling table, needed after changing the entries from code */
+	void RebuildAliasTable();
+
+	//~ Begin UObject interface
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PostEditUndo() override;
+#endif
+	//~ End UObject interface
+
+public:
+	/** The assets of the palette */
+	UPROPERTY(Category = "Palette", EditAnywhere)
+	TArray<FDesignerPaletteEntry> Entries;
+
+private:
+	/** Samples the entries by weight, entries without an asset have a weight of zero */
+	FDesignerAliasTable AliasTable;
+};
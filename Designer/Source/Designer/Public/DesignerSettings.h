@@ -33,6 +33,10 @@
 
 // Forward Declares
 class FDesignerEdMode;
+class UDesignerPalette;
+class ULandscapeLayerInfoObject;
+class UPhysicalMaterial;
+class UTexture2D;
 
 UENUM()
 enum class EAxisType : uint8
@@ -59,6 +63,41 @@ enum class EAxisType : uint8
 	Down = 0x09 UMETA(DisplayName = "Down (-Z)")
 };
 
+UENUM()
+enum class EPlacementMode : uint8
+{
+	/** Every click places a single asset */
+	Single UMETA(DisplayName = "Single"),
+
+	/** Every click drags out a lattice of static meshes from the spawn point */
+	Array UMETA(DisplayName = "Array")
+};
+
+UENUM()
+enum class EEraseFilter : uint8
+{
+	/** Everything placed by the Designer tools */
+	All UMETA(DisplayName = "All"),
+
+	/** Only the assets of the palette, or of the content browser selection when no palette is set */
+	SelectedAssets UMETA(DisplayName = "Selected Assets"),
+
+	/** Only placed actors, container instances are kept */
+	Actors UMETA(DisplayName = "Actors"),
+
+	/** Only container instances, placed actors are kept */
+	Instances UMETA(DisplayName = "Instances")
+};
+
+UENUM()
+enum class EDensityMapChannel : uint8
+{
+	Red,
+	Green,
+	Blue,
+	Alpha
+};
+
 /**
  * A random float within a min max range
  * Option for randomly negating the value
@@ -79,6 +118,9 @@ public:
 	/** Regenerates the random value and returns it. The value can also be retrieved later as well using GetCurrentRandomValue */
 	float RegenerateRandomValue();
 
+	/** Draws a random value from the given stream without changing the stored value. Used for deterministic placement */
+	float GetRandomValue(FRandomStream& RandomStream) const;
+
 public:
 	/** The minimal value */
 	UPROPERTY(EditAnywhere)
@@ -121,6 +163,12 @@ public:
 
 	void SetParent(FDesignerEdMode* DesignerEdMode);
 
+	/** Copies all editable settings from another settings object */
+	void CopySettingsFrom(const UDesignerSettings* Other);
+
+	/** The settings of the active designer mode, or the defaults when the mode is not active. Used by commands that can run outside of the mode */
+	static const UDesignerSettings* GetActiveSettings();
+
 public:
 	/** The spawn location offset in relative space */
 	UPROPERTY(Category = "SpawnSettings", NonTransactional, EditAnywhere)
@@ -186,6 +234,130 @@ public:
 	UPROPERTY(Category = "SpawnSettings", NonTransactional, EditAnywhere, meta = (EditCondition = "bApplyRandomScale"))
 	FRandomMinMaxFloat RandomScaleZ;
 
+	/** Aligns the spawned asset to a plane fitted under its bounds instead of to the normal under the cursor, which keeps large assets level on rough surfaces */
+	UPROPERTY(Category = "SpawnSettings", NonTransactional, EditAnywhere)
+	bool bAlignToFootprint;
+
+	/** The number of rays cast along each side of the footprint */
+	UPROPERTY(Category = "SpawnSettings", NonTransactional, EditAnywhere, meta = (ClampMin = "2", ClampMax = "8", EditCondition = "bAlignToFootprint"))
+	int32 FootprintRaysPerAxis;
+
+	/** Drops placed actors onto their surroundings with an isolated physics simulation, for rubble and stacked props */
+	UPROPERTY(Category = "SpawnSettings", NonTransactional, EditAnywhere)
+	bool bSettlePlacements;
+
+	/** When set, assets are picked from this palette by weight instead of from the content browser selection */
+	UPROPERTY(Category = "SpawnSettings", NonTransactional, EditAnywhere)
+	UDesignerPalette* Palette;
+
+	/** How many milliseconds per frame bulk operations may spend spawning actors, the rest is spawned over the next frames */
+	UPROPERTY(Category = "SpawnSettings", NonTransactional, EditAnywhere, meta = (ClampMin = "1.0"))
+	float SpawnBudgetMilliseconds;
+
+	/** Bulk placement density follows this mask, white places at the full density and black places nothing */
+	UPROPERTY(Category = "DensityMapSettings", NonTransactional, EditAnywhere)
+	UTexture2D* DensityTexture;
+
+	/** The channel of the density texture that holds the mask */
+	UPROPERTY(Category = "DensityMapSettings", NonTransactional, EditAnywhere)
+	EDensityMapChannel DensityTextureChannel;
+
+	/** The world xy region covered by the density texture. Its first row lies at the minimum y */
+	UPROPERTY(Category = "DensityMapSettings", NonTransactional, EditAnywhere)
+	FBox2D DensityTextureBounds;
+
+	/** Bulk placement density follows the painted weight of this landscape layer. Used instead of the density texture when both are set */
+	UPROPERTY(Category = "DensityMapSettings", NonTransactional, EditAnywhere)
+	ULandscapeLayerInfoObject* DensityLayer;
+
+	/** Bulk placement skips placements whose bounds overlap content placed earlier by the Designer tools or each other */
+	UPROPERTY(Category = "OverlapSettings", NonTransactional, EditAnywhere)
+	bool bRejectOverlaps;
+
+	/** The distance in cm kept between the bounds of placements when rejecting overlaps */
+	UPROPERTY(Category = "OverlapSettings", NonTransactional, EditAnywhere, meta = (EditCondition = "bRejectOverlaps"))
+	float OverlapPadding;
+
+	/** Bulk placement only places on surfaces within a range of slopes */
+	UPROPERTY(Category = "PlacementRules", NonTransactional, EditAnywhere)
+	bool bLimitSlope;
+
+	/** The smallest slope in degrees from horizontal that is placed on */
+	UPROPERTY(Category = "PlacementRules", NonTransactional, EditAnywhere, meta = (ClampMin = "0.0", ClampMax = "180.0", EditCondition = "bLimitSlope"))
+	float MinSlopeAngle;
+
+	/** The largest slope in degrees from horizontal that is placed on */
+	UPROPERTY(Category = "PlacementRules", NonTransactional, EditAnywhere, meta = (ClampMin = "0.0", ClampMax = "180.0", EditCondition = "bLimitSlope"))
+	float MaxSlopeAngle;
+
+	/** Bulk placement only places on surfaces within a range of world heights */
+	UPROPERTY(Category = "PlacementRules", NonTransactional, EditAnywhere)
+	bool bLimitHeight;
+
+	/** The lowest world height in cm that is placed on */
+	UPROPERTY(Category = "PlacementRules", NonTransactional, EditAnywhere, meta = (EditCondition = "bLimitHeight"))
+	float MinHeight;
+
+	/** The highest world height in cm that is placed on */
+	UPROPERTY(Category = "PlacementRules", NonTransactional, EditAnywhere, meta = (EditCondition = "bLimitHeight"))
+	float MaxHeight;
+
+	/** Bulk placement only places on slopes facing a direction. Level surfaces do not face any direction and are skipped */
+	UPROPERTY(Category = "PlacementRules", NonTransactional, EditAnywhere)
+	bool bLimitFacing;
+
+	/** The world yaw in degrees the slopes have to face, zero faces +X */
+	UPROPERTY(Category = "PlacementRules", NonTransactional, EditAnywhere, meta = (EditCondition = "bLimitFacing"))
+	float FacingYaw;
+
+	/** How far in degrees the facing of a slope may turn away from the facing yaw */
+	UPROPERTY(Category = "PlacementRules", NonTransactional, EditAnywhere, meta = (ClampMin = "0.0", ClampMax = "180.0", EditCondition = "bLimitFacing"))
+	float MaxFacingAngle;
+
+	/** Bulk placement never places on surfaces with these physical materials, e.g. water */
+	UPROPERTY(Category = "PlacementRules", NonTransactional, EditAnywhere)
+	TArray<UPhysicalMaterial*> ExcludedPhysicalMaterials;
+
+	/** Snaps the spawned actor to the sockets and bounds faces of nearby static mesh actors */
+	UPROPERTY(Category = "SnapSettings", NonTransactional, EditAnywhere)
+	bool bSnapToPlacedContent;
+
+	/** The maximum distance in cm the spawned actor is moved to snap */
+	UPROPERTY(Category = "SnapSettings", NonTransactional, EditAnywhere, meta = (ClampMin = "0.0", EditCondition = "bSnapToPlacedContent"))
+	float SnapDistance;
+
+	/** How the spawn asset tool places assets */
+	UPROPERTY(Category = "ArraySettings", NonTransactional, EditAnywhere)
+	EPlacementMode PlacementMode;
+
+	/** The distance between array items along the forward, right and up axis. Zero uses the size of the mesh bounds along that axis */
+	UPROPERTY(Category = "ArraySettings", NonTransactional, EditAnywhere, meta = (EditCondition = "PlacementMode == EPlacementMode::Array"))
+	FVector ArraySpacing;
+
+	/** The number of layers of the array stacked along the up axis */
+	UPROPERTY(Category = "ArraySettings", NonTransactional, EditAnywhere, meta = (ClampMin = "1", EditCondition = "PlacementMode == EPlacementMode::Array"))
+	int32 ArrayLayers;
+
+	/** Commit arrays as instances in an instance container instead of as separate actors */
+	UPROPERTY(Category = "ArraySettings", NonTransactional, EditAnywhere, meta = (EditCondition = "PlacementMode == EPlacementMode::Array"))
+	bool bCommitArrayAsInstances;
+
+	/** The radius in cm of the erase brush, used while holding Ctrl and Shift */
+	UPROPERTY(Category = "EraseSettings", NonTransactional, EditAnywhere, meta = (ClampMin = "1.0"))
+	float EraseRadius;
+
+	/** The fraction of the content under the brush a stroke removes. Lower values thin content out instead of clearing it */
+	UPROPERTY(Category = "EraseSettings", NonTransactional, EditAnywhere, meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float EraseFraction;
+
+	/** Which placed content the erase brush removes */
+	UPROPERTY(Category = "EraseSettings", NonTransactional, EditAnywhere)
+	EEraseFilter EraseFilter;
+
+	/** Draws the per frame cost of the tools, the traces and placements and the pending work over the viewport */
+	UPROPERTY(Category = "DiagnosticsSettings", NonTransactional, EditAnywhere)
+	bool bShowPerformanceHUD;
+
 private:
 	FDesignerEdMode* ParentEdMode;
 
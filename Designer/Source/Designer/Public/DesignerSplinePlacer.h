@@ -0,0 +1,167 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Engine Includes
+#include "CoreMinimal.h"
+
+// Local Includes
+#include "DesignerInstanceContainer.h"
+
+// Generated Include
+#include "DesignerSplinePlacer.generated.h"
+
+// Forward Declares
+class UDesignerSettings;
+struct FDesignerRotationGrid;
+class USplineComponent;
+class UStaticMesh;
+
+/**
+ * The cached placements of a single spline segment
+ */
+struct FDesignerSplineSegment
+{
+	FDesignerSplineSegment()
+		: Signature(0)
+	{
+	}
+
+	/** Hash of the spline points bounding the segment, the segment is regenerated when it changes */
+	uint32 Signature;
+
+	/** The cumulative length at evenly spaced input keys along the segment, used for arc length lookups */
+	TArray<float> ArcLengths;
+
+	/** The world transforms of the placements */
+	TArray<FTransform> Transforms;
+
+	/** The index into the placement meshes of the placer of every placement */
+	TArray<int32> MeshIndices;
+
+	/** The seed of every placement */
+	TArray<int32> Seeds;
+
+	/** The number of instances of every placement mesh the segment has in the container, as they were last written */
+	TArray<int32> InstanceCounts;
+};
+
+/**
+ * Distributes static meshes along a spline as instances, for fences, cables, borders and tree lines.
+ * Placements are spaced evenly per segment, so editing a spline point only regenerates the segments around it.
+ */
+UCLASS(ConversionRoot)
+class DESIGNER_API ADesignerSplinePlacer : public ADesignerInstanceContainer
+{
+	GENERATED_BODY()
+
+public:
+	ADesignerSplinePlacer(const FObjectInitializer& ObjectInitializer);
+
+	//~ Begin AActor interface
+	virtual void OnConstruction(const FTransform& Transform) override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PostEditUndo() override;
+#endif
+	//~ End AActor interface
+
+	/** Regenerates the placements of the segments that changed since the last update */
+	void UpdatePlacements();
+
+	/** Regenerates the placements of all segments on the next update */
+	void InvalidatePlacements();
+
+	USplineComponent* GetSpline() const
+	{
+		return Spline;
+	}
+
+	UDesignerSettings* GetSettings() const
+	{
+		return Settings;
+	}
+
+public:
+	/** The meshes that are distributed along the spline. Not used when the settings have a palette */
+	UPROPERTY(Category = "Placement", EditAnywhere)
+	TArray<UStaticMesh*> Meshes;
+
+	/** The distance between placements in cm. Every segment is filled evenly, so the actual spacing can be slightly larger */
+	UPROPERTY(Category = "Placement", EditAnywhere, meta = (ClampMin = "1.0"))
+	float Spacing;
+
+	/** The seed all random values of the placements are derived from */
+	UPROPERTY(Category = "Placement", EditAnywhere)
+	int32 Seed;
+
+	/** Moves every placement down onto the surface below it and aligns it with the surface normal */
+	UPROPERTY(Category = "Placement", EditAnywhere)
+	bool bProjectToSurface;
+
+	/** The distance above and below the spline that is searched for a surface */
+	UPROPERTY(Category = "Placement", EditAnywhere, meta = (EditCondition = "bProjectToSurface", ClampMin = "0.0"))
+	float ProjectionDistance;
+
+	/** The alignment and randomization applied to every placement */
+	UPROPERTY(Category = "Placement", VisibleAnywhere, Instanced)
+	UDesignerSettings* Settings;
+
+private:
+	/** Collects the meshes the placements pick from, the static meshes of the palette if the settings have one or Meshes otherwise */
+	void GetPlacementMeshes(TArray<UStaticMesh*>& OutPlacementMeshes) const;
+
+	/**
+	 * Builds the arc length table and the placements of a segment. Safe to call for different segments in parallel.
+	 * Returns the number of placements whose rotation fell back to the default frame.
+	 */
+	int32 GenerateSegment(int32 SegmentIndex, const FDesignerRotationGrid& RotationGrid);
+
+	/** Rewrites all instances of the container from the cached placements */
+	void RefillInstances();
+
+	/**
+	 * Replaces the instances of the dirty segments in the container, the instances of the other segments stay as they are.
+	 * Returns false if the container no longer holds the instances the segments last wrote, they need a refill then.
+	 */
+	bool ReplaceSegmentInstances(const TArray<int32>& DirtySegments);
+
+	/** The signature of a segment, based on the spline points at both ends */
+	uint32 GetSegmentSignature(int32 SegmentIndex) const;
+
+private:
+	UPROPERTY(Category = "Placement", VisibleAnywhere)
+	USplineComponent* Spline;
+
+	/** The cached placements, one entry per spline segment */
+	TArray<FDesignerSplineSegment> Segments;
+
+	/** The actor transform the cached placements were generated for */
+	FTransform GeneratedActorTransform;
+
+	/** The meshes the cached placements were generated for, parallel to the palette entries when a palette is used */
+	UPROPERTY(Transient)
+	TArray<UStaticMesh*> PlacementMeshes;
+};